@@ -0,0 +1,25 @@
+/**
+* @file Impostor.frag
+*/
+#version 410
+
+layout(location=0) in vec4 inColor;
+layout(location=1) in vec2 inTexCoord;
+
+out vec4 fragColor;
+
+uniform sampler2D texColor;
+
+/**
+* インポスター用フラグメントシェーダー.
+*
+* 陰影は焼き付け時に計算済み.
+*/
+void main()
+{
+  fragColor = inColor * texture(texColor, inTexCoord);
+  if (fragColor.a < 0.5) {
+    discard;
+  }
+  fragColor.a = 1.0;
+}
@@ -0,0 +1,39 @@
+/**
+* @file Impostor.vert
+*/
+#version 410
+
+layout(location=0) in vec4 vPositionAndSize;
+layout(location=1) in vec4 vColor;
+layout(location=2) in vec2 vRotationAndRow;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+
+uniform mat4x4 matVP;
+uniform vec3 cameraPosition;
+uniform vec2 atlasSize; // x=方向の数, y=メッシュの数.
+
+const float pi2 = 6.2831853;
+
+/**
+* インポスター用頂点シェーダー.
+*/
+void main()
+{
+  // 視点の方向をY軸周りの角度に変換し、最も近い焼き付け方向を選ぶ.
+  vec2 toCamera = cameraPosition.xz - vPositionAndSize.xz;
+  toCamera = dot(toCamera, toCamera) > 0.000001 ? normalize(toCamera) : vec2(0, 1);
+  float angle = atan(toCamera.x, toCamera.y) - vRotationAndRow.x;
+  float cell = mod(floor(angle / pi2 * atlasSize.x + 0.5), atlasSize.x);
+
+  // gl_VertexIDから板ポリゴンの頂点を作る(0=左下, 1=右下, 2=左上, 3=右上).
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  vec3 right = vec3(toCamera.y, 0, -toCamera.x);
+  float size = vPositionAndSize.w;
+  vec3 position = vPositionAndSize.xyz + right * ((corner.x - 0.5) * size) + vec3(0, corner.y * size, 0);
+
+  outColor = vColor;
+  outTexCoord = (vec2(cell, vRotationAndRow.y) + corner) / atlasSize;
+  gl_Position = matVP * vec4(position, 1.0);
+}
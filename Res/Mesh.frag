@@ -15,7 +15,7 @@ out vec4 fragColor;
 uniform sampler2D texColor;
 
 /**
-* XvCgptOgVF[_[.
+* スプライト用フラグメントシェーダー.
 */
 void main()
 {
@@ -29,7 +29,7 @@ uniform mat3x3 matNormal;
 uniform vec4 materialColor;
 
 /**
-* XvCgp_VF[_[.
+* スプライト用頂点シェーダー.
 */
 void main()
 {
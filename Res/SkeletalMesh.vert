@@ -22,7 +22,9 @@ uniform mat4x4 matVP;
 layout(std140) uniform MeshMatrixUniformData
 {
   vec4 color;
+  ivec4 flags; // x=1なら全ての行列が均一スケール.
   mat3x4 matModel[8]; // it must transpose.
+  mat3x4 matNormal[8]; // matModelの逆転置行列. it must transpose.
   mat3x4 matBones[256]; // it must transpose.
 } vd;
 
@@ -43,10 +45,18 @@ void main()
     vd.matBones[int(vJoints.z)] * vWeights.z +
     vd.matBones[int(vJoints.w)] * vWeights.w;
   mat4 matSkin = mat4(transpose(matSkinTmp));
-  matSkin[3][3] = dot(vWeights, vec4(1)); // EFCgKĂȂꍇ̑΍([3][3]1.0ɂȂƂ͌Ȃ).
+  matSkin[3][3] = dot(vWeights, vec4(1)); // ウェイトが正規化されていない場合の対策([3][3]が1.0になるとは限らない).
   mat4 matModel = mat4(transpose(vd.matModel[meshIndex])) * matSkin;
-  mat3 matNormal = transpose(inverse(mat3(matModel)));
-  outNormal = matNormal * vNormal;
+  if (vd.flags.x != 0) {
+    // 均一スケールなら法線もモデル行列で変換できる. 長さはフラグメントシェーダーで正規化する.
+    outNormal = mat3(matModel) * vNormal;
+  } else {
+    // 余因子行列は逆転置行列に行列式を掛けたもの. 逆行列を計算しなくても、行列式の符号を掛ければ法線の向きは求められる.
+    // 符号を掛けないと、鏡映を含む(行列式が負の)行列で法線が裏返ってしまう.
+    mat3 m = mat3(matSkin);
+    mat3 matSkinCofactor = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1])) * sign(determinant(m));
+    outNormal = mat3(transpose(vd.matNormal[meshIndex])) * (matSkinCofactor * vNormal);
+  }
   outPosition = vec3(matModel * vec4(vPosition, 1.0));
   gl_Position = matVP * matModel * vec4(vPosition, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/**
+* @file SkeletalMeshCrowd.vert
+*/
+#version 410
+
+layout(location=0) in vec3 vPosition;
+layout(location=1) in vec4 vColor;
+layout(location=2) in vec2 vTexCoord;
+layout(location=3) in vec3 vNormal;
+layout(location=4) in vec4 vWeights;
+layout(location=5) in vec4 vJoints;
+
+layout(location=0) out vec4 outColor;
+layout(location=1) out vec2 outTexCoord;
+layout(location=2) out vec3 outNormal;
+layout(location=3) out vec3 outPosition;
+
+// global
+uniform mat4x4 matVP;
+
+// per mesh
+uniform sampler2D texAnimation; // 焼き付けた関節行列. 1行が1フレームで、関節1つあたり3テクセル.
+uniform samplerBuffer texInstance; // インスタンスデータ. 1インスタンスあたり5テクセル.
+uniform int instanceOffset; // このメッシュのインスタンスデータの先頭テクセル.
+
+/**
+* 焼き付けた関節行列を取得する.
+*
+* @param joint 関節番号.
+* @param row   フレームの行番号.
+*
+* @return 関節行列(転置されている).
+*/
+mat3x4 FetchJoint(int joint, int row)
+{
+  int x = joint * 3;
+  return mat3x4(
+    texelFetch(texAnimation, ivec2(x + 0, row), 0),
+    texelFetch(texAnimation, ivec2(x + 1, row), 0),
+    texelFetch(texAnimation, ivec2(x + 2, row), 0));
+}
+
+/**
+* 2つのフレームの関節行列を補間する.
+*
+* @param joint 関節番号.
+* @param anim  x=フレーム0の行番号, y=フレーム1の行番号, z=補間係数.
+*
+* @return 補間した関節行列(転置されている).
+*/
+mat3x4 FetchPose(int joint, vec3 anim)
+{
+  return FetchJoint(joint, int(anim.x)) * (1.0 - anim.z) + FetchJoint(joint, int(anim.y)) * anim.z;
+}
+
+/**
+* Vertex shader for crowds of Skeletal Mesh.
+*/
+void main()
+{
+  int base = instanceOffset + gl_InstanceID * 5;
+  mat3x4 matInstance = mat3x4(
+    texelFetch(texInstance, base + 0),
+    texelFetch(texInstance, base + 1),
+    texelFetch(texInstance, base + 2));
+  vec4 instanceColor = texelFetch(texInstance, base + 3);
+  vec3 anim = texelFetch(texInstance, base + 4).xyz;
+
+  outColor = vColor * instanceColor;
+  outTexCoord = vTexCoord;
+  mat3x4 matSkinTmp =
+    FetchPose(int(vJoints.x), anim) * vWeights.x +
+    FetchPose(int(vJoints.y), anim) * vWeights.y +
+    FetchPose(int(vJoints.z), anim) * vWeights.z +
+    FetchPose(int(vJoints.w), anim) * vWeights.w;
+  mat4 matSkin = mat4(transpose(matSkinTmp));
+  matSkin[3][3] = dot(vWeights, vec4(1)); // ウェイトが正規化されていない場合の対策([3][3]が1.0になるとは限らない).
+  mat4 matModel = mat4(transpose(matInstance)) * matSkin;
+
+  // 余因子行列は逆転置行列に行列式を掛けたもの. 行列式の符号を掛ければ法線の向きは逆転置行列と一致する.
+  // 符号を掛けないと、鏡映を含む(行列式が負の)行列で法線が裏返ってしまう.
+  mat3 m = mat3(matModel);
+  outNormal = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1])) * (sign(determinant(m)) * vNormal);
+  outPosition = vec3(matModel * vec4(vPosition, 1.0));
+  gl_Position = matVP * matModel * vec4(vPosition, 1.0);
+}
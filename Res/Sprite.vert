@@ -13,7 +13,7 @@ layout(location=1) out vec2 outTexCoord;
 uniform mat4x4 matVP;
 
 /**
-* XvCgp_VF[_[.
+* スプライト用頂点シェーダー.
 */
 void main()
 {
@@ -6,15 +6,15 @@
 #include <algorithm>
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param name     AN^[̖O.
-* @param health   ϋv.
-* @param position ʒu.
-* @param rotation ].
-* @param scale    g嗦.
+* @param name     アクターの名前.
+* @param health   耐久力.
+* @param position 位置.
+* @param rotation 回転.
+* @param scale    拡大率.
 *
-* w肳ꂽOAϋv́AʒuA]Ag嗦ɂăAN^[.
+* 指定された名前、耐久力、位置、回転、拡大率によってアクターを初期化する.
 */
 Actor::Actor(const std::string& name, int health,
   const glm::vec3& position, const glm::vec3& rotation,
@@ -25,11 +25,11 @@ Actor::Actor(const std::string& name, int health,
 }
 
 /**
-* XV.
+* 更新.
 *
-* @param deltaTime oߎ.
+* @param deltaTime 経過時間.
 *
-* UpdateDrawData()OɎs邱.
+* UpdateDrawData()より前に実行すること.
 */
 void Actor::Update(float deltaTime)
 {
@@ -65,34 +65,34 @@ void Actor::Update(float deltaTime)
 }
 
 /**
-* `̍XV.
+* 描画情報の更新.
 *
-* @param deltaTime oߎ.
+* @param deltaTime 経過時間.
 *
-* Update()̌Ŏs邱.
+* Update()の後で実行すること.
 */
 void Actor::UpdateDrawData(float deltaTime)
 {
 }
 
 /**
-* `.
+* 描画.
 */
 void Actor::Draw()
 {
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param m        \郁bV.
-* @param name     AN^[̖O.
-* @param health   ϋv.
-* @param position ʒu.
-* @param rotation ].
-* @param scale    g嗦.
+* @param m        表示するメッシュ.
+* @param name     アクターの名前.
+* @param health   耐久力.
+* @param position 位置.
+* @param rotation 回転.
+* @param scale    拡大率.
 *
-* w肳ꂽbVAOAϋv́AʒuA]Ag嗦ɂăAN^[.
+* 指定されたメッシュ、名前、耐久力、位置、回転、拡大率によってアクターを初期化する.
 */
 StaticMeshActor::StaticMeshActor(const Mesh::MeshPtr& m,
   const std::string& name, int health, const glm::vec3& position,
@@ -102,7 +102,7 @@ StaticMeshActor::StaticMeshActor(const Mesh::MeshPtr& m,
 }
 
 /**
-* `.
+* 描画.
 */
 void StaticMeshActor::Draw()
 {
@@ -118,9 +118,9 @@ void StaticMeshActor::Draw()
 }
 
 /**
-* i[\ȃAN^[mۂ.
+* 格納可能なアクター数を確保する.
 *
-* @param reserveCount AN^[z̊mې.
+* @param reserveCount アクター配列の確保数.
 */
 void ActorList::Reserve(size_t reserveCount)
 {
@@ -128,9 +128,9 @@ void ActorList::Reserve(size_t reserveCount)
 }
 
 /**
-* AN^[ǉ.
+* アクターを追加する.
 *
-* @param actor ǉAN^[.
+* @param actor 追加するアクター.
 */
 void ActorList::Add(const ActorPtr& actor)
 {
@@ -138,9 +138,9 @@ void ActorList::Add(const ActorPtr& actor)
 }
 
 /**
-* AN^[폜.
+* アクターを削除する.
 *
-* @param actor 폜AN^[.
+* @param actor 削除するアクター.
 */
 bool ActorList::Remove(const ActorPtr& actor)
 {
@@ -153,7 +153,7 @@ bool ActorList::Remove(const ActorPtr& actor)
 }
 
 /**
-* AN^[Xgɂ.
+* アクターリストを空にする.
 */
 void ActorList::Clear()
 {
@@ -161,9 +161,9 @@ void ActorList::Clear()
 }
 
 /**
-* AN^[̏ԂXV.
+* アクターの状態を更新する.
 *
-* @param deltaTime O̍XV̌oߎ.
+* @param deltaTime 前回の更新からの経過時間.
 */
 void ActorList::Update(float deltaTime)
 {
@@ -183,9 +183,9 @@ void ActorList::Update(float deltaTime)
 }
 
 /**
-* AN^[̕`f[^XV.
+* アクターの描画データを更新する.
 *
-* @param deltaTime O̍XV̌oߎ.
+* @param deltaTime 前回の更新からの経過時間.
 */
 void ActorList::UpdateDrawData(float deltaTime)
 {
@@ -197,7 +197,7 @@ void ActorList::UpdateDrawData(float deltaTime)
 }
 
 /**
-* Actor`悷.
+* Actorを描画する.
 */
 void ActorList::Draw()
 {
@@ -209,12 +209,12 @@ void ActorList::Draw()
 }
 
 /**
-* OŃAN^[.
+* 名前でアクターを検索する.
 *
-* @param name AN^[.
+* @param name 検索するアクター名.
 *
-* @return OnameƈvAN^[.
-*         vAN^[ȂnullptrԂ.
+* @return 名前がnameと一致するアクター.
+*         一致するアクターがいなければnullptrを返す.
 */
 ActorPtr ActorList::Find(const std::string& name) const
 {
@@ -242,14 +242,14 @@ void ActorList::RemoveDead()
 }
 
 /**
-* Փ˔s.
+* 衝突判定を行う.
 *
-* @param a       Ώۂ̃AN^[̂P.
-* @param b       Ώۂ̃AN^[̂Q.
-* @param handler Փ˂ꍇɎs֐.
+* @param a       判定対象のアクターその１.
+* @param b       判定対象のアクターその２.
+* @param handler 衝突した場合に実行される関数.
 *
-* @retval true  Փ˂.
-* @retval false Փ˂Ȃ.
+* @retval true  衝突した.
+* @retval false 衝突しなかった.
 */
 bool DetectCollision(const ActorPtr& a, const ActorPtr& b, CollsionHandlerType handler)
 {
@@ -267,14 +267,14 @@ bool DetectCollision(const ActorPtr& a, const ActorPtr& b, CollsionHandlerType h
 }
 
 /**
-* Փ˔s.
+* 衝突判定を行う.
 *
-* @param a       Ώۂ̃AN^[.
-* @param b       Ώۂ̃AN^[Xg.
-* @param handler Փ˂ꍇɎs֐.
+* @param a       判定対象のアクター.
+* @param b       判定対象のアクターリスト.
+* @param handler 衝突した場合に実行される関数.
 *
-* @retval true  Փ˂ɂahealth0ȉɂȂ.
-* @retval false ahealthŏ0ȉA邢
+* @retval true  衝突によってaのhealthが0以下になった.
+* @retval false aのhealthが最初から0以下、あるいは
 */
 void DetectCollision(const ActorPtr& a, const ActorList& b, CollsionHandlerType handler)
 {
@@ -294,11 +294,11 @@ void DetectCollision(const ActorPtr& a, const ActorList& b, CollsionHandlerType
 }
 
 /**
-* Փ˔s.
+* 衝突判定を行う.
 *
-* @param a       Ώۂ̃AN^[XĝP.
-* @param b       Ώۂ̃AN^[XĝQ.
-* @param handler Փ˂ꍇɎs֐.
+* @param a       判定対象のアクターリストその１.
+* @param b       判定対象のアクターリストその２.
+* @param handler 衝突した場合に実行される関数.
 */
 void DetectCollision(const ActorList& a, const ActorList& b, CollsionHandlerType handler)
 {
@@ -309,13 +309,13 @@ void DetectCollision(const ActorList& a, const ActorList& b, CollsionHandlerType
 
 #if 0
 /**
-* 2̒`̏ՓˏԂ𒲂ׂ.
+* 2つの長方形の衝突状態を調べる.
 *
-* @param lhs `1.
-* @param rhs `2.
+* @param lhs 長方形その1.
+* @param rhs 長方形その2.
 *
-* @retval true  Փ˂Ă.
-* @retval false Փ˂ĂȂ.
+* @retval true  衝突している.
+* @retval false 衝突していない.
 */
 bool DetectCollision(const Actor& lhs, const Actor& rhs)
 {
@@ -329,11 +329,11 @@ bool DetectCollision(const Actor& lhs, const Actor& rhs)
 }
 
 /**
-* 2̃O[vԂŏՓ˔s.
+* 2つのグループ間で衝突判定を行う.
 *
-* @param va O[vA.
-* @param vb O[vB.
-* @param func A-BԂ̏Փ˂֐. 
+* @param va グループA.
+* @param vb グループB.
+* @param func A-B間の衝突を処理する関数. 
 */
 void DetectCollision(std::vector<Actor*>& va, std::vector<Actor*>& vb, CollsionHandlerType func)
 {
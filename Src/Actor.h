@@ -16,7 +16,7 @@ class Actor;
 using ActorPtr = std::shared_ptr<Actor>;
 
 /**
-* V[ɔzuIuWFNg.
+* シーンに配置するオブジェクト.
 */
 class Actor
 {
@@ -44,7 +44,7 @@ public:
 };
 
 /**
-* ÓIbVpAN^[.
+* 静的メッシュ用アクター.
 */
 class StaticMeshActor : public Actor
 {
@@ -63,7 +63,7 @@ private:
 using StaticMeshActorPtr = std::shared_ptr<StaticMeshActor>;
 
 /**
-* AN^[܂Ƃ߂đ삷NX.
+* アクターをまとめて操作するクラス.
 */
 class ActorList
 {
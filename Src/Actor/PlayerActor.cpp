@@ -5,6 +5,13 @@
 #include "../SkeletalMesh.h"
 #include <iostream>
 
+namespace /* unnamed */ {
+
+// 状態が変わったときに、アニメーションを切り替えるのにかける時間(秒).
+const float animationFadeTime = 0.15f;
+
+} // unnamed namespace
+
 /**
 *
 */
@@ -20,7 +27,7 @@ void PlayerActor::SetState(State s)
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 PlayerActor::PlayerActor(const Mesh::SkeletalMeshPtr& m, const std::string& name, int hp, const glm::vec3& pos,
   const glm::vec3& rot, const glm::vec3& scale)
@@ -71,7 +78,7 @@ bool PlayerActor::CheckRun(const GamePad& gamepad)
     velocity = move * speed;
 
     if (GetMesh()->GetAnimation() != "Run") {
-      GetMesh()->Play("Run");
+      GetMesh()->CrossFade("Run", animationFadeTime);
     }
     SetState(State::run);
     return true;
@@ -85,7 +92,7 @@ bool PlayerActor::CheckRun(const GamePad& gamepad)
 bool PlayerActor::CheckAttack(const GamePad& gamepad)
 {
   if (gamepad.buttonDown & GamePad::A) {
-    GetMesh()->Play("Attack.Light", false);
+    GetMesh()->CrossFade("Attack.Light", animationFadeTime, false);
     stateTimer = GetMesh()->GetTotalAnimationTime();
     SetState(State::lightAttack);
     return true;
@@ -99,7 +106,7 @@ bool PlayerActor::CheckAttack(const GamePad& gamepad)
 bool PlayerActor::CheckGuard(const GamePad& gamepad)
 {
   if (gamepad.buttons & GamePad::X) {
-    GetMesh()->Play("Guard", false);
+    GetMesh()->CrossFade("Guard", animationFadeTime, false);
     stateTimer = GetMesh()->GetTotalAnimationTime();
     SetState(State::guard);
     return true;
@@ -116,7 +123,7 @@ bool PlayerActor::CheckJump(const GamePad& gamepad)
     static const float jumpVelocity = 5.0f;
     velocity.y = jumpVelocity;
     isInAir = true;
-    GetMesh()->Play("Jump");
+    GetMesh()->CrossFade("Jump", animationFadeTime);
     SetState(State::jump);
     return true;
   }
@@ -128,7 +135,7 @@ bool PlayerActor::CheckJump(const GamePad& gamepad)
 */
 bool PlayerActor::CheckFall(float deltaTime, float groundHeight)
 {
-  const bool isFloating = position.y > groundHeight + 0.1f; // nʂ畂Ă邩.
+  const bool isFloating = position.y > groundHeight + 0.1f; // 地面から浮いているか.
   if (!isInAir && isFloating && !bordingObject) {
     isInAir = true;
     return true;
@@ -172,7 +179,7 @@ void PlayerActor::ProcessInput()
   case State::fall:
     // A -> jumpAttack
     if (gamepad.buttonDown & GamePad::A) {
-      mesh->Play("Attack.Jump", false);
+      mesh->CrossFade("Attack.Jump", animationFadeTime, false);
       stateTimer = mesh->GetTotalAnimationTime();
       SetState(State::jumpAttack);
     }
@@ -194,7 +201,7 @@ void PlayerActor::ProcessInput()
     }
     // Release X -> idle;
     if (!(gamepad.buttons & GamePad::X)) {
-      mesh->Play("Idle");
+      mesh->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     }
     break;
@@ -213,10 +220,10 @@ void PlayerActor::ProcessInput()
 */
 void PlayerActor::Update(float deltaTime)
 {
-  // W̍XV.
+  // 座標の更新.
   SkeletalMeshActor::Update(deltaTime);
 
-  // ڒn.
+  // 接地判定.
   static const float gravity = 9.8f;
   const float groundHeight = heightMap->Height(position);
   if (position.y <= groundHeight) {
@@ -228,7 +235,7 @@ void PlayerActor::Update(float deltaTime)
     }
   }
 
-  // ̔.
+  // 物体判定.
   if (bordingObject) {
     Collision::Shape col = colWorld;
     col.s.r += 0.1f;
@@ -240,12 +247,12 @@ void PlayerActor::Update(float deltaTime)
 
   CheckFall(deltaTime, groundHeight);
 
-  // d.
+  // 重力.
   if (isInAir) {
     velocity.y -= gravity * deltaTime;
   }
 
-  // x̌.
+  // 速度の減衰.
   if (!isInAir) {
     if (glm::dot(velocity, velocity) <= FLT_EPSILON) {
       velocity = glm::vec3(0);
@@ -260,47 +267,47 @@ void PlayerActor::Update(float deltaTime)
     }
   }
 
-  // Ԃ̍XV.
+  // 状態の更新.
   switch (state) {
   case State::run:
     if (isInAir) {
-      GetMesh()->Play("Fall");
+      GetMesh()->CrossFade("Fall", animationFadeTime);
       SetState(State::fall);
     } else if ((velocity.x * velocity.x + velocity.z * velocity.z) < (1.0f * deltaTime * deltaTime)) {
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     }
     break;
   case State::idle:
     if (isInAir) {
-      GetMesh()->Play("Fall");
+      GetMesh()->CrossFade("Fall", animationFadeTime);
       SetState(State::fall);
     } else if ((velocity.x * velocity.x + velocity.z * velocity.z) >= (1.0f * deltaTime * deltaTime)) {
-      GetMesh()->Play("Run");
+      GetMesh()->CrossFade("Run", animationFadeTime);
       SetState(State::run);
     }
     break;
   case State::jump:
     if (!isInAir) {
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     } else if (velocity.y < 0) {
-      GetMesh()->Play("Fall");
+      GetMesh()->CrossFade("Fall", animationFadeTime);
       SetState(State::fall);
     }
     break;
   case State::fall:
     if (!isInAir) {
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     } else if (velocity.y >= 0) {
-      GetMesh()->Play("Jump");
+      GetMesh()->CrossFade("Jump", animationFadeTime);
       SetState(State::jump);
     }
     break;
   case State::guard:
     if (isInAir) {
-      GetMesh()->Play("Fall");
+      GetMesh()->CrossFade("Fall", animationFadeTime);
       SetState(State::fall);
     }
     break;
@@ -321,31 +328,31 @@ void PlayerActor::Update(float deltaTime)
     if (GetMesh()->IsFinished()) {
       stateTimer = 0;
       if (isInAir) {
-        GetMesh()->Play("Fall");
+        GetMesh()->CrossFade("Fall", animationFadeTime);
         SetState(State::fall);
       }
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
       ClearAttackCollision();
     }
     break;
   case State::jumpAttack:
     if (!isInAir) {
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     } else if (GetMesh()->IsFinished()) {
       if (position.y - gravity > 0) {
-        GetMesh()->Play("Jump");
+        GetMesh()->CrossFade("Jump", animationFadeTime);
         SetState(State::jump);
       } else {
-        GetMesh()->Play("Fall");
+        GetMesh()->CrossFade("Fall", animationFadeTime);
         SetState(State::fall);
       }
     }
     break;
   case State::damage:
     if (GetMesh()->IsFinished()) {
-      GetMesh()->Play("Idle");
+      GetMesh()->CrossFade("Idle", animationFadeTime);
       SetState(State::idle);
     }
     break;
@@ -385,7 +392,7 @@ void PlayerActor::Draw()
 */
 void PlayerActor::OnHit(const ActorPtr& other, const glm::vec3& p)
 {
-  // vC[ƏQ̏Փ˂.
+  // プレイヤーと障害物の衝突を解決する.
   const glm::vec3 v = colWorld.s.center - p;
   if (dot(v, v) > FLT_EPSILON) {
     const glm::vec3 vn = normalize(v);
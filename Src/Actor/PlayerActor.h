@@ -8,7 +8,7 @@
 #include "../Terrain.h"
 
 /**
-* vC[삷AN^[.
+* プレイヤーが操作するアクター.
 */
 class PlayerActor : public SkeletalMeshActor
 {
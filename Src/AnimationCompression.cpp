@@ -0,0 +1,377 @@
+/**
+* @file AnimationCompression.cpp
+*/
+#define NOMINMAX
+#include "AnimationCompression.h"
+#include "SkeletalMesh.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Mesh {
+
+namespace /* unnamed */ {
+
+// smallest three形式で格納する成分の範囲は[-1/√2, 1/√2].
+const float rotationRange = 0.70710678f;
+const float rotationQuantizeScale = 32767.0f / (rotationRange * 2.0f);
+const float rotationDequantizeScale = (rotationRange * 2.0f) / 32767.0f;
+
+/**
+* 誤差が許容範囲に収まるようにキーを削減する.
+*
+* @param keys     削減するキーの配列.
+* @param maxError 許容誤差.
+* @param lerp     2つの値を補間する関数.
+* @param error    2つの値の誤差を求める関数.
+*
+* @return 削減したキーの配列.
+*
+* 残したキーの間にある全てのキーが、残したキーからの補間で許容誤差内に再現できるようにする.
+*/
+template<typename T, typename Lerp, typename Error>
+std::vector<KeyFrame<T>> ReduceKeys(const std::vector<KeyFrame<T>>& keys, float maxError, Lerp lerp, Error error)
+{
+  if (keys.size() <= 2) {
+    return keys;
+  }
+  std::vector<KeyFrame<T>> result;
+  result.reserve(keys.size());
+  result.push_back(keys.front());
+  size_t start = 0;
+  for (size_t i = 2; i < keys.size(); ++i) {
+    // startとiの間のキーを、startとiの補間で再現できなければi-1を残す.
+    const float span = keys[i].frame - keys[start].frame;
+    for (size_t j = start + 1; j < i; ++j) {
+      const float t = span > 0 ? (keys[j].frame - keys[start].frame) / span : 0.0f;
+      if (error(lerp(keys[start].value, keys[i].value, t), keys[j].value) > maxError) {
+        start = i - 1;
+        result.push_back(keys[start]);
+        break;
+      }
+    }
+  }
+  result.push_back(keys.back());
+
+  // 値が変化しないタイムラインはキー1つで足りる.
+  if (result.size() == 2 && error(result[0].value, result[1].value) <= maxError) {
+    result.pop_back();
+  }
+  return result;
+}
+
+/**
+* 時刻を量子化する.
+*/
+uint16_t QuantizeTime(float frame, float timeScale)
+{
+  return static_cast<uint16_t>(glm::clamp(std::lround(frame / timeScale), 0L, 65535L));
+}
+
+/**
+* ベクトルのタイムラインを圧縮する.
+*
+* @param src      圧縮するタイムライン.
+* @param maxError キー削減の許容誤差.
+* @param keys     圧縮したキーを追加する配列.
+*
+* @return 圧縮したタイムライン.
+*/
+CompressedTimeline CompressTimeline(const Timeline<glm::aligned_vec3>& src, float maxError, CompressedKeys& keys)
+{
+  const std::vector<KeyFrame<glm::aligned_vec3>> reduced = ReduceKeys(src.timeline, maxError,
+    [](const glm::aligned_vec3& a, const glm::aligned_vec3& b, float t) { return glm::mix(a, b, t); },
+    [](const glm::aligned_vec3& a, const glm::aligned_vec3& b) { return glm::length(a - b); });
+
+  CompressedTimeline dst;
+  dst.targetNodeId = src.targetNodeId;
+  dst.firstKey = static_cast<uint32_t>(keys.times.size());
+  dst.keyCount = static_cast<uint32_t>(reduced.size());
+
+  glm::vec3 minValue(FLT_MAX);
+  glm::vec3 maxValue(-FLT_MAX);
+  for (const auto& e : reduced) {
+    minValue = glm::min(minValue, glm::vec3(e.value));
+    maxValue = glm::max(maxValue, glm::vec3(e.value));
+  }
+  dst.offset = minValue;
+  dst.scale = (maxValue - minValue) / 65535.0f;
+
+  for (const auto& e : reduced) {
+    keys.times.push_back(QuantizeTime(e.frame, keys.timeScale));
+    PackedKey key;
+    for (int i = 0; i < 3; ++i) {
+      const float f = dst.scale[i] > 0 ? (e.value[i] - dst.offset[i]) / dst.scale[i] : 0.0f;
+      key.v[i] = static_cast<uint16_t>(glm::clamp(std::lround(f), 0L, 65535L));
+    }
+    keys.values.push_back(key);
+  }
+  return dst;
+}
+
+/**
+* 回転のタイムラインを圧縮する.
+*
+* @param src      圧縮するタイムライン.
+* @param maxError キー削減の許容誤差(ラジアン).
+* @param keys     圧縮したキーを追加する配列.
+*
+* @return 圧縮したタイムライン.
+*/
+CompressedTimeline CompressTimeline(const Timeline<glm::aligned_quat>& src, float maxError, CompressedKeys& keys)
+{
+  const std::vector<KeyFrame<glm::aligned_quat>> reduced = ReduceKeys(src.timeline, maxError,
+    [](const glm::aligned_quat& a, const glm::aligned_quat& b, float t) { return glm::slerp(a, b, t); },
+    [](const glm::aligned_quat& a, const glm::aligned_quat& b) {
+      // acosは1付近の精度が低いので、差の長さから角度を求める.
+      const glm::vec4 va(a.x, a.y, a.z, a.w);
+      const glm::vec4 vb(b.x, b.y, b.z, b.w);
+      const float d = glm::length(glm::dot(va, vb) < 0 ? va + vb : va - vb);
+      return 4.0f * std::asin(std::min(1.0f, d * 0.5f));
+    });
+
+  CompressedTimeline dst;
+  dst.targetNodeId = src.targetNodeId;
+  dst.firstKey = static_cast<uint32_t>(keys.times.size());
+  dst.keyCount = static_cast<uint32_t>(reduced.size());
+  for (const auto& e : reduced) {
+    keys.times.push_back(QuantizeTime(e.frame, keys.timeScale));
+    keys.values.push_back(PackRotation(glm::quat(e.value.w, e.value.x, e.value.y, e.value.z)));
+  }
+  return dst;
+}
+
+/**
+* 圧縮前のタイムラインのバイト数を求める.
+*/
+template<typename T>
+size_t ByteSize(const std::vector<Timeline<T>>& list, size_t& keyCount)
+{
+  size_t size = list.size() * sizeof(Timeline<T>);
+  for (const auto& e : list) {
+    size += e.timeline.size() * sizeof(KeyFrame<T>);
+    keyCount += e.timeline.size();
+  }
+  return size;
+}
+
+/**
+* 指定時刻を挟む2つのキーを探す.
+*
+* @param keys     キーの配列.
+* @param timeline タイムライン.
+* @param frame    時刻.
+* @param i0       前のキーの位置を格納する変数.
+* @param i1       後のキーの位置を格納する変数.
+*
+* @return i0からi1への補間係数.
+*/
+float FindKeys(const CompressedKeys& keys, const CompressedTimeline& timeline, float frame, size_t& i0, size_t& i1)
+{
+  const uint16_t* first = keys.times.data() + timeline.firstKey;
+  const uint16_t* last = first + timeline.keyCount;
+  const float t = frame / keys.timeScale;
+  const uint16_t* p = std::lower_bound(first, last, t, [](uint16_t key, float t) { return key < t; });
+  if (p == first) {
+    i0 = i1 = timeline.firstKey;
+    return 0;
+  }
+  if (p == last) {
+    i0 = i1 = timeline.firstKey + timeline.keyCount - 1;
+    return 0;
+  }
+  i1 = p - keys.times.data();
+  i0 = i1 - 1;
+  const float span = static_cast<float>(p[0] - p[-1]);
+  return span > 0 ? glm::clamp((t - p[-1]) / span, 0.0f, 1.0f) : 1.0f;
+}
+
+/**
+* 16ビット整数3つを浮動小数点数に変換する.
+*/
+__m128 LoadKey(const PackedKey& key, int mask)
+{
+  return _mm_cvtepi32_ps(_mm_setr_epi32(key.v[0] & mask, key.v[1] & mask, key.v[2] & mask, 0));
+}
+
+} // unnamed namespace
+
+/**
+* 統計情報を加算する.
+*/
+AnimationCompressionStatistics& AnimationCompressionStatistics::operator+=(const AnimationCompressionStatistics& rhs)
+{
+  keyCountBefore += rhs.keyCountBefore;
+  keyCountAfter += rhs.keyCountAfter;
+  byteSizeBefore += rhs.byteSizeBefore;
+  byteSizeAfter += rhs.byteSizeAfter;
+  return *this;
+}
+
+/**
+* アニメーションを圧縮する.
+*
+* @param src   圧縮前のアニメーション.
+* @param param キー削減の許容誤差.
+* @param dst   圧縮したタイムラインとキーを格納するアニメーション.
+* @param stats 圧縮の統計情報を加算する変数.
+*
+* 許容誤差内に収まるようにキーを削減してから、回転を48ビット、ベクトルを48ビット、時刻を16ビットに量子化する.
+*/
+void CompressAnimation(const RawAnimation& src, const AnimationCompressionParameter& param,
+  Animation& dst, AnimationCompressionStatistics& stats)
+{
+  // 時刻の量子化範囲はアニメーション全体で共通にする.
+  float maxTime = 0;
+  for (const auto& e : src.translationList) {
+    for (const auto& key : e.timeline) { maxTime = std::max(maxTime, key.frame); }
+  }
+  for (const auto& e : src.rotationList) {
+    for (const auto& key : e.timeline) { maxTime = std::max(maxTime, key.frame); }
+  }
+  for (const auto& e : src.scaleList) {
+    for (const auto& key : e.timeline) { maxTime = std::max(maxTime, key.frame); }
+  }
+  dst.keys.timeScale = maxTime > 0 ? maxTime / 65535.0f : 1.0f;
+  dst.keys.times.clear();
+  dst.keys.values.clear();
+
+  for (const auto& e : src.translationList) {
+    if (!e.timeline.empty()) {
+      dst.translationList.push_back(CompressTimeline(e, param.translationError, dst.keys));
+    }
+  }
+  for (const auto& e : src.rotationList) {
+    if (!e.timeline.empty()) {
+      dst.rotationList.push_back(CompressTimeline(e, param.rotationError, dst.keys));
+    }
+  }
+  for (const auto& e : src.scaleList) {
+    if (!e.timeline.empty()) {
+      dst.scaleList.push_back(CompressTimeline(e, param.scaleError, dst.keys));
+    }
+  }
+  dst.keys.times.shrink_to_fit();
+  dst.keys.values.shrink_to_fit();
+
+  AnimationCompressionStatistics s;
+  s.byteSizeBefore = ByteSize(src.translationList, s.keyCountBefore) +
+    ByteSize(src.rotationList, s.keyCountBefore) + ByteSize(src.scaleList, s.keyCountBefore);
+  s.keyCountAfter = dst.keys.times.size();
+  s.byteSizeAfter = dst.keys.times.size() * sizeof(uint16_t) + dst.keys.values.size() * sizeof(PackedKey) +
+    (dst.translationList.size() + dst.rotationList.size() + dst.scaleList.size()) * sizeof(CompressedTimeline);
+  stats += s;
+}
+
+/**
+* 回転を48ビットに量子化する.
+*
+* @param q 量子化する回転.
+*
+* @return 量子化した回転.
+*/
+PackedKey PackRotation(const glm::quat& q)
+{
+  const glm::quat n = glm::normalize(q);
+  const float c[4] = { n.x, n.y, n.z, n.w };
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::abs(c[i]) > std::abs(c[largest])) {
+      largest = i;
+    }
+  }
+  // qと-qは同じ回転なので、最大の成分が正になるほうを格納する.
+  const float sign = c[largest] < 0 ? -1.0f : 1.0f;
+  PackedKey key;
+  for (int i = 0, j = 0; i < 4; ++i) {
+    if (i != largest) {
+      const float f = (glm::clamp(c[i] * sign, -rotationRange, rotationRange) + rotationRange) * rotationQuantizeScale;
+      key.v[j++] = static_cast<uint16_t>(std::lround(f));
+    }
+  }
+  key.v[0] |= static_cast<uint16_t>((largest & 1) << 15);
+  key.v[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+  return key;
+}
+
+/**
+* 48ビットに量子化した回転を復元する.
+*
+* @param key 量子化した回転.
+*
+* @return 復元した回転.
+*/
+glm::quat UnpackRotation(const PackedKey& key)
+{
+  const int largest = (key.v[0] >> 15) | ((key.v[1] >> 15) << 1);
+  const __m128 scale = _mm_setr_ps(rotationDequantizeScale, rotationDequantizeScale, rotationDequantizeScale, 0);
+  const __m128 bias = _mm_setr_ps(-rotationRange, -rotationRange, -rotationRange, 0);
+  const __m128 abc = _mm_add_ps(_mm_mul_ps(LoadKey(key, 0x7fff), scale), bias); // [a, b, c, 0]
+
+  // 残りの成分は単位クォータニオンの条件から求める.
+  __m128 sq = _mm_mul_ps(abc, abc);
+  sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+  sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 0, 3, 2)));
+  const __m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), sq), _mm_setzero_ps()));
+  const __m128 maskW = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+  __m128 q = _mm_or_ps(abc, _mm_and_ps(d, maskW)); // [a, b, c, d]
+
+  // 除いた成分の位置にdを移動する.
+  switch (largest) {
+  case 0: q = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 0, 3)); break;
+  case 1: q = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 3, 0)); break;
+  case 2: q = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 1, 0)); break;
+  default: break;
+  }
+  float xyzw[4];
+  _mm_storeu_ps(xyzw, q);
+  return glm::quat(xyzw[3], xyzw[0], xyzw[1], xyzw[2]);
+}
+
+/**
+* 圧縮したタイムラインからベクトルを補間して取得する.
+*
+* @param keys     キーの配列.
+* @param timeline タイムライン.
+* @param frame    時刻.
+*
+* @return 補間したベクトル.
+*/
+glm::vec3 SampleVector(const CompressedKeys& keys, const CompressedTimeline& timeline, float frame)
+{
+  size_t i0, i1;
+  const float ratio = FindKeys(keys, timeline, frame, i0, i1);
+
+  // 量子化したまま補間してから、範囲を戻す.
+  const __m128 a = LoadKey(keys.values[i0], 0xffff);
+  const __m128 b = LoadKey(keys.values[i1], 0xffff);
+  const __m128 f = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(ratio)));
+  const __m128 scale = _mm_setr_ps(timeline.scale.x, timeline.scale.y, timeline.scale.z, 0);
+  const __m128 offset = _mm_setr_ps(timeline.offset.x, timeline.offset.y, timeline.offset.z, 0);
+  float v[4];
+  _mm_storeu_ps(v, _mm_add_ps(_mm_mul_ps(f, scale), offset));
+  return glm::vec3(v[0], v[1], v[2]);
+}
+
+/**
+* 圧縮したタイムラインから回転を補間して取得する.
+*
+* @param keys     キーの配列.
+* @param timeline タイムライン.
+* @param frame    時刻.
+*
+* @return 補間した回転.
+*/
+glm::quat SampleRotation(const CompressedKeys& keys, const CompressedTimeline& timeline, float frame)
+{
+  size_t i0, i1;
+  const float ratio = FindKeys(keys, timeline, frame, i0, i1);
+  const glm::quat a = UnpackRotation(keys.values[i0]);
+  if (i0 == i1) {
+    return a;
+  }
+  return glm::slerp(a, UnpackRotation(keys.values[i1]), ratio);
+}
+
+} // namespace Mesh
@@ -0,0 +1,108 @@
+/**
+* @file AnimationCompression.h
+*/
+#ifndef ANIMATIONCOMPRESSION_H_INCLUDED
+#define ANIMATIONCOMPRESSION_H_INCLUDED
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace Mesh {
+
+struct Animation;
+
+// アニメーションのキーフレーム.
+template<typename T>
+struct KeyFrame {
+  float frame;
+  T value;
+};
+
+// アニメーションのタイムライン.
+template<typename T>
+struct Timeline {
+  int targetNodeId;
+  std::vector<KeyFrame<T>> timeline;
+};
+
+/**
+* 圧縮前のアニメーション.
+*
+* ファイルから読み込んだキーをそのまま保持する. 読み込み中だけ使う.
+*/
+struct RawAnimation {
+  std::vector<Timeline<glm::aligned_vec3>> translationList;
+  std::vector<Timeline<glm::aligned_quat>> rotationList;
+  std::vector<Timeline<glm::aligned_vec3>> scaleList;
+};
+
+/**
+* 48ビットに量子化したキーの値.
+*
+* 回転はsmallest three形式で、最大の成分を除く3成分を15ビットずつに量子化する.
+* 除いた成分の番号(2ビット)はv[0]とv[1]の最上位ビットに格納する.
+* ベクトルはタイムラインごとの範囲に対して各成分を16ビットに量子化する.
+*/
+struct PackedKey {
+  uint16_t v[3];
+};
+
+/**
+* 圧縮したタイムライン.
+*
+* キーの時刻と値は、アニメーションごとにまとめた配列(CompressedKeys)に連続して格納される.
+*/
+struct CompressedTimeline {
+  int targetNodeId = -1;
+  uint32_t firstKey = 0; ///< 最初のキーの、キー配列内の位置.
+  uint32_t keyCount = 0; ///< キーの数.
+  glm::vec3 offset = glm::vec3(0); ///< ベクトルの量子化範囲の最小値.
+  glm::vec3 scale = glm::vec3(0);  ///< ベクトルの量子化1段階あたりの大きさ.
+};
+
+/**
+* 圧縮したキーの配列.
+*
+* 時刻はアニメーションの長さに対して16ビットに量子化する.
+*/
+struct CompressedKeys {
+  float timeScale = 1;            ///< 時刻の量子化1段階あたりの秒数.
+  std::vector<uint16_t> times;    ///< 全タイムラインのキーの時刻.
+  std::vector<PackedKey> values;  ///< 全タイムラインのキーの値.
+};
+
+/**
+* キー削減の許容誤差.
+*
+* 削除したキーの値と、残したキーから補間した値の差がこの値を超えないようにキーを削減する.
+*/
+struct AnimationCompressionParameter {
+  float translationError = 0.0005f; ///< 平行移動の許容誤差.
+  float rotationError = 0.0005f;    ///< 回転の許容誤差(ラジアン).
+  float scaleError = 0.0005f;       ///< 拡大率の許容誤差.
+};
+
+/**
+* 圧縮の統計情報.
+*/
+struct AnimationCompressionStatistics {
+  size_t keyCountBefore = 0; ///< 削減前のキーの数.
+  size_t keyCountAfter = 0;  ///< 削減後のキーの数.
+  size_t byteSizeBefore = 0; ///< 圧縮前のバイト数.
+  size_t byteSizeAfter = 0;  ///< 圧縮後のバイト数.
+
+  AnimationCompressionStatistics& operator+=(const AnimationCompressionStatistics&);
+};
+
+void CompressAnimation(const RawAnimation& src, const AnimationCompressionParameter& param,
+  Animation& dst, AnimationCompressionStatistics& stats);
+glm::vec3 SampleVector(const CompressedKeys& keys, const CompressedTimeline& timeline, float frame);
+glm::quat SampleRotation(const CompressedKeys& keys, const CompressedTimeline& timeline, float frame);
+PackedKey PackRotation(const glm::quat& q);
+glm::quat UnpackRotation(const PackedKey& key);
+
+} // namespace Mesh
+
+#endif // ANIMATIONCOMPRESSION_H_INCLUDED
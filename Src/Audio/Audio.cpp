@@ -25,7 +25,7 @@
 using Microsoft::WRL::ComPtr;
 
 /**
-* ֘ÃR[hi[閼O.
+* 音声関連のコードを格納する名前空間.
 */
 namespace Audio {
 
@@ -58,7 +58,7 @@ struct RIFFChunk
 };
 
 /**
-* WAVf[^.
+* WAVデータ.
 */
 struct WF
 {
@@ -107,7 +107,7 @@ uint32_t GetWaveFormatTag(const WAVEFORMATEXTENSIBLE& wf)
   return wf.SubFormat.Data1;
 }
 
-// tH[}bg擾
+// フォーマット情報を取得
 bool LoadWaveFile(HANDLE hFile, WF& wf, std::vector<UINT32>& seekTable, std::vector<uint8_t>* source)
 {
   RIFFChunk riffChunk;
@@ -158,7 +158,7 @@ bool LoadWaveFile(HANDLE hFile, WF& wf, std::vector<UINT32>& seekTable, std::vec
       case WAVE_FORMAT_WMAUDIO3:
         break;
       default:
-        // ̃R[hŃT|[gȂtH[}bg.
+        // このコードでサポートしないフォーマット.
         return false;
       }
       hasWaveFormat = true;
@@ -197,10 +197,10 @@ bool LoadWaveFile(HANDLE hFile, WF& wf, std::vector<UINT32>& seekTable, std::vec
 }
 
 /**
-* Sound̋.
+* Soundの空実装.
 *
-* I[fBIt@C̃pXAĐłȂtH[}bg肵
-* ꍇɁÃNX̃IuWFNgԂ.
+* オーディオファイルのパス名が無効だったり、再生できないフォーマットだったりした
+* 場合に、このクラスのオブジェクトが返される.
 */
 class NullSoundImpl : public Sound
 {
@@ -219,11 +219,11 @@ public:
 };
 
 /**
-* Sound̎.
+* Soundの実装.
 *
-* Xg[~OsȂI[fBINX.
-* SEɓKĂ.
-* Ή`: WAV, XWM.
+* ストリーミングを行わないオーディオクラス.
+* SEに適している.
+* 対応形式: WAV, XWM.
 */
 class SoundImpl : public Sound
 {
@@ -335,11 +335,11 @@ public:
 };
 
 /**
-* Sound̎.
+* Soundの実装.
 *
-* Xg[~OsI[fBINX.
-* BGMɓKĂ.
-* Ή`: WAV, XWM.
+* ストリーミングを行うオーディオクラス.
+* BGMに適している.
+* 対応形式: WAV, XWM.
 */
 class StreamSoundImpl : public Sound
 {
@@ -457,7 +457,7 @@ public:
       XAUDIO2_BUFFER_WMA bufWma = {};
       bufWma.PacketCount = static_cast<UINT32>(cbValid / packetSize);
       if (bufWma.PacketCount >= 0x100) {
-        std::cerr << "WARNING: PacketCountobt@TCYz." << std::endl;
+        std::cerr << "WARNING: PacketCountがバッファサイズを越えた." << std::endl;
       }
       bufWma.pDecodedPacketCumulativeBytes = buf[curBuf].seekTable;
       const UINT32* pSeekTable = seekTable.data() + (currentPos / packetSize);
@@ -504,11 +504,11 @@ public:
 };
 
 /**
-* Media Foundation𗘗pXg[TEh̎.
+* Media Foundationを利用したストリームサウンドの実装.
 *
-* Xg[~OsI[fBINX.
-* BGMɓKĂ.
-* Ή`: WAV, MP3, AAC, WMA.
+* ストリーミングを行うオーディオクラス.
+* BGMに適している.
+* 対応形式: WAV, MP3, AAC, WMA.
 */
 class MFStreamSoundImpl : public Sound
 {
@@ -614,7 +614,7 @@ public:
       curBuf = 0;
       currentPos = 0;
 
-      // ǂݍ݈ʒuZbg.
+      // 読み込み位置をリセット.
       PROPVARIANT value;
       value.vt = VT_I8;
       value.hVal.QuadPart = 0;
@@ -769,7 +769,7 @@ public:
 };
 
 /**
-* Engine̎.
+* Engineの実装.
 */
 class EngineImpl : public Engine, public std::enable_shared_from_this<EngineImpl>
 {
@@ -778,14 +778,14 @@ public:
 //  virtual ~EngineImpl() {}
 
   /**
-  * ĐGW.
+  * 音声再生エンジンを初期化する.
   *
-  * @retval true  .
-  * @retval false s.
+  * @retval true  初期化成功.
+  * @retval false 初期化失敗.
   */
   virtual bool Initialize() override {
     if (xaudio) {
-      std::cerr << "WARNING: Audio::Engine͏ς݂ł." << std::endl;
+      std::cerr << "WARNING: Audio::Engineは初期化済みです." << std::endl;
       return true;
     }
     ComPtr<IXAudio2> tmpAudio;
@@ -795,7 +795,7 @@ public:
 #endif // NDEBUG
     HRESULT hr = XAudio2Create(&tmpAudio, flags);
     if (FAILED(hr)) {
-      std::cerr << "ERROR: XAudio2̍쐬Ɏs." << std::endl;
+      std::cerr << "ERROR: XAudio2の作成に失敗." << std::endl;
       return false;
     }
     if (1) {
@@ -807,18 +807,18 @@ public:
     }
     hr = tmpAudio->CreateMasteringVoice(&masteringVoice);
     if (FAILED(hr)) {
-      std::cerr << "ERROR: XAudio2̉ʐݒɎs." << std::endl;
+      std::cerr << "ERROR: XAudio2の音量設定に失敗." << std::endl;
       return false;
     }
 
     // Setup for Media foundation.
     mf = std::make_unique<MediaFoundationInitialize>();
     if (FAILED(MFCreateAttributes(attributes.GetAddressOf(), 1))) {
-      std::cerr << "ERROR: Media Foundation̑IuWFNg̍쐬Ɏs." << std::endl;
+      std::cerr << "ERROR: Media Foundationの属性オブジェクトの作成に失敗." << std::endl;
       return false;
     }
     if (FAILED(attributes->SetUINT32(MF_LOW_LATENCY, true))) {
-      std::cerr << "ERROR: Media FoundatioñCeV̐ݒɎs." << std::endl;
+      std::cerr << "ERROR: Media Foundationのレイテンシの設定に失敗." << std::endl;
       return false;
     }
     xaudio.Swap(std::move(tmpAudio));
@@ -827,7 +827,7 @@ public:
   }
 
   /**
-  * GWj.
+  * エンジンを破棄する.
   */
   virtual void Finalize() override {
     streamSound.reset();
@@ -836,14 +836,14 @@ public:
   }
 
   /**
-  * GW̏ԂXV.
+  * エンジンの状態を更新する.
   *
-  * IɌĂяoKv.
+  * 定期的に呼び出す必要がある.
   *
-  * @retval true  XV.
-  * @retval false XVs.
+  * @retval true  更新成功.
+  * @retval false 更新失敗.
   *
-  * @note ݂͏trueԂ.
+  * @note 現在は常にtrueを返す.
   */
   virtual bool Update() override {
     soundList.remove_if(
@@ -867,24 +867,24 @@ public:
   }
 
   /**
-  * (SJISp).
+  * 音声を準備する(SJIS文字列用).
   *
-  * @param filename t@C̃pX(SJIS).
+  * @param filename 音声ファイルのパス(SJIS文字列).
   *
-  * @return IuWFNgւ̃|C^.
+  * @return 音声オブジェクトへのポインタ.
   *
-  * VbgĐȂ玟̂悤ɒPlay()ĂяoƂł.
+  * ワンショット再生だけなら次のように直接Play()を呼び出すこともできる.
   * @code
-  * Audio::Engine::Instance().Prepare("t@CpX")->Play()
+  * Audio::Engine::Instance().Prepare("ファイルパス")->Play()
   * @endcode
   *
-  * ʉ̂悤ɉxĐ鉹A܂͒~̕Kv鉹̏ꍇA߂lϐɊi[Ă
-  * Kvȃ^C~OŊ֐Ă.
+  * 効果音のように何度も再生する音声、または停止の必要がある音声の場合、戻り値を変数に格納しておいて
+  * 必要なタイミングで関数を呼ぶ.
   * @code
-  * // A߂l̉IuWFNgϐseɊi[.
-  * Audio::SoundPtr se = Audio::Engine::Instance().Prepare("t@CpX");
-  * ```
-  * // ϐseɊi[IuWFNggčĐ.
+  * // 音声を準備し、戻り値の音声制御オブジェクトを変数seに格納.
+  * Audio::SoundPtr se = Audio::Engine::Instance().Prepare("ファイルパス");
+  * ～～～
+  * // 変数seに格納した音声制御オブジェクトを使って再生.
   * se->Play();
   * @endcode
   */
@@ -900,18 +900,18 @@ public:
         return p;
       }
     }
-    std::cerr << "ERROR: " << filename << "ǂݍ߂܂." << std::endl;
+    std::cerr << "ERROR: " << filename << "を読み込めません." << std::endl;
     return std::make_shared<NullSoundImpl>();
   }
 
   /**
-  * (UTF-16p).
+  * 音声を準備する(UTF-16文字列用).
   *
-  * @param filename t@C̃pX(UTF-16).
+  * @param filename 音声ファイルのパス(UTF-16文字列).
   *
-  * @return IuWFNgւ̃|C^.
+  * @return 音声オブジェクトへのポインタ.
   *
-  * ݂̂ƂÅ֐Media FoundationΉ̂߁AʏSJISłPreparegp邱.
+  * 現在のところ、この関数はMedia Foundation未対応のため、通常はSJIS文字列版のPrepareを使用すること.
   */
   virtual SoundPtr Prepare(const wchar_t* filename) override {
     ScopedHandle hFile = CreateFile2(filename, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
@@ -932,20 +932,20 @@ public:
   }
 
   /**
-  * Xg[~Os(UTF-16p).
+  * ストリーミングを行う音声を準備する(UTF-16文字列用).
   *
-  * @param filename t@C̃pX(UTF-16).
+  * @param filename 音声ファイルのパス(UTF-16文字列).
   *
-  * @return IuWFNgւ̃|C^.
+  * @return 音声オブジェクトへのポインタ.
   *
-  * ̊֐XAudio2ΉĂt@C`(WAVyXWM)̂ݍĐł.
-  * ȊÕt@C`(MP3, AAC, WMAȂ)PremareMFStreamgp邱.
+  * この関数はXAudio2が対応しているファイル形式(WAV及びXWM)のみ再生できる.
+  * それ以外のファイル形式(MP3, AAC, WMAなど)はPremareMFStreamを使用すること.
   *
-  * @note PrepareMFStreamXAudio2ɂΉĂ邽߁Aɂ̊֐gKv͂Ȃ.
+  * @note PrepareMFStreamはXAudio2にも対応しているため、現状特にこの関数を使う必要はない.
   *
-  * @note ʏ́Å֐ł͂ȂPrepare֐g.
+  * @note 通常は、この関数ではなくPrepare関数を使うこと.
   *
-  * @note ̊֐͌1̉ĐłȂ.
+  * @note この関数は現在1つの音声しか再生できない.
   */
   virtual SoundPtr PrepareStream(const wchar_t* filename) override {
     streamSound.reset(new StreamSoundImpl(CreateFile2(filename, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr)));
@@ -969,16 +969,16 @@ public:
   }
 
   /**
-  * Xg[~Os(UTF-16p).
+  * ストリーミングを行う音声を準備する(UTF-16文字列用).
   *
-  * @param filename t@C̃pX(UTF-16).
+  * @param filename 音声ファイルのパス(UTF-16文字列).
   *
-  * @return IuWFNgւ̃|C^.
+  * @return 音声オブジェクトへのポインタ.
   *
-  * WindowsMedia Foundation𗘗pAACMP3Ȃǂ̍Đ\ɂĂ.
-  * PrepareStreamƂ͈قȂA̓ĐsƂł.
+  * WindowsのMedia Foundationを利用してAACやMP3などの再生を可能にしている.
+  * PrepareStreamとは異なり、複数音声の同時再生を行うことができる.
   *
-  * @note ʏ́Å֐ł͂ȂPrepare֐g.
+  * @note 通常は、この関数ではなくPrepare関数を使うこと.
   */
   virtual SoundPtr PrepareMFStream(const wchar_t* filename) override {
     std::shared_ptr<MFStreamSoundImpl> mfs = std::make_shared<MFStreamSoundImpl>();
@@ -991,9 +991,9 @@ public:
   }
 
   /**
-  * }X^[{[ݒ肷.
+  * マスターボリュームを設定する.
   *
-  * @param vol ݒ肷鉹.
+  * @param vol 設定する音量.
   */
   virtual void SetMasterVolume(float vol) override {
     if (xaudio) {
@@ -1002,9 +1002,9 @@ public:
   }
 
   /**
-  * }X^[{[擾.
+  * マスターボリュームを取得する.
   *
-  * @return ݒ肳Ă鉹.
+  * @return 設定されている音量.
   */
   virtual float GetMasterVolume() const override {
     if (xaudio) {
@@ -1032,9 +1032,9 @@ private:
 };
 
 /**
-* I[fBIGW̃VOgCX^X擾.
+* オーディオエンジンのシングルトンインスタンスを取得する.
 *
-* @return I[fBIGW̃VOgCX^Xւ̎Q.
+* @return オーディオエンジンのシングルトンインスタンスへの参照.
 */
 Engine& Engine::Instance()
 {
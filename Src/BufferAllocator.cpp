@@ -0,0 +1,280 @@
+/**
+* @file BufferAllocator.cpp
+*/
+#include "BufferAllocator.h"
+#include <algorithm>
+#include <iostream>
+
+/**
+* アロケータを初期化する.
+*
+* @param target    バッファオブジェクトの種類(GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFERなど).
+* @param pageSize  1ページのバイト数.
+* @param alignment 割り当て領域の整列サイズ.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*
+* 最初のページはこの時点で作成する.
+*/
+bool BufferAllocator::Init(GLenum target, GLsizeiptr pageSize, GLsizeiptr alignment)
+{
+  Destroy();
+  if (pageSize <= 0 || alignment <= 0) {
+    std::cerr << "[エラー]" << __func__ << ": ページサイズと整列サイズは1以上でなくてはなりません.\n";
+    return false;
+  }
+  this->target = target;
+  this->alignment = alignment;
+  this->pageSize = ((pageSize + alignment - 1) / alignment) * alignment;
+  return AddPage(this->pageSize) >= 0;
+}
+
+/**
+* 全てのページを破棄する.
+*/
+void BufferAllocator::Destroy()
+{
+  pages.clear();
+}
+
+/**
+* ページを追加する.
+*
+* @param minimumSize 追加するページの最低バイト数.
+*
+* @return 追加したページの番号. 追加に失敗した場合は-1.
+*
+* 解放済みのページ番号があれば、それを再利用する.
+*/
+int BufferAllocator::AddPage(GLsizeiptr minimumSize)
+{
+  const GLsizeiptr size = std::max(pageSize, minimumSize);
+  std::unique_ptr<BufferObject> buffer(new BufferObject);
+  if (!buffer->Create(target, size)) {
+    std::cerr << "[エラー]" << __func__ << ": " << size << "バイトのバッファを作成できません.\n";
+    return -1;
+  }
+
+  int pageNo = -1;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    if (!pages[i].buffer) {
+      pageNo = static_cast<int>(i);
+      break;
+    }
+  }
+  if (pageNo < 0) {
+    pageNo = static_cast<int>(pages.size());
+    pages.emplace_back();
+  }
+  Page& page = pages[pageNo];
+  page.buffer = std::move(buffer);
+  page.freeList.clear();
+  page.usedList.clear();
+  page.freeList.emplace(0, size);
+  return pageNo;
+}
+
+/**
+* 領域を割り当てる.
+*
+* @param size 割り当てるバイト数.
+* @param data 割り当てた領域に転送するデータ.
+*             nullptrの場合は転送しない.
+*
+* @return 割り当てた領域.
+*         割り当てに失敗した場合はIsNull()がtrueを返す.
+*
+* 全ページの空き領域から、要求を満たす最小のものを選択する(best fit).
+* 要求を満たす空き領域がなければ新しいページを追加する.
+*/
+BufferRange BufferAllocator::Allocate(GLsizeiptr size, const GLvoid* data)
+{
+  if (size <= 0) {
+    return {};
+  }
+  const GLsizeiptr alignedSize = ((size + alignment - 1) / alignment) * alignment;
+
+  int pageNo = -1;
+  GLintptr offset = 0;
+  GLsizeiptr blockSize = 0;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    for (const auto& e : pages[i].freeList) {
+      if (e.second >= alignedSize && (pageNo < 0 || e.second < blockSize)) {
+        pageNo = static_cast<int>(i);
+        offset = e.first;
+        blockSize = e.second;
+      }
+    }
+  }
+  if (pageNo < 0) {
+    pageNo = AddPage(alignedSize);
+    if (pageNo < 0) {
+      return {};
+    }
+    offset = 0;
+    blockSize = pages[pageNo].buffer->Size();
+  }
+
+  Page& page = pages[pageNo];
+  page.freeList.erase(offset);
+  if (blockSize > alignedSize) {
+    page.freeList.emplace(offset + alignedSize, blockSize - alignedSize);
+  }
+  page.usedList.emplace(offset, alignedSize);
+  if (data) {
+    page.buffer->BufferSubData(offset, size, data);
+  }
+  return { pageNo, offset, alignedSize };
+}
+
+/**
+* 領域を解放する.
+*
+* @param range Allocate()で割り当てた領域.
+*
+* @retval true  解放成功.
+* @retval false rangeは割り当てられた領域ではない.
+*
+* 前後の空き領域と隣接している場合は1つの空き領域に結合する.
+*/
+bool BufferAllocator::Free(const BufferRange& range)
+{
+  if (range.IsNull()) {
+    return true;
+  }
+  if (range.page >= static_cast<int>(pages.size())) {
+    std::cerr << "[警告]" << __func__ << ": ページ番号" << range.page << "は存在しません.\n";
+    return false;
+  }
+  Page& page = pages[range.page];
+  const auto itrUsed = page.usedList.find(range.offset);
+  if (itrUsed == page.usedList.end()) {
+    std::cerr << "[警告]" << __func__ << ": ページ" << range.page << "のオフセット" <<
+      range.offset << "は割り当てられていません.\n";
+    return false;
+  }
+  GLintptr offset = itrUsed->first;
+  GLsizeiptr size = itrUsed->second;
+  page.usedList.erase(itrUsed);
+
+  // 後ろの空き領域と結合.
+  auto itrNext = page.freeList.find(offset + size);
+  if (itrNext != page.freeList.end()) {
+    size += itrNext->second;
+    page.freeList.erase(itrNext);
+  }
+  // 前の空き領域と結合.
+  auto itrPrev = page.freeList.lower_bound(offset);
+  if (itrPrev != page.freeList.begin()) {
+    --itrPrev;
+    if (itrPrev->first + itrPrev->second == offset) {
+      itrPrev->second += size;
+      return true;
+    }
+  }
+  page.freeList.emplace(offset, size);
+  return true;
+}
+
+/**
+* 断片化を解消する.
+*
+* @return 移動した領域のリスト.
+*         呼び出し側は、このリストに従って保持している領域のオフセットを更新し、
+*         対象ページを参照するVAOなどを作り直さなくてはならない.
+*
+* 空き領域が2つ以上あるか、末尾以外に空き領域があるページについて、使用中の領域を新しいバッファの先頭から詰めて
+* コピーし、古いバッファと置き換える. そのため、ページのバッファオブジェクトIDは変化する.
+* また、使用中の領域が残っていないページは解放する(ただし、最初のページは常に残しておく).
+*/
+std::vector<BufferAllocator::Relocation> BufferAllocator::Defragment()
+{
+  std::vector<Relocation> relocations;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    Page& page = pages[i];
+    if (!page.buffer) {
+      continue;
+    }
+    if (page.usedList.empty()) {
+      if (i > 0) {
+        page.buffer.reset();
+        page.freeList.clear();
+      }
+      continue;
+    }
+    const GLsizeiptr size = page.buffer->Size();
+    if (page.freeList.empty() ||
+      (page.freeList.size() == 1 && page.freeList.begin()->first + page.freeList.begin()->second == size)) {
+      continue; // 断片化していない.
+    }
+
+    std::unique_ptr<BufferObject> buffer(new BufferObject);
+    if (!buffer->Create(target, size)) {
+      std::cerr << "[警告]" << __func__ << ": ページ" << i << "の再配置用バッファを作成できません.\n";
+      continue;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, page.buffer->Id());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->Id());
+    std::map<GLintptr, GLsizeiptr> usedList;
+    GLintptr newOffset = 0;
+    for (const auto& e : page.usedList) {
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, e.first, newOffset, e.second);
+      relocations.push_back({ static_cast<int>(i), e.first, newOffset });
+      usedList.emplace(newOffset, e.second);
+      newOffset += e.second;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    page.buffer = std::move(buffer);
+    page.usedList.swap(usedList);
+    page.freeList.clear();
+    if (newOffset < size) {
+      page.freeList.emplace(newOffset, size - newOffset);
+    }
+  }
+  return relocations;
+}
+
+/**
+* 使用状況を取得する.
+*
+* @return 使用状況.
+*/
+BufferAllocator::Usage BufferAllocator::GetUsage() const
+{
+  Usage usage;
+  for (const Page& page : pages) {
+    if (!page.buffer) {
+      continue;
+    }
+    ++usage.pageCount;
+    usage.capacity += page.buffer->Size();
+    usage.allocationCount += page.usedList.size();
+    usage.freeBlockCount += page.freeList.size();
+    for (const auto& e : page.usedList) {
+      usage.used += e.second;
+    }
+    for (const auto& e : page.freeList) {
+      usage.largestFreeBlock = std::max(usage.largestFreeBlock, e.second);
+    }
+  }
+  return usage;
+}
+
+/**
+* ページのバッファオブジェクトIDを取得する.
+*
+* @param page ページ番号.
+*
+* @return pageに対応するバッファオブジェクトのID.
+*         ページが存在しない場合は0.
+*/
+GLuint BufferAllocator::Id(int page) const
+{
+  if (page < 0 || page >= static_cast<int>(pages.size()) || !pages[page].buffer) {
+    return 0;
+  }
+  return pages[page].buffer->Id();
+}
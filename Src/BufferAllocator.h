@@ -0,0 +1,86 @@
+/**
+* @file BufferAllocator.h
+*/
+#ifndef BUFFERALLOCATOR_H_INCLUDED
+#define BUFFERALLOCATOR_H_INCLUDED
+#include <GL/glew.h>
+#include "BufferObject.h"
+#include <vector>
+#include <map>
+#include <memory>
+
+/**
+* バッファオブジェクト内の割り当て領域.
+*/
+struct BufferRange
+{
+  int page = -1;        ///< 割り当て先のページ番号(-1なら未割り当て).
+  GLintptr offset = 0;  ///< ページ先頭からのバイトオフセット.
+  GLsizeiptr size = 0;  ///< 割り当てたバイト数.
+
+  bool IsNull() const { return page < 0; }
+};
+
+/**
+* バッファオブジェクトの部分割り当てを管理するクラス.
+*
+* 一定サイズの「ページ」単位でバッファオブジェクトを作成し、ページ内の空き領域をフリーリストで管理する.
+* 空き領域が足りなくなった時点でページを追加するので、初期化時に最大容量を確保しておく必要はない.
+*
+* ページ番号は割り当て領域が残っている限り変化しない.
+* 空になったページはDefragment()で解放され、その番号は次にページを追加するときに再利用される.
+*/
+class BufferAllocator
+{
+public:
+  // 使用状況.
+  struct Usage
+  {
+    size_t pageCount = 0;             ///< 確保済みのページ数.
+    GLsizeiptr capacity = 0;          ///< 全ページの合計バイト数.
+    GLsizeiptr used = 0;              ///< 割り当て済みのバイト数.
+    GLsizeiptr largestFreeBlock = 0;  ///< 最大の連続した空き領域のバイト数.
+    size_t allocationCount = 0;       ///< 割り当て済みの領域数.
+    size_t freeBlockCount = 0;        ///< 空き領域の数.
+  };
+
+  // Defragment()による再配置情報.
+  struct Relocation
+  {
+    int page;             ///< 再配置されたページ番号.
+    GLintptr oldOffset;   ///< 再配置前のオフセット.
+    GLintptr newOffset;   ///< 再配置後のオフセット.
+  };
+
+  BufferAllocator() = default;
+  ~BufferAllocator() = default;
+  BufferAllocator(const BufferAllocator&) = delete;
+  BufferAllocator& operator=(const BufferAllocator&) = delete;
+
+  bool Init(GLenum target, GLsizeiptr pageSize, GLsizeiptr alignment = 4);
+  void Destroy();
+  BufferRange Allocate(GLsizeiptr size, const GLvoid* data = nullptr);
+  bool Free(const BufferRange& range);
+  std::vector<Relocation> Defragment();
+  Usage GetUsage() const;
+  GLuint Id(int page) const;
+  size_t PageCount() const { return pages.size(); }
+
+private:
+  // ページ.
+  struct Page
+  {
+    std::unique_ptr<BufferObject> buffer;
+    std::map<GLintptr, GLsizeiptr> freeList; ///< 空き領域(オフセット, バイト数).
+    std::map<GLintptr, GLsizeiptr> usedList; ///< 使用中の領域(オフセット, バイト数).
+  };
+
+  int AddPage(GLsizeiptr minimumSize);
+
+  std::vector<Page> pages;
+  GLenum target = GL_ARRAY_BUFFER;
+  GLsizeiptr pageSize = 0;
+  GLsizeiptr alignment = 4;
+};
+
+#endif // BUFFERALLOCATOR_H_INCLUDED
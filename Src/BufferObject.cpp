@@ -2,54 +2,62 @@
 * @file BufferObject.cpp
 */
 #include "BufferObject.h"
+#include "GLState.h"
 #include <iostream>
 
 /**
-* obt@IuWFNg쐬.
+* バッファオブジェクトを作成する.
 *
-* @param target obt@IuWFNg̎.
-* @param size   _f[^̃TCY.
-* @param data   _f[^ւ̃|C^.
-* @param usage  obt@IuWFNg̃ANZX^Cv.
+* @param target バッファオブジェクトの種類.
+* @param size   頂点データのサイズ.
+* @param data   頂点データへのポインタ.
+* @param usage  バッファオブジェクトのアクセスタイプ.
 */
 bool BufferObject::Create(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
 {
   Destroy();
   glGenBuffers(1, &id);
-  glBindBuffer(target, id);
+  if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    GLState::BindVertexArray(0); // バインド中のVAOのインデックスバッファを上書きしないように.
+  }
+  GLState::BindBuffer(target, id);
   glBufferData(target, size, data, usage);
-  glBindBuffer(target, 0);
+  GLState::BindBuffer(target, 0);
   this->target = target;
   this->size = size;
   return glGetError() == GL_NO_ERROR;
 }
 
 /**
-* Buffer Objectj.
+* Buffer Objectを破棄する.
 */
 bool BufferObject::BufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data)
 {
   if (offset + size > this->size) {
-    std::cerr << "WARNING: ]̈悪obt@TCYzĂ܂.\n";
+    std::cerr << "WARNING: 転送先領域がバッファサイズを越えています.\n";
     std::cerr << "  buffer size:" << this->size << " offset:" << offset << " size:" << size << "\n";
     if (offset >= this->size) {
       return false;
     }
-    // \Ȕ͈͂]s.
+    // 可能な範囲だけ転送を行う.
     size = this->size - offset;
   }
-  glBindBuffer(target, id);
+  if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    GLState::BindVertexArray(0); // バインド中のVAOのインデックスバッファを上書きしないように.
+  }
+  GLState::BindBuffer(target, id);
   glBufferSubData(target, offset, size, data);
-  glBindBuffer(target, 0);
+  GLState::BindBuffer(target, 0);
   return glGetError() == GL_NO_ERROR;
 }
 
 /**
-* Buffer Objectj.
+* Buffer Objectを破棄する.
 */
 void BufferObject::Destroy()
 {
   if (id) {
+    GLState::ForgetBuffer(id);
     glDeleteBuffers(1, &id);
     id = 0;
   }
@@ -60,7 +68,10 @@ void BufferObject::Destroy()
 */
 void BufferObject::Bind() const
 {
-  glBindBuffer(target, id);
+  if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    GLState::BindVertexArray(0);
+  }
+  GLState::BindBuffer(target, id);
 }
 
 /**
@@ -68,36 +79,36 @@ void BufferObject::Bind() const
 */
 void BufferObject::Unbind() const
 {
-  glBindBuffer(target, 0);
+  GLState::BindBuffer(target, 0);
 }
 
 /**
-* VAO쐬.
+* VAOを作成する.
 *
-* @param vbo  _obt@IuWFNgID.
-* @param ibo  CfbNXobt@IuWFNgID.
+* @param vbo  頂点バッファオブジェクトのID.
+* @param ibo  インデックスバッファオブジェクトのID.
 */
 bool VertexArrayObject::Create(GLuint vbo, GLuint ibo)
 {
   Destroy();
   glGenVertexArrays(1, &id);
-  glBindVertexArray(id);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  GLState::BindVertexArray(id);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+  GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+  GLState::BindVertexArray(0);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
   vboId = vbo;
   iboId = ibo;
   return glGetError() == GL_NO_ERROR;
 }
 
 /**
-* VAOj.
+* VAOを破棄する.
 */
 void VertexArrayObject::Destroy()
 {
   if (id) {
+    GLState::ForgetVertexArray(id);
     glDeleteVertexArrays(1, &id);
     id = 0;
     vboId = 0;
@@ -105,42 +116,42 @@ void VertexArrayObject::Destroy()
 }
 
 /**
-* VAOOpenGLReLXgɃoCh.
+* VAOをOpenGLコンテキストにバインドする.
 *
-* `AVertexAttribPointer()AResetVertexAttribPointer()ĂяoOɁÅ֐sVAOoChKv.
+* 描画、VertexAttribPointer()、ResetVertexAttribPointer()を呼び出す前に、この関数を実行してVAOをバインドする必要がある.
 *
 * @sa Unbind(), VertexAttribPointer(), ResetVertexAttribPointer()
 */
 void VertexArrayObject::Bind() const
 {
-	glBindVertexArray(id);
-	glBindBuffer(GL_ARRAY_BUFFER, vboId);
+  GLState::BindVertexArray(id);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, vboId);
 }
 
 /**
-* OpenGLReLXgւ̃oCh.
+* OpenGLコンテキストへのバインドを解除する.
 *
-* `AVertexAttribPointer()AResetVertexAttribPointer()IÅ֐săoChȂ΂ȂȂ.
+* 描画、VertexAttribPointer()、ResetVertexAttribPointer()が終わったら、この関数を実行してバインドを解除しなければならない.
 *
 * @sa Bind(), VertexAttribPointer(), ResetVertexAttribPointer()
 */
 void VertexArrayObject::Unbind() const
 {
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  GLState::BindVertexArray(0);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 /**
-* _Agr[gݒ肷.
+* 頂点アトリビュートを設定する.
 *
-* @param index      _Agr[g̃CfbNX.
-* @param size       _Agr[g̗vf.
-* @param type       _Agr[ǧ^.
-* @param normalized GL_TRUE=vf𐳋K. GL_FALSE=KȂ.
-* @param stride     ̒_f[^܂ł̃oCg.
-* @param offset     _f[^擪̃oCgItZbg.
+* @param index      頂点アトリビュートのインデックス.
+* @param size       頂点アトリビュートの要素数.
+* @param type       頂点アトリビュートの型.
+* @param normalized GL_TRUE=要素を正規化する. GL_FALSE=正規化しない.
+* @param stride     次の頂点データまでのバイト数.
+* @param offset     頂点データ先頭からのバイトオフセット.
 *
-* Bind()ĂUnbind()܂ł̊ԂŌĂяo.
+* Bind()してからUnbind()するまでの間で呼び出すこと.
 *
 * @sa Bind(), Unbind(), ResetVertexAttribPointer()
 */
@@ -152,7 +163,7 @@ void VertexArrayObject::VertexAttribPointer(
 }
 
 /**
-* SĂ̒_Agr[g𖳌.
+* 全ての頂点アトリビュートを無効化する.
 *
 * @sa Bind(), Unbind(), VertexAttribPointer()
 */
@@ -4,18 +4,18 @@
 #include "Collision.h"
 
 /**
-* Փ˔i[閼O.
+* 衝突判定を格納する名前空間.
 *
-* AJvZAOBB.
+* 球、カプセル、OBBを扱う.
 *
-* -  vs 
-* -  vs JvZ
-* -  vs OBB
+* - 球 vs 球
+* - 球 vs カプセル
+* - 球 vs OBB
 */
 namespace Collision {
 
 /**
-* ƋՓ˂Ă邩ׂ.
+* 球と球が衝突しているか調べる.
 */
 bool TestSphereSphere(const Sphere& s0, const Sphere& s1)
 {
@@ -26,7 +26,7 @@ bool TestSphereSphere(const Sphere& s0, const Sphere& s1)
 }
 
 /**
-* Ɠ_̍ŋߐړ_𒲂ׂ.
+* 線分と点の最近接点を調べる.
 */
 glm::vec3 ClosestPointLine(const Segment& l, const glm::vec3& p)
 {
@@ -43,7 +43,7 @@ glm::vec3 ClosestPointLine(const Segment& l, const glm::vec3& p)
 }
 
 /**
-* ƃJvZՓ˂Ă邩ׂ.
+* 球とカプセルが衝突しているか調べる.
 */
 bool TestSphereCapsule(const Sphere& s, const Capsule& c, glm::vec3* p)
 {
@@ -54,7 +54,7 @@ bool TestSphereCapsule(const Sphere& s, const Capsule& c, glm::vec3* p)
 }
 
 /**
-* OBBƓ_̍ŋߐړ_𒲂ׂ.
+* OBBと点の最近接点を調べる.
 */
 glm::vec3 ClosestPointOBB(const OrientedBoundingBox& obb, const glm::vec3& p)
 {
@@ -73,7 +73,7 @@ glm::vec3 ClosestPointOBB(const OrientedBoundingBox& obb, const glm::vec3& p)
 }
 
 /**
-* OBBՓ˂Ă邩ׂ.
+* 球とOBBが衝突しているか調べる.
 */
 bool TestSphereOBB(const Sphere& s, const OrientedBoundingBox& obb, glm::vec3* p)
 {
@@ -83,12 +83,12 @@ bool TestSphereOBB(const Sphere& s, const OrientedBoundingBox& obb, glm::vec3* p
 }
 
 /**
-* `쐬.
+* 球形状を作成する.
 *
-* @param center ̒SW.
-* @param r      ̔a.
+* @param center 球の中心座標.
+* @param r      球の半径.
 *
-* @return ێėpՓˌ`IuWFNg.
+* @return 球を保持する汎用衝突形状オブジェクト.
 */
 Shape CreateSphere(const glm::vec3& center, float r) {
   Shape result;
@@ -98,13 +98,13 @@ Shape CreateSphere(const glm::vec3& center, float r) {
 }
 
 /**
-* JvZ`쐬.
+* カプセル形状を作成する.
 *
-* @param a  S̐̎n_W.
-* @param b  S̐̏I_W.
-* @param r  JvZ̔a.
+* @param a  中心の線分の始点座標.
+* @param b  中心の線分の終点座標.
+* @param r  カプセルの半径.
 *
-* @return JvZێėpՓˌ`IuWFNg.
+* @return カプセルを保持する汎用衝突形状オブジェクト.
 */
 Shape CreateCapsule(const glm::vec3& a, const glm::vec3& b, float r) {
   Shape result;
@@ -114,15 +114,15 @@ Shape CreateCapsule(const glm::vec3& a, const glm::vec3& b, float r) {
 }
 
 /**
-* LE{bNX`쐬.
+* 有向境界ボックス形状を作成する.
 *
-* @param center LE{bNX̒SW.
-* @param axisX  X̌.
-* @param axisY  Y̌.
-* @param axisZ  Ž.
-* @param e      XYZ̕.
+* @param center 有向境界ボックスの中心座標.
+* @param axisX  X軸の向き.
+* @param axisY  Y軸の向き.
+* @param axisZ  Z軸の向き.
+* @param e      XYZ軸方向の幅.
 *
-* @return LE{bNXێėpՓˌ`IuWFNg.
+* @return 有向境界ボックスを保持する汎用衝突形状オブジェクト.
 */
 Shape CreateOBB(const glm::vec3& center, const glm::vec3& axisX, const glm::vec3& axisY, const glm::vec3& axisZ, const glm::vec3& e) {
   Shape result;
@@ -132,14 +132,14 @@ Shape CreateOBB(const glm::vec3& center, const glm::vec3& axisX, const glm::vec3
 }
 
 /**
-* VFCvmՓ˂Ă邩ׂ.
+* シェイプ同士が衝突しているか調べる.
 *
-* @param a  Ώۂ̃VFCv̂P.
-* @param b  Ώۂ̃VFCv̂Q.
-* @param p  Փ˂W.
+* @param a  判定対象のシェイプその１.
+* @param b  判定対象のシェイプその２.
+* @param p  衝突した座標.
 *
-* @retval true  Փ˂.
-* @retval false Փ˂Ȃ.
+* @retval true  衝突した.
+* @retval false 衝突しなかった.
 */
 bool TestShapeShape(const Shape& a, const Shape& b, glm::vec3* p)
 {
@@ -166,7 +166,7 @@ bool TestShapeShape(const Shape& a, const Shape& b, glm::vec3* p)
 
 
 /**
-* ړ鋅ƋՓ˂Ă邩ׂ.
+* 移動する球と球が衝突しているか調べる.
 */
 bool TestMovingSphereSphere(const Sphere& s0, const Sphere& s1, const glm::vec3& v0, const glm::vec3& v1, float* t)
 {
@@ -212,19 +212,19 @@ bool FindIntersectionRaySphere(const Ray& r, const Sphere& s, float* t, glm::vec
   const float b = dot(m, r.direction);
   const float c = dot(m, m) - s.r * s.r;
 
-  // (c > 0)Ȃř_s̊Oɂ. (b > 0)Ȃrs痣ĂwĂ.
-  // L̗̏ꍇA͔Ȃ.
+  // (c > 0)ならばrの原点はsの外側にある. (b > 0)ならばrはsから離れていく方向を指している.
+  // 上記の両方の条件が満たされる場合、交差は発生しない.
   if (c > 0 && b > 0) {
     return false;
   }
 
-  // ʎ̏ꍇ͉Ȃ(Ȃ)
+  // 判別式が負の場合は解なし(＝交差しない)
   const float d = b * b - c;
   if (d < 0) {
     return false;
   }
 
-  // 
+  // 小さい方の
   *t = -b - std::sqrt(d);
   if (*t < 0) {
     *t = 0;
@@ -9,7 +9,7 @@
 namespace Collision {
 
 /**
-* .
+* 球.
 */
 struct Sphere {
   glm::vec3 center = glm::vec3(0);
@@ -17,7 +17,7 @@ struct Sphere {
 };
 
 /**
-* .
+* 線分.
 */
 struct Segment {
   glm::vec3 a = glm::vec3(0);
@@ -25,7 +25,7 @@ struct Segment {
 };
 
 /**
-* JvZ.
+* カプセル.
 */
 struct Capsule {
   Segment seg;
@@ -33,7 +33,7 @@ struct Capsule {
 };
 
 /**
-* LE{bNX.
+* 有向境界ボックス.
 */
 struct OrientedBoundingBox {
   glm::vec3 center = glm::vec3(0);
@@ -49,7 +49,7 @@ glm::vec3 ClosestPointLine(const Segment& l, const glm::vec3& p);
 glm::vec3 ClosestPointOBB(const OrientedBoundingBox& obb, const glm::vec3& p);
 
 /**
-* ėpՓˌ`.
+* 汎用衝突形状.
 */
 struct Shape
 {
@@ -0,0 +1,41 @@
+/**
+* @file CpuFeatures.cpp
+*/
+#include "CpuFeatures.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+/**
+* コンストラクタ.
+*
+* CPUID命令で、CPUとOSが対応している命令セットを調べる.
+*/
+CpuFeatures::CpuFeatures()
+{
+  int info[4];
+  __cpuid(info, 0);
+  const int maxLeaf = info[0];
+  __cpuid(info, 1);
+  ssse3 = (info[2] & (1 << 9)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  // AVXのレジスタをOSが保存してくれる場合だけAVX2とFMAを使う.
+  if (osxsave && avx && (_xgetbv(0) & 6) == 6) {
+    fma = (info[2] & (1 << 12)) != 0;
+    if (maxLeaf >= 7) {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+  }
+}
+
+/**
+* CPUがサポートする命令セットを取得する.
+*
+* @return CPUがサポートする命令セット. 最初の呼び出しで調べた結果を返す.
+*/
+const CpuFeatures& GetCpuFeatures()
+{
+  static const CpuFeatures features;
+  return features;
+}
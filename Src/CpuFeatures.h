@@ -0,0 +1,23 @@
+/**
+* @file CpuFeatures.h
+*/
+#ifndef CPUFEATURES_H_INCLUDED
+#define CPUFEATURES_H_INCLUDED
+
+/**
+* CPUがサポートする命令セット.
+*
+* SSE2は常に使える前提とし、それより新しい命令セットは実行時に調べてから使う.
+*/
+struct CpuFeatures
+{
+  bool ssse3 = false;
+  bool avx2 = false;
+  bool fma = false;
+
+  CpuFeatures();
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+#endif // CPUFEATURES_H_INCLUDED
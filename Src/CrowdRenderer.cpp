@@ -0,0 +1,341 @@
+/**
+* @file CrowdRenderer.cpp
+*/
+#include "CrowdRenderer.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+
+/**
+* デストラクタ.
+*/
+CrowdRenderer::~CrowdRenderer()
+{
+  Destroy();
+}
+
+/**
+* OpenGLオブジェクトと焼き付けたアニメーションを破棄する.
+*/
+void CrowdRenderer::Destroy()
+{
+  for (auto& e : entries) {
+    GLState::ForgetTexture(e.texAnimation);
+    glDeleteTextures(1, &e.texAnimation);
+  }
+  entries.clear();
+  GLState::ForgetTexture(texInstance);
+  glDeleteTextures(1, &texInstance);
+  texInstance = 0;
+  instanceBuffer.Destroy();
+}
+
+/**
+* 群衆描画クラスを初期化する.
+*
+* @param maxInstanceCount 1フレームに描画可能な最大インスタンス数.
+* @param sampleRate       アニメーションを焼き付ける1秒あたりのフレーム数.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool CrowdRenderer::Init(size_t maxInstanceCount, float sampleRate)
+{
+  Destroy();
+  if (maxInstanceCount <= 0 || sampleRate <= 0) {
+    std::cerr << "[エラー]" << __func__ << ": インスタンス数とサンプリングレートは0より大きくなくてはなりません.\n";
+    return false;
+  }
+  this->maxInstanceCount = maxInstanceCount;
+  this->sampleRate = sampleRate;
+
+  // インスタンスデータはリングバッファに書き込み、リングバッファ全体をテクスチャバッファとして読む.
+  // 描画ごとに先頭テクセルを指定するので、VAOにインスタンス用の頂点アトリビュートを追加する必要がない.
+  const size_t frameCount = 3;
+  GLint maxTexelCount = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexelCount);
+  const size_t texelCount = maxInstanceCount * frameCount * (sizeof(Instance) / sizeof(glm::vec4));
+  if (texelCount > static_cast<size_t>(maxTexelCount)) {
+    std::cerr << "[エラー]" << __func__ << ": インスタンス数" << maxInstanceCount <<
+      "はテクスチャバッファの最大サイズ(" << maxTexelCount << "テクセル)を超えます.\n";
+    return false;
+  }
+  if (!instanceBuffer.Init(GL_TEXTURE_BUFFER, sizeof(Instance) * maxInstanceCount, frameCount, sizeof(Instance))) {
+    return false;
+  }
+  glGenTextures(1, &texInstance);
+  GLState::BindTexture(0, GL_TEXTURE_BUFFER, texInstance);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, instanceBuffer.Id());
+  GLState::BindTexture(0, GL_TEXTURE_BUFFER, 0);
+
+  program = Shader::Cache::Instance().Create("Res/SkeletalMeshCrowd.vert", "Res/SkeletalMesh.frag");
+  if (!texInstance || program->IsNull()) {
+    Destroy();
+    return false;
+  }
+  locInstanceOffset = program->GetUniformLocation("instanceOffset");
+  program->Use();
+  program->SetUniformInt(program->GetUniformLocation("texColor"), 0);
+  program->SetUniformInt(program->GetUniformLocation("texAnimation"), 1);
+  program->SetUniformInt(program->GetUniformLocation("texInstance"), 2);
+  program->Unuse();
+
+  return glGetError() == GL_NO_ERROR;
+}
+
+/**
+* スケルタルメッシュのアニメーションを焼き付ける.
+*
+* @param mesh 焼き付けるメッシュ. スキンを持つノードであること.
+*
+* @retval true  焼き付け成功、または焼き付け済み.
+* @retval false 焼き付け失敗.
+*
+* ファイルが持つ全てのアニメーションを、Init()で指定したサンプリングレートで焼き付ける.
+* テクスチャの1行が1フレームで、関節1つあたり3テクセル(転置した行列の上3行)を使う.
+*/
+bool CrowdRenderer::Bake(const Mesh::SkeletalMesh& mesh)
+{
+  if (Find(mesh) >= 0) {
+    return true;
+  }
+  const Mesh::ExtendedFilePtr& file = mesh.GetFile();
+  const Mesh::Node* node = mesh.GetNode();
+  if (!file || !node || node->mesh < 0 || node->skin < 0) {
+    std::cerr << "[エラー]" << __func__ << ": スキンを持たないメッシュは焼き付けられません.\n";
+    return false;
+  }
+
+  const size_t jointCount = file->skins[node->skin].joints.size();
+  const GLsizei width = static_cast<GLsizei>(jointCount * 3);
+  Entry entry;
+  entry.file = file;
+  entry.node = node;
+  entry.clips.reserve(file->animations.size());
+  GLsizei height = 1; // 0行目はバインドポーズ.
+  for (const Mesh::Animation& e : file->animations) {
+    Clip clip;
+    clip.firstRow = height;
+    clip.frameCount = static_cast<GLint>(std::ceil(e.totalTime * sampleRate)) + 1;
+    clip.totalTime = e.totalTime;
+    entry.clips.push_back(clip);
+    height += clip.frameCount;
+  }
+  GLint maxTextureSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+  if (width <= 0 || width > maxTextureSize || height > maxTextureSize) {
+    std::cerr << "[エラー]" << __func__ << ": " << file->name << "の関節行列テクスチャの大きさ(" << width << "x" <<
+      height << ")が最大テクスチャサイズ(" << maxTextureSize << ")を超えています.\n";
+    return false;
+  }
+
+  std::vector<glm::vec4> pixels(static_cast<size_t>(width) * height);
+  std::vector<glm::aligned_mat4> matrices;
+  const auto writeRow = [&](GLsizei row) {
+    glm::vec4* p = &pixels[static_cast<size_t>(row) * width];
+    for (size_t i = 0; i < jointCount && i < matrices.size(); ++i) {
+      const glm::mat4 m = glm::transpose(matrices[i]);
+      p[i * 3 + 0] = m[0];
+      p[i * 3 + 1] = m[1];
+      p[i * 3 + 2] = m[2];
+    }
+  };
+  Mesh::CalculateJointMatrices(file, node, nullptr, 0, matrices);
+  writeRow(0);
+  for (size_t i = 0; i < entry.clips.size(); ++i) {
+    const Clip& clip = entry.clips[i];
+    for (GLint frame = 0; frame < clip.frameCount; ++frame) {
+      const float t = std::min(static_cast<float>(frame) / sampleRate, clip.totalTime);
+      Mesh::CalculateJointMatrices(file, node, &file->animations[i], t, matrices);
+      writeRow(clip.firstRow + frame);
+    }
+  }
+
+  glGenTextures(1, &entry.texAnimation);
+  GLState::BindTexture(0, GL_TEXTURE_2D, entry.texAnimation);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, pixels.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  const GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    std::cerr << "[エラー]" << __func__ << ": " << file->name << "の関節行列テクスチャを作成できません(0x" <<
+      std::hex << error << std::dec << ").\n";
+    glDeleteTextures(1, &entry.texAnimation);
+    return false;
+  }
+
+  std::cout << "[情報]" << __func__ << ": " << file->name << "を焼き付けました(関節=" << jointCount <<
+    " クリップ=" << entry.clips.size() << " " << width << "x" << height << ").\n";
+  entries.push_back(std::move(entry));
+  return true;
+}
+
+/**
+* 焼き付け済みのメッシュを検索する.
+*
+* @param mesh 検索するメッシュ.
+*
+* @return entriesのインデックス. 見つからなければ-1.
+*/
+int CrowdRenderer::Find(const Mesh::SkeletalMesh& mesh) const
+{
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].file == mesh.GetFile() && entries[i].node == mesh.GetNode()) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+/**
+* メッシュが焼き付け済みか調べる.
+*
+* @param mesh 調べるメッシュ.
+*
+* @retval true  焼き付け済み.
+* @retval false 焼き付けられていない.
+*/
+bool CrowdRenderer::HasBakedAnimation(const Mesh::SkeletalMesh& mesh) const
+{
+  return Find(mesh) >= 0;
+}
+
+/**
+* インスタンスデータの作成を開始する.
+*/
+void CrowdRenderer::BeginUpdate()
+{
+  for (auto& e : entries) {
+    e.instances.clear();
+  }
+  instanceCount = 0;
+}
+
+/**
+* インスタンスを追加する.
+*
+* @param mesh     描画するメッシュ. Bake()で焼き付け済みであること.
+* @param matModel モデル行列.
+* @param color    描画色.
+*
+* @retval true  追加成功.
+* @retval false 焼き付けられていないメッシュ、またはインスタンス数が上限に達している.
+*
+* 再生中のアニメーションと再生位置はmeshから取得する.
+*/
+bool CrowdRenderer::AddInstance(const Mesh::SkeletalMesh& mesh, const glm::mat4& matModel, const glm::vec4& color)
+{
+  if (instanceCount >= maxInstanceCount) {
+    return false;
+  }
+  const int index = Find(mesh);
+  if (index < 0) {
+    return false;
+  }
+  Entry& e = entries[index];
+
+  Instance instance;
+  const glm::mat4 m = glm::transpose(matModel);
+  instance.matModel[0] = m[0];
+  instance.matModel[1] = m[1];
+  instance.matModel[2] = m[2];
+  instance.color = color;
+  instance.animation = glm::vec4(0);
+  const Mesh::Animation* animation = mesh.GetAnimationData();
+  if (animation) {
+    const Clip& clip = e.clips[animation - &e.file->animations[0]];
+    const float frame = glm::clamp(mesh.GetPosition(), 0.0f, clip.totalTime) * sampleRate;
+    const GLint frame0 = std::min(static_cast<GLint>(frame), clip.frameCount - 1);
+    const GLint frame1 = std::min(frame0 + 1, clip.frameCount - 1);
+    instance.animation = glm::vec4(clip.firstRow + frame0, clip.firstRow + frame1, frame - frame0, 0);
+  }
+  e.instances.push_back(instance);
+  ++instanceCount;
+  return true;
+}
+
+/**
+* インスタンスデータの作成を終了する.
+*
+* インスタンスデータはリングバッファの次の区画に書き込む.
+*/
+void CrowdRenderer::EndUpdate()
+{
+  instanceBuffer.BeginFrame();
+  for (auto& e : entries) {
+    e.instanceCount = 0;
+    if (e.instances.empty()) {
+      continue;
+    }
+    const GLsizeiptr size = static_cast<GLsizeiptr>(e.instances.size() * sizeof(Instance));
+    GLintptr offset = 0;
+    void* p = instanceBuffer.Allocate(size, offset);
+    if (!p) {
+      continue;
+    }
+    memcpy(p, e.instances.data(), size);
+    e.instanceOffset = static_cast<GLint>(offset / sizeof(glm::vec4));
+    e.instanceCount = static_cast<GLsizei>(e.instances.size());
+  }
+  instanceBuffer.EndFrame();
+}
+
+/**
+* 全てのインスタンスを描画する.
+*
+* @param matVP ビュー・プロジェクション行列.
+*
+* LODは、メッシュごとに最も視点に近いインスタンスに合わせて選択する.
+*/
+void CrowdRenderer::Draw(const glm::mat4& matVP) const
+{
+  if (instanceCount <= 0) {
+    return;
+  }
+  program->Use();
+  program->SetViewProjectionMatrix(matVP);
+  GLState::BindTexture(2, GL_TEXTURE_BUFFER, texInstance);
+  for (const auto& e : entries) {
+    if (e.instanceCount <= 0) {
+      continue;
+    }
+    GLState::BindTexture(1, GL_TEXTURE_2D, e.texAnimation);
+    glUniform1i(locInstanceOffset, e.instanceOffset);
+
+    const Mesh::MeshData& meshData = e.file->meshes[e.node->mesh];
+    int lod = 0;
+    if (!meshData.lodDistances.empty()) {
+      lod = static_cast<int>(meshData.lodDistances.size());
+      for (const Instance& instance : e.instances) {
+        glm::mat4 m(1);
+        m[3] = glm::vec4(instance.matModel[0].w, instance.matModel[1].w, instance.matModel[2].w, 1);
+        lod = std::min(lod, Mesh::SelectLod(meshData, matVP, m));
+      }
+    }
+    for (const auto& prim : meshData.primitives) {
+      prim.vao->Bind();
+      if (!prim.hasColorAttribute) {
+        static const glm::vec4 color(1);
+        glVertexAttrib4fv(1, &color.x);
+      }
+      if (prim.material < e.file->materials.size()) {
+        const Mesh::Material& m = e.file->materials[prim.material];
+        if (m.texture) {
+          m.texture->Bind(0);
+        }
+      }
+      Mesh::DrawElementsInstanced(prim, lod, e.instanceCount);
+    }
+  }
+  GLState::BindTexture(2, GL_TEXTURE_BUFFER, 0);
+  GLState::BindTexture(1, GL_TEXTURE_2D, 0);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  GLState::UseProgram(0);
+  GLState::BindVertexArray(0);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
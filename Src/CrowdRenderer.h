@@ -0,0 +1,94 @@
+/**
+* @file CrowdRenderer.h
+*/
+#ifndef CROWDRENDERER_H_INCLUDED
+#define CROWDRENDERER_H_INCLUDED
+#include <GL/glew.h>
+#include "RingBuffer.h"
+#include "SkeletalMesh.h"
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+* 群衆用のスケルタルメッシュ描画クラス.
+*
+* アニメーションを一定間隔でサンプリングして関節行列のテクスチャに焼き付けておき、
+* 頂点シェーダがインスタンスごとの(クリップ, フレーム)からテクスチャを読んでスキニングする.
+* インスタンスごとにCPUで姿勢を計算する必要がなく、メッシュの種類ごとに1回のインスタンシング描画で済む.
+*
+* 使い方:
+* -# Init()で初期化.
+* -# Bake()で、群衆として描画したいスケルタルメッシュの全てのアニメーションを焼き付ける.
+*    これは読み込み時に1回だけ行えばよい.
+* -# 毎フレーム、BeginUpdate()のあとで、SkeletalMesh::Update()の代わりにSkeletalMesh::AdvanceFrame()で再生位置を進め、
+*    AddInstance()でインスタンスを追加し、EndUpdate()を呼ぶ.
+* -# Draw()で全てのインスタンスをインスタンシング描画する.
+*
+* スキンを持つノードだけが対象. 焼き付けた姿勢はフレーム間を線形補間する.
+*/
+class CrowdRenderer
+{
+public:
+  CrowdRenderer() = default;
+  ~CrowdRenderer();
+  CrowdRenderer(const CrowdRenderer&) = delete;
+  CrowdRenderer& operator=(const CrowdRenderer&) = delete;
+
+  bool Init(size_t maxInstanceCount, float sampleRate = 30.0f);
+  bool Bake(const Mesh::SkeletalMesh& mesh);
+  bool HasBakedAnimation(const Mesh::SkeletalMesh& mesh) const;
+
+  void BeginUpdate();
+  bool AddInstance(const Mesh::SkeletalMesh& mesh, const glm::mat4& matModel, const glm::vec4& color = glm::vec4(1));
+  void EndUpdate();
+  void Draw(const glm::mat4& matVP) const;
+
+  void Distance(float d) { distance = d; }
+  float Distance() const { return distance; }
+
+private:
+  void Destroy();
+  int Find(const Mesh::SkeletalMesh& mesh) const;
+
+  // インスタンスデータ. シェーダからはテクスチャバッファの5テクセルとして読む.
+  struct Instance
+  {
+    glm::vec4 matModel[3]; ///< 転置したモデル行列の上3行.
+    glm::vec4 color;       ///< 色.
+    glm::vec4 animation;   ///< x=フレーム0の行, y=フレーム1の行, z=補間係数.
+  };
+
+  // 焼き付けたクリップ.
+  struct Clip
+  {
+    GLint firstRow = 0;   ///< 最初のフレームの行番号.
+    GLint frameCount = 0; ///< フレーム数.
+    float totalTime = 0;  ///< クリップの長さ(秒).
+  };
+
+  // 焼き付け済みのメッシュ.
+  struct Entry
+  {
+    Mesh::ExtendedFilePtr file;    ///< メッシュを含むファイル.
+    const Mesh::Node* node;        ///< スキンを持つノード.
+    GLuint texAnimation = 0;       ///< 関節行列テクスチャ. 0行目はバインドポーズ.
+    std::vector<Clip> clips;       ///< ファイルのアニメーションと同じ順序のクリップ.
+    std::vector<Instance> instances;
+    GLint instanceOffset = 0;      ///< インスタンスバッファ内の先頭テクセル.
+    GLsizei instanceCount = 0;
+  };
+  std::vector<Entry> entries;
+
+  RingBuffer instanceBuffer;
+  GLuint texInstance = 0;
+  Shader::ProgramPtr program;
+  GLint locInstanceOffset = -1;
+  size_t maxInstanceCount = 0;
+  size_t instanceCount = 0;
+  float sampleRate = 30.0f;
+
+  float distance = 20.0f; ///< 群衆描画に切り替える距離.
+};
+
+#endif // CROWDRENDERER_H_INCLUDED
@@ -8,30 +8,32 @@
 #include <stdio.h>
 
 /**
-* tHg`@\i[閼O.
+* フォント描画機能を格納する名前空間.
 */
 namespace Font {
 
 /**
-* tHg`IuWFNg.
+* フォント描画オブジェクトを初期化する.
 *
-* @param maxChar   ő`敶.
+* @param maxChar   最大描画文字数.
 *
-* @retval true  .
-* @retval false s.
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
 */
 bool Renderer::Init(size_t maxChar)
 {
+  // 文字どうしは重ならないので、描画順を変えてもページごとにまとめて描画したほうがよい.
+  spriteRenderer.SortByTexture(true);
   return spriteRenderer.Init(maxChar, "Res/Font.vert", "Res/Font.frag");
 }
 
 /**
-* tHgt@Cǂݍ.
+* フォントファイルを読み込む.
 *
-* @param filename tHgt@C.
+* @param filename フォントファイル名.
 *
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
 */
 bool Renderer::LoadFromFile(const char* filename)
 {
@@ -46,7 +48,7 @@ bool Renderer::LoadFromFile(const char* filename)
     &baseFontSize, &padding[0], &padding[1], &padding[2], &padding[3],
     &spacing[0], &spacing[1]);
   if (ret < 7) {
-    std::cerr << "ERROR: " << filename << "̓ǂݍ݂Ɏs(line=" << line << ")\n";
+    std::cerr << "ERROR: " << filename << "の読み込みに失敗(line=" << line << ")\n";
     return false;
   }
   ++line;
@@ -55,12 +57,12 @@ bool Renderer::LoadFromFile(const char* filename)
   ret = fscanf(fp.get(), " common lineHeight=%f base=%f scaleW=%f scaleH=%f pages=%*d packed=%*d%*[^\n]",
     &lineHeight, &base, &scale.x, &scale.y);
   if (ret < 4) {
-    std::cerr << "ERROR: " << filename << "̓ǂݍ݂Ɏs(line=" << line << ")\n";
+    std::cerr << "ERROR: " << filename << "の読み込みに失敗(line=" << line << ")\n";
     return false;
   }
   ++line;
 
-  // ʒut@C̃pXo.
+  // 位置情報ファイルのパス部分を取り出す.
   std::string basePath = filename;
   const size_t lastSlashIndex = basePath.find_last_of('/', std::string::npos);
   if (lastSlashIndex == std::string::npos) {
@@ -81,14 +83,14 @@ bool Renderer::LoadFromFile(const char* filename)
     ++line;
   }
   if (texNameList.empty()) {
-    std::cerr << "ERROR: " << filename << "̓ǂݍ݂Ɏs(line=" << line << ")\n";
+    std::cerr << "ERROR: " << filename << "の読み込みに失敗(line=" << line << ")\n";
     return false;
   }
 
   int charCount;
   ret = fscanf(fp.get(), " chars count=%d", &charCount);
   if (ret < 1) {
-    std::cerr << "ERROR: " << filename << "̓ǂݍ݂Ɏs(line=" << line << ")\n";
+    std::cerr << "ERROR: " << filename << "の読み込みに失敗(line=" << line << ")\n";
     return false;
   }
   ++line;
@@ -101,10 +103,10 @@ bool Renderer::LoadFromFile(const char* filename)
     ret = fscanf(fp.get(), " char id=%d x=%f y=%f width=%f height=%f xoffset=%f yoffset=%f xadvance=%f page=%d chnl=%*d",
       &font.id, &font.uv.x, &font.uv.y, &font.size.x, &font.size.y, &font.offset.x, &font.offset.y, &font.xadvance, &font.page);
     if (ret < 9) {
-      std::cerr << "ERROR: " << filename << "̓ǂݍ݂Ɏs(line=" << line << ")\n";
+      std::cerr << "ERROR: " << filename << "の読み込みに失敗(line=" << line << ")\n";
       return false;
     }
-    // tHgt@C͍オ_Ȃ̂ŁAOpenGL̍Wn(_)ɕϊ.
+    // フォントファイルは左上が原点なので、OpenGLの座標系(左下が原点)に変換.
     font.uv.y = scale.y - font.uv.y - font.size.y;
     if (font.id >= 0 && font.id < static_cast<int>(fontList.size())) {
       fontList[font.id] = font;
@@ -115,11 +117,11 @@ bool Renderer::LoadFromFile(const char* filename)
     ++line;
   }
 
-  // eNX`ǂݍ.
+  // テクスチャを読み込む.
   texList.clear();
   texList.reserve(texNameList.size());
   for (const auto& e : texNameList) {
-    Texture::Image2DPtr tex = Texture::Image2D::Create(e.c_str());
+    Texture::Image2DPtr tex = Texture::Cache::Instance().Create(e.c_str());
     if (!tex) {
       return false;
     }
@@ -129,9 +131,9 @@ bool Renderer::LoadFromFile(const char* filename)
 }
 
 /**
-* Fݒ肷.
+* 文字色を設定する.
 *
-* @param cF.
+* @param c文字色.
 */
 void Renderer::Color(const glm::vec4& c)
 {
@@ -139,9 +141,9 @@ void Renderer::Color(const glm::vec4& c)
 }
 
 /**
-*F擾.
+*文字色を取得する.
 *
-* @returnF.
+* @return文字色.
 */
 const glm::vec4& Renderer::Color() const
 {
@@ -149,13 +151,13 @@ const glm::vec4& Renderer::Color() const
 }
 
 /**
-* ǉ.
+* 文字列を追加する.
 *
-* @param position \JnW.
-* @param str      ǉ镶.
+* @param position 表示開始座標.
+* @param str      追加する文字列.
 *
-* @retval true  ǉ.
-* @retval false ǉs.
+* @retval true  追加成功.
+* @retval false 追加失敗.
 */
 bool Renderer::AddString(const glm::vec2& position, const wchar_t* str)
 {
@@ -163,7 +165,7 @@ bool Renderer::AddString(const glm::vec2& position, const wchar_t* str)
   for (const wchar_t* itr = str; *itr; ++itr) {
     const FontInfo& font = fontList[*itr];
     if (font.id >= 0 && font.size.x && font.size.y) {
-      // XvCg̍W͉摜̒Sw肷邪AtHg͍w肷̂ŁA̍ł߂̕␳lvZ.
+      // スプライトの座標は画像の中心を指定するが、フォントは左上を指定するので、その差を打ち消すための補正値を計算する.
       const float baseX = font.size.x * 0.5f + font.offset.x;
       const float baseY = base - font.size.y * 0.5f - font.offset.y;
       glm::vec3 offsetedPos = glm::vec3(pos + glm::vec2(baseX, baseY) * scale, 0);
@@ -185,7 +187,7 @@ bool Renderer::AddString(const glm::vec2& position, const wchar_t* str)
 }
 
 /**
-* VBOVXeɃ}bsO.
+* VBOをシステムメモリにマッピングする.
 */
 void Renderer::BeginUpdate()
 {
@@ -193,7 +195,7 @@ void Renderer::BeginUpdate()
 }
 
 /**
-* VBÕ}bsO.
+* VBOのマッピングを解除する.
 */
 void Renderer::EndUpdate()
 {
@@ -201,7 +203,7 @@ void Renderer::EndUpdate()
 }
 
 /**
-* tHg`悷.
+* フォントを描画する.
 */
 void Renderer::Draw(const glm::vec2& ss) const
 {
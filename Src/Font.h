@@ -10,7 +10,7 @@
 namespace Font {
 
 /**
-* rbg}bvtHg`NX.
+* ビットマップフォント描画クラス.
 */
 class Renderer
 {
@@ -38,8 +38,8 @@ private:
   SpriteRenderer spriteRenderer;
   std::vector<Texture::Image2DPtr> texList;
 
-  glm::vec2 scale = glm::vec2(1); ///< tHg`悷Ƃ̊g嗦.
-  glm::vec4 color = glm::vec4(1); ///< tHg`悷Ƃ̐F.
+  glm::vec2 scale = glm::vec2(1); ///< フォントを描画するときの拡大率.
+  glm::vec4 color = glm::vec4(1); ///< フォントを描画するときの色.
   float baseFontSize = 32;
   bool propotional = true;
   float fixedAdvance = 0;
@@ -48,16 +48,16 @@ private:
   float lineHeight = 0;
   float base = 0;
 
-  /// tHg.
+  /// フォント情報.
   struct FontInfo {
-    int id = -1;        ///< R[h.
-    int page = 0;       ///< tHg܂܂摜̔ԍ.
-    glm::vec2 uv = glm::vec2(0); ///< tHg摜̃eNX`W.
-    glm::vec2 size = glm::vec2(0);     ///< tHg摜̕\TCY.
-    glm::vec2 offset = glm::vec2(0);   ///< \ʒu炷.
-    float xadvance = 0; ///< J[\i߂鋗.
+    int id = -1;        ///< 文字コード.
+    int page = 0;       ///< フォントが含まれる画像の番号.
+    glm::vec2 uv = glm::vec2(0); ///< フォント画像のテクスチャ座標.
+    glm::vec2 size = glm::vec2(0);     ///< フォント画像の表示サイズ.
+    glm::vec2 offset = glm::vec2(0);   ///< 表示位置をずらす距離.
+    float xadvance = 0; ///< カーソルを進める距離.
   };
-  std::vector<FontInfo> fontList; ///< tHgʒũXg.
+  std::vector<FontInfo> fontList; ///< フォント位置情報のリスト.
 };
 
 } // namespace Font
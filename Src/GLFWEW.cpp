@@ -5,11 +5,11 @@
 #include <iostream>
 #include <string>
 
-/// GLFWGLEWbv邽߂̖O.
+/// GLFWとGLEWをラップするための名前空間.
 namespace GLFWEW {
 
 /**
-* OpenGL̃G[񍐂.
+* OpenGLからのエラー報告を処理する.
 */
 void APIENTRY OutputGLDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, GLvoid *userParam)
 {
@@ -17,10 +17,10 @@ void APIENTRY OutputGLDebugMessage(GLenum source, GLenum type, GLuint id, GLenum
 }
 
 /**
-* GLFW̃G[񍐂.
+* GLFWからのエラー報告を処理する.
 *
-* @param error G[ԍ.
-* @param desc  G[̓e.
+* @param error エラー番号.
+* @param desc  エラーの内容.
 */
 void ErrorCallback(int error, const char* desc)
 {
@@ -28,9 +28,9 @@ void ErrorCallback(int error, const char* desc)
 }
 
 /**
-* VOgCX^X擾.
+* シングルトンインスタンスを取得する.
 *
-* @return Window̃VOgCX^X.
+* @return Windowのシングルトンインスタンス.
 */
 Window& Window::Instance()
 {
@@ -39,7 +39,7 @@ Window& Window::Instance()
 }
 
 /**
-* fXgN^.
+* デストラクタ.
 */
 Window::~Window()
 {
@@ -49,19 +49,19 @@ Window::~Window()
 }
 
 /**
-* GLFW/GLEW̏.
+* GLFW/GLEWの初期化.
 *
-* @param w EBhE̕`͈͂̕(sNZ).
-* @param h EBhE̕`͈͂̍(sNZ).
-* @param title EBhE^Cg(UTF-80I[).
+* @param w ウィンドウの描画範囲の幅(ピクセル).
+* @param h ウィンドウの描画範囲の高さ(ピクセル).
+* @param title ウィンドウタイトル(UTF-8の0終端文字列).
 *
-* @retval true .
-* @retval false s.
+* @retval true 初期化成功.
+* @retval false 初期化失敗.
 */
 bool Window::Init(int w, int h, const char* title)
 {
   if (isInitialized) {
-    std::cerr << "ERROR: GLFWEW͊ɏĂ܂." << std::endl;
+    std::cerr << "ERROR: GLFWEWは既に初期化されています." << std::endl;
     return false;
   }
   if (!isGLFWInitialized) {
@@ -81,7 +81,7 @@ bool Window::Init(int w, int h, const char* title)
   }
 
   if (glewInit() != GLEW_OK) {
-    std::cerr << "ERROR: GLEW̏Ɏs܂." << std::endl;
+    std::cerr << "ERROR: GLEWの初期化に失敗しました." << std::endl;
     return false;
   }
 
@@ -139,7 +139,7 @@ bool Window::Init(int w, int h, const char* title)
 */
 void Window::Update()
 {
-  // L[Ԃ̍XV.
+  // キー状態の更新.
   for (size_t i = 0; i < keyState.size(); ++i) {
     const bool pressed = glfwGetKey(window, i) == GLFW_PRESS;
     if (pressed) {
@@ -171,7 +171,7 @@ void Window::Update()
       fpsTickList.pop_front();
     }
     const double delta = t - fpsPrevTime;
-    if (delta < (120.0 / fps)) { // Ԋuꍇ͗OƂĊp.
+    if (delta < (120.0 / fps)) { // 間隔が長すぎる場合は例外として棄却.
       fpsTickList.push_back(delta);
       fpsTickSum += delta;
       fps = fpsTickList.size() / fpsTickSum;
@@ -190,12 +190,12 @@ void Window::ResetDeltaTime()
 }
 
 /**
-* L[ꂽuԂׂ.
+* キーが押された瞬間か調べる.
 *
-* @param key ׂL[ID(GLFW_KEY_AȂ).
+* @param key 調べるキーのID(GLFW_KEY_Aなど).
 *
-* @retval true  L[ꂽu.
-* @retval false L[ꂽuԂł͂Ȃ.
+* @retval true  キーが押された瞬間.
+* @retval false キーが押された瞬間ではない.
 */
 bool Window::KeyDown(int key) const
 {
@@ -206,12 +206,12 @@ bool Window::KeyDown(int key) const
 }
 
 /**
-* L[Ă邩ׂ.
+* キーが押されているか調べる.
 *
-* @param key ׂL[ID(GLFW_KEY_AȂ).
+* @param key 調べるキーのID(GLFW_KEY_Aなど).
 *
-* @retval true  L[Ă.
-* @retval false L[ĂȂ.
+* @retval true  キーが押されている.
+* @retval false キーが押されていない.
 */
 bool Window::KeyPressed(int key) const
 {
@@ -222,10 +222,10 @@ bool Window::KeyPressed(int key) const
 }
 
 /**
-* EBhEׂׂ.
+* ウィンドウを閉じるべきか調べる.
 *
-* @retval true .
-* @retval false Ȃ.
+* @retval true 閉じる.
+* @retval false 閉じない.
 */
 bool Window::ShouldClose() const
 {
@@ -233,7 +233,7 @@ bool Window::ShouldClose() const
 }
 
 /**
-* tgobt@ƃobNobt@؂ւ.
+* フロントバッファとバックバッファを切り替える.
 */
 void Window::SwapBuffers() const
 {
@@ -242,9 +242,9 @@ void Window::SwapBuffers() const
 }
 
 /**
-* }EX̍W擾.
+* マウスの座標を取得する.
 *
-* @return EBhE̍(0,0)Ƃ}EX̍W.
+* @return ウィンドウの左上隅を(0,0)としたマウスの座標.
 */
 glm::vec2 Window::MousePosition() const
 {
@@ -254,9 +254,9 @@ glm::vec2 Window::MousePosition() const
 }
 
 /**
-* }EXJ[\\ɂ.
+* マウスカーソルを非表示にする.
 *
-* J[\ړ́A擾\.
+* カーソル移動情報は、引き続き取得可能.
 */
 void Window::DisableMouseCursor()
 {
@@ -264,7 +264,7 @@ void Window::DisableMouseCursor()
 }
 
 /**
-* }EXJ[\\.
+* マウスカーソルを表示する.
 */
 void Window::EnableMouseCursor()
 {
@@ -272,42 +272,42 @@ void Window::EnableMouseCursor()
 }
 
 /**
-* WCXeBbÑAiO͑uID.
+* ジョイスティックのアナログ入力装置ID.
 +
-* @note XBOX360Rg[[.
+* @note XBOX360コントローラー基準.
 */
 enum JOYSTICK_AXES {
-  JOYSTICK_AXES_LEFT_X,  ///< XeBbNX.
-  JOYSTICK_AXES_LEFT_Y,  ///< XeBbNY.
-  JOYSTICK_AXES_TRIGGER, ///< AiOgK[.
-  JOYSTICK_AXES_RIGHT_Y, ///< EXeBbNY.
-  JOYSTICK_AXES_RIGHT_X, ///< EXeBbNX.
+  JOYSTICK_AXES_LEFT_X,  ///< 左スティックのX軸.
+  JOYSTICK_AXES_LEFT_Y,  ///< 左スティックのY軸.
+  JOYSTICK_AXES_TRIGGER, ///< アナログトリガー.
+  JOYSTICK_AXES_RIGHT_Y, ///< 右スティックのY軸.
+  JOYSTICK_AXES_RIGHT_X, ///< 右スティックのX軸.
 };
 
 /**
-* WCXeBbÑfW^͑uID.
+* ジョイスティックのデジタル入力装置ID.
 *
-* @note Xbox OneRg[[.
+* @note Xbox Oneコントローラー準拠.
 */
 enum JOYSTICK_BUTTON {
-  JOYSTICK_BUTTON_A, ///< A{^.
-  JOYSTICK_BUTTON_B, ///< B{^.
-  JOYSTICK_BUTTON_X, ///< X{^.
-  JOYSTICK_BUTTON_Y, ///< Y{^.
-  JOYSTICK_BUTTON_L, ///< L{^.
-  JOYSTICK_BUTTON_R, ///< R{^.
-  JOYSTICK_BUTTON_BACK, ///< Back{^.
-  JOYSTICK_BUTTON_START, ///< Start{^.
-  JOYSTICK_BUTTON_L_THUMB, ///< XeBbN{^.
-  JOYSTICK_BUTTON_R_THUMB, ///< EXeBbN{^.
-  JOYSTICK_BUTTON_UP, ///< L[.
-  JOYSTICK_BUTTON_RIGHT, ///< EL[.
-  JOYSTICK_BUTTON_DOWN, ///< L[.
-  JOYSTICK_BUTTON_LEFT, ///< L[.
+  JOYSTICK_BUTTON_A, ///< Aボタン.
+  JOYSTICK_BUTTON_B, ///< Bボタン.
+  JOYSTICK_BUTTON_X, ///< Xボタン.
+  JOYSTICK_BUTTON_Y, ///< Yボタン.
+  JOYSTICK_BUTTON_L, ///< Lボタン.
+  JOYSTICK_BUTTON_R, ///< Rボタン.
+  JOYSTICK_BUTTON_BACK, ///< Backボタン.
+  JOYSTICK_BUTTON_START, ///< Startボタン.
+  JOYSTICK_BUTTON_L_THUMB, ///< 左スティックボタン.
+  JOYSTICK_BUTTON_R_THUMB, ///< 右スティックボタン.
+  JOYSTICK_BUTTON_UP, ///< 上キー.
+  JOYSTICK_BUTTON_RIGHT, ///< 右キー.
+  JOYSTICK_BUTTON_DOWN, ///< 下キー.
+  JOYSTICK_BUTTON_LEFT, ///< 左キー.
 };
 
 /**
-* Q[pbh̏ԂXV.
+* ゲームパッドの状態を更新する.
 */
 void Window::UpdateGamePad()
 {
@@ -11,7 +11,7 @@
 #include <glm/vec2.hpp>
 
 /**
-* Q[pbh.
+* ゲームパッド情報.
 */
 struct GamePad
 {
@@ -27,14 +27,14 @@ struct GamePad
   static const uint32_t L = 0x0200;
   static const uint32_t R = 0x0400;
 
-  uint32_t buttons = 0; ///< Ă邠tO.
-  uint32_t buttonDown = 0; ///< ꂽuԂtO.
+  uint32_t buttons = 0; ///< 押されているあいだフラグが立つ.
+  uint32_t buttonDown = 0; ///< 押された瞬間だけフラグが立つ.
 }; 
 
 namespace GLFWEW {
 
 /**
-* GLFWGLEW̃bp[NX.
+* GLFWとGLEWのラッパークラス.
 */
 class Window
 {
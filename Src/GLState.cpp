@@ -0,0 +1,277 @@
+/**
+* @file GLState.cpp
+*/
+#include "GLState.h"
+
+namespace GLState {
+
+namespace /* unnamed */ {
+
+/// 状態が分からないことを示す値.
+const GLuint unknown = 0xffffffff;
+
+/// 記録するテクスチャユニットの数. これ以上のユニットは常にバインドを発行する.
+const GLuint maxTextureUnitCount = 16;
+
+/**
+* テクスチャのバインド対象を配列のインデックスに変換する.
+*
+* @param target バインド対象.
+*
+* @retval 0以上 インデックス.
+* @retval -1    記録しないバインド対象.
+*/
+int TargetIndex(GLenum target)
+{
+  switch (target) {
+  case GL_TEXTURE_2D: return 0;
+  case GL_TEXTURE_CUBE_MAP: return 1;
+  default: return -1;
+  }
+}
+
+/**
+* 記録しているOpenGLの状態.
+*/
+struct State
+{
+  GLuint program = unknown;
+  GLuint vertexArray = unknown;
+  GLuint arrayBuffer = unknown;
+  GLuint activeTexture = unknown;
+  GLuint textures[maxTextureUnitCount][2];
+
+  State() { Invalidate(); }
+
+  void Invalidate()
+  {
+    program = unknown;
+    vertexArray = unknown;
+    arrayBuffer = unknown;
+    activeTexture = unknown;
+    for (auto& unit : textures) {
+      unit[0] = unit[1] = unknown;
+    }
+  }
+};
+
+State state;
+Statistics current;
+Statistics last;
+
+/**
+* アクティブなテクスチャユニットを切り替える.
+*
+* @param unit テクスチャユニット番号.
+*/
+void ActiveTexture(GLuint unit)
+{
+  if (state.activeTexture != unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    state.activeTexture = unit;
+  }
+}
+
+} // unnamed namespace
+
+/**
+* フレームの描画を開始する.
+*
+* 前のフレームの統計情報を確定し、記録している状態を破棄する.
+* 描画の前に行われた読み込み処理などが直接OpenGLを操作していても、以後は正しくバインドされる.
+*/
+void BeginFrame()
+{
+  last = current;
+  current = Statistics();
+  Invalidate();
+}
+
+/**
+* 記録している状態を破棄する.
+*
+* この名前空間の関数を通さずにバインド状態を変更した場合に呼び出すこと.
+* 次のバインドは省略されずに発行される.
+*/
+void Invalidate()
+{
+  state.Invalidate();
+}
+
+/**
+* 前のフレームの統計情報を取得する.
+*
+* @return 前のフレームの統計情報.
+*/
+const Statistics& LastFrameStatistics()
+{
+  return last;
+}
+
+/**
+* プログラムオブジェクトを使用する.
+*
+* @param id 使用するプログラムオブジェクトのID. 0なら使用を解除する.
+*/
+void UseProgram(GLuint id)
+{
+  if (state.program == id) {
+    ++current.program.skipped;
+    return;
+  }
+  glUseProgram(id);
+  state.program = id;
+  ++current.program.issued;
+}
+
+/**
+* VAOをバインドする.
+*
+* @param id バインドするVAOのID. 0ならバインドを解除する.
+*/
+void BindVertexArray(GLuint id)
+{
+  if (state.vertexArray == id) {
+    ++current.vertexArray.skipped;
+    return;
+  }
+  glBindVertexArray(id);
+  state.vertexArray = id;
+  ++current.vertexArray.issued;
+}
+
+/**
+* バッファオブジェクトをバインドする.
+*
+* @param target バインド対象.
+* @param id     バインドするバッファオブジェクトのID. 0ならバインドを解除する.
+*
+* 記録するのはGL_ARRAY_BUFFERだけ. GL_ELEMENT_ARRAY_BUFFERはVAOの状態なので、
+* それ以外の対象と同じく常にバインドを発行する.
+*/
+void BindBuffer(GLenum target, GLuint id)
+{
+  if (target != GL_ARRAY_BUFFER) {
+    glBindBuffer(target, id);
+    ++current.buffer.issued;
+    return;
+  }
+  if (state.arrayBuffer == id) {
+    ++current.buffer.skipped;
+    return;
+  }
+  glBindBuffer(target, id);
+  state.arrayBuffer = id;
+  ++current.buffer.issued;
+}
+
+/**
+* テクスチャをバインドする.
+*
+* @param unit   バインド先のテクスチャユニット番号.
+* @param target バインド対象.
+* @param id     バインドするテクスチャのID. 0ならバインドを解除する.
+*/
+void BindTexture(GLuint unit, GLenum target, GLuint id)
+{
+  const int index = TargetIndex(target);
+  const bool isTracked = unit < maxTextureUnitCount && index >= 0;
+  if (isTracked && state.textures[unit][index] == id) {
+    ++current.texture.skipped;
+    return;
+  }
+  ActiveTexture(unit);
+  glBindTexture(target, id);
+  if (isTracked) {
+    state.textures[unit][index] = id;
+  }
+  ++current.texture.issued;
+}
+
+/**
+* ユニフォーム変数の設定を統計情報に記録する.
+*
+* @param isIssued true=設定を発行した. false=値が変わらないので省略した.
+*
+* ユニフォーム変数の値はプログラムオブジェクトごとに保持されるので、
+* 省略するかどうかはShader::Program側で判定する.
+*/
+void CountUniform(bool isIssued)
+{
+  if (isIssued) {
+    ++current.uniform.issued;
+  } else {
+    ++current.uniform.skipped;
+  }
+}
+
+/**
+* フェンスの確認を統計情報に記録する.
+*
+* @param isStalled true=GPUの処理が終わるのを待った. false=待たずに済んだ.
+* @param stallTime 待った時間(秒).
+*/
+void CountFenceWait(bool isStalled, double stallTime)
+{
+  ++current.fenceWaitCount;
+  if (isStalled) {
+    ++current.fenceStallCount;
+    current.fenceStallTime += stallTime;
+  }
+}
+
+/**
+* 削除されたプログラムオブジェクトの記録を消す.
+*
+* @param id 削除されたプログラムオブジェクトのID.
+*
+* IDは再利用されるので、削除時にこれを呼ばないと、同じIDの新しいオブジェクトのバインドが省略されてしまう.
+*/
+void ForgetProgram(GLuint id)
+{
+  if (state.program == id) {
+    state.program = unknown;
+  }
+}
+
+/**
+* 削除されたVAOの記録を消す.
+*
+* @param id 削除されたVAOのID.
+*/
+void ForgetVertexArray(GLuint id)
+{
+  if (state.vertexArray == id) {
+    state.vertexArray = unknown;
+  }
+}
+
+/**
+* 削除されたバッファオブジェクトの記録を消す.
+*
+* @param id 削除されたバッファオブジェクトのID.
+*/
+void ForgetBuffer(GLuint id)
+{
+  if (state.arrayBuffer == id) {
+    state.arrayBuffer = unknown;
+  }
+}
+
+/**
+* 削除されたテクスチャの記録を消す.
+*
+* @param id 削除されたテクスチャのID.
+*/
+void ForgetTexture(GLuint id)
+{
+  for (auto& unit : state.textures) {
+    for (GLuint& e : unit) {
+      if (e == id) {
+        e = unknown;
+      }
+    }
+  }
+}
+
+} // namespace GLState
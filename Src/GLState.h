@@ -0,0 +1,55 @@
+/**
+* @file GLState.h
+*/
+#ifndef GLSTATE_H_INCLUDED
+#define GLSTATE_H_INCLUDED
+#include <GL/glew.h>
+#include <cstdint>
+
+/**
+* OpenGLのバインド状態を記録し、変化しない設定を省略するための名前空間.
+*
+* プログラム、VAO、GL_ARRAY_BUFFER、テクスチャのバインドはこの名前空間の関数を通して行うこと.
+* 直接glBindTexture等を呼び出した場合は、その後でInvalidate()を呼ぶ必要がある.
+*/
+namespace GLState {
+
+// 発行した回数と省略した回数.
+struct Counter
+{
+  uint32_t issued = 0;
+  uint32_t skipped = 0;
+};
+
+// 1フレーム分の統計情報.
+struct Statistics
+{
+  Counter program;
+  Counter vertexArray;
+  Counter buffer;
+  Counter texture;
+  Counter uniform;
+  uint32_t fenceWaitCount = 0;  ///< RingBufferがフェンスを確認した回数.
+  uint32_t fenceStallCount = 0; ///< そのうちGPUの処理が終わっていなくて待った回数.
+  double fenceStallTime = 0;    ///< 待った時間の合計(秒).
+};
+
+void BeginFrame();
+void Invalidate();
+const Statistics& LastFrameStatistics();
+
+void UseProgram(GLuint id);
+void BindVertexArray(GLuint id);
+void BindBuffer(GLenum target, GLuint id);
+void BindTexture(GLuint unit, GLenum target, GLuint id);
+void CountUniform(bool isIssued);
+void CountFenceWait(bool isStalled, double stallTime);
+
+void ForgetProgram(GLuint id);
+void ForgetVertexArray(GLuint id);
+void ForgetBuffer(GLuint id);
+void ForgetTexture(GLuint id);
+
+} // namespace GLState
+
+#endif // GLSTATE_H_INCLUDED
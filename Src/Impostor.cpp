@@ -0,0 +1,321 @@
+/**
+* @file Impostor.cpp
+*/
+#include "Impostor.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <iostream>
+
+/**
+* デストラクタ.
+*/
+ImpostorRenderer::~ImpostorRenderer()
+{
+  Destroy();
+}
+
+/**
+* 焼き付け用のOpenGLオブジェクトを破棄する.
+*/
+void ImpostorRenderer::Destroy()
+{
+  glDeleteFramebuffers(1, &fbo);
+  glDeleteRenderbuffers(1, &rboDepth);
+  GLState::ForgetTexture(texAtlas);
+  glDeleteTextures(1, &texAtlas);
+  fbo = 0;
+  rboDepth = 0;
+  texAtlas = 0;
+  entries.clear();
+}
+
+/**
+* インポスター描画クラスを初期化する.
+*
+* @param maxMeshCount     焼き付け可能な最大メッシュ数.
+* @param maxInstanceCount 描画可能な最大インスタンス数.
+* @param angleCount       Y軸周りの焼き付け方向の数.
+* @param cellSize         1方向あたりの画像の縦横のピクセル数.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*
+* アトラスは横にangleCount個、縦にmaxMeshCount個の画像を並べた大きさになる.
+*/
+bool ImpostorRenderer::Init(size_t maxMeshCount, size_t maxInstanceCount, int angleCount, GLsizei cellSize)
+{
+  Destroy();
+  if (maxMeshCount <= 0 || maxInstanceCount <= 0 || angleCount <= 0 || cellSize <= 0) {
+    std::cerr << "[エラー]" << __func__ << ": 引数は全て1以上でなくてはなりません.\n";
+    return false;
+  }
+  this->maxMeshCount = maxMeshCount;
+  this->angleCount = angleCount;
+  this->cellSize = cellSize;
+
+  GLint maxTextureSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+  const GLsizei width = cellSize * angleCount;
+  const GLsizei height = cellSize * static_cast<GLsizei>(maxMeshCount);
+  if (width > maxTextureSize || height > maxTextureSize) {
+    std::cerr << "[エラー]" << __func__ << ": アトラスの大きさ(" << width << "x" << height <<
+      ")が最大テクスチャサイズ(" << maxTextureSize << ")を超えています.\n";
+    return false;
+  }
+
+  // アトラステクスチャ. 縮小時のちらつきを抑えるためミップマップを使う.
+  glGenTextures(1, &texAtlas);
+  GLState::BindTexture(0, GL_TEXTURE_2D, texAtlas);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+
+  glGenRenderbuffers(1, &rboDepth);
+  glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texAtlas, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status == GL_FRAMEBUFFER_COMPLETE) {
+    glClearColor(0, 0, 0, 0);
+    glClearDepth(1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    std::cerr << "[エラー]" << __func__ << ": フレームバッファが不完全です(0x" << std::hex << status << std::dec << ").\n";
+    Destroy();
+    return false;
+  }
+
+  // インスタンスデータ用のVBO. 板ポリゴンの頂点はシェーダでgl_VertexIDから作る.
+  vbo.Create(GL_ARRAY_BUFFER, sizeof(Instance) * maxInstanceCount, nullptr, GL_STREAM_DRAW);
+  vao.Create(vbo.Id(), 0);
+  vao.Bind();
+  vao.VertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), offsetof(Instance, positionAndSize));
+  vao.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), offsetof(Instance, color));
+  vao.VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), offsetof(Instance, rotationAndRow));
+  glVertexAttribDivisor(0, 1);
+  glVertexAttribDivisor(1, 1);
+  glVertexAttribDivisor(2, 1);
+  vao.Unbind();
+
+  program = Shader::Cache::Instance().Create("Res/Impostor.vert", "Res/Impostor.frag");
+  if (!vbo.Id() || !vao.Id() || program->IsNull()) {
+    return false;
+  }
+  locCameraPosition = program->GetUniformLocation("cameraPosition");
+  locAtlasSize = program->GetUniformLocation("atlasSize");
+  program->Use();
+  program->SetUniformInt(program->GetUniformLocation("texColor"), 0);
+  program->Unuse();
+
+  instances.reserve(maxInstanceCount);
+  entries.reserve(maxMeshCount);
+  return true;
+}
+
+/**
+* メッシュをアトラスに焼き付ける.
+*
+* @param buffer メッシュを管理しているメッシュバッファ.
+* @param mesh   焼き付けるメッシュ.
+*
+* @retval true  焼き付け成功、または焼き付け済み.
+* @retval false 焼き付け失敗.
+*
+* メッシュのY軸周りにangleCount個の方向から平行投影で描画する.
+* 描画にはメッシュバッファのビュー・プロジェクション行列を書き換えるので、呼び出し後に設定し直すこと.
+*/
+bool ImpostorRenderer::Bake(const Mesh::Buffer& buffer, const Mesh::MeshPtr& mesh)
+{
+  if (!fbo || !mesh || !mesh->file || mesh->meshNo < 0) {
+    return false;
+  }
+  if (Find(*mesh) >= 0) {
+    return true;
+  }
+  if (entries.size() >= maxMeshCount) {
+    std::cerr << "[警告]" << __func__ << ": アトラスが満杯のため'" << mesh->name << "'を焼き付けられません.\n";
+    return false;
+  }
+  const Mesh::MeshData& meshData = mesh->file->meshes[mesh->meshNo];
+  const glm::vec3 boundsMin = meshData.boundsMin;
+  const glm::vec3 boundsMax = meshData.boundsMax;
+  if (boundsMin.x >= boundsMax.x || boundsMin.y >= boundsMax.y || boundsMin.z >= boundsMax.z) {
+    std::cerr << "[警告]" << __func__ << ": '" << meshData.name << "'には境界ボックスがありません.\n";
+    return false;
+  }
+
+  // どの方向から見てもはみ出さないように、Y軸からの最大距離で横幅を決める.
+  const glm::vec2 maxXZ = glm::max(glm::abs(glm::vec2(boundsMin.x, boundsMin.z)),
+    glm::abs(glm::vec2(boundsMax.x, boundsMax.z)));
+  const float radius = glm::length(maxXZ);
+  const float size = std::max(radius * 2, boundsMax.y - boundsMin.y);
+  const float bottom = boundsMin.y;
+  const float halfSize = size * 0.5f;
+  const glm::mat4 matProj = glm::ortho(-halfSize, halfSize, bottom, bottom + size, 0.0f, radius * 2 + 2);
+
+  // 読み込み処理が直接テクスチャをバインドしているかもしれないので、記録している状態を破棄する.
+  GLState::Invalidate();
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  const GLboolean isBlendEnabled = glIsEnabled(GL_BLEND);
+  const GLboolean isCullFaceEnabled = glIsEnabled(GL_CULL_FACE);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glEnable(GL_DEPTH_TEST);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_BLEND); // アルファ値をそのまま書き込む.
+  glEnable(GL_SCISSOR_TEST);
+
+  const GLint row = static_cast<GLint>(entries.size());
+  for (int i = 0; i < angleCount; ++i) {
+    const GLint x = cellSize * i;
+    const GLint y = cellSize * row;
+    glViewport(x, y, cellSize, cellSize);
+    glScissor(x, y, cellSize, cellSize);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // i番目の方向. シェーダでの方向の選び方と一致させること.
+    const float angle = glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(angleCount);
+    const glm::vec3 eye = glm::vec3(std::sin(angle), 0, std::cos(angle)) * (radius + 1);
+    const glm::mat4 matView = glm::lookAt(eye, glm::vec3(0), glm::vec3(0, 1, 0));
+    buffer.SetViewProjectionMatrix(matProj * matView);
+    mesh->Draw(glm::mat4(1));
+  }
+
+  glDisable(GL_SCISSOR_TEST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  if (isBlendEnabled) {
+    glEnable(GL_BLEND);
+  }
+  if (isCullFaceEnabled) {
+    glEnable(GL_CULL_FACE);
+  }
+
+  GLState::BindTexture(0, GL_TEXTURE_2D, texAtlas);
+  glGenerateMipmap(GL_TEXTURE_2D);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+
+  entries.push_back({ mesh->file.get(), mesh->meshNo, size, bottom });
+  std::cout << "[情報]" << __func__ << ": '" << meshData.name << "'のインポスターを作成しました(" <<
+    angleCount << "方向).\n";
+  return true;
+}
+
+/**
+* 焼き付け済みのメッシュを検索する.
+*
+* @param mesh 検索するメッシュ.
+*
+* @return meshに対応するアトラスの行番号. 焼き付けられていなければ-1.
+*
+* 焼き付けるメッシュは数種類程度の想定なので線形探索で十分.
+*/
+int ImpostorRenderer::Find(const Mesh::Mesh& mesh) const
+{
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].file == mesh.file.get() && entries[i].meshNo == mesh.meshNo) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+/**
+* メッシュが焼き付け済みか調べる.
+*
+* @param mesh 調べるメッシュ.
+*
+* @retval true  焼き付け済み.
+* @retval false 焼き付けられていない.
+*/
+bool ImpostorRenderer::HasImpostor(const Mesh::Mesh& mesh) const
+{
+  return Find(mesh) >= 0;
+}
+
+/**
+* インスタンスデータの作成を開始する.
+*/
+void ImpostorRenderer::BeginUpdate()
+{
+  instances.clear();
+}
+
+/**
+* インスタンスを追加する.
+*
+* @param mesh     描画するメッシュ. Bake()で焼き付け済みであること.
+* @param position メッシュの座標.
+* @param rotation メッシュのY軸回転(ラジアン).
+* @param scale    メッシュの拡大率. ビルボードの大きさにはXとYの大きいほうを使う.
+* @param color    描画色.
+*
+* @retval true  追加成功.
+* @retval false 焼き付けられていないメッシュ、またはVBOが満杯で追加できない.
+*/
+bool ImpostorRenderer::AddInstance(const Mesh::Mesh& mesh, const glm::vec3& position, float rotation,
+  const glm::vec3& scale, const glm::vec4& color)
+{
+  if (instances.size() * sizeof(Instance) >= static_cast<size_t>(vbo.Size())) {
+    return false;
+  }
+  const int row = Find(mesh);
+  if (row < 0) {
+    return false;
+  }
+  const Entry& e = entries[row];
+  const float s = std::max(scale.x, scale.y);
+  const glm::vec3 base = position + glm::vec3(0, e.bottom * scale.y, 0);
+  instances.push_back({ glm::vec4(base, e.size * s), color, glm::vec2(rotation, row) });
+  return true;
+}
+
+/**
+* インスタンスデータの作成を終了する.
+*/
+void ImpostorRenderer::EndUpdate()
+{
+  instanceCount = static_cast<GLsizei>(instances.size());
+  if (instanceCount > 0) {
+    vbo.BufferSubData(0, instances.size() * sizeof(Instance), instances.data());
+  }
+}
+
+/**
+* インポスターを描画する.
+*
+* @param matVP          ビュー・プロジェクション行列.
+* @param cameraPosition 視点の座標.
+*/
+void ImpostorRenderer::Draw(const glm::mat4& matVP, const glm::vec3& cameraPosition) const
+{
+  if (instanceCount <= 0) {
+    return;
+  }
+  vao.Bind();
+  program->Use();
+  program->SetViewProjectionMatrix(matVP);
+  glUniform3fv(locCameraPosition, 1, &cameraPosition.x);
+  glUniform2f(locAtlasSize, static_cast<GLfloat>(angleCount), static_cast<GLfloat>(maxMeshCount));
+  GLState::BindTexture(0, GL_TEXTURE_2D, texAtlas);
+
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instanceCount);
+
+  program->Unuse();
+  vao.Unbind();
+}
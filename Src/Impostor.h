@@ -0,0 +1,87 @@
+/**
+* @file Impostor.h
+*/
+#ifndef IMPOSTOR_H_INCLUDED
+#define IMPOSTOR_H_INCLUDED
+#include <GL/glew.h>
+#include "BufferObject.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+* 遠景用のインポスター描画クラス.
+*
+* 使い方:
+* -# Init()で初期化.
+* -# Bake()で、インポスターに置き換えたいメッシュを複数の方向から描画してアトラスに焼き付ける.
+*    これは読み込み時に1回だけ行えばよい.
+* -# 毎フレーム、BeginUpdate()のあとで、遠くにあるメッシュの代わりにAddInstance()でインスタンスを追加し、EndUpdate()を呼ぶ.
+* -# Draw()で全てのインスタンスをインスタンシング描画する.
+*
+* 焼き付けはY軸周りの方向だけで行い、ビルボードもY軸だけを回転軸にして視点に向ける.
+* そのため、樹木や草のように縦に立っているメッシュに向いている.
+*/
+class ImpostorRenderer
+{
+public:
+  ImpostorRenderer() = default;
+  ~ImpostorRenderer();
+  ImpostorRenderer(const ImpostorRenderer&) = delete;
+  ImpostorRenderer& operator=(const ImpostorRenderer&) = delete;
+
+  bool Init(size_t maxMeshCount, size_t maxInstanceCount, int angleCount = 8, GLsizei cellSize = 128);
+  bool Bake(const Mesh::Buffer& buffer, const Mesh::MeshPtr& mesh);
+  bool HasImpostor(const Mesh::Mesh& mesh) const;
+
+  void BeginUpdate();
+  bool AddInstance(const Mesh::Mesh& mesh, const glm::vec3& position, float rotation, const glm::vec3& scale,
+    const glm::vec4& color = glm::vec4(1));
+  void EndUpdate();
+  void Draw(const glm::mat4& matVP, const glm::vec3& cameraPosition) const;
+
+  void Distance(float d) { distance = d; }
+  float Distance() const { return distance; }
+
+private:
+  void Destroy();
+  int Find(const Mesh::Mesh& mesh) const;
+
+  // 焼き付け済みのメッシュ.
+  struct Entry
+  {
+    const Mesh::File* file; ///< メッシュを含むファイル.
+    int meshNo;             ///< ファイル内のメッシュ番号.
+    float size;             ///< ビルボードの一辺の長さ.
+    float bottom;           ///< ビルボード下端のY座標.
+  };
+  std::vector<Entry> entries;
+
+  // インスタンスデータ.
+  struct Instance
+  {
+    glm::vec4 positionAndSize; ///< xyz=ビルボード下端の中心座標, w=ビルボードの一辺の長さ.
+    glm::vec4 color;           ///< 色.
+    glm::vec2 rotationAndRow;  ///< x=Y軸回転(ラジアン), y=アトラスの行番号.
+  };
+  std::vector<Instance> instances;
+  GLsizei instanceCount = 0;
+
+  BufferObject vbo;
+  VertexArrayObject vao;
+  Shader::ProgramPtr program;
+  GLint locCameraPosition = -1;
+  GLint locAtlasSize = -1;
+
+  GLuint texAtlas = 0;
+  GLuint fbo = 0;
+  GLuint rboDepth = 0;
+  size_t maxMeshCount = 0;
+  int angleCount = 0;
+  GLsizei cellSize = 0;
+
+  float distance = 120.0f; ///< インポスターに切り替える視点からの距離.
+};
+
+#endif // IMPOSTOR_H_INCLUDED
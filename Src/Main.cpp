@@ -6,13 +6,32 @@
 #include "Scenes/TitleScene.h"
 #include "SkeletalMesh.h"
 #include "Audio/Audio.h"
+#include "TextureCooker.h"
+#include "TextureStreamer.h"
+#include "Shader.h"
+#include "GLState.h"
+#include "MatrixKernel.h"
 #include <iostream>
+#include <cstring>
 
 /**
-* vÕGg[|Cg.
+* プログラムのエントリーポイント.
+*
+* コマンドライン引数に"--cook"を指定すると、ゲームを起動せずにテクスチャの変換だけを行う.
+* 例: OpenGL3D2019.exe --cook Res
+* "--bench"を指定すると、ゲームを起動せずに行列演算のベンチマークを行う.
 */
-int main()
+int main(int argc, char* argv[])
 {
+  if (argc >= 2 && std::strcmp(argv[1], "--cook") == 0) {
+    Texture::CookDirectory(argc >= 3 ? argv[2] : "Res");
+    return 0;
+  }
+  if (argc >= 2 && std::strcmp(argv[1], "--bench") == 0) {
+    Mesh::BenchmarkMatrixKernels();
+    return 0;
+  }
+
   GLFWEW::Window& window = GLFWEW::Window::Instance();
   if (!window.Init(1280, 720, "OpenGL 3D 2019")) {
     return 1;
@@ -23,16 +42,29 @@ int main()
     return 1;
   }
 
+  // 使用する全てのシェーダーのビルドを開始しておく.
+  // 結果は最初に使うときに確認するので、その間にドライバが並列にコンパイルできる.
+  Shader::Cache::Instance().Create({
+    { "Res/Mesh.vert", "Res/Mesh.frag" },
+    { "Res/SkeletalMesh.vert", "Res/SkeletalMesh.frag" },
+    { "Res/SkeletalMeshCrowd.vert", "Res/SkeletalMesh.frag" },
+    { "Res/Sprite.vert", "Res/Sprite.frag" },
+    { "Res/Impostor.vert", "Res/Impostor.frag" },
+  });
+
   if (!Mesh::GlobalSkeletalMeshState::Initialize()) {
     return 1;
   }
+  // 初期化に失敗した場合、テクスチャはその場で読み込まれる.
+  Texture::Streamer& textureStreamer = Texture::Streamer::Instance();
+  textureStreamer.Init();
   SceneStack& sceneStack = SceneStack::Instance();
   sceneStack.Push(std::make_shared<TitleScene>());
 
   while (!window.ShouldClose()) {
     window.Update();
     if (window.KeyDown(GLFW_KEY_ESCAPE)) {
-      if (MessageBox(nullptr, "Q[I܂H", "I", MB_YESNO) == IDYES) {
+      if (MessageBox(nullptr, "ゲームを終了しますか？", "終了", MB_YESNO) == IDYES) {
         break;
       }
     }
@@ -44,17 +76,20 @@ int main()
     Mesh::GlobalSkeletalMeshState::UploadUniformData();
 
     audioEngine.Update();
+    textureStreamer.Update();
 
     glClearColor(0.1f, 0.2f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glEnable(GL_CULL_FACE);
     glEnable(GL_DEPTH_TEST);
 
+    GLState::BeginFrame();
     sceneStack.Render();
 
     window.SwapBuffers();
   }
 
+  textureStreamer.Finalize();
   audioEngine.Finalize();
   Mesh::GlobalSkeletalMeshState::Finalize();
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+/**
+* @file MappedFile.cpp
+*/
+#define NOMINMAX
+#include "MappedFile.h"
+#include <Windows.h>
+
+/**
+* コンストラクタ.
+*
+* @param path マップするファイル名.
+*
+* 失敗した場合はIsNull()がtrueを返す.
+*/
+MappedFile::MappedFile(const char* path)
+{
+  const HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  file = h;
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(h, &fileSize) || fileSize.QuadPart <= 0) {
+    return; // 空のファイルはマップできない.
+  }
+  mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    return;
+  }
+  data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (data) {
+    size = static_cast<size_t>(fileSize.QuadPart);
+  }
+}
+
+/**
+* デストラクタ.
+*/
+MappedFile::~MappedFile()
+{
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  if (file) {
+    CloseHandle(file);
+  }
+}
@@ -0,0 +1,34 @@
+/**
+* @file MappedFile.h
+*/
+#ifndef MAPPEDFILE_H_INCLUDED
+#define MAPPEDFILE_H_INCLUDED
+#include <cstdint>
+#include <cstddef>
+
+/**
+* 読み取り専用でメモリにマップしたファイル.
+*
+* ファイルの内容はOSのページキャッシュから直接参照されるので、読み込み用のバッファは不要.
+*/
+class MappedFile
+{
+public:
+  explicit MappedFile(const char* path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsNull() const { return !data; }
+  const uint8_t* Data() const { return data; }
+  size_t Size() const { return size; }
+
+private:
+  // Windows.hをインクルードしなくて済むように、HANDLEはvoid*として保持する.
+  void* file = nullptr;
+  void* mapping = nullptr;
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+#endif // MAPPEDFILE_H_INCLUDED
@@ -0,0 +1,359 @@
+/**
+* @file MatrixKernel.cpp
+*
+* 骨格アニメーション用の行列演算.
+* glmの行列は列優先で、m[i]がi列目になる. アフィン変換では0～2列目のwは0、3列目のwは1.
+*/
+#define NOMINMAX
+#include "MatrixKernel.h"
+#include "CpuFeatures.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <immintrin.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+namespace Mesh {
+
+namespace /* unnamed */ {
+
+/**
+* アフィン変換行列どうしを乗算する(SSE版).
+*
+* out = a * b. outはaやbと同じでもよい.
+*/
+void MultiplyAffineSSE(const glm::aligned_mat4& a, const glm::aligned_mat4& b, glm::aligned_mat4& out)
+{
+  const __m128 a0 = _mm_load_ps(&a[0][0]);
+  const __m128 a1 = _mm_load_ps(&a[1][0]);
+  const __m128 a2 = _mm_load_ps(&a[2][0]);
+  const __m128 a3 = _mm_load_ps(&a[3][0]);
+  __m128 r[4];
+  for (int i = 0; i < 4; ++i) {
+    const __m128 c = _mm_load_ps(&b[i][0]);
+    r[i] = _mm_add_ps(
+      _mm_add_ps(
+        _mm_mul_ps(a0, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0))),
+        _mm_mul_ps(a1, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)))),
+      _mm_mul_ps(a2, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2))));
+  }
+  // bの3列目のwは1なので、aの3列目はそのまま加算すればよい.
+  r[3] = _mm_add_ps(r[3], a3);
+  for (int i = 0; i < 4; ++i) {
+    _mm_store_ps(&out[i][0], r[i]);
+  }
+}
+
+/**
+* アフィン変換行列どうしを乗算する(AVX2+FMA版).
+*
+* 2列ずつ256ビットレジスタで計算する.
+*/
+void MultiplyAffineAVX2(const glm::aligned_mat4& a, const glm::aligned_mat4& b, glm::aligned_mat4& out)
+{
+  const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[0][0]));
+  const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[1][0]));
+  const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[2][0]));
+  const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[3][0]));
+  const __m256 b01 = _mm256_loadu_ps(&b[0][0]);
+  const __m256 b23 = _mm256_loadu_ps(&b[2][0]);
+
+  __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+  r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+  r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+
+  // 2列目のwは0、3列目のwは1なので、aの3列目も同じ式で加算できる.
+  __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+  r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+  r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+  r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+  _mm256_storeu_ps(&out[0][0], r01);
+  _mm256_storeu_ps(&out[2][0], r23);
+}
+
+/**
+* 4x4行列を転置して、上3行を格納する(SSE版).
+*/
+void TransposeToAffineSSE(const glm::aligned_mat4* src, glm::aligned_mat3x4* dst, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    __m128 c0 = _mm_load_ps(&src[i][0][0]);
+    __m128 c1 = _mm_load_ps(&src[i][1][0]);
+    __m128 c2 = _mm_load_ps(&src[i][2][0]);
+    __m128 c3 = _mm_load_ps(&src[i][3][0]);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_store_ps(&dst[i][0][0], c0);
+    _mm_store_ps(&dst[i][1][0], c1);
+    _mm_store_ps(&dst[i][2][0], c2);
+  }
+}
+
+/**
+* 4x4行列を転置して、上3行を格納する(AVX2版).
+*
+* 2つの行列を256ビットレジスタの上下に分けて、同時に転置する.
+*/
+void TransposeToAffineAVX2(const glm::aligned_mat4* src, glm::aligned_mat3x4* dst, size_t count)
+{
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m256 c0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(&src[i][0][0])),
+      _mm_load_ps(&src[i + 1][0][0]), 1);
+    const __m256 c1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(&src[i][1][0])),
+      _mm_load_ps(&src[i + 1][1][0]), 1);
+    const __m256 c2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(&src[i][2][0])),
+      _mm_load_ps(&src[i + 1][2][0]), 1);
+    const __m256 c3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(&src[i][3][0])),
+      _mm_load_ps(&src[i + 1][3][0]), 1);
+    const __m256 t0 = _mm256_unpacklo_ps(c0, c1); // [c0.x c1.x c0.y c1.y]
+    const __m256 t1 = _mm256_unpacklo_ps(c2, c3); // [c2.x c3.x c2.y c3.y]
+    const __m256 t2 = _mm256_unpackhi_ps(c0, c1); // [c0.z c1.z c0.w c1.w]
+    const __m256 t3 = _mm256_unpackhi_ps(c2, c3); // [c2.z c3.z c2.w c3.w]
+    const __m256 r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    _mm_store_ps(&dst[i][0][0], _mm256_castps256_ps128(r0));
+    _mm_store_ps(&dst[i][1][0], _mm256_castps256_ps128(r1));
+    _mm_store_ps(&dst[i][2][0], _mm256_castps256_ps128(r2));
+    _mm_store_ps(&dst[i + 1][0][0], _mm256_extractf128_ps(r0, 1));
+    _mm_store_ps(&dst[i + 1][1][0], _mm256_extractf128_ps(r1, 1));
+    _mm_store_ps(&dst[i + 1][2][0], _mm256_extractf128_ps(r2, 1));
+  }
+  TransposeToAffineSSE(src + i, dst + i, count - i);
+}
+
+/**
+* 実行時に選択した実装.
+*/
+struct Kernels
+{
+  void (*multiplyAffine)(const glm::aligned_mat4&, const glm::aligned_mat4&, glm::aligned_mat4&);
+  void (*transposeToAffine)(const glm::aligned_mat4*, glm::aligned_mat3x4*, size_t);
+
+  Kernels()
+  {
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.avx2 && cpu.fma) {
+      multiplyAffine = MultiplyAffineAVX2;
+      transposeToAffine = TransposeToAffineAVX2;
+    } else {
+      multiplyAffine = MultiplyAffineSSE;
+      transposeToAffine = TransposeToAffineSSE;
+    }
+  }
+};
+
+const Kernels& GetKernels()
+{
+  static const Kernels kernels;
+  return kernels;
+}
+
+/**
+* 処理時間を計測する.
+*
+* @param count 処理する要素数.
+* @param f     計測する処理.
+*
+* @return 1要素あたりの処理時間(ナノ秒). 5回計測した中の最短時間.
+*/
+template<typename F>
+double Measure(size_t count, F f)
+{
+  double best = 0;
+  for (int i = 0; i < 5; ++i) {
+    const auto begin = std::chrono::high_resolution_clock::now();
+    f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - begin;
+    const double t = elapsed.count() / static_cast<double>(count);
+    best = (i == 0) ? t : std::min(best, t);
+  }
+  return best;
+}
+
+/**
+* 2つの行列の要素の最大誤差を求める.
+*/
+template<typename M>
+float MaxError(const M& a, const M& b)
+{
+  const float* pa = &a[0][0];
+  const float* pb = &b[0][0];
+  float e = 0;
+  for (size_t i = 0; i < sizeof(M) / sizeof(float); ++i) {
+    e = std::max(e, std::abs(pa[i] - pb[i]));
+  }
+  return e;
+}
+
+/**
+* 計測結果を表示する.
+*/
+void PrintResult(const char* name, double glmTime, double simdTime, float error)
+{
+  std::cout << "  " << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(2) <<
+    "glm=" << std::setw(7) << glmTime << "ns simd=" << std::setw(7) << simdTime << "ns x" <<
+    std::setprecision(2) << (glmTime / simdTime) << " 誤差=" << std::scientific << std::setprecision(1) << error <<
+    std::defaultfloat << "\n";
+}
+
+} // unnamed namespace
+
+/**
+* 平行移動、回転、拡大縮小からアフィン変換行列を作る.
+*
+* @param translation 平行移動.
+* @param rotation    回転. 正規化されていること.
+* @param scale       拡大率.
+* @param out         作成した行列の格納先.
+*
+* glm::translate(T) * glm::mat4_cast(R) * glm::scale(S)と同じ結果になる.
+*/
+void ComposeAffine(const glm::aligned_vec3& translation, const glm::aligned_quat& rotation,
+  const glm::aligned_vec3& scale, glm::aligned_mat4& out)
+{
+  const __m128 q = _mm_setr_ps(rotation.x, rotation.y, rotation.z, rotation.w);
+  const __m128 q2 = _mm_add_ps(q, q);
+
+  // 回転行列の各列を、対角成分の1と2つの積の和で表す.
+  // 0列目 = (1-2yy-2zz, 2xy+2wz, 2xz-2wy)
+  // 1列目 = (2xy-2wz, 1-2xx-2zz, 2yz+2wx)
+  // 2列目 = (2xz+2wy, 2yz-2wx, 1-2xx-2yy)
+  const __m128 v0 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 0, 0, 1)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 2, 1, 1))); // [2yy, 2xy, 2xz]
+  const __m128 w0 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 2)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 1, 2, 2))); // [2zz, 2wz, 2wy]
+  const __m128 v1 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 1, 0, 0)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 2, 0, 1))); // [2xy, 2xx, 2yz]
+  const __m128 w1 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 2, 3)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 0, 2, 2))); // [2wz, 2zz, 2wx]
+  const __m128 v2 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 0, 1, 0)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 0, 2, 2))); // [2xz, 2yz, 2xx]
+  const __m128 w2 = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 1, 3, 3)),
+    _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(3, 1, 0, 1))); // [2wy, 2wx, 2yy]
+
+  // 符号の4番目を0にして、wを0にする.
+  __m128 c0 = _mm_add_ps(_mm_setr_ps(1, 0, 0, 0), _mm_add_ps(
+    _mm_mul_ps(v0, _mm_setr_ps(-1, 1, 1, 0)), _mm_mul_ps(w0, _mm_setr_ps(-1, 1, -1, 0))));
+  __m128 c1 = _mm_add_ps(_mm_setr_ps(0, 1, 0, 0), _mm_add_ps(
+    _mm_mul_ps(v1, _mm_setr_ps(1, -1, 1, 0)), _mm_mul_ps(w1, _mm_setr_ps(-1, -1, 1, 0))));
+  __m128 c2 = _mm_add_ps(_mm_setr_ps(0, 0, 1, 0), _mm_add_ps(
+    _mm_mul_ps(v2, _mm_setr_ps(1, 1, -1, 0)), _mm_mul_ps(w2, _mm_setr_ps(1, -1, -1, 0))));
+  c0 = _mm_mul_ps(c0, _mm_set1_ps(scale.x));
+  c1 = _mm_mul_ps(c1, _mm_set1_ps(scale.y));
+  c2 = _mm_mul_ps(c2, _mm_set1_ps(scale.z));
+
+  _mm_store_ps(&out[0][0], c0);
+  _mm_store_ps(&out[1][0], c1);
+  _mm_store_ps(&out[2][0], c2);
+  _mm_store_ps(&out[3][0], _mm_setr_ps(translation.x, translation.y, translation.z, 1));
+}
+
+/**
+* アフィン変換行列どうしを乗算する.
+*
+* @param a   左側の行列.
+* @param b   右側の行列.
+* @param out a * bの格納先. aやbと同じでもよい.
+*
+* aとbの最下行は(0, 0, 0, 1)でなくてはならない.
+*/
+void MultiplyAffine(const glm::aligned_mat4& a, const glm::aligned_mat4& b, glm::aligned_mat4& out)
+{
+  GetKernels().multiplyAffine(a, b, out);
+}
+
+/**
+* 4x4行列の配列を転置して、上3行だけを格納する.
+*
+* @param src   変換する行列の配列.
+* @param dst   変換した行列の格納先(UBOの行列と同じ形式).
+* @param count 変換する行列の数.
+*/
+void TransposeToAffine(const glm::aligned_mat4* src, glm::aligned_mat3x4* dst, size_t count)
+{
+  GetKernels().transposeToAffine(src, dst, count);
+}
+
+/**
+* 行列演算をglmと比較して、処理時間を表示する.
+*
+* @param count 計測に使う行列の数.
+*/
+void BenchmarkMatrixKernels(size_t count)
+{
+  std::mt19937 rand(0);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<glm::aligned_vec3> translations(count);
+  std::vector<glm::aligned_quat> rotations(count);
+  std::vector<glm::aligned_vec3> scales(count);
+  for (size_t i = 0; i < count; ++i) {
+    translations[i] = glm::aligned_vec3(dist(rand), dist(rand), dist(rand)) * 10.0f;
+    rotations[i] = glm::normalize(glm::aligned_quat(dist(rand), dist(rand), dist(rand), dist(rand)));
+    scales[i] = glm::aligned_vec3(dist(rand), dist(rand), dist(rand)) + 1.5f;
+  }
+  std::vector<glm::aligned_mat4> a(count);
+  std::vector<glm::aligned_mat4> b(count);
+  std::vector<glm::aligned_mat4> r(count);
+  std::vector<glm::aligned_mat3x4> t(count);
+  std::vector<glm::aligned_mat3x4> t2(count);
+
+  const CpuFeatures& cpu = GetCpuFeatures();
+  std::cout << "[情報] 行列演算のベンチマーク(" << count << "要素, " <<
+    (cpu.avx2 && cpu.fma ? "AVX2+FMA" : "SSE") << ")\n";
+
+  const double composeGlm = Measure(count, [&] {
+    for (size_t i = 0; i < count; ++i) {
+      a[i] = glm::translate(glm::aligned_mat4(1), translations[i]) * glm::mat4_cast(rotations[i]) *
+        glm::scale(glm::aligned_mat4(1), scales[i]);
+    }
+  });
+  const double composeSimd = Measure(count, [&] {
+    for (size_t i = 0; i < count; ++i) {
+      ComposeAffine(translations[i], rotations[i], scales[i], b[i]);
+    }
+  });
+  float error = 0;
+  for (size_t i = 0; i < count; ++i) {
+    error = std::max(error, MaxError(a[i], b[i]));
+  }
+  PrintResult("TRS->アフィン", composeGlm, composeSimd, error);
+
+  std::rotate(b.begin(), b.begin() + 1, b.end());
+  const double multiplyGlm = Measure(count, [&] {
+    for (size_t i = 0; i < count; ++i) {
+      r[i] = a[i] * b[i];
+    }
+  });
+  std::vector<glm::aligned_mat4> r2(count);
+  const double multiplySimd = Measure(count, [&] {
+    for (size_t i = 0; i < count; ++i) {
+      MultiplyAffine(a[i], b[i], r2[i]);
+    }
+  });
+  error = 0;
+  for (size_t i = 0; i < count; ++i) {
+    error = std::max(error, MaxError(r[i], r2[i]));
+  }
+  PrintResult("アフィン乗算", multiplyGlm, multiplySimd, error);
+
+  const double transposeGlm = Measure(count, [&] {
+    for (size_t i = 0; i < count; ++i) {
+      t[i] = glm::transpose(r[i]);
+    }
+  });
+  const double transposeSimd = Measure(count, [&] {
+    TransposeToAffine(r.data(), t2.data(), count);
+  });
+  error = 0;
+  for (size_t i = 0; i < count; ++i) {
+    error = std::max(error, MaxError(t[i], t2[i]));
+  }
+  PrintResult("転置(3x4)", transposeGlm, transposeSimd, error);
+}
+
+} // namespace Mesh
@@ -0,0 +1,27 @@
+/**
+* @file MatrixKernel.h
+*/
+#ifndef MATRIXKERNEL_H_INCLUDED
+#define MATRIXKERNEL_H_INCLUDED
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/type_aligned.hpp>
+#include <cstddef>
+
+namespace Mesh {
+
+/**
+* 骨格アニメーション用の行列演算.
+*
+* 関節の行列は全てアフィン変換(最下行が0,0,0,1)なので、一般の4x4行列演算より計算を省略できる.
+* SSEで実装し、AVX2とFMAが使えるCPUでは実行時にAVX2版に切り替える.
+*/
+void ComposeAffine(const glm::aligned_vec3& translation, const glm::aligned_quat& rotation,
+  const glm::aligned_vec3& scale, glm::aligned_mat4& out);
+void MultiplyAffine(const glm::aligned_mat4& a, const glm::aligned_mat4& b, glm::aligned_mat4& out);
+void TransposeToAffine(const glm::aligned_mat4* src, glm::aligned_mat3x4* dst, size_t count);
+void BenchmarkMatrixKernels(size_t count = 100000);
+
+} // namespace Mesh
+
+#endif // MATRIXKERNEL_H_INCLUDED
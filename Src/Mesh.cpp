@@ -3,10 +3,13 @@
 */
 #define NOMINMAX
 #include "Mesh.h"
+#include "GLState.h"
 #include "SkeletalMesh.h"
+#include "MeshOptimizer.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/packing.hpp>
 #include <math.h>
 #include <iostream>
 #include <fstream>
@@ -14,18 +17,140 @@
 
 namespace Mesh {
 
+namespace /* unnamed */ {
+
+/**
+* 頂点データの要素型のバイト数を取得する.
+*
+* @param type 要素型(GL_BYTE, GL_UNSIGNED_SHORT, GL_FLOATなど).
+*
+* @return typeのバイト数.
+*/
+GLsizei ComponentSize(GLenum type)
+{
+  switch (type) {
+  case GL_BYTE:
+  case GL_UNSIGNED_BYTE:
+    return 1;
+  case GL_SHORT:
+  case GL_UNSIGNED_SHORT:
+  case GL_HALF_FLOAT:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
 /**
-* t@Cǂݍ.
+* 頂点データの要素をfloatとして読み出す.
 *
-* @param path t@C.
+* @param p          読み出す要素のアドレス.
+* @param type       要素型.
+* @param normalized 整数型の場合、[0, 1]または[-1, 1]に正規化するならtrue.
 *
-* @return t@C̓e.
+* @return 読み出した値.
+*/
+float ReadComponent(const char* p, GLenum type, bool normalized)
+{
+  switch (type) {
+  case GL_BYTE: {
+    GLbyte v;
+    memcpy(&v, p, sizeof(v));
+    return normalized ? std::max(static_cast<float>(v) / 127.0f, -1.0f) : static_cast<float>(v);
+  }
+  case GL_UNSIGNED_BYTE: {
+    GLubyte v;
+    memcpy(&v, p, sizeof(v));
+    return normalized ? static_cast<float>(v) / 255.0f : static_cast<float>(v);
+  }
+  case GL_SHORT: {
+    GLshort v;
+    memcpy(&v, p, sizeof(v));
+    return normalized ? std::max(static_cast<float>(v) / 32767.0f, -1.0f) : static_cast<float>(v);
+  }
+  case GL_UNSIGNED_SHORT: {
+    GLushort v;
+    memcpy(&v, p, sizeof(v));
+    return normalized ? static_cast<float>(v) / 65535.0f : static_cast<float>(v);
+  }
+  case GL_UNSIGNED_INT: {
+    GLuint v;
+    memcpy(&v, p, sizeof(v));
+    return static_cast<float>(v);
+  }
+  default: {
+    GLfloat v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  }
+}
+
+/**
+* ウェイトを4つのunorm8に圧縮する.
+*
+* @param w 圧縮するウェイト.
+*
+* @return 圧縮したウェイト.
+*
+* 量子化誤差で合計が1からずれないように、端数は最も大きいウェイトに加える.
+*/
+GLuint PackWeights(glm::vec4 w)
+{
+  const float sum = w.x + w.y + w.z + w.w;
+  if (sum > 0) {
+    w /= sum;
+  }
+  int q[4];
+  int total = 0;
+  int maxIndex = 0;
+  for (int i = 0; i < 4; ++i) {
+    q[i] = static_cast<int>(glm::clamp(w[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+    total += q[i];
+    if (q[i] > q[maxIndex]) {
+      maxIndex = i;
+    }
+  }
+  if (total > 0) {
+    q[maxIndex] = glm::clamp(q[maxIndex] + 255 - total, 0, 255);
+  }
+  return static_cast<GLuint>(q[0]) | (static_cast<GLuint>(q[1]) << 8) |
+    (static_cast<GLuint>(q[2]) << 16) | (static_cast<GLuint>(q[3]) << 24);
+}
+
+/**
+* 頂点データを圧縮形式に変換する.
+*
+* @param v 変換する頂点データ.
+*
+* @return 変換した頂点データ.
+*/
+PackedVertex PackVertex(const Vertex& v)
+{
+  PackedVertex pv;
+  pv.position = v.position;
+  pv.normal = glm::packSnorm3x10_1x2(glm::vec4(v.normal, 0));
+  const GLuint texCoord = glm::packHalf2x16(v.texCoord);
+  memcpy(pv.texCoord, &texCoord, sizeof(pv.texCoord));
+  const GLuint color = glm::packUnorm4x8(glm::clamp(v.color, 0.0f, 1.0f));
+  memcpy(pv.color, &color, sizeof(pv.color));
+  return pv;
+}
+
+} // unnamed namespace
+
+/**
+* ファイルを読み込む.
+*
+* @param path ファイル名.
+*
+* @return ファイルの内容.
 */
 std::vector<char> ReadFromFile(const char* path)
 {
   std::ifstream ifs(path, std::ios_base::binary);
   if (!ifs) {
-    std::cerr << "ERROR: " << path << "J܂.\n";
+    std::cerr << "ERROR: " << path << "を開けません.\n";
     return {};
   }
   std::vector<char> tmp(1000000);
@@ -43,32 +168,42 @@ std::vector<char> ReadFromFile(const char* path)
 }
 
 /**
-* v~eBu쐬.
+* プリミティブを作成する.
 *
-* @param count    v~eBũCfbNXf[^̐.
-* @param type     CfbNXf[^̌^(GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT̂ꂩ).
-* @param iOffset  IBÕCfbNXf[^̊Jnʒu.
-* @param vOffset  VBO̒_f[^̊Jnʒu.
+* @param count    プリミティブのインデックスデータの数.
+* @param type     インデックスデータの型(GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INTのいずれか).
+* @param iRange   AddIndexData()で追加したインデックスデータの領域.
+* @param vRange   AddVertexData()で追加した頂点データの領域.
+* @param format   AddVertexData()で指定した頂点データの形式.
+*                 VertexFormat::Skinnedは指定できない(VertexFormat::Standardとして扱う).
 *
-* @return 쐬Primitive\.
+* @return 作成したPrimitive構造体.
 */
-Primitive Buffer::CreatePrimitive(size_t count, GLenum type, size_t iOffset, size_t vOffset) const
+Primitive Buffer::CreatePrimitive(size_t count, GLenum type, const BufferRange& iRange, const BufferRange& vRange,
+  VertexFormat format) const
 {
   Primitive prim;
   prim.mode = GL_TRIANGLES;
   prim.count = static_cast<GLsizei>(count);
   prim.type = type;
-  prim.indices = reinterpret_cast<const GLvoid*>(iOffset);
+  prim.indices = reinterpret_cast<const GLvoid*>(iRange.offset);
   prim.baseVertex = 0;
-  std::shared_ptr<VertexArrayObject> vao = std::make_shared<VertexArrayObject>();
-  vao->Create(vbo.Id(), ibo.Id());
-  vao->Bind();
-  vao->VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), vOffset + offsetof(Vertex, position));
-  vao->VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), vOffset + offsetof(Vertex, color));
-  vao->VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), vOffset + offsetof(Vertex, texCoord));
-  vao->VertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), vOffset + offsetof(Vertex, normal));
-  vao->Unbind();
-  prim.vao = vao;
+  prim.indexRange = iRange;
+  prim.vertexRanges.push_back(vRange);
+  if (format == VertexFormat::Static) {
+    prim.vertexFormat = VertexFormat::Static;
+    const GLsizei stride = sizeof(PackedVertex);
+    prim.attributes.push_back({ 0, 3, GL_FLOAT, GL_FALSE, stride, offsetof(PackedVertex, position), 0 });
+    prim.attributes.push_back({ 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offsetof(PackedVertex, color), 0 });
+    prim.attributes.push_back({ 2, 2, GL_HALF_FLOAT, GL_FALSE, stride, offsetof(PackedVertex, texCoord), 0 });
+    prim.attributes.push_back({ 3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offsetof(PackedVertex, normal), 0 });
+  } else {
+    prim.attributes.push_back({ 0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, position), 0 });
+    prim.attributes.push_back({ 1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, color), 0 });
+    prim.attributes.push_back({ 2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, texCoord), 0 });
+    prim.attributes.push_back({ 3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, normal), 0 });
+  }
+  SetupVertexArray(prim);
   prim.hasColorAttribute = true;
   prim.material = 0;
 
@@ -76,9 +211,110 @@ Primitive Buffer::CreatePrimitive(size_t count, GLenum type, size_t iOffset, siz
 }
 
 /**
-* bV`悷.
+* プリミティブのVAOを設定する.
+*
+* @param prim VAOを設定するプリミティブ.
+*
+* prim.attributes, prim.vertexRanges, prim.indexRangeの内容に従って頂点アトリビュートを設定する.
+* prim.vaoが作成済みの場合はそれを作り直すので、同じVAOを共有している全てのプリミティブに反映される.
+*/
+void Buffer::SetupVertexArray(Primitive& prim) const
+{
+  if (!prim.vao) {
+    prim.vao = std::make_shared<VertexArrayObject>();
+  }
+  const GLuint vboId = prim.vertexRanges.empty() ? 0 : vbo.Id(prim.vertexRanges[0].page);
+  prim.vao->Create(vboId, ibo.Id(prim.indexRange.page));
+  prim.vao->Bind();
+  for (const VertexAttribute& e : prim.attributes) {
+    const BufferRange& range = prim.vertexRanges[e.range];
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo.Id(range.page));
+    prim.vao->VertexAttribPointer(e.index, e.size, e.type, e.normalized, e.stride, range.offset + e.offset);
+  }
+  prim.vao->Unbind();
+}
+
+/**
+* プリミティブが使用しているバッファ領域を解放する.
+*
+* @param meshList 解放するプリミティブを含むメッシュデータ配列.
+*/
+void Buffer::FreePrimitives(std::vector<MeshData>& meshList)
+{
+  for (MeshData& mesh : meshList) {
+    for (Primitive& prim : mesh.primitives) {
+      ibo.Free(prim.indexRange);
+      for (const Primitive::Lod& e : prim.lods) {
+        ibo.Free(e.indexRange);
+      }
+      for (const BufferRange& e : prim.vertexRanges) {
+        vbo.Free(e);
+      }
+      prim.indexRange = BufferRange();
+      prim.lods.clear();
+      prim.vertexRanges.clear();
+      prim.vao.reset();
+    }
+  }
+}
+
+/**
+* 視点からの距離に応じたLODを選択する.
 *
-* OVAOoChĂ.
+* @param mesh     描画するメッシュデータ.
+* @param matVP    ビュー・プロジェクション行列.
+* @param matModel モデル行列.
+*
+* @return 選択したLOD番号(0が最も詳細).
+*
+* 透視投影では、クリップ座標のwが視点からの奥行きになる.
+*/
+int SelectLod(const MeshData& mesh, const glm::mat4& matVP, const glm::mat4& matModel)
+{
+  const float depth = (matVP * matModel[3]).w;
+  int lod = 0;
+  while (lod < static_cast<int>(mesh.lodDistances.size()) && depth >= mesh.lodDistances[lod]) {
+    ++lod;
+  }
+  return lod;
+}
+
+/**
+* プリミティブを描画する.
+*
+* @param prim 描画するプリミティブ.
+* @param lod  使用するLOD番号.
+*             プリミティブが持つLODより大きい場合は、最も簡略化されたLODを使う.
+*/
+void DrawElements(const Primitive& prim, int lod)
+{
+  if (lod <= 0 || prim.lods.empty()) {
+    glDrawElementsBaseVertex(prim.mode, prim.count, prim.type, prim.indices, prim.baseVertex);
+    return;
+  }
+  const Primitive::Lod& e = prim.lods[std::min<size_t>(lod, prim.lods.size()) - 1];
+  glDrawElementsBaseVertex(prim.mode, e.count, prim.type, e.indices, prim.baseVertex);
+}
+
+/**
+* プリミティブをインスタンシング描画する.
+*
+* @param prim          描画するプリミティブ.
+* @param lod           使用するLOD番号. DrawElements()と同じ.
+* @param instanceCount 描画するインスタンス数.
+*/
+void DrawElementsInstanced(const Primitive& prim, int lod, GLsizei instanceCount)
+{
+  if (lod <= 0 || prim.lods.empty()) {
+    glDrawElementsInstancedBaseVertex(prim.mode, prim.count, prim.type, prim.indices, instanceCount, prim.baseVertex);
+    return;
+  }
+  const Primitive::Lod& e = prim.lods[std::min<size_t>(lod, prim.lods.size()) - 1];
+  glDrawElementsInstancedBaseVertex(prim.mode, e.count, prim.type, e.indices, instanceCount, prim.baseVertex);
+}
+
+/**
+* メッシュを描画する.
 */
 void Mesh::Draw(const glm::mat4& matModel, const glm::vec4& color) const
 {
@@ -86,13 +322,17 @@ void Mesh::Draw(const glm::mat4& matModel, const glm::vec4& color) const
     return;
   }
 
-  // TODO: V[x̕`ɑΉ邱.
+  // TODO: シーンレベルの描画に対応すること.
   //std::vector<const Node*> meshNodes;
   //meshNodes.reserve(32);
   //GetMeshNodeList(node, meshNodes);
 
   const MeshData& meshData = file->meshes[meshNo];
-  GLuint prevTexId = 0;
+  int lod = 0;
+  if (!meshData.lodDistances.empty() && !file->materials.empty()) {
+    lod = SelectLod(meshData, file->materials[0].program->ViewProjectionMatrix(), matModel);
+  }
+  // バインドの解除は行わない. 同じVAOやテクスチャが続く場合、GLStateが再バインドを省略する.
   for (const auto& prim : meshData.primitives) {
     prim.vao->Bind();
     if (!prim.hasColorAttribute) {
@@ -104,54 +344,43 @@ void Mesh::Draw(const glm::mat4& matModel, const glm::vec4& color) const
       const Material& m = file->materials[prim.material];
       m.program->Use();
       m.program->SetModelMatrix(matModel);
-
       if (m.texture) {
-        const GLuint texId = m.texture->Id();
-        if (prevTexId != texId) {
-          m.texture->Bind(0);
-          prevTexId = texId;
-        }
+        m.texture->Bind(0);
       }
       m.program->SetModelColor(color);
     }
-    glDrawElementsBaseVertex(prim.mode, prim.count, prim.type, prim.indices, prim.baseVertex);
-    prim.vao->Unbind();
+    DrawElements(prim, lod);
   }
 }
 
 /**
-* bVobt@.
+* メッシュバッファを初期化する.
 *
-* @param vboSize VBÕoCgTCY.
-* @param iboSize IBÕoCgTCY.
+* @param vboSize VBOの1ページのバイトサイズ.
+* @param iboSize IBOの1ページのバイトサイズ.
 *
-* @retval true  .
-* @retval false s.
+* ページの容量を越えるデータを追加すると、新しいページが自動的に作成される.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
 */
 bool Buffer::Init(GLsizeiptr vboSize, GLsizeiptr iboSize, GLsizeiptr uboSize)
 {
-  if (!vbo.Create(GL_ARRAY_BUFFER, vboSize)) {
-    return false;
-  }
-  if (!ibo.Create(GL_ELEMENT_ARRAY_BUFFER, iboSize)) {
+  // 次に来るのがどのデータ型でも大丈夫なように4バイト境界に整列.
+  if (!vbo.Init(GL_ARRAY_BUFFER, vboSize, 4)) {
     return false;
   }
-  if (!vao.Create(vbo.Id(), ibo.Id())) {
+  if (!ibo.Init(GL_ELEMENT_ARRAY_BUFFER, iboSize, 4)) {
     return false;
   }
-  vao.Bind();
-  vao.VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, position));
-  vao.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, color));
-  vao.VertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, texCoord));
-  vao.VertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), offsetof(Vertex, normal));
-  vao.Unbind();
-  vboEnd = 0;
-  iboEnd = 0;
   meshes.reserve(100);
 
-  Shader::Cache& shaderCache = Shader::Cache::Instance();
-  progStaticMesh = shaderCache.Create("Res/Mesh.vert", "Res/Mesh.frag");
-  progSkeletalMesh = shaderCache.Create("Res/SkeletalMesh.vert", "Res/SkeletalMesh.frag");
+  const std::vector<Shader::ProgramPtr> programs = Shader::Cache::Instance().Create({
+    { "Res/Mesh.vert", "Res/Mesh.frag" },
+    { "Res/SkeletalMesh.vert", "Res/SkeletalMesh.frag" },
+  });
+  progStaticMesh = programs[0];
+  progSkeletalMesh = programs[1];
 
   GlobalSkeletalMeshState::BindUniformBlock(progSkeletalMesh);
 
@@ -159,46 +388,64 @@ bool Buffer::Init(GLsizeiptr vboSize, GLsizeiptr iboSize, GLsizeiptr uboSize)
 }
 
 /**
-* _f[^ǉ.
+* 頂点データを追加する.
 *
-* @param data ǉf[^̃|C^.
-* @param size ǉf[^̃oCg.
+* @param data 追加するデータのポインタ.
+* @param size 追加するデータのバイト数.
 *
-* @return f[^ǉʒu.
-*         _Agr[goffsetp[^ƂĎgƂł.
+* @return データを追加した領域.
+*         CreatePrimitive()の引数として使うことができる.
 */
-GLintptr Buffer::AddVertexData(const void* data, size_t size)
+BufferRange Buffer::AddVertexData(const void* data, size_t size)
 {
-  vbo.BufferSubData(vboEnd, size, data);
-  const GLintptr tmp = vboEnd;
-  vboEnd += size;
-  return tmp;
+  return vbo.Allocate(size, data);
 }
 
 /**
-* CfbNXf[^ǉ.
+* 頂点データを追加する.
 *
-* @param data ǉf[^̃|C^.
-* @param size ǉf[^̃oCg.
+* @param vertices 追加する頂点データ.
+* @param format   VBOに格納する形式.
+*                 VertexFormat::Staticの場合はPackedVertexに変換してから追加する.
+*                 VertexFormat::Skinnedは指定できない(VertexFormat::Standardとして扱う).
 *
-* @return f[^ǉʒu.
-*         v~eBuindicesp[^ƂĎgƂł.
+* @return データを追加した領域.
+*         CreatePrimitive()の引数として使うことができる.
 */
-GLintptr Buffer::AddIndexData(const void* data, size_t size)
+BufferRange Buffer::AddVertexData(const std::vector<Vertex>& vertices, VertexFormat format)
 {
-  ibo.BufferSubData(iboEnd, size, data);
-  const GLintptr tmp = iboEnd;
-  iboEnd += size;
-  return tmp;
+  if (format != VertexFormat::Static) {
+    return AddVertexData(vertices.data(), vertices.size() * sizeof(Vertex));
+  }
+  std::vector<PackedVertex> packedVertices;
+  packedVertices.reserve(vertices.size());
+  for (const Vertex& v : vertices) {
+    packedVertices.push_back(PackVertex(v));
+  }
+  return AddVertexData(packedVertices.data(), packedVertices.size() * sizeof(PackedVertex));
+}
+
+/**
+* インデックスデータを追加する.
+*
+* @param data 追加するデータのポインタ.
+* @param size 追加するデータのバイト数.
+*
+* @return データを追加した領域.
+*         CreatePrimitive()の引数として使うことができる.
+*/
+BufferRange Buffer::AddIndexData(const void* data, size_t size)
+{
+  return ibo.Allocate(size, data);
 }
 
 /**
-* }eA쐬.
+* マテリアルを作成する.
 *
-* @param color   }eÅ{F.
-* @param texture }eÃeNX`.
+* @param color   マテリアルの基本色.
+* @param texture マテリアルのテクスチャ.
 *
-* @return 쐬Material\.
+* @return 作成したMaterial構造体.
 */
 Material Buffer::CreateMaterial(const glm::vec4& color, Texture::Image2DPtr texture) const
 {
@@ -211,43 +458,44 @@ Material Buffer::CreateMaterial(const glm::vec4& color, Texture::Image2DPtr text
 }
 
 /**
-* bVǉ.
+* メッシュを追加する.
 *
-* @param data ǉ郁bVf[^.
+* @param data 追加するメッシュデータ.
 */
-void Buffer::AddMesh(const char* name, size_t count, GLenum type, size_t iOffset, size_t vOffset)
+void Buffer::AddMesh(const char* name, size_t count, GLenum type, const BufferRange& iRange, const BufferRange& vRange,
+  VertexFormat format)
 {
   FilePtr pFile = std::make_shared<File>();
   pFile->name = name;
 
   MeshData data;
   data.name = name;
-  data.primitives.push_back(CreatePrimitive(count, type, iOffset, vOffset));
+  data.primitives.push_back(CreatePrimitive(count, type, iRange, vRange, format));
   pFile->meshes.push_back(data);
 
   pFile->materials.push_back(CreateMaterial(glm::vec4(1), nullptr));
   if (files.find(name) != files.end()) {
-    std::cerr << "[x]" << __func__ << ": " << pFile->name << "ƂO͓o^ς݂ł.\n";
+    std::cerr << "[警告]" << __func__ << ": " << pFile->name << "という名前は登録済みです.\n";
   }
   files.insert(std::make_pair(pFile->name, pFile));
-  std::cout << "Mesh::Buffer: bV'" << name << "'ǉ.\n";
+  std::cout << "Mesh::Buffer: メッシュ'" << name << "'を追加.\n";
 }
 
 /**
-* bVǉ.
+* メッシュを追加する.
 *
-* @param name      bVyуt@C̖O.
-* @param primitive bVƂĒǉv~eBu.
-* @param material  v~eBup̃}eA.
+* @param name      メッシュ及びファイルの名前.
+* @param primitive メッシュとして追加するプリミティブ.
+* @param material  プリミティブ用のマテリアル.
 *
-* @retval true  ǉ.
-* @retval false ǉs(̃bVo^ς).
+* @retval true  追加成功.
+* @retval false 追加失敗(同名のメッシュが登録済み).
 */
 bool Buffer::AddMesh(const char* name, const Primitive& primitive, const Material& material)
 {
   if (files.find(name) != files.end()) {
-    std::cerr << "[x]" << __func__ << ": " << name <<
-      "ƂO͊ɒǉĂ܂.\n";
+    std::cerr << "[警告]" << __func__ << ": " << name <<
+      "という名前は既に追加されています.\n";
     return false;
   }
 
@@ -259,16 +507,16 @@ bool Buffer::AddMesh(const char* name, const Primitive& primitive, const Materia
   p->meshes[0].primitives.push_back(primitive);
 
   files.insert(std::make_pair(p->name, p));
-  std::cout << "[]" << __func__ << ": bV'" << name << "'ǉ.\n";
+  std::cout << "[情報]" << __func__ << ": メッシュ'" << name << "'を追加.\n";
   return true;
 }
 
 /**
-* bV擾.
+* メッシュを取得する.
 *
-* @param meshName 擾bV̖O.
+* @param meshName 取得したいメッシュの名前.
 *
-* @return meshNameƓObV.
+* @return meshNameと同じ名前を持つメッシュ.
 */
 MeshPtr Buffer::GetMesh(const char* meshName) const
 {
@@ -284,9 +532,9 @@ MeshPtr Buffer::GetMesh(const char* meshName) const
 }
 
 /**
-* ̂쐬.
+* 立方体を作成する.
 *
-* @param ̂̃bV.
+* @param 立方体のメッシュ名.
 */
 void Buffer::CreateCube(const char* name)
 {
@@ -325,17 +573,17 @@ void Buffer::CreateCube(const char* name)
       indices.push_back(static_cast<GLubyte>(baseIndices[i] + plane * 4));
     }
   }
-  const size_t vOffset = AddVertexData(vertices.data(), vertices.size() * sizeof(Vertex));
-  const size_t iOffset = AddIndexData(indices.data(), indices.size() * sizeof(GLubyte));
+  const BufferRange vRange = AddVertexData(vertices, VertexFormat::Static);
+  const BufferRange iRange = AddIndexData(indices.data(), indices.size() * sizeof(GLubyte));
 
-  AddMesh(name, indices.size(), GL_UNSIGNED_BYTE, iOffset, vOffset);
+  AddMesh(name, indices.size(), GL_UNSIGNED_BYTE, iRange, vRange, VertexFormat::Static);
 }
 
 /**
-* ~Ղ쐬.
+* 円盤を作成する.
 *
-* @param name     ~Ղ̃bV.
-* @param segments ~Ղ̉~̕.
+* @param name     円盤のメッシュ名.
+* @param segments 円盤の円周の分割数.
 */
 void Buffer::CreateCircle(const char* name, size_t segments)
 {
@@ -363,7 +611,6 @@ void Buffer::CreateCircle(const char* name, size_t segments)
     v.normal = glm::vec3(0, 1, 0);
     vertices.push_back(v);
   }
-  const size_t vOffset = AddVertexData(vertices.data(), vertices.size() * sizeof(Vertex));
 
   std::vector<GLubyte> indices;
   indices.reserve(segments * 3);
@@ -375,17 +622,22 @@ void Buffer::CreateCircle(const char* name, size_t segments)
   indices.push_back(0);
   indices.push_back(static_cast<GLubyte>(segments));
   indices.push_back(1);
-  const size_t iOffset = AddIndexData(indices.data(), indices.size() * sizeof(GLubyte));
 
-  AddMesh(name, indices.size(), GL_UNSIGNED_BYTE, iOffset, vOffset);
+  std::vector<GLuint> tmp(indices.begin(), indices.end());
+  PrintStatistics(name, OptimizeMesh(vertices, tmp, optimizeOverdraw));
+  indices.assign(tmp.begin(), tmp.end());
+  const BufferRange vRange = AddVertexData(vertices, VertexFormat::Static);
+  const BufferRange iRange = AddIndexData(indices.data(), indices.size() * sizeof(GLubyte));
+
+  AddMesh(name, indices.size(), GL_UNSIGNED_BYTE, iRange, vRange, VertexFormat::Static);
 }
 
 /**
-* 쐬.
+* 球を作成する.
 *
-* @param name     ̃bV.
-* @param segments ̉~̕.
-* @param rings    ̐̕.
+* @param name     球のメッシュ名.
+* @param segments 球の円周の分割数.
+* @param rings    球の垂直方向の分割数.
 */
 void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
 {
@@ -396,7 +648,7 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
   std::vector<Vertex> vertices;
   vertices.reserve(segments * (rings - 1) + 2);
 
-  // ԏ̒_.
+  // 一番上の頂点.
   Vertex center;
   center.position = glm::vec3(0, 1, 0);
   center.color = glm::vec4(1);
@@ -404,7 +656,7 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
   center.normal = glm::vec3(0, 1, 0);
   vertices.push_back(center);
 
-  // ԕ̒_.
+  // 中間部の頂点.
   for (size_t ring = 1; ring < rings; ++ring) {
     const float ringAngle = static_cast<float>(ring) / static_cast<float>(rings) * glm::pi<float>();
     const glm::mat4 matRing = glm::rotate(glm::mat4(1), ringAngle, glm::vec3(1, 0, 0));
@@ -420,12 +672,11 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
       vertices.push_back(v);
     }
   }
-  // ԉ̒_.
+  // 一番下の頂点.
   center.position = glm::vec3(0, -1, 0);
   center.texCoord = glm::vec2(0.5f, 0.0f);
   center.normal = glm::vec3(0, -1, 0);
   vertices.push_back(center);
-  const size_t vOffset = AddVertexData(vertices.data(), vertices.size() * sizeof(Vertex));
 
   std::vector<GLushort> indices;
   const size_t indexCountOfTopCone = segments * 3;
@@ -433,7 +684,7 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
   const size_t indexCountOfBottomCone = segments * 3;
   indices.reserve(indexCountOfTopCone + indexCountOfCenterRing + indexCountOfBottomCone);
 
-  // 㕔̉~.
+  // 上部の円錐.
   for (GLushort i = 0; i < segments - 1; ++i) {
     indices.push_back(0);
     indices.push_back(i + 1);
@@ -443,7 +694,7 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
   indices.push_back(static_cast<GLushort>(segments));
   indices.push_back(1);
 
-  // ԕ̃O.
+  // 中間部のリング.
   for (size_t ring = 1; ring < rings - 1; ++ring) {
     const GLushort upperBaseIndex = static_cast<GLushort>(segments * (ring - 1) + 1);
     const GLushort lowerBaseIndex = static_cast<GLushort>(segments * ring + 1);
@@ -464,7 +715,7 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
     indices.push_back(offset + upperBaseIndex);
   }
 
-  // ̉~.
+  // 下部の円錐.
   const GLushort bottomIndex = static_cast<GLushort>(segments * (rings - 1) + 1);
   const GLushort baseIndex = static_cast<GLushort>(segments * (rings - 2) + 1);
   for (GLushort i = 0; i < segments - 1; ++i) {
@@ -476,36 +727,24 @@ void Buffer::CreateSphere(const char* name, size_t segments, size_t rings)
   indices.push_back(baseIndex);
   indices.push_back(bottomIndex - 1);
 
-  const size_t iOffset = AddIndexData(indices.data(), indices.size() * sizeof(GLushort));
-
-  AddMesh(name, indices.size(), GL_UNSIGNED_SHORT, iOffset, vOffset);
-}
-
-/**
-* bVpVAOoCh.
-*/
-void Buffer::Bind()
-{
-  vao.Bind();
-}
+  std::vector<GLuint> tmp(indices.begin(), indices.end());
+  PrintStatistics(name, OptimizeMesh(vertices, tmp, optimizeOverdraw));
+  indices.assign(tmp.begin(), tmp.end());
+  const BufferRange vRange = AddVertexData(vertices, VertexFormat::Static);
+  const BufferRange iRange = AddIndexData(indices.data(), indices.size() * sizeof(GLushort));
 
-/**
-* bVpVAÕoCh.
-*/
-void Buffer::Unbind()
-{
-  vao.Unbind();
+  AddMesh(name, indices.size(), GL_UNSIGNED_SHORT, iRange, vRange, VertexFormat::Static);
 }
 
 /**
-* ANZbTw肷oCif[^̈ʒuƃoCg擾.
+* アクセッサが指定するバイナリデータの位置とバイト数を取得する.
 *
-* @param accessor    glTFANZbT
-* @param bufferViews oCif[^𕪊Ǘ邽߂̃f[^z.
-* @param binFiles    oCit@C̔z.
-* @param pp          擾oCif[^̈ʒu.
-* @param pLength     擾oCif[^̃oCg.
-* @param pStride     擾oCif[^̃f[^(_f[^̒`Ŏgp).
+* @param accessor    glTFアクセッサ
+* @param bufferViews バイナリデータを分割管理するためのデータ配列.
+* @param binFiles    バイナリファイルの配列.
+* @param pp          取得したバイナリデータの位置.
+* @param pLength     取得したバイナリデータのバイト数.
+* @param pStride     取得したバイナリデータのデータ幅(頂点データの定義で使用).
 */
 void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles, const void** pp, size_t* pLength, int* pStride = nullptr)
 {
@@ -516,20 +755,7 @@ void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, co
   const int baesByteOffset = bufferView["byteOffset"].int_value();
   int byteLength = bufferView["byteLength"].int_value();
   if (!accessor["count"].is_null()) {
-    int unitByteSize;
-    switch (accessor["componentType"].int_value()) {
-    case GL_BYTE:
-    case GL_UNSIGNED_BYTE:
-      unitByteSize = 1;
-      break;
-    case GL_SHORT:
-    case GL_UNSIGNED_SHORT:
-      unitByteSize = 2;
-      break;
-    default:
-      unitByteSize = 4;
-      break;
-    }
+    const int unitByteSize = ComponentSize(accessor["componentType"].int_value());
     const std::string& type = accessor["type"].string_value();
     static const char* const typeNameList[] = { "SCALAR", "VEC2", "VEC3", "VEC4", "MAT4" };
     static const int typeSizeList[] = { 1, 2, 3, 4, 16 };
@@ -541,7 +767,7 @@ void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, co
       }
     }
     if (typeSize < 0) {
-      std::cerr << "ERROR in GetBuffer: ANZŤ^(" << type << ")ɂ͑ΉĂ܂.\n";
+      std::cerr << "ERROR in GetBuffer: アクセサの型(" << type << ")には対応していません.\n";
       byteLength = 0;
     } else {
       byteLength = std::min(byteLength, accessor["count"].int_value() * unitByteSize * typeSize);
@@ -557,19 +783,220 @@ void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, co
 }
 
 /**
-* _ݒ肷.
+* インデックスデータを設定する.
+*
+* @param prim        インデックスデータを設定するプリミティブ.
+* @param primitive   glTFのプリミティブ.
+* @param accessors   アクセッサ配列.
+* @param bufferViews バッファ・ビュー配列.
+* @param binFiles    バイナリデータ配列.
+* @param remap       頂点の並べ替え表を格納する配列.
+*                    SetAttribute()に渡して、頂点データを同じ順序に並べ替えること.
+*                    並べ替えが不要な場合は空になる.
+* @param stats       最適化の統計情報を加算する変数.
 *
-* @param prim        _f[^ݒ肷v~eBu.
-* @param index       ݒ肷钸_̃CfbNX.
-* @param accessor    _f[^̊i[.
-* @param bufferViews _f[^QƂ邽߂̃obt@Er[z.
-* @param binFiles    _f[^i[ĂoCif[^z.
+* @retval true  設定成功.
+* @retval false 設定失敗.
 *
-* @retval true  ݒ萬.
-* @retval false ݒ莸s.
+* 三角形リストの場合、頂点キャッシュ、オーバードロー、頂点フェッチの順に最適化してから転送する.
+* さらに、lodSettingsに従って簡略化したインデックスデータを作成し、prim.lodsに設定する.
+* スケルタルメッシュの場合は、事前にprim.vertexFormatをVertexFormat::Skinnedに設定しておくこと.
+*/
+bool Buffer::SetIndices(Primitive& prim, const json11::Json& primitive, const json11::Json& accessors,
+  const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles,
+  std::vector<GLuint>& remap, OptimizationStatistics& stats)
+{
+  const json11::Json& accessor = accessors[primitive["indices"].int_value()];
+  if (accessor["type"].string_value() != "SCALAR") {
+    std::cerr << "ERROR: インデックスデータ・タイプはSCALARでなくてはなりません \n";
+    std::cerr << "  type = " << accessor["type"].string_value() << "\n";
+    return false;
+  }
+
+  prim.mode = primitive["mode"].is_null() ? GL_TRIANGLES : primitive["mode"].int_value();
+  prim.count = accessor["count"].int_value();
+  prim.type = accessor["componentType"].int_value();
+
+  const void* p;
+  size_t byteLength;
+  GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
+
+  remap.clear();
+  prim.lods.clear();
+  std::vector<char> optimized;
+  std::vector<std::vector<char>> lodIndices;
+  const json11::Json& attributes = primitive["attributes"];
+  const json11::Json& positionAccessor = accessors[attributes["POSITION"].int_value()];
+  const size_t vertexCount = positionAccessor["count"].int_value();
+  const GLsizei indexSize = ComponentSize(prim.type);
+
+  // インデックスを元の型のバイト列に戻す. 頂点数は減ることはあっても増えることはないので、必ず元の型に収まる.
+  const auto toBytes = [indexSize](const std::vector<GLuint>& indices) {
+    std::vector<char> bytes(indices.size() * indexSize);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      if (indexSize == 1) {
+        bytes[i] = static_cast<char>(indices[i]);
+      } else if (indexSize == 2) {
+        const GLushort v = static_cast<GLushort>(indices[i]);
+        memcpy(&bytes[i * 2], &v, 2);
+      } else {
+        memcpy(&bytes[i * 4], &indices[i], 4);
+      }
+    }
+    return bytes;
+  };
+
+  // 頂点属性(VEC3またはVEC4)を読み出す.
+  const auto readAttribute = [&](const json11::Json& accessor) {
+    const void* pData;
+    size_t dataLength;
+    int stride;
+    GetBuffer(accessor, bufferViews, binFiles, &pData, &dataLength, &stride);
+    const GLenum type = accessor["componentType"].int_value();
+    const bool normalized = accessor["normalized"].bool_value();
+    const int size = accessor["type"].string_value() == "VEC4" ? 4 : 3;
+    const GLsizei componentSize = ComponentSize(type);
+    if (stride <= 0) {
+      stride = componentSize * size;
+    }
+    std::vector<glm::vec4> result(accessor["count"].int_value(), glm::vec4(0));
+    for (size_t i = 0; i < result.size(); ++i) {
+      for (int c = 0; c < size; ++c) {
+        result[i][c] = ReadComponent(static_cast<const char*>(pData) + i * stride + c * componentSize, type, normalized);
+      }
+    }
+    return result;
+  };
+
+  if (prim.mode == GL_TRIANGLES && prim.count % 3 == 0 && byteLength >= static_cast<size_t>(prim.count * indexSize)) {
+    std::vector<GLuint> indices(prim.count);
+    bool isValid = true;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = static_cast<GLuint>(ReadComponent(static_cast<const char*>(p) + i * indexSize, prim.type, false));
+      isValid &= indices[i] < vertexCount;
+    }
+    if (isValid) {
+      std::vector<glm::vec3> positions;
+      if (positionAccessor["componentType"].int_value() == GL_FLOAT) {
+        const std::vector<glm::vec4> tmp = readAttribute(positionAccessor);
+        positions.reserve(tmp.size());
+        for (const glm::vec4& e : tmp) {
+          positions.push_back(glm::vec3(e));
+        }
+      }
+
+      OptimizationStatistics s;
+      s.triangleCount = indices.size() / 3;
+      s.transformCountBefore = CountVertexTransforms(indices, vertexCount);
+      OptimizeVertexCache(indices, vertexCount);
+      if (optimizeOverdraw && !positions.empty()) {
+        OptimizeOverdraw(indices, positions);
+      }
+      const size_t newVertexCount = OptimizeVertexFetch(indices, vertexCount, remap);
+      s.transformCountAfter = CountVertexTransforms(indices, newVertexCount);
+      optimized = toBytes(indices);
+      p = optimized.data();
+      byteLength = optimized.size();
+
+      // LODを生成.
+      if (!positions.empty() && !lodSettings.empty()) {
+        std::vector<glm::vec3> newPositions(newVertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) {
+          if (remap[i] != 0xffffffff) {
+            newPositions[remap[i]] = positions[i];
+          }
+        }
+
+        // スケルタルメッシュは、影響の最も大きいジョイントが異なる頂点同士を結合しないようにする.
+        std::vector<int> groups;
+        const json11::Json& jointsAccessor = attributes["JOINTS_0"].is_null() ? json11::Json() : accessors[attributes["JOINTS_0"].int_value()];
+        const json11::Json& weightsAccessor = attributes["WEIGHTS_0"].is_null() ? json11::Json() : accessors[attributes["WEIGHTS_0"].int_value()];
+        if (prim.vertexFormat == VertexFormat::Skinned && jointsAccessor.is_object() && weightsAccessor.is_object()) {
+          const std::vector<glm::vec4> jointsList = readAttribute(jointsAccessor);
+          const std::vector<glm::vec4> weightsList = readAttribute(weightsAccessor);
+          groups.resize(newVertexCount, -1);
+          for (size_t i = 0; i < std::min(vertexCount, std::min(jointsList.size(), weightsList.size())); ++i) {
+            if (remap[i] == 0xffffffff) {
+              continue;
+            }
+            const glm::vec4& joints = jointsList[i];
+            const glm::vec4& weights = weightsList[i];
+            int dominant = 0;
+            for (int c = 1; c < 4; ++c) {
+              if (weights[c] > weights[dominant]) {
+                dominant = c;
+              }
+            }
+            groups[remap[i]] = static_cast<int>(joints[dominant]);
+          }
+        }
+
+        size_t prevCount = indices.size();
+        for (const LodSetting& e : lodSettings) {
+          const size_t targetCount = static_cast<size_t>(static_cast<float>(indices.size()) * e.ratio);
+          std::vector<GLuint> lod = SimplifyMesh(indices, newPositions, targetCount, e.maxError,
+            groups.empty() ? nullptr : &groups);
+          if (lod.empty() || lod.size() >= prevCount * 9 / 10) {
+            break; // ほとんど減らせなければ、それ以上のLODは作らない.
+          }
+          OptimizeVertexCache(lod, newVertexCount);
+          prevCount = lod.size();
+          lodIndices.push_back(toBytes(lod));
+          s.lodTriangleCount.push_back(lod.size() / 3);
+        }
+        // 作成できなかったLODは最後のLODの三角形数で埋める.
+        while (s.lodTriangleCount.size() < lodSettings.size()) {
+          s.lodTriangleCount.push_back(prevCount / 3);
+        }
+      }
+      stats += s;
+    }
+  }
+
+  prim.indexRange = ibo.Allocate(byteLength, p);
+  if (prim.indexRange.IsNull()) {
+    std::cerr << "[エラー]" << __func__ << ": インデックスデータ用の領域を確保できません.\n";
+    return false;
+  }
+  prim.indices = reinterpret_cast<const GLvoid*>(prim.indexRange.offset);
+
+  for (const std::vector<char>& e : lodIndices) {
+    Primitive::Lod lod;
+    lod.count = static_cast<GLsizei>(e.size() / indexSize);
+    lod.indexRange = ibo.Allocate(e.size(), e.data());
+    if (lod.indexRange.IsNull()) {
+      break;
+    }
+    lod.indices = reinterpret_cast<const GLvoid*>(lod.indexRange.offset);
+    prim.lods.push_back(lod);
+  }
+  return true;
+}
+
+/**
+* 頂点属性を設定する.
+*
+* @param prim        頂点データを設定するプリミティブ.
+* @param index       設定する頂点属性のインデックス.
+* @param accessor    頂点データの格納情報.
+* @param bufferViews 頂点データを参照するためのバッファ・ビュー配列.
+* @param binFiles    頂点データを格納しているバイナリデータ配列.
+* @param remap       SetIndices()で作成した頂点の並べ替え表.
+*                    空の場合は並べ替えない.
+*
+* @retval true  設定成功.
+* @retval false 設定失敗.
+*
+* prim.vertexFormatが圧縮形式の場合、変換可能な頂点属性は以下のように変換してから転送する.
+* - 色(1番):             unorm8 x 4.
+* - テクスチャ座標(2番): half x 2. ただし、値の範囲が[-2, 2]を越える場合は精度が足りないので変換しない.
+* - 法線(3番):           10-10-10-2.
+* - ウェイト(4番):       unorm8 x 4. VertexFormat::Skinnedの場合のみ.
+* - ジョイント番号(5番): ubyte x 4. VertexFormat::Skinnedの場合のみ. 256以上の番号を含む場合は変換しない.
 */
 bool Buffer::SetAttribute(
-  Primitive& prim, int index, const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles)
+  Primitive& prim, int index, const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles,
+  const std::vector<GLuint>& remap)
 {
   if (accessor.is_null()) {
     return true;
@@ -585,7 +1012,7 @@ bool Buffer::SetAttribute(
     }
   }
   if (size < 0) {
-    std::cerr << "[G[]" << __func__ << ": " << type << "͒_ɐݒł܂.\n";
+    std::cerr << "[エラー]" << __func__ << ": " << type << "は頂点属性に設定できません.\n";
     return false;
   }
 
@@ -594,12 +1021,122 @@ bool Buffer::SetAttribute(
   int byteStride;
   GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength, &byteStride);
   const GLenum componentType = accessor["componentType"].int_value();
-  prim.vao->Bind();
-  prim.vao->VertexAttribPointer(index, size, componentType, GL_FALSE, byteStride, vboEnd);
-  prim.vao->Unbind();
+  const bool normalized = accessor["normalized"].bool_value();
+  size_t count = accessor["count"].int_value();
+
+  // 頂点フェッチが局所化されるように並べ替える.
+  std::vector<char> reordered;
+  if (!remap.empty()) {
+    const size_t elementSize = ComponentSize(componentType) * size;
+    const size_t srcStride = byteStride > 0 ? byteStride : elementSize;
+    size_t newCount = 0;
+    for (const GLuint e : remap) {
+      if (e != 0xffffffff) {
+        newCount = std::max<size_t>(newCount, e + 1);
+      }
+    }
+    reordered.resize(newCount * elementSize);
+    const char* const src = static_cast<const char*>(p);
+    for (size_t i = 0; i < std::min(count, remap.size()); ++i) {
+      if (remap[i] != 0xffffffff) {
+        memcpy(&reordered[remap[i] * elementSize], src + i * srcStride, elementSize);
+      }
+    }
+    p = reordered.data();
+    byteLength = reordered.size();
+    byteStride = 0;
+    count = newCount;
+  }
+
+  VertexAttribute attr;
+  attr.index = index;
+  attr.size = size;
+  attr.type = componentType;
+  attr.normalized = normalized ? GL_TRUE : GL_FALSE;
+  attr.stride = byteStride;
+  attr.offset = 0;
+  attr.range = prim.vertexRanges.size();
+
+  // 圧縮形式に変換する.
+  // 変換後はどの頂点属性も1頂点あたり4バイトになる.
+  std::vector<GLuint> packed;
+  if (prim.vertexFormat != VertexFormat::Standard) {
+    const GLsizei componentSize = ComponentSize(componentType);
+    const size_t stride = byteStride > 0 ? byteStride : componentSize * size;
+    const char* const src = static_cast<const char*>(p);
+    const auto read = [&](size_t i) {
+      glm::vec4 v(0, 0, 0, 1);
+      for (int c = 0; c < size; ++c) {
+        v[c] = ReadComponent(src + i * stride + c * componentSize, componentType, normalized);
+      }
+      return v;
+    };
+    const bool isSkinned = prim.vertexFormat == VertexFormat::Skinned;
+
+    if (index == 1 && size >= 3 && componentType != GL_UNSIGNED_BYTE) {
+      packed.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        packed[i] = glm::packUnorm4x8(glm::clamp(read(i), 0.0f, 1.0f));
+      }
+      attr.size = 4;
+      attr.type = GL_UNSIGNED_BYTE;
+      attr.normalized = GL_TRUE;
+    } else if (index == 2 && size == 2 && componentType == GL_FLOAT) {
+      bool inRange = true;
+      for (size_t i = 0; i < count && inRange; ++i) {
+        const glm::vec4 v = read(i);
+        inRange = std::abs(v.x) <= 2.0f && std::abs(v.y) <= 2.0f;
+      }
+      if (inRange) {
+        packed.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+          packed[i] = glm::packHalf2x16(glm::vec2(read(i)));
+        }
+        attr.type = GL_HALF_FLOAT;
+        attr.normalized = GL_FALSE;
+      }
+    } else if (index == 3 && size == 3) {
+      packed.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        packed[i] = glm::packSnorm3x10_1x2(glm::vec4(glm::vec3(read(i)), 0));
+      }
+      attr.size = 4;
+      attr.type = GL_INT_2_10_10_10_REV;
+      attr.normalized = GL_TRUE;
+    } else if (index == 4 && isSkinned && size == 4 && componentType != GL_UNSIGNED_BYTE) {
+      packed.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        packed[i] = PackWeights(read(i));
+      }
+      attr.type = GL_UNSIGNED_BYTE;
+      attr.normalized = GL_TRUE;
+    } else if (index == 5 && isSkinned && size == 4 && componentType != GL_UNSIGNED_BYTE) {
+      packed.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        const glm::vec4 v = read(i);
+        if (v.x > 255 || v.y > 255 || v.z > 255 || v.w > 255) {
+          packed.clear();
+          break;
+        }
+        packed[i] = static_cast<GLuint>(v.x) | (static_cast<GLuint>(v.y) << 8) |
+          (static_cast<GLuint>(v.z) << 16) | (static_cast<GLuint>(v.w) << 24);
+      }
+      attr.type = packed.empty() ? componentType : GL_UNSIGNED_BYTE;
+    }
+    if (!packed.empty()) {
+      p = packed.data();
+      byteLength = packed.size() * sizeof(GLuint);
+      attr.stride = 0;
+    }
+  }
 
-  vbo.BufferSubData(vboEnd, byteLength, p);
-  vboEnd += ((byteLength + 3) / 4) * 4; // 4oCgEɐ.
+  const BufferRange range = vbo.Allocate(byteLength, p);
+  if (range.IsNull()) {
+    std::cerr << "[エラー]" << __func__ << ": 頂点データ用の領域を確保できません.\n";
+    return false;
+  }
+  prim.attributes.push_back(attr);
+  prim.vertexRanges.push_back(range);
 
   return true;
 }
@@ -609,28 +1146,33 @@ bool Buffer::SetAttribute(
 */
 bool Buffer::LoadMesh(const char* path)
 {
-  // gltft@Cǂݍ.
+  if (files.find(path) != files.end()) {
+    std::cout << "[情報]" << __func__ << ": '" << path << "'は読み込み済みです.\n";
+    return true;
+  }
+
+  // gltfファイルを読み込む.
   std::vector<char> gltfFile = ReadFromFile(path);
   if (gltfFile.empty()) {
     return false;
   }
   gltfFile.push_back('\0');
 
-  // json.
+  // json解析.
   std::string err;
   const json11::Json json = json11::Json::parse(gltfFile.data(), err);
   if (!err.empty()) {
-    std::cerr << "ERROR: " << path << "̓ǂݍ݂Ɏs܂.\n";
+    std::cerr << "ERROR: " << path << "の読み込みに失敗しました.\n";
     std::cerr << err << "\n";
     return false;
   }
 
-  // oCit@Cǂݍ.
+  // バイナリファイルを読み込む.
   std::vector<std::vector<char>> binFiles;
   for (const json11::Json& e : json["buffers"].array_items()) {
     const json11::Json& uri = e["uri"];
     if (!uri.is_string()) {
-      std::cerr << "[G[]" << __func__ << ": " << path << "ɕsuri܂.\n";
+      std::cerr << "[エラー]" << __func__ << ": " << path << "に不正なuriがあります.\n";
       return false;
     }
     const std::string binPath = std::string("Res/") + uri.string_value();
@@ -643,60 +1185,71 @@ bool Buffer::LoadMesh(const char* path)
   FilePtr pFile = std::make_shared<File>();
   File& file = *pFile;
 
-  // ANZbTf[^擾GPU֓].
+  // アクセッサからデータを取得してGPUへ転送.
   const json11::Json& accessors = json["accessors"];
   const json11::Json& bufferViews = json["bufferViews"];
 
-  // CfbNXf[^ƒ_f[^̃ANZbTID擾.
+  // インデックスデータと頂点属性データのアクセッサIDを取得.
+  OptimizationStatistics stats;
   file.meshes.reserve(json["meshes"].array_items().size());
   for (const auto& currentMesh : json["meshes"].array_items()) {
     MeshData mesh;
     mesh.name = currentMesh["name"].string_value();
     const std::vector<json11::Json>& primitives = currentMesh["primitives"].array_items();
     mesh.primitives.resize(primitives.size());
+    size_t lodCount = 0;
     for (size_t primId = 0; primId < primitives.size(); ++primId) {
       const json11::Json& primitive = currentMesh["primitives"][primId];
 
-      // _CfbNX.
-      {
-        const int accessorId_index = primitive["indices"].int_value();
-        const json11::Json& accessor = accessors[accessorId_index];
-        if (accessor["type"].string_value() != "SCALAR") {
-          std::cerr << "ERROR: CfbNXf[^E^CvSCALARłȂĂ͂Ȃ܂ \n";
-          std::cerr << "  type = " << accessor["type"].string_value() << "\n";
-          return false;
-        }
-
-        mesh.primitives[primId].mode = primitive["mode"].is_null() ? GL_TRIANGLES : primitive["mode"].int_value();
-        mesh.primitives[primId].count = accessor["count"].int_value();
-        mesh.primitives[primId].type = accessor["componentType"].int_value();
-        mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(iboEnd);
-
-        const void* p;
-        size_t byteLength;
-        GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
-        ibo.BufferSubData(iboEnd, byteLength, p);
-        iboEnd += ((byteLength + 3) / 4) * 4; // ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ.
+      // 頂点インデックス.
+      mesh.primitives[primId].vertexFormat = VertexFormat::Static;
+      std::vector<GLuint> remap;
+      if (!SetIndices(mesh.primitives[primId], primitive, accessors, bufferViews, binFiles, remap, stats)) {
+        file.meshes.push_back(mesh);
+        FreePrimitives(file.meshes);
+        return false;
       }
 
-      // _.
+      // 頂点属性.
       const json11::Json& attributes = primitive["attributes"];
       const int accessorId_position = attributes["POSITION"].int_value();
       const int accessorId_normal = attributes["NORMAL"].is_null() ? -1 : attributes["NORMAL"].int_value();
       const int accessorId_texcoord = attributes["TEXCOORD_0"].is_null() ? -1 : attributes["TEXCOORD_0"].int_value();
 
-      mesh.primitives[primId].vao = std::make_shared<VertexArrayObject>();
-      mesh.primitives[primId].vao->Create(vbo.Id(), ibo.Id());
-      SetAttribute(mesh.primitives[primId], 0, accessors[accessorId_position], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 2, accessors[accessorId_texcoord], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 3, accessors[accessorId_normal], bufferViews, binFiles);
+      SetAttribute(mesh.primitives[primId], 0, accessors[accessorId_position], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 2, accessors[accessorId_texcoord], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 3, accessors[accessorId_normal], bufferViews, binFiles, remap);
+
+      SetupVertexArray(mesh.primitives[primId]);
 
       mesh.primitives[primId].material = primitive["material"].int_value();
+      lodCount = std::max(lodCount, mesh.primitives[primId].lods.size());
+
+      // 境界ボックス. glTFではPOSITIONアクセッサのminとmaxは必須.
+      const std::vector<json11::Json>& minValues = accessors[accessorId_position]["min"].array_items();
+      const std::vector<json11::Json>& maxValues = accessors[accessorId_position]["max"].array_items();
+      if (minValues.size() >= 3 && maxValues.size() >= 3) {
+        glm::vec3 primMin, primMax;
+        for (int i = 0; i < 3; ++i) {
+          primMin[i] = static_cast<float>(minValues[i].number_value());
+          primMax[i] = static_cast<float>(maxValues[i].number_value());
+        }
+        if (primId == 0) {
+          mesh.boundsMin = primMin;
+          mesh.boundsMax = primMax;
+        } else {
+          mesh.boundsMin = glm::min(mesh.boundsMin, primMin);
+          mesh.boundsMax = glm::max(mesh.boundsMax, primMax);
+        }
+      }
+    }
+    for (size_t i = 0; i < lodCount; ++i) {
+      mesh.lodDistances.push_back(lodSettings[i].distance);
     }
     file.meshes.push_back(mesh);
   }
 
-  // }eA.
+  // マテリアル.
   {
     const std::vector<json11::Json> materials = json["materials"].array_items();
     file.materials.reserve(materials.size());
@@ -722,7 +1275,7 @@ bool Buffer::LoadMesh(const char* path)
       }
       Texture::Image2DPtr tex;
       if (!texturePath.empty()) {
-        tex = Texture::Image2D::Create(texturePath.c_str());
+        tex = Texture::Cache::Instance().Create(texturePath.c_str(), true);
       }
       file.materials.push_back(CreateMaterial(col, tex));
     }
@@ -730,20 +1283,170 @@ bool Buffer::LoadMesh(const char* path)
 
   file.name = path;
   files.insert(std::make_pair(file.name, pFile));
-  std::cout << "[INFO]" << __func__ << ": '" << path << "'ǂݍ݂܂.\n";
+  std::cout << "[INFO]" << __func__ << ": '" << path << "'を読み込みました.\n";
   for (size_t i = 0; i < file.meshes.size(); ++i) {
     std::cout << "  mesh[" << i << "] = " << file.meshes[i].name << "\n";
   }
+  PrintStatistics(path, stats);
 
   return true;
 }
 
 /**
-* VF[_Ƀr[EvWFNVsݒ肷.
+* メッシュを破棄する.
+*
+* @param name AddMesh()やCreateCube()などで追加したメッシュの名前.
+*
+* @retval true  破棄成功.
+* @retval false 破棄失敗(メッシュが存在しない、またはまだ使用中).
+*
+* LoadMesh()で読み込んだファイルに含まれるメッシュは個別に破棄できない. UnloadFile()を使うこと.
+*/
+bool Buffer::UnloadMesh(const char* name)
+{
+  const auto itr = files.find(name);
+  if (itr == files.end() || itr->second->meshes.size() != 1 || itr->second->meshes[0].name != name) {
+    std::cerr << "[警告]" << __func__ << ": メッシュ'" << name << "'は登録されていません.\n";
+    return false;
+  }
+  return UnloadFile(name);
+}
+
+/**
+* ファイルを破棄する.
+*
+* @param path LoadMesh()またはLoadSkeletalMesh()で読み込んだファイル名.
+*
+* @retval true  破棄成功.
+* @retval false 破棄失敗(ファイルが存在しない、またはまだ使用中).
+*
+* ファイルに含まれる全てのメッシュについて、頂点データとインデックスデータの領域を解放する.
+* GetMesh()やGetSkeletalMesh()で取得したメッシュが残っている場合は破棄できない.
+*/
+bool Buffer::UnloadFile(const char* path)
+{
+  const auto itrFile = files.find(path);
+  if (itrFile != files.end()) {
+    if (itrFile->second.use_count() > 1) {
+      std::cerr << "[警告]" << __func__ << ": '" << path << "'はまだ使用中のため破棄できません(参照数=" <<
+        itrFile->second.use_count() - 1 << ").\n";
+      return false;
+    }
+    FreePrimitives(itrFile->second->meshes);
+    files.erase(itrFile);
+    std::cout << "[情報]" << __func__ << ": '" << path << "'を破棄しました.\n";
+    return true;
+  }
+
+  const auto itrExtendedFile = extendedFiles.find(path);
+  if (itrExtendedFile != extendedFiles.end()) {
+    // meshesが保持している参照は数に入れない.
+    long useCount = itrExtendedFile->second.use_count() - 1;
+    for (const auto& e : meshes) {
+      if (e.second.file == itrExtendedFile->second) {
+        --useCount;
+      }
+    }
+    if (useCount > 0) {
+      std::cerr << "[警告]" << __func__ << ": '" << path << "'はまだ使用中のため破棄できません(参照数=" <<
+        useCount << ").\n";
+      return false;
+    }
+    for (auto itr = meshes.begin(); itr != meshes.end();) {
+      if (itr->second.file == itrExtendedFile->second) {
+        itr = meshes.erase(itr);
+      } else {
+        ++itr;
+      }
+    }
+    FreePrimitives(itrExtendedFile->second->meshes);
+    extendedFiles.erase(itrExtendedFile);
+    std::cout << "[情報]" << __func__ << ": '" << path << "'を破棄しました.\n";
+    return true;
+  }
+
+  std::cerr << "[警告]" << __func__ << ": '" << path << "'は読み込まれていません.\n";
+  return false;
+}
+
+/**
+* VBOとIBOの断片化を解消する.
+*
+* 使用中の領域を各ページの先頭に詰め直し、全てのプリミティブのオフセットとVAOを更新する.
+* 空になったページは解放される.
+* GPUへのコピーとVAOの再作成を伴うため、シーンの切り替え時など描画していないときに実行すること.
+*/
+void Buffer::Defragment()
+{
+  const std::vector<BufferAllocator::Relocation> vboRelocations = vbo.Defragment();
+  const std::vector<BufferAllocator::Relocation> iboRelocations = ibo.Defragment();
+  if (vboRelocations.empty() && iboRelocations.empty()) {
+    return;
+  }
+
+  const auto relocate = [](BufferRange& range, const std::vector<BufferAllocator::Relocation>& list) {
+    for (const auto& e : list) {
+      if (e.page == range.page && e.oldOffset == range.offset) {
+        range.offset = e.newOffset;
+        return true;
+      }
+    }
+    return false;
+  };
+  const auto update = [&](std::vector<MeshData>& meshList) {
+    for (MeshData& mesh : meshList) {
+      for (Primitive& prim : mesh.primitives) {
+        bool moved = relocate(prim.indexRange, iboRelocations);
+        prim.indices = reinterpret_cast<const GLvoid*>(prim.indexRange.offset);
+        for (Primitive::Lod& e : prim.lods) {
+          relocate(e.indexRange, iboRelocations);
+          e.indices = reinterpret_cast<const GLvoid*>(e.indexRange.offset);
+        }
+        for (BufferRange& e : prim.vertexRanges) {
+          moved |= relocate(e, vboRelocations);
+        }
+        if (moved) {
+          SetupVertexArray(prim);
+        }
+      }
+    }
+  };
+  for (auto& e : files) {
+    update(e.second->meshes);
+  }
+  for (auto& e : extendedFiles) {
+    update(e.second->meshes);
+  }
+  std::cout << "[情報]" << __func__ << ": VBOの" << vboRelocations.size() << "領域, IBOの" <<
+    iboRelocations.size() << "領域を再配置しました.\n";
+}
+
+/**
+* VBOとIBOの使用状況を表示する.
+*/
+void Buffer::PrintUsage() const
+{
+  const auto print = [](const char* name, const BufferAllocator::Usage& usage) {
+    const GLsizeiptr free = usage.capacity - usage.used;
+    // 断片化率 = 最大の空き領域に含まれない空き容量の割合.
+    const double fragmentation = free > 0 ?
+      100.0 * static_cast<double>(free - usage.largestFreeBlock) / static_cast<double>(free) : 0.0;
+    std::cout << "  " << name << ": " << usage.used / 1024 << "/" << usage.capacity / 1024 << "KB使用" <<
+      " (ページ数=" << usage.pageCount << " 割り当て数=" << usage.allocationCount <<
+      " 空き領域数=" << usage.freeBlockCount << " 最大空き領域=" << usage.largestFreeBlock / 1024 << "KB" <<
+      " 断片化率=" << static_cast<int>(fragmentation) << "%)\n";
+  };
+  std::cout << "[情報]Mesh::Buffer: ファイル数=" << files.size() + extendedFiles.size() << "\n";
+  print("VBO", vbo.GetUsage());
+  print("IBO", ibo.GetUsage());
+}
+
+/**
+* シェーダにビュー・プロジェクション行列を設定する.
 *
-* @param matVP r[EvWFNVs.
+* @param matVP ビュー・プロジェクション行列.
 *
-* @note UBOŋLƂ̂ق悢݌vƎv.
+* @note こういう処理はUBOで共有するとかのほうがよい設計だと思う.
 */
 void Buffer::SetViewProjectionMatrix(const glm::mat4& matVP) const
 {
@@ -751,7 +1454,7 @@ void Buffer::SetViewProjectionMatrix(const glm::mat4& matVP) const
   progStaticMesh->SetViewProjectionMatrix(matVP);
   progSkeletalMesh->Use();
   progSkeletalMesh->SetViewProjectionMatrix(matVP);
-  glUseProgram(0);
+  progSkeletalMesh->Unuse();
 }
 
 } // namespace Mesh
\ No newline at end of file
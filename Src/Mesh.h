@@ -5,6 +5,7 @@
 #define MESH_H_INCLUDED
 #include <GL/glew.h>
 #include "BufferObject.h"
+#include "BufferAllocator.h"
 #include "json11/json11.hpp"
 #include "Texture.h"
 #include "Shader.h"
@@ -23,7 +24,7 @@ using aligned_quat = qua<float, aligned_highp>;
 
 namespace Mesh {
 
-// s錾.
+// 先行宣言.
 class Buffer;
 using BufferPtr = std::shared_ptr<Buffer>;
 struct Mesh;
@@ -31,12 +32,14 @@ using MeshPtr = std::shared_ptr<Mesh>;
 class SkeletalMesh;
 using SkeletalMeshPtr = std::shared_ptr<SkeletalMesh>;
 
-// XP^bVp.
+// スケルタルメッシュ用.
 struct Node;
 struct ExtendedFile;
 using ExtendedFilePtr = std::shared_ptr<ExtendedFile>;
 
-// _f[^.
+struct OptimizationStatistics;
+
+// 頂点データ.
 struct Vertex
 {
   glm::vec3 position;
@@ -47,7 +50,25 @@ struct Vertex
   GLushort  joints[4];
 };
 
-// }eA.
+/**
+* 頂点データの形式.
+*/
+enum class VertexFormat {
+  Standard, ///< Vertex構造体と同じ形式. 全ての要素をfloatで格納する.
+  Static,   ///< 静的メッシュ用の圧縮形式. 法線を10-10-10-2, テクスチャ座標をhalf, 色をunorm8で格納する.
+  Skinned,  ///< スケルタルメッシュ用の圧縮形式. Staticに加えて、ウェイトをunorm8, ジョイント番号をubyteで格納する.
+};
+
+// 圧縮形式の頂点データ(VertexFormat::Static).
+struct PackedVertex
+{
+  glm::vec3 position;
+  GLuint    normal;       // GL_INT_2_10_10_10_REV.
+  GLushort  texCoord[2];  // GL_HALF_FLOAT.
+  GLubyte   color[4];     // GL_UNSIGNED_BYTE(正規化).
+};
+
+// マテリアル.
 struct Material {
   glm::vec4 baseColor = glm::vec4(1);
   Texture::Image2DPtr texture;
@@ -55,7 +76,18 @@ struct Material {
   Shader::ProgramPtr progSkeletalMesh;
 };
 
-// bVv~eBu.
+// 頂点アトリビュート.
+struct VertexAttribute {
+  GLuint index = 0;
+  GLint size = 0;
+  GLenum type = GL_FLOAT;
+  GLboolean normalized = GL_FALSE;
+  GLsizei stride = 0;
+  size_t offset = 0; // vertexRanges[range]の先頭からのバイトオフセット.
+  size_t range = 0;  // データを格納しているvertexRangesのインデックス.
+};
+
+// メッシュプリミティブ.
 struct Primitive {
   GLenum mode;
   GLsizei count;
@@ -65,42 +97,73 @@ struct Primitive {
   std::shared_ptr<VertexArrayObject> vao;
   bool hasColorAttribute = false;
   size_t material = 0;
+  VertexFormat vertexFormat = VertexFormat::Standard;
+
+  // VAOの再構築と領域の解放に使う.
+  BufferRange indexRange;
+  std::vector<BufferRange> vertexRanges;
+  std::vector<VertexAttribute> attributes;
+
+  // 簡略化したインデックスデータ(LOD1以降). 頂点データは元のものを共有する.
+  struct Lod {
+    GLsizei count = 0;
+    const GLvoid* indices = nullptr;
+    BufferRange indexRange;
+  };
+  std::vector<Lod> lods;
 };
 
-// bVf[^.
+// メッシュデータ.
 struct MeshData {
   std::string name;
   std::vector<Primitive> primitives;
+  std::vector<float> lodDistances; // LOD1以降に切り替える距離.
+  glm::vec3 boundsMin = glm::vec3(0); // 境界ボックスの最小座標(glTFファイルのメッシュのみ).
+  glm::vec3 boundsMax = glm::vec3(0); // 境界ボックスの最大座標(glTFファイルのメッシュのみ).
 };
 
-// t@C.
+/**
+* LODの生成と切り替えの設定.
+*/
+struct LodSetting
+{
+  float ratio;    ///< 元の三角形数に対する比率.
+  float maxError; ///< 許容する誤差(メッシュの半径に対する比率).
+  float distance; ///< このLODに切り替える視点からの距離.
+};
+
+int SelectLod(const MeshData& mesh, const glm::mat4& matVP, const glm::mat4& matModel);
+void DrawElements(const Primitive& prim, int lod);
+void DrawElementsInstanced(const Primitive& prim, int lod, GLsizei instanceCount);
+
+// ファイル.
 struct File {
-  std::string name; // t@C.
+  std::string name; // ファイル名.
   std::vector<MeshData> meshes;
   std::vector<Material> materials;
 };
 using FilePtr = std::shared_ptr<File>;
 
 /**
-* `悷郁bVf[^.
+* 描画するメッシュデータ.
 *
-* Primitve܂Ƃ߂.
-* V[[gm[h烁bVm[h܂ł̕ϊs|ȂƁApŕ`悳Ȃꍇ.
-* Aj[V̂{[m[hȂA͈xvZΏ\.
-* Aʏm[hAj[VĂꍇ̂ŁȀꍇ͖񃋁[gm[hČvZKv.
-* glTF̃Aj[Vf[^ɂ͒ʏm[hƃ{[m[h̋ʂȂ̂ŁAʂ΃Aj[Vf[^̑ΏۂƂȂm[h
-* XPgm[hXgɊ܂܂邩ǂŔ肷Kv肻.
+* Primitveをまとめたもの.
+* シーンルートノードからメッシュノードまでの変換行列を掛けないと、正しい姿勢で描画されない場合がある.
+* アニメーションを持つのがボーンノードだけなら、これは一度計算すれば十分.
+* だが、通常ノードがアニメーションを持っている場合もあるので、その場合は毎回ルートノードから再計算する必要がある.
+* glTFのアニメーションデータには通常ノードとボーンノードの区別がないので、区別したければアニメーションデータの対象となるノードが
+* スケルトンノードリストに含まれるかどうかで判定する必要がありそう.
 *
-* 쐬@:
-* - Buffer::GetMeshō쐬.
+* 作成方法:
+* - Buffer::GetMeshで作成.
 *
-* XV@:
-* -# Buffer::ResetUniformData()UBOobt@Zbg.
-* -# `悷邷ׂẴbVɂāAMesh::UpdateŃAj[VUBOobt@̍XV(͕ق).
-* -# Buffer::UploadUniformData()UBOobt@VRAMɓ].
+* 更新方法:
+* -# Buffer::ResetUniformData()でUBOバッファをリセット.
+* -# 描画するすべてのメッシュについて、Mesh::UpdateでアニメーションとUBOバッファの更新(これは分けたほうがいいかも).
+* -# Buffer::UploadUniformData()でUBOバッファをVRAMに転送.
 *
-* `@:
-* - Mesh::Drawŕ`.
+* 描画方法:
+* - Mesh::Drawで描画.
 */
 struct Mesh
 {
@@ -114,17 +177,25 @@ struct Mesh
 };
 
 /**
-* SĂ̕`f[^ێNX.
+* 全ての描画データを保持するクラス.
 *
-* bV̓o^@:
-* - _f[^ƃCfbNXf[^pӂ.
-* - MeshIuWFNgpӂAbV߂Mesh::nameɐݒ肷.
-* - AddVertexData()Œ_̍WAeNX`WAFȂǂݒ肵A߂lVertexTCYŊlbaseVertexɐݒ肷.
-* - AddIndexData()ŃCfbNXf[^ݒ肵A߂lMesh::indicesɐݒ肷.
-* - Meshmode, count, typeo[ɓK؂Ȓlݒ肷.
-*   Ƃ΍W𒸓_Agr[g0ԖڂƂĎw肷ꍇAMesh::attributes[0]::offsetɐݒ肷.
-* - _Agr[gindex, size, type, strideɓK؂Ȓlݒ肷.
-* - AddMesh()ŃbVo^.
+* メッシュの登録方法:
+* - 頂点データとインデックスデータを用意する.
+* - Meshオブジェクトを用意し、メッシュ名を決めてMesh::nameに設定する.
+* - AddVertexData()でVertex型の頂点データを追加し、戻り値の領域を受け取る.
+*   VertexFormat::Staticを指定すると、頂点データを圧縮してから追加する.
+* - AddIndexData()でインデックスデータを追加し、戻り値の領域を受け取る.
+* - CreatePrimitive()に2つの領域とAddVertexData()で指定した頂点形式を渡してプリミティブを作成する.
+* - AddMesh()でメッシュを登録する.
+*
+* VBOとIBOはBufferAllocatorによって部分割り当てされる.
+* 容量が足りなくなるとページが追加されるので、Init()には最大容量ではなくページサイズを指定する.
+* 不要になったメッシュはUnloadMesh()またはUnloadFile()で解放でき、Defragment()で空き領域を詰めることができる.
+*
+* LoadMesh(), LoadSkeletalMesh(), CreateCircle(), CreateSphere()は、三角形と頂点の順序を最適化してから転送する.
+* オーバードローの最適化はSetOverdrawOptimization()で無効にできる.
+* また、glTFファイルのメッシュについては、SetLodSettings()の設定に従ってLODを生成する.
+* LODは描画時に視点からの距離によって自動的に選択される.
 */
 class Buffer
 {
@@ -133,16 +204,25 @@ public:
   ~Buffer() = default;
 
   bool Init(GLsizeiptr vboSize, GLsizeiptr iboSize, GLsizeiptr uboSize);
-  GLintptr AddVertexData(const void* data, size_t size);
-  GLintptr AddIndexData(const void* data, size_t size);
-  Primitive CreatePrimitive(size_t count, GLenum type, size_t iOffset, size_t vOffset) const;
+  BufferRange AddVertexData(const void* data, size_t size);
+  BufferRange AddVertexData(const std::vector<Vertex>& vertices, VertexFormat format);
+  BufferRange AddIndexData(const void* data, size_t size);
+  Primitive CreatePrimitive(size_t count, GLenum type, const BufferRange& iRange, const BufferRange& vRange,
+    VertexFormat format = VertexFormat::Standard) const;
   Material CreateMaterial(const glm::vec4& color, Texture::Image2DPtr texture) const;
-  void AddMesh(const char* name, size_t count, GLenum type, size_t iOffset, size_t vOffset);
+  void AddMesh(const char* name, size_t count, GLenum type, const BufferRange& iRange, const BufferRange& vRange,
+    VertexFormat format = VertexFormat::Standard);
   bool AddMesh(const char* name, const Primitive& primitive, const Material& material);
   bool LoadMesh(const char* path);
   MeshPtr GetMesh(const char* meshName) const;
-  void Bind();
-  void Unbind();
+
+  void SetOverdrawOptimization(bool enable) { optimizeOverdraw = enable; }
+  void SetLodSettings(const std::vector<LodSetting>& settings) { lodSettings = settings; }
+
+  bool UnloadMesh(const char* name);
+  bool UnloadFile(const char* path);
+  void Defragment();
+  void PrintUsage() const;
 
   void SetViewProjectionMatrix(const glm::mat4&) const;
 
@@ -150,24 +230,34 @@ public:
   void CreateCircle(const char* name, size_t segments);
   void CreateSphere(const char* name, size_t segments, size_t rings);
 
-  // XP^bVp.
+  // スケルタルメッシュ用.
   bool LoadSkeletalMesh(const char* path);
   SkeletalMeshPtr GetSkeletalMesh(const char* meshName) const;
 
 private:
-  BufferObject vbo;
-  BufferObject ibo;
-  VertexArrayObject vao;
-  GLintptr vboEnd = 0;
-  GLintptr iboEnd = 0;
+  BufferAllocator vbo;
+  BufferAllocator ibo;
 
   std::unordered_map<std::string, FilePtr> files;
   Shader::ProgramPtr progStaticMesh;
 
+  bool optimizeOverdraw = true;
+  std::vector<LodSetting> lodSettings = {
+    { 0.5f, 0.01f, 30.0f },
+    { 0.25f, 0.03f, 60.0f },
+    { 0.1f, 0.08f, 100.0f },
+  };
+
+  bool SetIndices(Primitive& prim, const json11::Json& primitive, const json11::Json& accessors,
+    const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles,
+    std::vector<GLuint>& remap, OptimizationStatistics& stats);
   bool SetAttribute(
-    Primitive& prim, int index, const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles);
+    Primitive& prim, int index, const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles,
+    const std::vector<GLuint>& remap);
+  void SetupVertexArray(Primitive& prim) const;
+  void FreePrimitives(std::vector<MeshData>& meshList);
 
-  // XP^bVp.
+  // スケルタルメッシュ用.
   struct MeshIndex {
     ExtendedFilePtr file;
     const Node* node = nullptr;
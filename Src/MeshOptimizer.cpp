@@ -0,0 +1,748 @@
+/**
+* @file MeshOptimizer.cpp
+*
+* インデックスデータと頂点データの並べ替えによる描画の最適化.
+*
+* - 頂点キャッシュ: Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+* - オーバードロー: Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+* - 簡略化: Garland, Heckbert, "Surface Simplification Using Quadric Error Metrics".
+*/
+#define NOMINMAX
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <map>
+#include <tuple>
+#include <float.h>
+#include <math.h>
+
+namespace Mesh {
+
+namespace /* unnamed */ {
+
+// Forsythのスコア計算用定数.
+const int maxCacheSize = 32;
+const float cacheDecayPower = 1.5f;
+const float lastTriangleScore = 0.75f;
+const float valenceBoostScale = 2.0f;
+const float valenceBoostPower = 0.5f;
+
+/**
+* 頂点のスコアを計算する.
+*
+* @param cachePosition      頂点のキャッシュ内の位置(キャッシュにない場合は-1).
+* @param remainingTriangles 頂点を使用する未出力の三角形の数.
+*
+* @return 頂点のスコア.
+*/
+float VertexScore(int cachePosition, int remainingTriangles)
+{
+  if (remainingTriangles <= 0) {
+    return -1.0f; // もう使われない頂点.
+  }
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+    if (cachePosition < 3) {
+      // 直前の三角形で使われた頂点は、同じ三角形を出力しないように固定値とする.
+      score = lastTriangleScore;
+    } else {
+      const float scaler = 1.0f / static_cast<float>(maxCacheSize - 3);
+      score = 1.0f - static_cast<float>(cachePosition - 3) * scaler;
+      score = powf(score, cacheDecayPower);
+    }
+  }
+  // 残り三角形が少ない頂点ほど優先して、孤立した三角形が残らないようにする.
+  score += valenceBoostScale * powf(static_cast<float>(remainingTriangles), -valenceBoostPower);
+  return score;
+}
+
+/**
+* 二次誤差行列(対称4x4行列).
+*/
+struct Quadric
+{
+  double a2 = 0, ab = 0, ac = 0, ad = 0;
+  double b2 = 0, bc = 0, bd = 0;
+  double c2 = 0, cd = 0;
+  double d2 = 0;
+
+  /**
+  * 平面ax+by+cz+d=0を追加する.
+  */
+  void AddPlane(double a, double b, double c, double d, double weight)
+  {
+    a2 += a * a * weight; ab += a * b * weight; ac += a * c * weight; ad += a * d * weight;
+    b2 += b * b * weight; bc += b * c * weight; bd += b * d * weight;
+    c2 += c * c * weight; cd += c * d * weight;
+    d2 += d * d * weight;
+  }
+
+  /**
+  * 座標pにおける誤差(平面までの距離の二乗和)を計算する.
+  */
+  double Evaluate(const glm::vec3& p) const
+  {
+    const double x = p.x, y = p.y, z = p.z;
+    return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+      b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+      c2 * z * z + 2 * cd * z + d2;
+  }
+
+  Quadric& operator+=(const Quadric& q)
+  {
+    a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+    b2 += q.b2; bc += q.bc; bd += q.bd;
+    c2 += q.c2; cd += q.cd;
+    d2 += q.d2;
+    return *this;
+  }
+};
+
+// 頂点の種類.
+enum class VertexKind {
+  manifold, ///< 内部の頂点. どの隣接頂点にも移動できる.
+  border,   ///< 境界上の頂点. 境界に沿ってのみ移動できる.
+  locked,   ///< 移動できない頂点(テクスチャ座標の継ぎ目など).
+};
+
+/**
+* 辺を表すキーを作成する.
+*/
+uint64_t EdgeKey(GLuint a, GLuint b)
+{
+  return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+}
+
+} // unnamed namespace
+
+/**
+* 最適化前のACMRを取得する.
+*/
+float OptimizationStatistics::AcmrBefore() const
+{
+  return triangleCount ? static_cast<float>(transformCountBefore) / static_cast<float>(triangleCount) : 0.0f;
+}
+
+/**
+* 最適化後のACMRを取得する.
+*/
+float OptimizationStatistics::AcmrAfter() const
+{
+  return triangleCount ? static_cast<float>(transformCountAfter) / static_cast<float>(triangleCount) : 0.0f;
+}
+
+/**
+* 統計情報を合算する.
+*/
+OptimizationStatistics& OptimizationStatistics::operator+=(const OptimizationStatistics& other)
+{
+  triangleCount += other.triangleCount;
+  transformCountBefore += other.transformCountBefore;
+  transformCountAfter += other.transformCountAfter;
+  if (lodTriangleCount.size() < other.lodTriangleCount.size()) {
+    lodTriangleCount.resize(other.lodTriangleCount.size(), 0);
+  }
+  for (size_t i = 0; i < other.lodTriangleCount.size(); ++i) {
+    lodTriangleCount[i] += other.lodTriangleCount[i];
+  }
+  return *this;
+}
+
+/**
+* 頂点シェーダの実行回数を数える.
+*
+* @param indices     三角形リストのインデックス配列.
+* @param vertexCount 頂点数.
+* @param cacheSize   シミュレートする頂点キャッシュ(FIFO)のサイズ.
+*
+* @return 頂点キャッシュにヒットしなかった(頂点シェーダが実行される)回数.
+*/
+size_t CountVertexTransforms(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize)
+{
+  // キャッシュに入った時刻を記録しておき、cacheSize回以上キャッシュミスが起きたら追い出されたとみなす.
+  std::vector<size_t> timestamps(vertexCount, 0);
+  size_t time = cacheSize + 1;
+  size_t transforms = 0;
+  for (const GLuint i : indices) {
+    if (i >= vertexCount) {
+      continue;
+    }
+    if (time - timestamps[i] > cacheSize) {
+      timestamps[i] = time++;
+      ++transforms;
+    }
+  }
+  return transforms;
+}
+
+/**
+* 頂点キャッシュのヒット率が高くなるように三角形を並べ替える.
+*
+* @param indices     三角形リストのインデックス配列.
+* @param vertexCount 頂点数.
+*/
+void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+{
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0 || vertexCount == 0) {
+    return;
+  }
+
+  // 頂点ごとの隣接三角形リストを作成.
+  std::vector<int> remaining(vertexCount, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i) {
+    ++remaining[indices[i]];
+  }
+  std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+  }
+  std::vector<GLuint> adjacency(adjacencyOffset.back());
+  {
+    std::vector<size_t> cursor(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+      for (size_t k = 0; k < 3; ++k) {
+        adjacency[cursor[indices[t * 3 + k]]++] = static_cast<GLuint>(t);
+      }
+    }
+  }
+
+  std::vector<float> vertexScore(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    vertexScore[v] = VertexScore(-1, remaining[v]);
+  }
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<float> triangleScore(triangleCount);
+  for (size_t t = 0; t < triangleCount; ++t) {
+    triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+  }
+
+  std::vector<GLuint> result;
+  result.reserve(triangleCount * 3);
+  std::vector<GLuint> cache;
+  cache.reserve(maxCacheSize + 3);
+  std::vector<GLuint> newCache;
+  newCache.reserve(maxCacheSize + 3);
+  size_t scanPosition = 0; // キャッシュ外から三角形を探すときの開始位置.
+  int bestTriangle = -1;
+  for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+    if (bestTriangle < 0) {
+      // キャッシュ内の頂点に隣接する三角形がなければ、未出力の三角形から最もスコアの高いものを選ぶ.
+      float bestScore = -1.0f;
+      for (size_t t = scanPosition; t < triangleCount; ++t) {
+        if (!emitted[t] && triangleScore[t] > bestScore) {
+          bestScore = triangleScore[t];
+          bestTriangle = static_cast<int>(t);
+        }
+      }
+      while (scanPosition < triangleCount && emitted[scanPosition]) {
+        ++scanPosition;
+      }
+    }
+
+    // 三角形を出力し、頂点を隣接三角形リストから取り除く.
+    const GLuint* tri = &indices[bestTriangle * 3];
+    result.insert(result.end(), tri, tri + 3);
+    emitted[bestTriangle] = true;
+    for (size_t k = 0; k < 3; ++k) {
+      const GLuint v = tri[k];
+      GLuint* begin = &adjacency[adjacencyOffset[v]];
+      GLuint* end = begin + remaining[v];
+      std::remove(begin, end, static_cast<GLuint>(bestTriangle));
+      --remaining[v];
+    }
+
+    // 出力した三角形の頂点をキャッシュの先頭に移動.
+    newCache.assign(tri, tri + 3);
+    for (const GLuint v : cache) {
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        newCache.push_back(v);
+      }
+    }
+    for (size_t i = maxCacheSize; i < newCache.size(); ++i) {
+      vertexScore[newCache[i]] = VertexScore(-1, remaining[newCache[i]]);
+    }
+    if (newCache.size() > maxCacheSize) {
+      newCache.resize(maxCacheSize);
+    }
+    cache.swap(newCache);
+
+    // キャッシュ内の頂点のスコアを更新し、隣接する三角形から次に出力するものを選ぶ.
+    for (size_t i = 0; i < cache.size(); ++i) {
+      vertexScore[cache[i]] = VertexScore(static_cast<int>(i), remaining[cache[i]]);
+    }
+    float bestScore = -1.0f;
+    bestTriangle = -1;
+    for (const GLuint v : cache) {
+      for (size_t a = 0; a < static_cast<size_t>(remaining[v]); ++a) {
+        const GLuint t = adjacency[adjacencyOffset[v] + a];
+        const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        triangleScore[t] = score;
+        if (score > bestScore) {
+          bestScore = score;
+          bestTriangle = static_cast<int>(t);
+        }
+      }
+    }
+  }
+  indices.swap(result);
+}
+
+/**
+* オーバードローが少なくなるように三角形のまとまり(クラスタ)を並べ替える.
+*
+* @param indices   OptimizeVertexCache()で並べ替えた三角形リストのインデックス配列.
+* @param positions 頂点座標の配列.
+* @param threshold ACMRの悪化をどこまで許容するか(1.05なら5%まで).
+*                  並べ替えの結果がこれを越えた場合は元の順序に戻す.
+*
+* 頂点キャッシュが完全にミスする位置でクラスタに分割し、外側を向いているクラスタほど先に描画されるように並べ替える.
+* 凸に近い形状では、手前の面が先に描かれることで奥の面のフラグメント処理が深度テストで省略される.
+*/
+void OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<glm::vec3>& positions, float threshold)
+{
+  const size_t triangleCount = indices.size() / 3;
+  const size_t vertexCount = positions.size();
+  if (triangleCount < 2 || vertexCount == 0) {
+    return;
+  }
+  for (const GLuint i : indices) {
+    if (i >= vertexCount) {
+      return;
+    }
+  }
+
+  // 3頂点ともキャッシュミスする三角形をクラスタの開始位置とする.
+  std::vector<size_t> clusters;
+  {
+    std::vector<size_t> timestamps(vertexCount, 0);
+    size_t time = simulatedCacheSize + 1;
+    for (size_t t = 0; t < triangleCount; ++t) {
+      int misses = 0;
+      for (size_t k = 0; k < 3; ++k) {
+        const GLuint v = indices[t * 3 + k];
+        if (time - timestamps[v] > simulatedCacheSize) {
+          timestamps[v] = time++;
+          ++misses;
+        }
+      }
+      if (t == 0 || misses == 3) {
+        clusters.push_back(t);
+      }
+    }
+  }
+  if (clusters.size() < 2) {
+    return;
+  }
+  clusters.push_back(triangleCount);
+
+  // メッシュ全体の中心.
+  glm::vec3 meshCenter(0);
+  for (const glm::vec3& p : positions) {
+    meshCenter += p;
+  }
+  meshCenter /= static_cast<float>(vertexCount);
+
+  // クラスタの向き(面積で重み付けした法線)と中心から、外側を向いている度合いを計算.
+  struct Cluster {
+    size_t begin;
+    size_t end;
+    float sortKey;
+  };
+  std::vector<Cluster> clusterList;
+  clusterList.reserve(clusters.size() - 1);
+  for (size_t c = 0; c + 1 < clusters.size(); ++c) {
+    glm::vec3 center(0);
+    glm::vec3 normal(0);
+    float area = 0;
+    for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+      const glm::vec3& p0 = positions[indices[t * 3]];
+      const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+      const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+      const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+      const float a = glm::length(n);
+      center += (p0 + p1 + p2) * (a / 3.0f);
+      normal += n;
+      area += a;
+    }
+    float sortKey = 0;
+    if (area > 0) {
+      center /= area;
+      const float length = glm::length(normal);
+      if (length > 0) {
+        sortKey = glm::dot(center - meshCenter, normal / length);
+      }
+    }
+    clusterList.push_back({ clusters[c], clusters[c + 1], sortKey });
+  }
+  std::stable_sort(clusterList.begin(), clusterList.end(),
+    [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+  std::vector<GLuint> result;
+  result.reserve(indices.size());
+  for (const Cluster& e : clusterList) {
+    result.insert(result.end(), indices.begin() + e.begin * 3, indices.begin() + e.end * 3);
+  }
+
+  // 頂点キャッシュの効率が大きく悪化する場合は採用しない.
+  const size_t before = CountVertexTransforms(indices, vertexCount);
+  const size_t after = CountVertexTransforms(result, vertexCount);
+  if (static_cast<float>(after) <= static_cast<float>(before) * threshold) {
+    indices.swap(result);
+  }
+}
+
+/**
+* 頂点データを参照される順番に並べ替えるための変換表を作成する.
+*
+* @param indices     三角形リストのインデックス配列.
+*                    新しい頂点番号に書き換えられる.
+* @param vertexCount 頂点数.
+* @param remap       変換表を格納する配列.
+*                    remap[古い頂点番号] = 新しい頂点番号. 参照されない頂点は0xffffffffになる.
+*
+* @return 参照されている頂点の数.
+*
+* 頂点データを変換表に従って並べ替えると、頂点フェッチのメモリアクセスが局所化される.
+* また、参照されない頂点は取り除かれる.
+*/
+size_t OptimizeVertexFetch(std::vector<GLuint>& indices, size_t vertexCount, std::vector<GLuint>& remap)
+{
+  remap.assign(vertexCount, 0xffffffff);
+  GLuint next = 0;
+  for (GLuint& i : indices) {
+    if (i >= vertexCount) {
+      continue;
+    }
+    if (remap[i] == 0xffffffff) {
+      remap[i] = next++;
+    }
+    i = remap[i];
+  }
+  return next;
+}
+
+/**
+* 二次誤差(QEM)に基づいてメッシュを簡略化する.
+*
+* @param indices          三角形リストのインデックス配列.
+* @param positions        頂点座標の配列.
+* @param targetIndexCount 目標とするインデックス数.
+* @param maxError         許容する誤差. メッシュの半径に対する比率で指定する.
+* @param vertexGroups     頂点のグループ番号の配列. 異なるグループの頂点同士は結合しない.
+*                         スケルタルメッシュで、最も影響の大きいジョイント番号を指定する用途を想定している.
+*                         nullptrの場合はグループ分けをしない.
+*
+* @return 簡略化したインデックス配列.
+*         目標数に達する前に誤差がmaxErrorを越えた場合は、そこで簡略化を打ち切る.
+*
+* 辺を縮約するとき、新しい頂点を作らずに辺の一方の頂点へ移動させる(half-edge collapse).
+* そのため、簡略化後も元の頂点データをそのまま使うことができ、スキンのウェイトなども保存される.
+*
+* 同じ座標に複数の頂点がある場合(テクスチャ座標や法線の継ぎ目)は、継ぎ目が開かないように移動を禁止する.
+* 境界上の頂点は境界に沿ってのみ移動でき、境界からの逸脱は大きな誤差として扱う.
+*/
+std::vector<GLuint> SimplifyMesh(const std::vector<GLuint>& indices, const std::vector<glm::vec3>& positions,
+  size_t targetIndexCount, float maxError, const std::vector<int>* vertexGroups)
+{
+  const size_t vertexCount = positions.size();
+  std::vector<GLuint> result(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+  for (const GLuint i : result) {
+    if (i >= vertexCount) {
+      return indices;
+    }
+  }
+  if (vertexGroups && vertexGroups->size() < vertexCount) {
+    vertexGroups = nullptr;
+  }
+
+  // 誤差の基準となるメッシュの半径.
+  glm::vec3 minPos(FLT_MAX);
+  glm::vec3 maxPos(-FLT_MAX);
+  for (const glm::vec3& p : positions) {
+    minPos = glm::min(minPos, p);
+    maxPos = glm::max(maxPos, p);
+  }
+  const double radius = glm::length(maxPos - minPos) * 0.5;
+  const double maxErrorSq = (maxError * radius) * (maxError * radius);
+
+  // 同じ座標を持つ頂点を探し、継ぎ目の頂点は移動禁止にする.
+  std::vector<VertexKind> kinds(vertexCount, VertexKind::manifold);
+  {
+    std::map<std::tuple<float, float, float>, GLuint> positionMap;
+    for (GLuint v = 0; v < vertexCount; ++v) {
+      const auto key = std::make_tuple(positions[v].x, positions[v].y, positions[v].z);
+      const auto itr = positionMap.find(key);
+      if (itr == positionMap.end()) {
+        positionMap.emplace(key, v);
+      } else {
+        kinds[v] = VertexKind::locked;
+        kinds[itr->second] = VertexKind::locked;
+      }
+    }
+  }
+
+  // 各頂点の二次誤差行列を計算.
+  std::vector<Quadric> quadrics(vertexCount);
+  std::unordered_map<uint64_t, int> edgeCount;
+  edgeCount.reserve(result.size());
+  for (size_t t = 0; t < result.size(); t += 3) {
+    const glm::vec3& p0 = positions[result[t]];
+    const glm::vec3& p1 = positions[result[t + 1]];
+    const glm::vec3& p2 = positions[result[t + 2]];
+    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+    const float area = glm::length(n);
+    if (area <= 0) {
+      continue;
+    }
+    n /= area;
+    const double d = -glm::dot(n, p0);
+    for (size_t k = 0; k < 3; ++k) {
+      quadrics[result[t + k]].AddPlane(n.x, n.y, n.z, d, area);
+      ++edgeCount[EdgeKey(result[t + k], result[t + (k + 1) % 3])];
+    }
+  }
+
+  // 境界の辺には、面に垂直な平面を大きな重みで追加して、境界が崩れないようにする.
+  const double borderWeight = 10.0;
+  for (size_t t = 0; t < result.size(); t += 3) {
+    const glm::vec3& p0 = positions[result[t]];
+    const glm::vec3& p1 = positions[result[t + 1]];
+    const glm::vec3& p2 = positions[result[t + 2]];
+    const glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+    for (size_t k = 0; k < 3; ++k) {
+      const GLuint a = result[t + k];
+      const GLuint b = result[t + (k + 1) % 3];
+      if (edgeCount[EdgeKey(a, b)] != 1) {
+        continue;
+      }
+      for (const GLuint v : { a, b }) {
+        if (kinds[v] == VertexKind::manifold) {
+          kinds[v] = VertexKind::border;
+        }
+      }
+      const glm::vec3 edge = positions[b] - positions[a];
+      glm::vec3 n = glm::cross(edge, faceNormal);
+      const float length = glm::length(n);
+      if (length <= 0) {
+        continue;
+      }
+      n /= length;
+      const double d = -glm::dot(n, positions[a]);
+      const double weight = borderWeight * glm::length(edge) * glm::length(edge);
+      quadrics[a].AddPlane(n.x, n.y, n.z, d, weight);
+      quadrics[b].AddPlane(n.x, n.y, n.z, d, weight);
+    }
+  }
+
+  // 頂点fromをtoへ移動できるか.
+  const auto canCollapse = [&](GLuint from, GLuint to) {
+    if (kinds[from] == VertexKind::locked) {
+      return false;
+    }
+    if (vertexGroups && (*vertexGroups)[from] != (*vertexGroups)[to]) {
+      return false;
+    }
+    if (kinds[from] == VertexKind::border) {
+      const auto itr = edgeCount.find(EdgeKey(from, to));
+      return kinds[to] != VertexKind::manifold && itr != edgeCount.end() && itr->second == 1;
+    }
+    return true;
+  };
+
+  struct Collapse {
+    GLuint from;
+    GLuint to;
+    double cost;
+  };
+  std::vector<Collapse> collapses;
+  std::vector<size_t> adjacencyOffset(vertexCount + 1);
+  std::vector<GLuint> adjacency;
+  std::vector<GLuint> remap(vertexCount);
+  std::vector<char> touched(vertexCount);
+  for (int pass = 0; pass < 100 && result.size() > targetIndexCount; ++pass) {
+    // 頂点ごとの隣接三角形リストを作成.
+    std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+    for (const GLuint i : result) {
+      ++adjacencyOffset[i + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+      adjacencyOffset[v + 1] += adjacencyOffset[v];
+    }
+    adjacency.resize(result.size());
+    {
+      std::vector<size_t> cursor(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+      for (size_t i = 0; i < result.size(); ++i) {
+        adjacency[cursor[result[i]]++] = static_cast<GLuint>(i / 3);
+      }
+    }
+
+    // 全ての辺について、誤差の小さいほうの方向へ縮約する候補を作成.
+    collapses.clear();
+    for (size_t t = 0; t < result.size(); t += 3) {
+      for (size_t k = 0; k < 3; ++k) {
+        const GLuint a = result[t + k];
+        const GLuint b = result[t + (k + 1) % 3];
+        if (a > b && edgeCount.count(EdgeKey(a, b)) && edgeCount[EdgeKey(a, b)] > 1) {
+          continue; // 内部の辺は2回現れるので、片方だけ処理する.
+        }
+        Quadric q = quadrics[a];
+        q += quadrics[b];
+        const double costAB = canCollapse(a, b) ? q.Evaluate(positions[b]) : DBL_MAX;
+        const double costBA = canCollapse(b, a) ? q.Evaluate(positions[a]) : DBL_MAX;
+        if (costAB <= costBA && costAB < DBL_MAX) {
+          collapses.push_back({ a, b, costAB });
+        } else if (costBA < DBL_MAX) {
+          collapses.push_back({ b, a, costBA });
+        }
+      }
+    }
+    if (collapses.empty()) {
+      break;
+    }
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+    // 誤差の小さい順に縮約する.
+    // 1回のパスで同じ三角形に関わる縮約は1つだけにする.
+    const size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+    size_t removedTriangles = 0;
+    for (GLuint v = 0; v < vertexCount; ++v) {
+      remap[v] = v;
+    }
+    std::fill(touched.begin(), touched.end(), 0);
+    for (const Collapse& c : collapses) {
+      if (c.cost > maxErrorSq || removedTriangles >= trianglesToRemove) {
+        break;
+      }
+      if (touched[c.from] || touched[c.to]) {
+        continue;
+      }
+
+      // 移動によって裏返る三角形があれば縮約しない.
+      bool flipped = false;
+      size_t sharedTriangles = 0;
+      for (size_t a = adjacencyOffset[c.from]; a < adjacencyOffset[c.from + 1]; ++a) {
+        const GLuint* tri = &result[adjacency[a] * 3];
+        if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+          ++sharedTriangles;
+          continue;
+        }
+        glm::vec3 p[3];
+        glm::vec3 q[3];
+        for (size_t k = 0; k < 3; ++k) {
+          p[k] = positions[tri[k]];
+          q[k] = tri[k] == c.from ? positions[c.to] : p[k];
+        }
+        const glm::vec3 n0 = glm::cross(p[1] - p[0], p[2] - p[0]);
+        const glm::vec3 n1 = glm::cross(q[1] - q[0], q[2] - q[0]);
+        if (glm::dot(n0, n1) <= 0) {
+          flipped = true;
+          break;
+        }
+      }
+      if (flipped) {
+        continue;
+      }
+
+      remap[c.from] = c.to;
+      quadrics[c.to] += quadrics[c.from];
+      removedTriangles += sharedTriangles;
+      // 隣接する三角形の頂点は、このパスではもう動かさない.
+      for (size_t a = adjacencyOffset[c.from]; a < adjacencyOffset[c.from + 1]; ++a) {
+        const GLuint* tri = &result[adjacency[a] * 3];
+        touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+      }
+    }
+    if (removedTriangles == 0) {
+      break;
+    }
+
+    // 縮約を反映し、潰れた三角形を取り除く.
+    size_t writeIndex = 0;
+    for (size_t t = 0; t < result.size(); t += 3) {
+      const GLuint a = remap[result[t]];
+      const GLuint b = remap[result[t + 1]];
+      const GLuint c = remap[result[t + 2]];
+      if (a != b && b != c && c != a) {
+        result[writeIndex++] = a;
+        result[writeIndex++] = b;
+        result[writeIndex++] = c;
+      }
+    }
+    result.resize(writeIndex);
+
+    // 辺の使用回数を作り直す.
+    edgeCount.clear();
+    for (size_t t = 0; t < result.size(); t += 3) {
+      for (size_t k = 0; k < 3; ++k) {
+        ++edgeCount[EdgeKey(result[t + k], result[t + (k + 1) % 3])];
+      }
+    }
+  }
+  return result;
+}
+
+/**
+* 頂点データとインデックスデータを最適化する.
+*
+* @param vertices 頂点データ配列.
+* @param indices  三角形リストのインデックス配列.
+* @param overdraw オーバードローの最適化を行うならtrue.
+*
+* @return 最適化の統計情報.
+*/
+OptimizationStatistics OptimizeMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, bool overdraw)
+{
+  OptimizationStatistics stats;
+  stats.triangleCount = indices.size() / 3;
+  stats.transformCountBefore = CountVertexTransforms(indices, vertices.size());
+
+  OptimizeVertexCache(indices, vertices.size());
+  if (overdraw) {
+    std::vector<glm::vec3> positions;
+    positions.reserve(vertices.size());
+    for (const Vertex& v : vertices) {
+      positions.push_back(v.position);
+    }
+    OptimizeOverdraw(indices, positions);
+  }
+  std::vector<GLuint> remap;
+  const size_t newVertexCount = OptimizeVertexFetch(indices, vertices.size(), remap);
+  std::vector<Vertex> newVertices(newVertexCount);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    if (remap[i] != 0xffffffff) {
+      newVertices[remap[i]] = vertices[i];
+    }
+  }
+  vertices.swap(newVertices);
+
+  stats.transformCountAfter = CountVertexTransforms(indices, vertices.size());
+  return stats;
+}
+
+/**
+* 最適化の統計情報を表示する.
+*
+* @param name  メッシュまたはファイルの名前.
+* @param stats 表示する統計情報.
+*/
+void PrintStatistics(const char* name, const OptimizationStatistics& stats)
+{
+  if (stats.triangleCount == 0) {
+    return;
+  }
+  std::cout << "[情報]" << name << ": ACMR " << std::fixed << std::setprecision(3) <<
+    stats.AcmrBefore() << " -> " << stats.AcmrAfter() << std::defaultfloat <<
+    " (三角形数=" << stats.triangleCount;
+  if (!stats.lodTriangleCount.empty()) {
+    std::cout << " LOD=";
+    for (size_t i = 0; i < stats.lodTriangleCount.size(); ++i) {
+      std::cout << (i ? "/" : "") << stats.lodTriangleCount[i];
+    }
+  }
+  std::cout << ")\n";
+}
+
+} // namespace Mesh
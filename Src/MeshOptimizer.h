@@ -0,0 +1,47 @@
+/**
+* @file MeshOptimizer.h
+*/
+#ifndef MESHOPTIMIZER_H_INCLUDED
+#define MESHOPTIMIZER_H_INCLUDED
+#include <GL/glew.h>
+#include "Mesh.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Mesh {
+
+/**
+* 最適化の統計情報.
+*
+* ACMR(Average Cache Miss Ratio)は三角形1つあたりの頂点シェーダ実行回数.
+* 理想値は0.5前後で、最悪値は3.0になる.
+*/
+struct OptimizationStatistics
+{
+  size_t triangleCount = 0;         ///< 三角形の数.
+  size_t transformCountBefore = 0;  ///< 最適化前の頂点変換回数.
+  size_t transformCountAfter = 0;   ///< 最適化後の頂点変換回数.
+  std::vector<size_t> lodTriangleCount; ///< LODごとの三角形の数.
+
+  float AcmrBefore() const;
+  float AcmrAfter() const;
+  OptimizationStatistics& operator+=(const OptimizationStatistics&);
+};
+
+// 頂点キャッシュのシミュレーションに使うキャッシュサイズ(FIFO).
+const size_t simulatedCacheSize = 16;
+
+size_t CountVertexTransforms(const std::vector<GLuint>& indices, size_t vertexCount,
+  size_t cacheSize = simulatedCacheSize);
+void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+void OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<glm::vec3>& positions,
+  float threshold = 1.05f);
+size_t OptimizeVertexFetch(std::vector<GLuint>& indices, size_t vertexCount, std::vector<GLuint>& remap);
+std::vector<GLuint> SimplifyMesh(const std::vector<GLuint>& indices, const std::vector<glm::vec3>& positions,
+  size_t targetIndexCount, float maxError, const std::vector<int>* vertexGroups = nullptr);
+OptimizationStatistics OptimizeMesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, bool overdraw);
+void PrintStatistics(const char* name, const OptimizationStatistics& stats);
+
+} // namespace Mesh
+
+#endif // MESHOPTIMIZER_H_INCLUDED
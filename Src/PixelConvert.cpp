@@ -0,0 +1,177 @@
+/**
+* @file PixelConvert.cpp
+*
+* 画素データの並べ替えと変換.
+* SSE2は常に使える前提とし、SSSE3とAVX2は実行時にCPUが対応しているか調べてから使う.
+*/
+#include "PixelConvert.h"
+#include "CpuFeatures.h"
+#include <immintrin.h>
+
+namespace Texture {
+
+/**
+* BGRA順の画素をRGBA順に並べ替える.
+*
+* @param src        BGRA順の画素データ.
+* @param dst        RGBA順の画素データの格納先. srcと同じでもよい.
+* @param pixelCount ピクセル数.
+*/
+void SwizzleBGRAToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount)
+{
+  size_t i = 0;
+  if (GetCpuFeatures().ssse3) {
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; i + 4 <= pixelCount; i += 4) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, mask));
+    }
+  } else {
+    // SSE2ではシフトとマスクでRとBを入れ替える.
+    const __m128i maskGA = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+    const __m128i maskB = _mm_set1_epi32(0x000000ff);
+    for (; i + 4 <= pixelCount; i += 4) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+      const __m128i ga = _mm_and_si128(v, maskGA);
+      const __m128i b = _mm_slli_epi32(_mm_and_si128(v, maskB), 16);
+      const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), maskB);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(ga, _mm_or_si128(b, r)));
+    }
+  }
+  for (; i < pixelCount; ++i) {
+    const uint8_t b = src[i * 4 + 0];
+    const uint8_t r = src[i * 4 + 2];
+    dst[i * 4 + 0] = r;
+    dst[i * 4 + 1] = src[i * 4 + 1];
+    dst[i * 4 + 2] = b;
+    dst[i * 4 + 3] = src[i * 4 + 3];
+  }
+}
+
+/**
+* BGR順の画素をRGBA順に並べ替える.
+*
+* @param src        BGR順の画素データ.
+* @param dst        RGBA順の画素データの格納先. srcと重なっていてはいけない.
+* @param pixelCount ピクセル数.
+*
+* アルファは255になる.
+*/
+void SwizzleBGRToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount)
+{
+  size_t i = 0;
+  if (GetCpuFeatures().ssse3) {
+    // 16バイト読み込んで先頭の4ピクセル(12バイト)を使う.
+    // 読み込みが画像の末尾を越えないよう、6ピクセル以上残っている間だけ処理する.
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+    for (; i + 6 <= pixelCount; i += 4) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+    }
+  }
+  for (; i < pixelCount; ++i) {
+    dst[i * 4 + 0] = src[i * 3 + 2];
+    dst[i * 4 + 1] = src[i * 3 + 1];
+    dst[i * 4 + 2] = src[i * 3 + 0];
+    dst[i * 4 + 3] = 255;
+  }
+}
+
+/**
+* 8ビットの値を浮動小数点数に変換する.
+*
+* @param src        変換する値の先頭. 多チャンネルの画像の場合は変換するチャンネルを指すこと.
+* @param pixelBytes 次のピクセルまでのバイト数.
+* @param dst        変換結果の格納先.
+* @param count      変換する値の数.
+* @param scale      値に掛ける係数.
+* @param bias       係数を掛けた後で加える値.
+*
+* dst[i] = src[i * pixelBytes] * scale + bias を計算する.
+* pixelBytesが1と4の場合はSIMD命令を使う.
+*/
+void ConvertToFloat(const uint8_t* src, size_t pixelBytes, float* dst, size_t count, float scale, float bias)
+{
+  size_t i = 0;
+  if (pixelBytes == 1) {
+    if (GetCpuFeatures().avx2) {
+      const __m256 s = _mm256_set1_ps(scale);
+      const __m256 b = _mm256_set1_ps(bias);
+      for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), s), b));
+      }
+    } else {
+      const __m128 s = _mm_set1_ps(scale);
+      const __m128 b = _mm_set1_ps(bias);
+      const __m128i zero = _mm_setzero_si128();
+      for (; i + 16 <= count; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        const __m128i w[4] = {
+          _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+          _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero),
+        };
+        for (int j = 0; j < 4; ++j) {
+          _mm_storeu_ps(dst + i + j * 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(w[j]), s), b));
+        }
+      }
+    }
+  } else if (pixelBytes == 4) {
+    // 4ピクセル分の16バイトを読み込み、各32ビットの下位8ビットを取り出す.
+    // 指定チャンネルより後ろのバイトも読むので、末尾の1ピクセルはスカラーで処理する.
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 b = _mm_set1_ps(bias);
+    const __m128i mask = _mm_set1_epi32(0xff);
+    for (; i + 5 <= count; i += 4) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+      const __m128 f = _mm_cvtepi32_ps(_mm_and_si128(v, mask));
+      _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(f, s), b));
+    }
+  }
+  for (; i < count; ++i) {
+    dst[i] = src[i * pixelBytes] * scale + bias;
+  }
+}
+
+/**
+* 16ビットの値を浮動小数点数に変換する.
+*
+* @param src   変換する値の先頭.
+* @param dst   変換結果の格納先.
+* @param count 変換する値の数.
+* @param scale 値に掛ける係数.
+* @param bias  係数を掛けた後で加える値.
+*
+* dst[i] = src[i] * scale + bias を計算する.
+*/
+void ConvertToFloat(const uint16_t* src, float* dst, size_t count, float scale, float bias)
+{
+  size_t i = 0;
+  if (GetCpuFeatures().avx2) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 b = _mm256_set1_ps(bias);
+    for (; i + 8 <= count; i += 8) {
+      const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+      _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), s), b));
+    }
+  } else {
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 b = _mm_set1_ps(bias);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+      const __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+      _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(lo, s), b));
+      _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(hi, s), b));
+    }
+  }
+  for (; i < count; ++i) {
+    dst[i] = src[i] * scale + bias;
+  }
+}
+
+} // namespace Texture
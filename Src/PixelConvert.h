@@ -0,0 +1,18 @@
+/**
+* @file PixelConvert.h
+*/
+#ifndef PIXELCONVERT_H_INCLUDED
+#define PIXELCONVERT_H_INCLUDED
+#include <cstdint>
+#include <cstddef>
+
+namespace Texture {
+
+void SwizzleBGRAToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount);
+void SwizzleBGRToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount);
+void ConvertToFloat(const uint8_t* src, size_t pixelBytes, float* dst, size_t count, float scale, float bias);
+void ConvertToFloat(const uint16_t* src, float* dst, size_t count, float scale, float bias);
+
+} // namespace Texture
+
+#endif // PIXELCONVERT_H_INCLUDED
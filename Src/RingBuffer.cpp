@@ -0,0 +1,249 @@
+/**
+* @file RingBuffer.cpp
+*/
+#define NOMINMAX
+#include "RingBuffer.h"
+#include "GLState.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace /* unnamed */ {
+
+/**
+* バッファオブジェクトをバインドする.
+*
+* @param target バインド対象.
+* @param id     バインドするバッファオブジェクトのID.
+*/
+void Bind(GLenum target, GLuint id)
+{
+  if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    GLState::BindVertexArray(0); // バインド中のVAOのインデックスバッファを上書きしないように.
+  }
+  GLState::BindBuffer(target, id);
+}
+
+} // unnamed namespace
+
+/**
+* リングバッファを初期化する.
+*
+* @param target     バッファオブジェクトの種類(GL_ARRAY_BUFFER, GL_UNIFORM_BUFFERなど).
+* @param frameSize  1フレームに書き込めるバイト数.
+* @param frameCount フレーム区画の数. GPUの処理がこの数-1フレーム遅れるまでは待たずに書き込める.
+* @param alignment  割り当て領域の整列サイズ. 2のべき乗でなくてもよい.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool RingBuffer::Init(GLenum target, GLsizeiptr frameSize, size_t frameCount, GLsizeiptr alignment)
+{
+  Destroy();
+  if (frameSize <= 0 || frameCount < 2 || alignment <= 0) {
+    std::cerr << "[エラー]" << __func__ << ": フレームサイズと整列サイズは1以上、フレーム数は2以上でなくてはなりません.\n";
+    return false;
+  }
+  this->target = target;
+  this->alignment = alignment;
+  this->frameSize = ((frameSize + alignment - 1) / alignment) * alignment;
+  const GLsizeiptr bufferSize = this->frameSize * frameCount;
+
+  glGenBuffers(1, &id);
+  Bind(target, id);
+  isPersistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+  if (isPersistent) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(target, bufferSize, nullptr, flags);
+    mappedPointer = static_cast<uint8_t*>(glMapBufferRange(target, 0, bufferSize, flags));
+    if (!mappedPointer) {
+      std::cerr << "[警告]" << __func__ << ": バッファを永続マップできません. 通常のマップを使います.\n";
+      GLState::ForgetBuffer(id);
+      glDeleteBuffers(1, &id);
+      glGenBuffers(1, &id);
+      Bind(target, id);
+      isPersistent = false;
+    }
+  }
+  if (!isPersistent) {
+    glBufferData(target, bufferSize, nullptr, GL_STREAM_DRAW);
+  }
+  GLState::BindBuffer(target, 0);
+  const GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    std::cerr << "[エラー]" << __func__ << ": " << bufferSize << "バイトのバッファを作成できません(0x" <<
+      std::hex << error << std::dec << ").\n";
+    Destroy();
+    return false;
+  }
+
+  frames.resize(frameCount);
+  for (size_t i = 0; i < frameCount; ++i) {
+    frames[i].offset = this->frameSize * i;
+  }
+  current = 0;
+  usedSize = 0;
+  statistics = Statistics();
+  if (!isPersistent && !Map()) {
+    Destroy();
+    return false;
+  }
+  return true;
+}
+
+/**
+* リングバッファを破棄する.
+*/
+void RingBuffer::Destroy()
+{
+  if (id) {
+    if (mappedPointer) {
+      Bind(target, id);
+      glUnmapBuffer(target);
+      GLState::BindBuffer(target, 0);
+      mappedPointer = nullptr;
+    }
+    GLState::ForgetBuffer(id);
+    glDeleteBuffers(1, &id);
+    id = 0;
+  }
+  for (auto& e : frames) {
+    if (e.fence) {
+      glDeleteSync(e.fence);
+    }
+  }
+  frames.clear();
+  frameSize = 0;
+  usedSize = 0;
+  isPersistent = false;
+}
+
+/**
+* 次のフレーム区画への書き込みを開始する.
+*
+* 現在の区画を使う描画命令は、この関数を呼ぶまでに全て発行されていなくてはならない.
+* 次の区画をGPUがまだ使っている場合は、使い終わるまで待つ.
+* 待った回数と時間はGLStateの統計情報と、このバッファの統計情報に記録される.
+*/
+void RingBuffer::BeginFrame()
+{
+  if (!id) {
+    return;
+  }
+  Unmap();
+
+  // 現在の区画を使う描画命令の後ろにフェンスを置いてから、次の区画に移る.
+  Frame& prevFrame = frames[current];
+  if (prevFrame.fence) {
+    glDeleteSync(prevFrame.fence);
+  }
+  prevFrame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  current = (current + 1) % frames.size();
+  usedSize = 0;
+  ++statistics.frameCount;
+  statistics.lastStallTime = 0;
+
+  Frame& frame = frames[current];
+  if (frame.fence) {
+    GLenum result = glClientWaitSync(frame.fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+      const auto begin = std::chrono::steady_clock::now();
+      do {
+        result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+      } while (result == GL_TIMEOUT_EXPIRED);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+      GLState::CountFenceWait(true, elapsed.count());
+      ++statistics.stallCount;
+      statistics.stallTime += elapsed.count();
+      statistics.maxStallTime = std::max(statistics.maxStallTime, elapsed.count());
+      statistics.lastStallTime = elapsed.count();
+    } else {
+      GLState::CountFenceWait(false, 0);
+    }
+    if (result == GL_WAIT_FAILED) {
+      std::cerr << "[警告]" << __func__ << ": フェンスの待機に失敗しました.\n";
+    }
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+  }
+  Map();
+}
+
+/**
+* フレーム区画への書き込みを終了する.
+*
+* 永続マップでない場合は区画をアンマップする. 書き込んだデータを描画に使う前に呼び出すこと.
+*/
+void RingBuffer::EndFrame()
+{
+  Unmap();
+}
+
+/**
+* 現在のフレーム区画から領域を割り当てる.
+*
+* @param size   割り当てるバイト数.
+* @param offset 割り当てた領域の、バッファ先頭からのバイトオフセットを格納する変数.
+*
+* @return 割り当てた領域への書き込み用ポインタ.
+*         区画に空きがない場合、またはEndFrame()の後で呼び出した場合はnullptr.
+*
+* 返されたポインタはGPUが直接読み取るメモリを指すことがあるので、書き込みだけに使うこと.
+*
+* 割り当てはロックを使わずに行うので、複数のスレッドから同時に呼び出すことができる.
+* ただし、その場合は割り当てられる順序(オフセット)が実行のたびに変わる.
+*/
+void* RingBuffer::Allocate(GLsizeiptr size, GLintptr& offset)
+{
+  if (!mappedPointer || size <= 0) {
+    return nullptr;
+  }
+  const GLsizeiptr alignedSize = ((size + alignment - 1) / alignment) * alignment;
+  GLsizeiptr used = usedSize.load(std::memory_order_relaxed);
+  do {
+    if (used + alignedSize > frameSize) {
+      return nullptr;
+    }
+  } while (!usedSize.compare_exchange_weak(used, used + alignedSize, std::memory_order_relaxed));
+  offset = frames[current].offset + used;
+  return mappedPointer + (isPersistent ? offset : used);
+}
+
+/**
+* 現在のフレーム区画をマップする.
+*
+* @retval true  マップ成功、または永続マップ済み.
+* @retval false マップ失敗.
+*/
+bool RingBuffer::Map()
+{
+  if (isPersistent || mappedPointer) {
+    return true;
+  }
+  // 区画の再利用はフェンスで確認済みなので、ドライバによる同期は不要.
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+  Bind(target, id);
+  mappedPointer = static_cast<uint8_t*>(glMapBufferRange(target, frames[current].offset, frameSize, flags));
+  GLState::BindBuffer(target, 0);
+  if (!mappedPointer) {
+    std::cerr << "[エラー]" << __func__ << ": バッファをマップできません.\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+* 現在のフレーム区画をアンマップする.
+*
+* 永続マップの場合は何もしない.
+*/
+void RingBuffer::Unmap()
+{
+  if (isPersistent || !mappedPointer) {
+    return;
+  }
+  Bind(target, id);
+  glUnmapBuffer(target);
+  GLState::BindBuffer(target, 0);
+  mappedPointer = nullptr;
+}
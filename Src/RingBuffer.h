@@ -0,0 +1,77 @@
+/**
+* @file RingBuffer.h
+*/
+#ifndef RINGBUFFER_H_INCLUDED
+#define RINGBUFFER_H_INCLUDED
+#include <GL/glew.h>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+/**
+* 毎フレーム書き換えるデータ用のリングバッファ.
+*
+* バッファオブジェクトを複数の「フレーム区画」に分け、BeginFrame()のたびに次の区画へ移る.
+* 区画を再利用する前には、その区画を使った描画が終わっていることをフェンスで確認する.
+*
+* 永続マップ(GL_ARB_buffer_storage)が使える場合、Allocate()はバッファのメモリを直接指すポインタを返すので、
+* CPU側で一時的なバッファを作ってglBufferSubDataで転送する必要はない.
+* 使えない場合は区画ごとに同期なしでマップし、EndFrame()でアンマップする.
+*
+* Allocate()は複数のスレッドから同時に呼び出してよい. それ以外の関数はメインスレッドから呼び出すこと.
+*/
+class RingBuffer
+{
+public:
+  // フェンス待ちの統計情報. Init()またはResetStatistics()からの累計.
+  struct Statistics
+  {
+    uint32_t frameCount = 0;   ///< BeginFrame()を呼んだ回数.
+    uint32_t stallCount = 0;   ///< GPUの処理が終わっていなくて待った回数.
+    double stallTime = 0;      ///< 待った時間の合計(秒).
+    double maxStallTime = 0;   ///< 1回に待った時間の最大値(秒).
+    double lastStallTime = 0;  ///< 最後のBeginFrame()で待った時間(秒).
+  };
+
+  RingBuffer() = default;
+  ~RingBuffer() { Destroy(); }
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  bool Init(GLenum target, GLsizeiptr frameSize, size_t frameCount = 3, GLsizeiptr alignment = 4);
+  void Destroy();
+  void BeginFrame();
+  void EndFrame();
+  void* Allocate(GLsizeiptr size, GLintptr& offset);
+  GLuint Id() const { return id; }
+  GLsizeiptr FrameSize() const { return frameSize; }
+  size_t FrameCount() const { return frames.size(); }
+  GLsizeiptr UsedSize() const { return usedSize.load(std::memory_order_relaxed); }
+  bool IsPersistent() const { return isPersistent; }
+  const Statistics& GetStatistics() const { return statistics; }
+  void ResetStatistics() { statistics = Statistics(); }
+
+private:
+  // フレーム区画.
+  struct Frame
+  {
+    GLintptr offset = 0;    ///< バッファ先頭からのバイトオフセット.
+    GLsync fence = nullptr; ///< この区画を使う描画命令の完了を待つためのフェンス.
+  };
+
+  bool Map();
+  void Unmap();
+
+  GLenum target = GL_ARRAY_BUFFER;
+  GLuint id = 0;
+  GLsizeiptr frameSize = 0;
+  GLsizeiptr alignment = 4;
+  std::atomic<GLsizeiptr> usedSize{ 0 }; ///< 現在の区画で割り当て済みのバイト数.
+  std::vector<Frame> frames;
+  size_t current = 0;
+  uint8_t* mappedPointer = nullptr; ///< 永続マップならバッファ先頭、そうでなければ現在の区画の先頭.
+  bool isPersistent = false;
+  Statistics statistics;
+};
+
+#endif // RINGBUFFER_H_INCLUDED
@@ -6,9 +6,9 @@
 #include <iostream>
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param name V[.
+* @param name シーン名.
 */
 Scene::Scene(const char* name) : name(name)
 {
@@ -16,7 +16,7 @@ Scene::Scene(const char* name) : name(name)
 }
 
 /**
-* fXgN^.
+* デストラクタ.
 */
 Scene::~Scene()
 {
@@ -25,7 +25,7 @@ Scene::~Scene()
 }
 
 /**
-* V[Ԃɂ.
+* シーンを活動状態にする.
 */
 void Scene::Play()
 {
@@ -34,7 +34,7 @@ void Scene::Play()
 }
 
 /**
-* V[~Ԃɂ.
+* シーンを停止状態にする.
 */
 void Scene::Stop()
 {
@@ -43,7 +43,7 @@ void Scene::Stop()
 }
 
 /**
-* V[\.
+* シーンを表示する.
 */
 void Scene::Show()
 {
@@ -52,7 +52,7 @@ void Scene::Show()
 }
 
 /**
-* V[\ɂ.
+* シーンを非表示にする.
 */
 void Scene::Hide()
 {
@@ -61,9 +61,9 @@ void Scene::Hide()
 }
 
 /**
-* V[擾.
+* シーン名を取得する.
 *
-* @return V[.
+* @return シーン名.
 */
 const std::string& Scene::Name() const
 {
@@ -71,10 +71,10 @@ const std::string& Scene::Name() const
 }
 
 /**
-* V[̊Ԃ𒲂ׂ.
+* シーンの活動状態を調べる.
 *
-* @retval true  Ă.
-* @retval false ~Ă.
+* @retval true  活動している.
+* @retval false 停止している.
 */
 bool Scene::IsActive() const
 {
@@ -82,10 +82,10 @@ bool Scene::IsActive() const
 }
 
 /**
-* V[̕\Ԃ𒲂ׂ.
+* シーンの表示状態を調べる.
 *
-* @retval true  \.
-* @retval false \.
+* @retval true  表示状態.
+* @retval false 非表示状態.
 */
 bool Scene::IsVisible() const
 {
@@ -93,9 +93,9 @@ bool Scene::IsVisible() const
 }
 
 /**
-* V[X^bÑVOgCX^X擾.
+* シーンスタックのシングルトンインスタンスを取得する.
 *
-* @return V[X^bÑVOgCX^X.
+* @return シーンスタックのシングルトンインスタンス.
 */
 SceneStack& SceneStack::Instance()
 {
@@ -104,7 +104,7 @@ SceneStack& SceneStack::Instance()
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 SceneStack::SceneStack()
 {
@@ -112,9 +112,9 @@ SceneStack::SceneStack()
 }
 
 /**
-* V[vbV.
+* シーンをプッシュする.
 *
-* @param p VV[.
+* @param p 新しいシーン.
 */
 void SceneStack::Push(ScenePtr p)
 {
@@ -128,18 +128,19 @@ void SceneStack::Push(ScenePtr p)
 }
 
 /**
-* V[|bv.
+* シーンをポップする.
 */
 void SceneStack::Pop()
 {
   if (stack.empty()) {
-    std::cout << "SceneStack Pop: [x]V[X^bNł.\n";
+    std::cout << "SceneStack Pop: [警告]シーンスタックが空です.\n";
     return;
   }
   Current().Stop();
   Current().Finalize();
   const std::string sceneName = Current().Name();
   stack.pop_back();
+  Texture::Cache::Instance().Purge();
   std::cout << "SceneStack Pop: " << sceneName << "\n";
   if (!stack.empty()) {
     Current().Play();
@@ -147,20 +148,21 @@ void SceneStack::Pop()
 }
 
 /**
-* V[u.
+* シーンを置き換える.
 *
-* @param p VV[.
+* @param p 新しいシーン.
 */
 void SceneStack::Replace(ScenePtr p)
 {
   std::string sceneName = "(Empty)";
   if (stack.empty()) {
-    std::cout << "SceneStack Replace: [x]V[X^bNł.\n";
+    std::cout << "SceneStack Replace: [警告]シーンスタックが空です.\n";
   } else {
     sceneName = Current().Name();
     Current().Stop();
     Current().Finalize();
     stack.pop_back();
+    Texture::Cache::Instance().Purge();
   }
   stack.push_back(p);
   std::cout << "SceneStack Replace: " << sceneName << " -> " << p->Name() << "\n";
@@ -169,9 +171,9 @@ void SceneStack::Replace(ScenePtr p)
 }
 
 /**
-* ݂̃V[擾.
+* 現在のシーンを取得する.
 *
-* @return ݂̃V[.
+* @return 現在のシーン.
 */
 Scene& SceneStack::Current()
 {
@@ -179,9 +181,9 @@ Scene& SceneStack::Current()
 }
 
 /**
-* ݂̃V[擾.
+* 現在のシーンを取得する.
 *
-* @return ݂̃V[.
+* @return 現在のシーン.
 */
 const Scene& SceneStack::Current() const
 {
@@ -189,9 +191,9 @@ const Scene& SceneStack::Current() const
 }
 
 /**
-* V[̐擾.
+* シーンの数を取得する.
 *
-* @return X^bNɐς܂ĂV[̐.
+* @return スタックに積まれているシーンの数.
 */
 size_t SceneStack::Size() const
 {
@@ -199,10 +201,10 @@ size_t SceneStack::Size() const
 }
 
 /**
-* X^bN󂩂ǂ𒲂ׂ.
+* スタックが空かどうかを調べる.
 *
-* @retval true  X^bN͋.
-* @retval false X^bN1ȏ̃V[ς܂Ă.
+* @retval true  スタックは空.
+* @retval false スタックに1つ以上のシーンが積まれている.
 */
 bool SceneStack::Empty() const
 {
@@ -210,9 +212,9 @@ bool SceneStack::Empty() const
 }
 
 /**
-* V[XV.
+* シーンを更新する.
 *
-* @param deltaTime O̍XV̌oߎ(b).
+* @param deltaTime 前回の更新からの経過時間(秒).
 */
 void SceneStack::Update(float deltaTime)
 {
@@ -227,7 +229,7 @@ void SceneStack::Update(float deltaTime)
 }
 
 /**
-* V[`悷.
+* シーンを描画する.
 */
 void SceneStack::Render()
 {
@@ -240,9 +242,9 @@ void SceneStack::Render()
 }
 
 /**
-* tF[hCEtF[hAEgNX̃VOgCX^X擾.
+* フェードイン・フェードアウト制御クラスのシングルトンインスタンスを取得する.
 *
-* @return tF[hCEtF[hAEgNX̃VOgCX^X.
+* @return フェードイン・フェードアウト制御クラスのシングルトンインスタンス.
 */
 SceneFader& SceneFader::Instance()
 {
@@ -251,7 +253,7 @@ SceneFader& SceneFader::Instance()
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 SceneFader::SceneFader()
 {
@@ -264,21 +266,21 @@ SceneFader::SceneFader()
 }
 
 /**
-* tF[hCEtF[hAEg̏ԂXV.
+* フェードイン・フェードアウトの状態を更新する.
 *
-* @param deltaTime O̍XV̌oߎ(b).
+* @param deltaTime 前回の更新からの経過時間(秒).
 */
 void SceneFader::Update(float deltaTime)
 {
   if (mode != Mode::none) {
-    // ʑŜ𕢂悤ɃXvCg̃TCY𒲐.
+    // 画面全体を覆うようにスプライトのサイズを調整.
     glm::vec2 scale;
     GLFWEW::Window& window = GLFWEW::Window::Instance();
     scale.x = static_cast<float>(window.Width()) / static_cast<float>(spr.Texture()->Width());
     scale.y = static_cast<float>(window.Height()) / static_cast<float>(spr.Texture()->Height());
     spr.Scale(scale);
 
-    // oߎԂɉĕsxXV.
+    // 経過時間に応じて不透明度を更新.
     glm::vec4 color = spr.Color();
     if (mode == Mode::fadeIn) {
       color.a = timer / totalTime;
@@ -287,12 +289,12 @@ void SceneFader::Update(float deltaTime)
     }
     spr.Color(color);
 
-    // XvCgXvCg`NXɒǉ.
+    // スプライトをスプライト描画クラスに追加.
     spriteRenderer.BeginUpdate();
     spriteRenderer.AddVertices(spr);
     spriteRenderer.EndUpdate();
 
-    // oߎԃ^C}[XV.
+    // 経過時間タイマー更新.
     timer -= deltaTime;
     if (timer <= 0) {
       timer = 0;
@@ -304,7 +306,7 @@ void SceneFader::Update(float deltaTime)
 }
 
 /**
-* tF[hCEtF[hAEg`悷.
+* フェードイン・フェードアウトを描画する.
 */
 void SceneFader::Render() const
 {
@@ -315,10 +317,10 @@ void SceneFader::Render() const
 }
 
 /**
-* tF[hAEgJn.
+* フェードアウトを開始する.
 *
-* @param time  tF[hAEgɂ鎞(b).
-* @param color tF[hAEg̐F.
+* @param time  フェードアウトにかかる時間(秒).
+* @param color フェードアウト先の色.
 */
 void SceneFader::FadeOut(float time, const glm::vec3& color)
 {
@@ -328,9 +330,9 @@ void SceneFader::FadeOut(float time, const glm::vec3& color)
 }
 
 /**
-* tF[hCJn.
+* フェードインを開始する.
 *
-* @param time tF[hCɂ鎞(b).
+* @param time フェードインにかかる時間(秒).
 */
 void SceneFader::FadeIn(float time)
 {
@@ -342,10 +344,10 @@ void SceneFader::FadeIn(float time)
 }
 
 /**
-* tF[hC(܂̓tF[hAEg)ׂ.
+* フェードイン(またはフェードアウト)中か調べる.
 *
-* @retval true  tF[hC(܂̓tF[hAEg).
-* @retval false tF[hC(܂̓tF[hAEg)͏IĂ.
+* @retval true  フェードイン(またはフェードアウト)中.
+* @retval false フェードイン(またはフェードアウト)は終了している.
 */
 bool SceneFader::IsFading() const
 {
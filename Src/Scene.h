@@ -11,7 +11,7 @@
 class SceneStack;
 
 /**
-* V[̊NX.
+* シーンの基底クラス.
 */
 class Scene {
 public:
@@ -43,7 +43,7 @@ private:
 using ScenePtr = std::shared_ptr<Scene>;
 
 /**
-* V[ǗNX.
+* シーン管理クラス.
 */
 class SceneStack {
 public:
@@ -70,17 +70,17 @@ private:
 };
 
 /**
-* V[EtF[_[.
+* シーン・フェーダー.
 *
-* tF[hCEtF[hAEg𐧌䂷NX.
+* フェードイン・フェードアウトを制御するクラス.
 */
 class SceneFader
 {
 public:
   enum class Mode {
-    none, ///< tF[hCEtF[hAEgĂȂ(IĂ).
-    fadeIn, ///< tF[hC.
-    fadeOut, ///< tF[hAEg.
+    none, ///< フェードイン・フェードアウトをしていない(終了している).
+    fadeIn, ///< フェードイン中.
+    fadeOut, ///< フェードアウト中.
   };
 
   static SceneFader& Instance();
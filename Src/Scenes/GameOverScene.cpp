@@ -6,17 +6,17 @@
 #include "TitleScene.h"
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 GameOverScene::GameOverScene() : Scene("GameOverScene")
 {
 }
 
 /**
-* V[.
+* シーンを初期化する.
 *
-* @retval true  .
-* @retval false s. Q[issɂAvOI邱.
+* @retval true  初期化成功.
+* @retval false 初期化失敗. ゲーム進行不可につき、プログラムを終了すること.
 */
 bool GameOverScene::Initialize()
 {
@@ -27,7 +27,7 @@ bool GameOverScene::Initialize()
 }
 
 /**
-* V[̓͂.
+* シーンの入力を処理する.
 */
 void GameOverScene::ProcessInput()
 {
@@ -46,24 +46,24 @@ void GameOverScene::ProcessInput()
 }
 
 /**
-* V[XV.
+* シーンを更新する.
 *
-* @param deltaTime  O̍XV̌oߎ(b).
+* @param deltaTime  前回の更新からの経過時間(秒).
 */
 void GameOverScene::Update(float deltaTime)
 {
   fontRenderer.BeginUpdate();
   fontRenderer.Scale(glm::vec2(1));
   fontRenderer.Color(glm::vec4(1));
-  fontRenderer.AddString(glm::vec2(-600, 320), L"Q[I[o[");
+  fontRenderer.AddString(glm::vec2(-600, 320), L"ゲームオーバー画面");
   fontRenderer.Scale(glm::vec2(3));
   fontRenderer.Color(glm::vec4(1, 0.2f, 0.1f, 1));
-  fontRenderer.AddString(glm::vec2(-288, 0), L"Q[I[o[");
+  fontRenderer.AddString(glm::vec2(-288, 0), L"ゲームオーバー");
   fontRenderer.EndUpdate();
 }
 
 /**
-* V[`悷.
+* シーンを描画する.
 */
 void GameOverScene::Render()
 {
@@ -73,7 +73,7 @@ void GameOverScene::Render()
 }
 
 /**
-* V[j.
+* シーンを破棄する.
 */
 void GameOverScene::Finalize()
 {
@@ -7,7 +7,7 @@
 #include "../Font.h"
 
 /**
-* Q[I[o[.
+* ゲームオーバー画面.
 */
 class GameOverScene : public Scene
 {
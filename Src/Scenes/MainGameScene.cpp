@@ -6,6 +6,8 @@
 #include "GameOverScene.h"
 #include "../Actor/ObjectiveActor.h"
 #include "../GLFWEW.h"
+#include "../TextureStreamer.h"
+#include "../GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <random>
 #include <sstream>
@@ -13,29 +15,29 @@
 #include <iostream>
 
 /*
-  bZ[W[h̊Jn begin x
-  msg eLXg
-  select I
-  set ϐԍ lorϐԍ
-  add ϐԍ lorϐԍ
-  sub ϐԍ lorϐԍ
-  if ϐԍ(0łȂ) Wv惉x
-  bZ[W[h̏I end
-
-  ̍u`\:
-  - bV\
-  - nCg}bv
-  - glTFbV\({[iXgbN:@Aj[V)
-  - Ƌ̏Փ˔
-  - `Ƌ̏Փ˔
-  - Cxg(bAtO)
+  メッセージモードの開始 begin ラベル
+  msg テキスト
+  select 選択肢
+  set 変数番号 数値or変数番号
+  add 変数番号 数値or変数番号
+  sub 変数番号 数値or変数番号
+  if 変数番号(が0でなければ) ジャンプ先ラベル
+  メッセージモードの終了 end
+
+  今後の講義予定:
+  - メッシュ表示
+  - ハイトマップ
+  - glTFメッシュ表示(ボーナストラック:　アニメーション)
+  - 球と球の衝突判定
+  - 矩形と球の衝突判定
+  - イベント処理(会話、フラグ制御)
 */
 
 /**
-* vC[ƏQ̏Փ˂.
+* プレイヤーと障害物の衝突を解決する.
 *
-* @param a  Փ˂AN^[̂P.
-* @param b  Փ˂AN^[̂Q.
+* @param a  衝突したアクターその１.
+* @param b  衝突したアクターその２.
 */
 void PlayerObstacleCollisionHandler(const ActorPtr& a, const ActorPtr& b, const glm::vec3& p)
 {
@@ -69,24 +71,32 @@ void PlayerObstacleCollisionHandler(const ActorPtr& a, const ActorPtr& b, const
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 MainGameScene::MainGameScene() : Scene("MainGameScene")
 {
 }
 
 /**
-* V[.
+* シーンを初期化する.
 *
-* @retval true  .
-* @retval false s. Q[issɂAvOI邱.
+* @retval true  初期化成功.
+* @retval false 初期化失敗. ゲーム進行不可につき、プログラムを終了すること.
 */
 bool MainGameScene::Initialize()
 {
   fontRenderer.Init(1000);
   fontRenderer.LoadFromFile("Res/font.fnt");
 
-  meshBuffer.Init(sizeof(Mesh::Vertex) * 1'000'000, sizeof(GLushort) * 3'000'000, 1024);
+  // HUDのアイコンはアトラスにまとめておく. 種類の違うアイコンが交互に並んでも、描画は1回で済む.
+  hudRenderer.Init(64, "Res/Sprite.vert", "Res/Sprite.frag");
+  hudRenderer.SortByTexture(true);
+  hudAtlas.Init(256);
+  hudAtlas.Add("Res/jizo_statue.tga");
+  hudAtlas.Add("Res/effect_curse.tga");
+
+  // 足りなくなったらページが追加されるので、最大容量を確保しておく必要はない.
+  meshBuffer.Init(sizeof(Mesh::Vertex) * 50'000, sizeof(GLushort) * 500'000, 1024);
   heightMap.Load("Res/HeightMap.tga", 50.0f, 0.5f);
   heightMap.CreateMesh(meshBuffer, "Terrain", "Res/ColorMap.tga");
 
@@ -104,6 +114,8 @@ bool MainGameScene::Initialize()
   meshBuffer.LoadSkeletalMesh("Res/effect_hit_normal.gltf");
   meshBuffer.LoadSkeletalMesh("Res/effect_curse.gltf");
   meshBuffer.LoadSkeletalMesh("Res/watermill.gltf");
+  meshBuffer.PrintUsage();
+  Texture::Cache::Instance().PrintStatistics();
 
   terrain = std::make_shared<StaticMeshActor>(meshBuffer.GetMesh("Terrain"), "Terrain", 100, glm::vec3(0));
 
@@ -173,6 +185,22 @@ bool MainGameScene::Initialize()
     }
   }
 
+  // 遠くの樹木と草を置き換えるインポスターを作成.
+  // 焼き付けには最終的なテクスチャが必要なので、非同期読み込みの完了を待つ.
+  if (impostorRenderer.Init(4, treeCount + weedCount)) {
+    Texture::Streamer::Instance().Flush();
+    impostorRenderer.Bake(meshBuffer, meshBuffer.GetMesh("RedPineTree"));
+    impostorRenderer.Bake(meshBuffer, meshBuffer.GetMesh("Weed.Susuki"));
+    impostorRenderer.Bake(meshBuffer, meshBuffer.GetMesh("Weed.Kazekusa"));
+    impostorRenderer.Bake(meshBuffer, meshBuffer.GetMesh("Weed.Chigaya"));
+  }
+
+  // 遠くの鬼をまとめて描画するため、アニメーションをテクスチャに焼き付ける.
+  if (crowdRenderer.Init(oniCount)) {
+    crowdRenderer.Bake(*meshBuffer.GetSkeletalMesh("oni_small"));
+    crowdRenderer.Bake(*meshBuffer.GetSkeletalMesh("OniMedium"));
+  }
+
   {
     buildings.Reserve(10);
     glm::vec3 position = startPos + glm::vec3(20, 5, 3);
@@ -217,7 +245,7 @@ bool MainGameScene::Initialize()
     position = startPos + glm::vec3(-20, 0, 25);
     position.y = heightMap.Height(position);
     p = std::make_shared<StaticMeshActor>(meshBuffer.GetMesh("WoodWell"), "WoodWell", 100, position, glm::vec3(0, glm::radians(30.0f), 0));
-    // ]eXg
+    // 軸回転テスト
     const glm::mat4 matR = glm::rotate(glm::mat4(1), glm::radians(0.0f), glm::vec3(0, 1, 0));
     p->colLocal = Collision::CreateOBB({ 0, 0, 0 }, matR * glm::vec4(1, 0, 0, 1), matR * glm::vec4(0, 1, 0, 1), matR * glm::vec4(0, 0,-1, 1), {1, 2, 1});
     buildings.Add(p);
@@ -285,7 +313,7 @@ bool MainGameScene::Initialize()
 }
 
 /**
-* V[̓͂.
+* シーンの入力を処理する.
 */
 void MainGameScene::ProcessInput()
 {
@@ -329,7 +357,7 @@ void MainGameScene::ProcessInput()
       }
     }
 #endif
-    // V[؂ւ.
+    // シーン切り替え.
     const GamePad gamepad = window.GetGamePad();
     if (gamepad.buttonDown & GamePad::START) {
       SceneStack::Instance().Push(std::make_shared<StatusScene>());
@@ -340,19 +368,19 @@ void MainGameScene::ProcessInput()
 }
 
 /**
-* V[XV.
+* シーンを更新する.
 *
-* @param deltaTime  O̍XV̌oߎ(b).
+* @param deltaTime  前回の更新からの経過時間(秒).
 *
-* TODO: nʂ̏ړ...ok
-* TODO: Wv...ok
-* TODO: UƍU...ok
-* TODO: G̏o.
-* TODO: G̎vl.
-* TODO: ؂A...ok
-* TODO: lƉb.
-* TODO: {X.
-* TODO: @.
+* TODO: 地面の上を移動...ok
+* TODO: ジャンプ動作...ok
+* TODO: 攻撃動作と攻撃判定...ok
+* TODO: 敵の出現.
+* TODO: 敵の思考.
+* TODO: 木を植える...ok
+* TODO: 村人と会話.
+* TODO: ボス.
+* TODO: 法力.
 */
 void MainGameScene::Update(float deltaTime)
 {
@@ -477,33 +505,97 @@ void MainGameScene::Update(float deltaTime)
   trees.UpdateDrawData(deltaTime);
   vegetations.UpdateDrawData(deltaTime);
   buildings.UpdateDrawData(deltaTime);
-  enemies.UpdateDrawData(deltaTime);
+  UpdateEnemyDrawData(deltaTime);
   effects.UpdateDrawData(deltaTime);
   objectives.UpdateDrawData(deltaTime);
 
+  // 地蔵ごとに、アイコンと呪いの印を表示する. 呪いを解いた地蔵は明るく表示する.
+  {
+    hudRenderer.BeginUpdate();
+    const float hh = static_cast<float>(window.Height()) * 0.5f;
+    Sprite jizo;
+    Sprite curse;
+    if (hudAtlas.Get("Res/jizo_statue.tga", jizo) && hudAtlas.Get("Res/effect_curse.tga", curse)) {
+      jizo.Scale(glm::vec2(0.375f));
+      curse.Scale(glm::vec2(0.75f));
+      glm::vec3 pos(-576, hh - 112, 0);
+      for (const auto& e : objectives) {
+        const bool isAchieved = std::static_pointer_cast<ObjectiveActor>(e)->IsAchieved();
+        jizo.Position(pos);
+        jizo.Color(isAchieved ? glm::vec4(1) : glm::vec4(0.4f, 0.4f, 0.4f, 1));
+        hudRenderer.AddVertices(jizo);
+        if (!isAchieved) {
+          curse.Position(pos + glm::vec3(0, -28, 0));
+          hudRenderer.AddVertices(curse);
+        }
+        pos.x += 56;
+      }
+    }
+    hudRenderer.EndUpdate();
+  }
+
   {
     fontRenderer.BeginUpdate();
     fontRenderer.Scale(glm::vec2(1));
     const float hh = static_cast<float>(window.Height()) * 0.5f;
     const float lh = fontRenderer.LineHeight();
     if (IsActive()) {
-      fontRenderer.AddString(glm::vec2(380, hh - lh), L"CQ[");
+      fontRenderer.AddString(glm::vec2(380, hh - lh), L"メインゲーム画面");
       std::wstringstream wss;
       wss << L"FPS:" << std::fixed << std::setprecision(2) << window.Fps();
       fontRenderer.AddString(glm::vec2(500, hh - lh * 2), wss.str().c_str());
+
+      // 前のフレームで発行したバインドとユニフォーム設定の数(括弧内は省略した数).
+      const GLState::Statistics& stat = GLState::LastFrameStatistics();
+      const GLState::Counter* counters[] = { &stat.program, &stat.vertexArray, &stat.buffer, &stat.texture, &stat.uniform };
+      uint32_t issued = 0;
+      uint32_t skipped = 0;
+      for (const GLState::Counter* e : counters) {
+        issued += e->issued;
+        skipped += e->skipped;
+      }
+      wss.str(L"");
+      wss << L"GL:" << issued << L"(" << skipped << L")";
+      // HUDのアイコンの描画回数.
+      wss << L" HUD:" << hudRenderer.DrawCount();
+      // リングバッファがGPUを待った回数と時間.
+      wss << L" Stall:" << stat.fenceStallCount << L"/" << stat.fenceWaitCount <<
+        L"(" << std::setprecision(2) << stat.fenceStallTime * 1000.0 << L"ms)";
+      fontRenderer.AddString(glm::vec2(500, hh - lh * 3), wss.str().c_str());
+
+      // 姿勢キャッシュで再利用できた姿勢の数/姿勢を要求した数.
+      const Mesh::GlobalSkeletalMeshState::PoseCacheStatistics& poseStat =
+        Mesh::GlobalSkeletalMeshState::GetPoseCacheStatistics();
+      wss.str(L"");
+      wss << L"Pose:" << poseStat.hitCount << L"/" << (poseStat.hitCount + poseStat.missCount);
+
+      // アニメーションLODで姿勢を更新した数/間引いた数/画面外で固定した数.
+      const Mesh::GlobalSkeletalMeshState::AnimationLodStatistics& lodStat =
+        Mesh::GlobalSkeletalMeshState::GetAnimationLodStatistics();
+      wss << L" AnimLOD:" << lodStat.updateCount << L"/" << lodStat.throttledCount << L"/" << lodStat.frozenCount;
+      fontRenderer.AddString(glm::vec2(500, hh - lh * 4), wss.str().c_str());
+
+      // 骨格アニメーション用UBOの区画数と、GPUを待った時間(前のフレーム/最大).
+      const Mesh::GlobalSkeletalMeshState::UniformBufferStatistics uboStat =
+        Mesh::GlobalSkeletalMeshState::GetUniformBufferStatistics();
+      wss.str(L"");
+      wss << L"SkinUBO:" << uboStat.framesInFlight << L"f " << uboStat.stallCount << L"/" << uboStat.frameCount <<
+        L"(" << std::setprecision(2) << uboStat.lastStallTime * 1000.0 << L"/" << uboStat.maxStallTime * 1000.0 <<
+        L"ms)";
+      fontRenderer.AddString(glm::vec2(500, hh - lh * 5), wss.str().c_str());
     }
     {
       std::wstringstream wss;
-      wss << L"̗́F";
+      wss << L"体力：";
       for (int i = 0; i < player->health; i += 4) {
-        wss << L"";
+        wss << L"●";
       }
       fontRenderer.AddString(glm::vec2(-600, hh - lh * 2), wss.str().c_str());
     }
 
     if (isMissionAccomplished) {
       fontRenderer.Scale(glm::vec2(2));
-      fontRenderer.AddString(glm::vec2(-400, 0), L"SĂ̒n̎􂢂I");
+      fontRenderer.AddString(glm::vec2(-400, 0), L"全ての地蔵の呪いを解いた！");
     } else {
       int achievementCount = 0;
       for (const auto& e : objectives) {
@@ -533,25 +625,27 @@ void MainGameScene::Update(float deltaTime)
 }
 
 /**
-* V[`悷.
+* シーンを描画する.
 */
 void MainGameScene::Render()
 {
   const GLFWEW::Window& window = GLFWEW::Window::Instance();
 
   glm::mat4 matView;
+  glm::vec3 cameraPos;
   if (window.KeyPressed(GLFW_KEY_SPACE)) {
     const glm::aligned_vec3 front = glm::rotate(glm::mat4(1), player->rotation.y, glm::vec3(0, 1, 0)) * glm::aligned_vec4(0, 0, 1, 1);
-    const glm::aligned_vec3 cameraPos = player->position + glm::vec3(0, 1.3f, 0);
-    matView = glm::lookAt(cameraPos, cameraPos + front * 5.0f, glm::aligned_vec3(0, 1, 0));
+    cameraPos = player->position + glm::vec3(0, 1.3f, 0);
+    matView = glm::lookAt(cameraPos, cameraPos + glm::vec3(front) * 5.0f, glm::vec3(0, 1, 0));
   } else {
-    const glm::vec3 cameraPos = player->position + glm::vec3(0, 50, 50) * 0.25f;
+    cameraPos = player->position + glm::vec3(0, 50, 50) * 0.25f;
     matView = glm::lookAt(cameraPos, player->position + glm::vec3(0, 1.25f, 0), glm::vec3(0, 1, 0));
   }
   const float aspectRatio = static_cast<float>(window.Width()) / static_cast<float>(window.Height());
   const glm::mat4 matProj = glm::perspective(glm::radians(30.0f), aspectRatio, 1.0f, 1000.0f);
+  const glm::mat4 matVP = matProj * matView;
 
-  meshBuffer.SetViewProjectionMatrix(matProj * matView);
+  meshBuffer.SetViewProjectionMatrix(matVP);
   {
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -563,13 +657,19 @@ void MainGameScene::Render()
 
     glDisable(GL_CULL_FACE);
 
-    trees.Draw();
-    vegetations.Draw();
+    impostorRenderer.BeginUpdate();
+    DrawVegetation(trees, cameraPos);
+    DrawVegetation(vegetations, cameraPos);
+    impostorRenderer.EndUpdate();
+    impostorRenderer.Draw(matVP, cameraPos);
 
     glEnable(GL_CULL_FACE);
 
     player->Draw();
-    enemies.Draw();
+    for (const ActorPtr& e : detailedEnemies) {
+      e->Draw();
+    }
+    crowdRenderer.Draw(matVP);
     objectives.Draw();
 
     glDisable(GL_CULL_FACE);
@@ -577,15 +677,83 @@ void MainGameScene::Render()
   }
 
   const glm::vec2 screenSize(window.Width(), window.Height());
+  hudRenderer.Draw(screenSize);
   fontRenderer.Draw(screenSize);
 
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glUseProgram(0);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  GLState::UseProgram(0);
+}
+
+/**
+* 樹木や草を描画する.
+*
+* @param actors    描画するアクターのリスト. StaticMeshActorだけを格納していること.
+* @param cameraPos 視点の座標.
+*
+* 視点から一定以上離れているアクターは、メッシュの代わりにインポスターとして登録する.
+* 登録したインポスターはImpostorRenderer::Draw()でまとめて描画される.
+*/
+void MainGameScene::DrawVegetation(const ActorList& actors, const glm::vec3& cameraPos)
+{
+  const float distance = impostorRenderer.Distance();
+  const float distanceSq = distance * distance;
+  for (const ActorPtr& e : actors) {
+    if (!e || e->health <= 0) {
+      continue;
+    }
+    const glm::vec3 v = e->position - cameraPos;
+    if (glm::dot(v, v) >= distanceSq) {
+      const StaticMeshActorPtr p = std::static_pointer_cast<StaticMeshActor>(e);
+      if (p->GetMesh() &&
+        impostorRenderer.AddInstance(*p->GetMesh(), p->position, p->rotation.y, p->scale, p->color)) {
+        continue;
+      }
+    }
+    e->Draw();
+  }
+}
+
+/**
+* 敵の描画データを更新する.
+*
+* @param deltaTime 前回の更新からの経過時間.
+*
+* プレイヤーから一定以上離れている敵は、姿勢を計算せずに再生位置だけを進め、群衆描画クラスに登録する.
+* それ以外の敵は通常どおり姿勢を計算し、detailedEnemiesに追加する.
+*/
+void MainGameScene::UpdateEnemyDrawData(float deltaTime)
+{
+  const float distance = crowdRenderer.Distance();
+  const float distanceSq = distance * distance;
+  detailedEnemies.clear();
+  crowdRenderer.BeginUpdate();
+  for (const ActorPtr& e : enemies) {
+    if (!e || e->health <= 0) {
+      continue;
+    }
+    const glm::vec3 v = e->position - player->position;
+    if (glm::dot(v, v) >= distanceSq) {
+      const SkeletalMeshActorPtr p = std::static_pointer_cast<SkeletalMeshActor>(e);
+      const Mesh::SkeletalMeshPtr& mesh = p->GetMesh();
+      if (mesh && crowdRenderer.HasBakedAnimation(*mesh)) {
+        mesh->AdvanceFrame(deltaTime);
+        if (crowdRenderer.AddInstance(*mesh, p->CalcModelMatrix(), p->color)) {
+          continue;
+        }
+        // 登録できなかった場合は、進めた再生位置はそのままで姿勢を計算する.
+        mesh->Update(0, p->CalcModelMatrix(), p->color);
+        detailedEnemies.push_back(e);
+        continue;
+      }
+    }
+    e->UpdateDrawData(deltaTime);
+    detailedEnemies.push_back(e);
+  }
+  crowdRenderer.EndUpdate();
 }
 
 /**
-* V[j.
+* シーンを破棄する.
 */
 void MainGameScene::Finalize()
 {
@@ -593,7 +761,7 @@ void MainGameScene::Finalize()
 }
 
 /**
-* V[Ԃɂ.
+* シーンを活動状態にする.
 */
 void MainGameScene::Play()
 {
@@ -9,12 +9,15 @@
 #include "../Texture.h"
 #include "../Shader.h"
 #include "../Font.h"
+#include "../SpriteAtlas.h"
 #include "../Terrain.h"
+#include "../Impostor.h"
+#include "../CrowdRenderer.h"
 #include "../Actor/PlayerActor.h"
 #include <random>
 
 /**
-* CQ[.
+* メインゲーム画面.
 */
 class MainGameScene : public Scene
 {
@@ -28,14 +31,22 @@ public:
   virtual void Play() override;
 
 private:
+  void DrawVegetation(const ActorList& actors, const glm::vec3& cameraPos);
+  void UpdateEnemyDrawData(float deltaTime);
+
   Font::Renderer fontRenderer;
+  SpriteRenderer hudRenderer;
+  SpriteAtlas hudAtlas; // HUDのアイコン. 1枚のテクスチャにまとめて、1回で描画する.
   Mesh::Buffer meshBuffer;
+  ImpostorRenderer impostorRenderer;
+  CrowdRenderer crowdRenderer;
   PlayerActorPtr player;
   StaticMeshActorPtr terrain;
   ActorList trees;
   ActorList vegetations;
   ActorList buildings;
   ActorList enemies;
+  std::vector<ActorPtr> detailedEnemies; // 群衆描画でなく、個別に描画する敵.
   ActorList effects;
   ActorList objectives;
 
@@ -5,17 +5,17 @@
 #include "../GLFWEW.h"
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 StatusScene::StatusScene() : Scene("StatusScene")
 {
 }
 
 /**
-* V[.
+* シーンを初期化する.
 *
-* @retval true  .
-* @retval false s. Q[issɂAvOI邱.
+* @retval true  初期化成功.
+* @retval false 初期化失敗. ゲーム進行不可につき、プログラムを終了すること.
 */
 bool StatusScene::Initialize()
 {
@@ -25,7 +25,7 @@ bool StatusScene::Initialize()
 }
 
 /**
-* V[̓͂.
+* シーンの入力を処理する.
 */
 void StatusScene::ProcessInput()
 {
@@ -37,23 +37,23 @@ void StatusScene::ProcessInput()
 }
 
 /**
-* V[XV.
+* シーンを更新する.
 *
-* @param deltaTime  O̍XV̌oߎ(b).
+* @param deltaTime  前回の更新からの経過時間(秒).
 */
 void StatusScene::Update(float deltaTime)
 {
   fontRenderer.BeginUpdate();
-  fontRenderer.AddString(glm::vec2(-600, 320), L"Xe[^X");
-  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 4), L"̗́F@QO^QQ");
-  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 6), L"@́F@PT^PT");
-  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 8), L"F@̎");
-  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 10), L"hF@Âт֕t");
+  fontRenderer.AddString(glm::vec2(-600, 320), L"ステータス画面");
+  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 4), L"体力：　２０／２２");
+  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 6), L"法力：　１５／１５");
+  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 8), L"武器：　銅の錫杖");
+  fontRenderer.AddString(glm::vec2(-400, 360 - 32 * 10), L"防具：　古びた裳付け衣");
   fontRenderer.EndUpdate();
 }
 
 /**
-* V[`悷.
+* シーンを描画する.
 */
 void StatusScene::Render()
 {
@@ -63,14 +63,14 @@ void StatusScene::Render()
 }
 
 /**
-* V[j.
+* シーンを破棄する.
 */
 void StatusScene::Finalize()
 {
 }
 
 /**
-* V[Ԃɂ.
+* シーンを活動状態にする.
 */
 void StatusScene::Play()
 {
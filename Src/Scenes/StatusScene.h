@@ -7,7 +7,7 @@
 #include "../Font.h"
 
 /**
-* Xe[^X.
+* ステータス画面.
 */
 class StatusScene : public Scene
 {
@@ -7,24 +7,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 TitleScene::TitleScene() : Scene("TitleScene")
 {
 }
 
 /**
-* V[.
+* シーンを初期化する.
 *
-* @retval true  .
-* @retval false s. Q[issɂAvOI邱.
+* @retval true  初期化成功.
+* @retval false 初期化失敗. ゲーム進行不可につき、プログラムを終了すること.
 */
 bool TitleScene::Initialize()
 {
   spriteRenderer.Init(1000, "Res/Sprite.vert", "Res/Sprite.frag");
   fontRenderer.Init(1000);
   fontRenderer.LoadFromFile("Res/font.fnt");
-  Sprite spr(Texture::Image2D::Create("Res/TitleBg.tga"));
+  Sprite spr(Texture::Cache::Instance().Create("Res/TitleBg.tga"));
   spr.Scale(glm::vec2(2));
   sprites.push_back(spr);
 
@@ -37,11 +37,11 @@ bool TitleScene::Initialize()
 }
 
 /**
-* V[̓͂.
+* シーンの入力を処理する.
 */
 void TitleScene::ProcessInput()
 {
-  // V[؂ւ.
+  // シーン切り替え.
   SceneStack& sceneStack = SceneStack::Instance();
   if (!SceneFader::Instance().IsFading()) {
     if (!isNext) {
@@ -59,9 +59,9 @@ void TitleScene::ProcessInput()
 }
 
 /**
-* V[XV.
+* シーンを更新する.
 *
-* @param deltaTime  O̍XV̌oߎ(b).
+* @param deltaTime  前回の更新からの経過時間(秒).
 */
 void TitleScene::Update(float deltaTime)
 {
@@ -77,9 +77,9 @@ void TitleScene::Update(float deltaTime)
   spriteRenderer.EndUpdate();
   fontRenderer.BeginUpdate();
   fontRenderer.Scale(glm::vec2(1));
-  fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lh), L"^Cg");
+  fontRenderer.AddString(glm::vec2(-w * 0.5f + 32, h * 0.5f - lh), L"タイトル画面");
   fontRenderer.Scale(glm::vec2(4));
-  fontRenderer.AddString(glm::vec2(-300, 0), L"uVs^");
+  fontRenderer.AddString(glm::vec2(-300, 0), L"比丘尼遊行録");
   fontRenderer.EndUpdate();
 
   if (isNext) {
@@ -95,7 +95,7 @@ void TitleScene::Update(float deltaTime)
 }
 
 /**
-* V[`悷.
+* シーンを描画する.
 */
 void TitleScene::Render()
 {
@@ -106,7 +106,7 @@ void TitleScene::Render()
 }
 
 /**
-* V[j.
+* シーンを破棄する.
 */
 void TitleScene::Finalize()
 {
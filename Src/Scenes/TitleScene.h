@@ -10,7 +10,7 @@
 #include <vector>
 
 /**
-* ^Cg.
+* タイトル画面.
 */
 class TitleScene : public Scene
 {
@@ -2,30 +2,296 @@
 * @file Shader.cpp
 */
 #include "Shader.h"
+#include "GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <GLFW/glfw3.h>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace Shader {
 
+namespace /* unnamed */ {
+
+/// プログラムバイナリを保存するフォルダ.
+const char binaryCacheDirectory[] = "ShaderCache";
+
+/**
+* キャッシュファイルのヘッダ.
+*/
+struct BinaryCacheHeader
+{
+  char magic[4];        ///< "GLPB".
+  uint32_t version;     ///< ファイル形式のバージョン.
+  uint64_t hash;        ///< シェーダーコードとドライバ情報のハッシュ値.
+  uint32_t format;      ///< glGetProgramBinaryが返したバイナリ形式.
+  uint32_t length;      ///< バイナリのバイト数.
+};
+const uint32_t binaryCacheVersion = 1;
+
 /**
-* VF[_R[hRpC.
+* FNV-1aでハッシュ値を計算する.
 *
-* @param type   VF[_̎.
-* @param string VF[_R[hւ̃|C^.
+* @param hash 計算途中のハッシュ値.
+* @param data ハッシュ値を計算するデータ.
+* @param size dataのバイト数.
 *
-* @return 쐬VF[_IuWFNg.
+* @return 計算したハッシュ値.
 */
-GLuint Compile(GLenum type, const GLchar* string)
+uint64_t HashFNV1a(uint64_t hash, const void* data, size_t size)
 {
-  if (!string) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ p[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/**
+* プログラムバイナリを使えるか調べる.
+*
+* @retval true  使える.
+* @retval false 使えない.
+*/
+bool IsProgramBinarySupported()
+{
+  if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+    return false;
+  }
+  GLint formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  return formatCount > 0;
+}
+
+/**
+* シェーダーコードとドライバ情報からキャッシュのキーを作成する.
+*
+* @param vsCode 頂点シェーダコード.
+* @param fsCode フラグメントシェーダコード.
+*
+* @return キャッシュのキー.
+*
+* ドライバが更新されるとバイナリは使えなくなるので、ドライバ情報もハッシュに含める.
+*/
+uint64_t CreateBinaryCacheKey(const GLchar* vsCode, const GLchar* fsCode)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = HashFNV1a(hash, vsCode, strlen(vsCode) + 1);
+  hash = HashFNV1a(hash, fsCode, strlen(fsCode) + 1);
+  const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+  for (GLenum e : names) {
+    if (const GLubyte* p = glGetString(e)) {
+      hash = HashFNV1a(hash, p, strlen(reinterpret_cast<const char*>(p)) + 1);
+    }
+  }
+  return hash;
+}
+
+/**
+* キャッシュファイル名を取得する.
+*
+* @param key キャッシュのキー.
+*
+* @return キャッシュファイル名.
+*/
+std::string BinaryCachePath(uint64_t key)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.bin", static_cast<unsigned long long>(key));
+  return std::string(binaryCacheDirectory) + name;
+}
+
+/**
+* キャッシュファイルからプログラムオブジェクトの作成を開始する.
+*
+* @param key キャッシュのキー.
+*
+* @retval 0以外 作成を開始したプログラムオブジェクト.
+*               ドライバがバイナリを受け付けたかどうかは、GL_LINK_STATUSで確認すること.
+* @retval 0     キャッシュがない、壊れている、またはドライバがバイナリの形式を受け付けなかった.
+*/
+GLuint StartLoadProgramBinary(uint64_t key)
+{
+  std::ifstream ifs(BinaryCachePath(key), std::ios_base::binary | std::ios_base::ate);
+  if (!ifs) {
+    return 0;
+  }
+  const std::streamoff fileSize = ifs.tellg();
+  ifs.seekg(0);
+  BinaryCacheHeader header;
+  if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+    memcmp(header.magic, "GLPB", 4) != 0 || header.version != binaryCacheVersion || header.hash != key) {
+    return 0;
+  }
+  // 途中で切れたり壊れたりしたファイルの長さを信用しないように、実際のファイルサイズと比較する.
+  if (header.length == 0 || header.length > fileSize - static_cast<std::streamoff>(sizeof(header))) {
+    std::cerr << "WARNING: " << BinaryCachePath(key) << "は壊れています.\n";
+    return 0;
+  }
+  std::vector<char> binary(header.length);
+  if (!ifs.read(binary.data(), header.length)) {
+    return 0;
+  }
+
+  const GLuint program = glCreateProgram();
+  glProgramBinary(program, header.format, binary.data(), header.length);
+
+  // 形式を受け付けない場合はGLエラーになる. 後のエラー確認に残らないように、ここで全て取り出す.
+  bool hasError = false;
+  while (glGetError() != GL_NO_ERROR) {
+    hasError = true;
+  }
+  if (hasError) {
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+/**
+* キャッシュファイルからプログラムオブジェクトを作成する.
+*
+* @param key キャッシュのキー.
+*
+* @retval 0以外 作成したプログラムオブジェクト.
+* @retval 0     キャッシュがない、またはドライバがバイナリを受け付けなかった.
+*/
+GLuint LoadProgramBinary(uint64_t key)
+{
+  const GLuint program = StartLoadProgramBinary(key);
+  if (!program) {
     return 0;
   }
+  GLint linkStatus = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus != GL_TRUE) {
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+/**
+* プログラムオブジェクトのバイナリをキャッシュファイルに保存する.
+*
+* @param key     キャッシュのキー.
+* @param program 保存するプログラムオブジェクト.
+*
+* 書き込み途中のファイルを読まないように、一時ファイルに書き込んでから名前を変更する.
+*/
+void SaveProgramBinary(uint64_t key, GLuint program)
+{
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(length);
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &length, &format, binary.data());
+  if (length <= 0) {
+    return;
+  }
 
+  std::error_code ec;
+  std::filesystem::create_directories(binaryCacheDirectory, ec);
+  const std::string path = BinaryCachePath(key);
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream ofs(tmpPath, std::ios_base::binary);
+    if (!ofs) {
+      std::cerr << "WARNING: " << tmpPath << "を作成できません.\n";
+      return;
+    }
+    const BinaryCacheHeader header = { { 'G', 'L', 'P', 'B' }, binaryCacheVersion, key, format,
+      static_cast<uint32_t>(length) };
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(binary.data(), length);
+    if (!ofs) {
+      std::cerr << "WARNING: " << tmpPath << "に書き込めません.\n";
+      return;
+    }
+  }
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+  }
+}
+
+/**
+* シェーダの並列コンパイルを有効にする.
+*
+* @retval true  並列コンパイルに対応している. GL_COMPLETION_STATUS_KHRで完了を確認できる.
+* @retval false 対応していない.
+*
+* 初めて呼ばれたときに、ドライバが使えるだけのスレッドでコンパイルするように設定する.
+* GLEWが拡張機能に対応していない可能性があるので、関数はGLFWから取得する.
+*/
+bool EnableParallelCompile()
+{
+  static const bool isSupported = [] {
+    using PFNMAXSHADERCOMPILERTHREADS = void (APIENTRY*)(GLuint);
+    PFNMAXSHADERCOMPILERTHREADS maxShaderCompilerThreads = nullptr;
+    if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) {
+      maxShaderCompilerThreads =
+        reinterpret_cast<PFNMAXSHADERCOMPILERTHREADS>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+    } else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) {
+      maxShaderCompilerThreads =
+        reinterpret_cast<PFNMAXSHADERCOMPILERTHREADS>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+    if (!maxShaderCompilerThreads) {
+      return false;
+    }
+    maxShaderCompilerThreads(0xffffffff);
+    std::cout << "INFO: シェーダの並列コンパイルを有効化\n";
+    return true;
+  }();
+  return isSupported;
+}
+
+/**
+* シェーダのコンパイルを開始する.
+*
+* @param type   シェーダの種類.
+* @param string シェーダコードへのポインタ.
+*
+* @return 作成したシェーダオブジェクト.
+*         コンパイルの結果はCheckCompileStatus()で確認すること.
+*/
+GLuint StartCompile(GLenum type, const GLchar* string)
+{
+  if (!string) {
+    return 0;
+  }
   GLuint shader = glCreateShader(type);
   glShaderSource(shader, 1, &string, nullptr);
   glCompileShader(shader);
+  return shader;
+}
+
+/**
+* シェーダのコンパイル結果を確認する.
+*
+* @param shader シェーダオブジェクト.
+*
+* @retval true  コンパイル成功.
+* @retval false コンパイル失敗. エラーメッセージを出力する.
+*
+* コンパイルが終わっていなければ、終わるまで待つ.
+*/
+bool CheckCompileStatus(GLuint shader)
+{
+  if (!shader) {
+    return false;
+  }
   GLint compiled = 0;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
   if (!compiled) {
@@ -36,36 +302,48 @@ GLuint Compile(GLenum type, const GLchar* string)
       buf.resize(infoLen);
       if (static_cast<int>(buf.size()) >= infoLen) {
         glGetShaderInfoLog(shader, infoLen, NULL, buf.data());
-        std::cerr << "ERROR: VF[_̃RpCɎs\n" << buf.data() << std::endl;
+        std::cerr << "ERROR: シェーダのコンパイルに失敗\n" << buf.data() << std::endl;
       }
     }
-    glDeleteShader(shader);
-    return 0;
+    return false;
   }
-  return shader;
+  return true;
 }
 
 /**
-* vOIuWFNg쐬.
+* プログラムオブジェクトのリンクを開始する.
 *
-* @param vsCode _VF[_R[hւ̃|C^.
-* @param fsCode tOgVF[_R[hւ̃|C^.
+* @param vs          頂点シェーダオブジェクト.
+* @param fs          フラグメントシェーダオブジェクト.
+* @param retrievable true=リンク後にglGetProgramBinaryでバイナリを取得できるようにする.
 *
-* @return 쐬vOIuWFNg.
+* @return 作成したプログラムオブジェクト.
+*         リンクの結果はCheckLinkStatus()で確認すること.
 */
-GLuint Build(const GLchar* vsCode, const GLchar* fsCode)
+GLuint StartLink(GLuint vs, GLuint fs, bool retrievable)
 {
-  GLuint vs = Compile(GL_VERTEX_SHADER, vsCode);
-  GLuint fs = Compile(GL_FRAGMENT_SHADER, fsCode);
-  if (!vs || !fs) {
-    return 0;
-  }
   GLuint program = glCreateProgram();
+  if (retrievable) {
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
   glAttachShader(program, fs);
-  glDeleteShader(fs);
   glAttachShader(program, vs);
-  glDeleteShader(vs);
   glLinkProgram(program);
+  return program;
+}
+
+/**
+* プログラムオブジェクトのリンク結果を確認する.
+*
+* @param program プログラムオブジェクト.
+*
+* @retval true  リンク成功.
+* @retval false リンク失敗. エラーメッセージを出力する.
+*
+* リンクが終わっていなければ、終わるまで待つ.
+*/
+bool CheckLinkStatus(GLuint program)
+{
   GLint linkStatus = GL_FALSE;
   glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
   if (linkStatus != GL_TRUE) {
@@ -76,9 +354,56 @@ GLuint Build(const GLchar* vsCode, const GLchar* fsCode)
       buf.resize(infoLen);
       if (static_cast<int>(buf.size()) >= infoLen) {
         glGetProgramInfoLog(program, infoLen, NULL, buf.data());
-        std::cerr << "ERROR: VF[_̃NɎs\n" << buf.data() << std::endl;
+        std::cerr << "ERROR: シェーダのリンクに失敗\n" << buf.data() << std::endl;
       }
     }
+    return false;
+  }
+  return true;
+}
+
+} // unnamed namespace
+
+/**
+* シェーダコードをコンパイルする.
+*
+* @param type   シェーダの種類.
+* @param string シェーダコードへのポインタ.
+*
+* @return 作成したシェーダオブジェクト.
+*/
+GLuint Compile(GLenum type, const GLchar* string)
+{
+  const GLuint shader = StartCompile(type, string);
+  if (!CheckCompileStatus(shader)) {
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+/**
+* プログラムオブジェクトを作成する.
+*
+* @param vsCode      頂点シェーダコードへのポインタ.
+* @param fsCode      フラグメントシェーダコードへのポインタ.
+* @param retrievable true=リンク後にglGetProgramBinaryでバイナリを取得できるようにする.
+*
+* @return 作成したプログラムオブジェクト.
+*/
+GLuint Build(const GLchar* vsCode, const GLchar* fsCode, bool retrievable)
+{
+  GLuint vs = Compile(GL_VERTEX_SHADER, vsCode);
+  GLuint fs = Compile(GL_FRAGMENT_SHADER, fsCode);
+  if (!vs || !fs) {
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    return 0;
+  }
+  GLuint program = StartLink(vs, fs, retrievable);
+  glDeleteShader(fs);
+  glDeleteShader(vs);
+  if (!CheckLinkStatus(program)) {
     glDeleteProgram(program);
     return 0;
   }
@@ -86,18 +411,18 @@ GLuint Build(const GLchar* vsCode, const GLchar* fsCode)
 }
 
 /**
-* t@Cǂݍ.
+* ファイルを読み込む.
 *
-* @param path ǂݍރt@C.
+* @param path 読み込むファイル名.
 *
-* @return ǂݍ񂾃f[^.
+* @return 読み込んだデータ.
 */
 std::vector<GLchar> ReadFile(const char* path)
 {
   std::basic_ifstream<GLchar> ifs;
   ifs.open(path, std::ios_base::binary);
   if (!ifs.is_open()) {
-    std::cerr << "ERROR: " << path << " J܂\n";
+    std::cerr << "ERROR: " << path << " を開けません\n";
     return {};
   }
   ifs.seekg(0, std::ios_base::end);
@@ -110,29 +435,139 @@ std::vector<GLchar> ReadFile(const char* path)
 }
 
 /**
-* t@CvOEIuWFNg쐬.
+* ファイルからプログラム・オブジェクトを作成する.
+*
+* @param vsPath 頂点シェーダーファイル名.
+* @param fsPath フラグメントシェーダーファイル名.
 *
-* @param vsPath _VF[_[t@C.
-* @param fsPath tOgVF[_[t@C.
+* @return 作成したプログラム・オブジェクト.
 *
-* @return 쐬vOEIuWFNg.
+* ドライバがプログラムバイナリに対応していれば、リンク結果をShaderCacheフォルダに保存し、
+* 次回からはコンパイルせずに保存したバイナリを使う.
+* シェーダーコードかドライバが変わった場合、またはドライバがバイナリを受け付けなかった場合は
+* コンパイルし直してバイナリを保存し直す.
 */
 GLuint BuildFromFile(const char* vsPath, const char* fsPath)
 {
   const std::vector<GLchar> vsCode = ReadFile(vsPath);
   const std::vector<GLchar> fsCode = ReadFile(fsPath);
-  return Build(vsCode.data(), fsCode.data());
+  if (vsCode.empty() || fsCode.empty()) {
+    return 0;
+  }
+  if (!IsProgramBinarySupported()) {
+    return Build(vsCode.data(), fsCode.data());
+  }
+
+  const uint64_t key = CreateBinaryCacheKey(vsCode.data(), fsCode.data());
+  GLuint program = LoadProgramBinary(key);
+  if (program) {
+    return program;
+  }
+  program = Build(vsCode.data(), fsCode.data(), true);
+  if (program) {
+    SaveProgramBinary(key, program);
+  }
+  return program;
 }
 
 /**
-* RXgN^.
+* 結果の確認を待っているビルドの情報.
+*/
+struct Program::BuildState
+{
+  std::vector<GLchar> vsCode;
+  std::vector<GLchar> fsCode;
+  GLuint vs = 0;
+  GLuint fs = 0;
+  uint64_t key = 0;            ///< プログラムバイナリのキャッシュのキー.
+  bool useBinaryCache = false; ///< true=リンク結果をキャッシュに保存する.
+  bool isFromBinary = false;   ///< true=キャッシュのバイナリから作成した.
+};
+
+/**
+* コンストラクタ.
+*
+* @param vsPath 頂点シェーダーファイル名.
+* @param fsPath フラグメントシェーダーファイル名.
 *
-* @param vsPath _VF[_[t@C.
-* @param fsPath tOgVF[_[t@C.
+* コンパイルとリンクを開始するだけで、結果は待たない.
+* 結果は最初に使われたときに確認するので、その間にドライバが別のプログラムを並列にコンパイルできる.
 */
 Program::Program(const char* vsPath, const char* fsPath)
 {
-  id = BuildFromFile(vsPath, fsPath);
+  std::unique_ptr<BuildState> state(new BuildState);
+  state->vsCode = ReadFile(vsPath);
+  state->fsCode = ReadFile(fsPath);
+  if (state->vsCode.empty() || state->fsCode.empty()) {
+    return;
+  }
+  EnableParallelCompile();
+  state->useBinaryCache = IsProgramBinarySupported();
+  if (state->useBinaryCache) {
+    state->key = CreateBinaryCacheKey(state->vsCode.data(), state->fsCode.data());
+    id = StartLoadProgramBinary(state->key);
+    state->isFromBinary = id != 0;
+  }
+  if (!id) {
+    state->vs = StartCompile(GL_VERTEX_SHADER, state->vsCode.data());
+    state->fs = StartCompile(GL_FRAGMENT_SHADER, state->fsCode.data());
+    id = StartLink(state->vs, state->fs, state->useBinaryCache);
+  }
+  buildState = std::move(state);
+}
+
+/**
+* デストラクタ.
+*
+* プログラム・オブジェクトを削除する.
+*/
+Program::~Program()
+{
+  if (buildState) {
+    glDeleteShader(buildState->vs);
+    glDeleteShader(buildState->fs);
+  }
+  GLState::ForgetProgram(id);
+  glDeleteProgram(id);
+}
+
+/**
+* ビルドの結果を確認する.
+*
+* コンストラクタで開始したビルドが終わっていなければ、終わるまで待つ.
+* キャッシュのバイナリをドライバが受け付けなかった場合は、ここでコンパイルし直す.
+*/
+void Program::Resolve() const
+{
+  if (!buildState) {
+    return;
+  }
+  const std::unique_ptr<BuildState> state = std::move(buildState);
+  GLint linkStatus = GL_FALSE;
+  glGetProgramiv(id, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus == GL_TRUE) {
+    if (state->useBinaryCache && !state->isFromBinary) {
+      SaveProgramBinary(state->key, id);
+    }
+  } else if (state->isFromBinary) {
+    GLState::ForgetProgram(id);
+    glDeleteProgram(id);
+    id = Build(state->vsCode.data(), state->fsCode.data(), true);
+    if (id) {
+      SaveProgramBinary(state->key, id);
+    }
+  } else {
+    // エラーログはプログラム・オブジェクトから取得するので、削除する前に表示する.
+    if (CheckCompileStatus(state->vs) && CheckCompileStatus(state->fs)) {
+      CheckLinkStatus(id);
+    }
+    GLState::ForgetProgram(id);
+    glDeleteProgram(id);
+    id = 0;
+  }
+  glDeleteShader(state->vs);
+  glDeleteShader(state->fs);
+
   if (id) {
     locMatVP = glGetUniformLocation(id, "matVP");
     locMatModel = glGetUniformLocation(id, "matModel");
@@ -142,61 +577,88 @@ Program::Program(const char* vsPath, const char* fsPath)
 }
 
 /**
-* fXgN^.
+* ビルドが終わっているか調べる.
 *
-* vOEIuWFNg폜.
+* @retval true  終わっている. 使用しても待たされない.
+*               並列コンパイルに対応していない場合は、確認できないので常にtrueを返す.
+* @retval false まだ終わっていない.
 */
-Program::~Program()
+bool Program::IsReady() const
 {
-  glDeleteProgram(id);
+  if (!buildState || !EnableParallelCompile()) {
+    return true;
+  }
+  GLint completed = GL_TRUE;
+  glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &completed);
+  return completed == GL_TRUE;
 }
 
 /**
-* vOEIuWFNgݒ肳Ă邩ׂ.
+* プログラム・オブジェクトが設定されているか調べる.
 *
-* @retval true  ݒ肳Ă.
-* @retval false ݒ肳ĂȂ.
+* @retval true  設定されている.
+* @retval false 設定されていない.
 */
 bool Program::IsNull() const
 {
+  Resolve();
   return id;
 }
 
 /**
-* vOEIuWFNgOtBbNXEpCvCɊ蓖Ă.
+* プログラム・オブジェクトをグラフィックス・パイプラインに割り当てる.
 *
-* vOEIuWFNggIglUseProgram(0)sĉ邱.
+* プログラム・オブジェクトを使い終わったらUnuse()を実行して解除すること.
 */
 void Program::Use() const
 {
-  glUseProgram(id);
+  Resolve();
+  GLState::UseProgram(id);
 }
 
 void Program::Unuse() const
 {
-  glUseProgram(0);
+  GLState::UseProgram(0);
 }
 
 /**
-* `Ɏgr[EvWFNVsݒ肷.
+* 描画に使われるビュー・プロジェクション行列を設定する.
 *
-* @param m ݒ肷r[EvWFNVs.
+* @param m 設定するビュー・プロジェクション行列.
 *
 */
 void Program::SetViewProjectionMatrix(const glm::mat4& m) const
 {
+  if (isMatVPUploaded && m == matVP) {
+    GLState::CountUniform(false);
+    return;
+  }
+  matVP = m;
   if (locMatVP >= 0) {
     glUniformMatrix4fv(locMatVP, 1, GL_FALSE, &m[0][0]);
+    isMatVPUploaded = true;
+    GLState::CountUniform(true);
   }
 }
 
 /**
-* `Ɏg郂fsݒ肷.
+* 描画に使われるモデル行列を設定する.
 *
-* @param m ݒ肷郂fs.
+* @param m 設定するモデル行列.
 */
 void Program::SetModelMatrix(const glm::mat4& m) const
 {
+  if (locMatModel < 0 && locMatNormal < 0) {
+    return;
+  }
+  // 同じ行列なら、法線行列の計算も含めて省略する.
+  if (isMatModelUploaded && m == matModel) {
+    GLState::CountUniform(false);
+    return;
+  }
+  matModel = m;
+  isMatModelUploaded = true;
+  GLState::CountUniform(true);
   if (locMatModel >= 0) {
     glUniformMatrix4fv(locMatModel, 1, GL_FALSE, &m[0][0]);
   }
@@ -207,40 +669,42 @@ void Program::SetModelMatrix(const glm::mat4& m) const
 }
 
 /**
-* UniformubNoCfBOE|CgɊ蓖Ă.
+* Uniformブロックをバインディング・ポイントに割り当てる.
 *
-* @param blockName    蓖ĂUniformubN̖O.
-* @param bindingPoint 蓖Đ̃oCfBOE|Cg.
+* @param blockName    割り当てるUniformブロックの名前.
+* @param bindingPoint 割り当て先のバインディング・ポイント.
 *
-* @retval true  蓖Đ.
-* @retval false 蓖Ďs.
+* @retval true  割り当て成功.
+* @retval false 割り当て失敗.
 */
 bool Program::BindUniformBlock(const char* blockName, GLuint bindingPoint)
 {
+  Resolve();
   const GLuint blockIndex = glGetUniformBlockIndex(id, blockName);
   if (blockIndex == GL_INVALID_INDEX) {
-    std::cerr << "[G[] UniformubN'" << blockName << "'܂\n";
+    std::cerr << "[エラー] Uniformブロック'" << blockName << "'が見つかりません\n";
     return false;
   }
   glUniformBlockBinding(id, blockIndex, bindingPoint);
   const GLenum result = glGetError();
   if (result != GL_NO_ERROR) {
-    std::cerr << "[G[] UniformubN'" << blockName << "'̃oChɎs\n";
+    std::cerr << "[エラー] Uniformブロック'" << blockName << "'のバインドに失敗\n";
     return false;
   }
   return true;
 }
 
 /**
-* jtH[ϐ̈ʒu擾.
+* ユニフォーム変数の位置を取得する.
 *
-* @param uniformName jtH[ϐ̖O.
+* @param uniformName ユニフォーム変数の名前.
 *
-* @retval 0      OuniformNameƈvϐȂ. ܂̓VF[_[.
-* @retval 1ȏ  OuniformNameƈvϐ̈ʒu.
+* @retval 0      名前がuniformNameと一致する変数が見つからない. またはシェーダーが無効.
+* @retval 1以上  名前がuniformNameと一致する変数の位置.
 */
 GLint Program::GetUniformLocation(const char* uniformName) const
 {
+  Resolve();
   if (id) {
     return glGetUniformLocation(id, uniformName);
   }
@@ -248,7 +712,7 @@ GLint Program::GetUniformLocation(const char* uniformName) const
 }
 
 /**
-* jtH[ϐɃf[^ݒ肷.
+* ユニフォーム変数にデータを設定する.
 */
 void Program::SetUniformInt(GLint location, GLint value) const
 {
@@ -258,21 +722,29 @@ void Program::SetUniformInt(GLint location, GLint value) const
 }
 
 /**
-* f̕`Fݒ肷.
+* モデルの描画色を設定する.
 *
-* @param c  `F.
+* @param c  描画色.
 */
 void Program::SetModelColor(const glm::vec4& c) const
 {
-  if (locModelColor >= 0) {
-    glUniform4fv(locModelColor, 1, &c.x);
+  if (locModelColor < 0) {
+    return;
   }
+  if (isModelColorUploaded && c == modelColor) {
+    GLState::CountUniform(false);
+    return;
+  }
+  glUniform4fv(locModelColor, 1, &c.x);
+  modelColor = c;
+  isModelColorUploaded = true;
+  GLState::CountUniform(true);
 }
 
 /**
-* VOgCX^X擾.
+* シングルトンインスタンスを取得する.
 *
-* @return CachẽVOgCX^X.
+* @return Cacheのシングルトンインスタンス.
 */
 Cache& Cache::Instance()
 {
@@ -281,7 +753,7 @@ Cache& Cache::Instance()
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 */
 Cache::Cache()
 {
@@ -289,12 +761,12 @@ Cache::Cache()
 }
 
 /**
-* VF[_[vO쐬ALbV.
+* シェーダープログラムを作成し、キャッシュする.
 *
-* @param vsPath _VF[_[t@C.
-* @param fsPath tOgVF[_[t@C.
+* @param vsPath 頂点シェーダーファイル名.
+* @param fsPath フラグメントシェーダーファイル名.
 *
-* @return vsPathfsPath쐬ꂽVF[_[vO.
+* @return vsPathとfsPathから作成されたシェーダープログラム.
 */
 ProgramPtr Cache::Create(const char* vsPath, const char* fsPath)
 {
@@ -309,13 +781,59 @@ ProgramPtr Cache::Create(const char* vsPath, const char* fsPath)
 }
 
 /**
-* VF[_[vO擾.
+* 複数のシェーダープログラムをまとめて作成し、キャッシュする.
+*
+* @param sources 作成するシェーダープログラムのファイル名の組.
+*
+* @return 作成されたシェーダープログラムの配列. sourcesと同じ順番で格納される.
+*
+* 全てのプログラムのコンパイルとリンクを先に開始するので、ドライバが並列にコンパイルできる.
+* 起動時など、後で使うプログラムが分かっている場合に呼び出しておくとよい.
+*/
+std::vector<ProgramPtr> Cache::Create(std::initializer_list<Source> sources)
+{
+  std::vector<ProgramPtr> programs;
+  programs.reserve(sources.size());
+  for (const Source& e : sources) {
+    programs.push_back(Create(e.vsPath, e.fsPath));
+  }
+  return programs;
+}
+
+/**
+* キャッシュしている全てのシェーダープログラムのビルドが終わっているか調べる.
+*
+* @retval true  全て終わっている.
+* @retval false 終わっていないプログラムがある.
+*/
+bool Cache::IsReady() const
+{
+  for (const auto& e : map) {
+    if (!e.second->IsReady()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+* キャッシュしている全てのシェーダープログラムのビルドが終わるまで待つ.
+*/
+void Cache::Finish()
+{
+  for (const auto& e : map) {
+    e.second->IsNull();
+  }
+}
+
+/**
+* シェーダープログラムを取得する.
 *
-* @param vsPath _VF[_[t@C.
-* @param fsPath tOgVF[_[t@C.
+* @param vsPath 頂点シェーダーファイル名.
+* @param fsPath フラグメントシェーダーファイル名.
 *
-* @return vsPathfsPath쐬ꂽVF[_[vO.
-*         ΉGgȂꍇnullptrԂ.
+* @return vsPathとfsPathから作成されたシェーダープログラム.
+*         対応するエントリがない場合はnullptrを返す.
 */
 ProgramPtr Cache::Get(const char* vsPath, const char* fsPath) const
 {
@@ -328,7 +846,7 @@ ProgramPtr Cache::Get(const char* vsPath, const char* fsPath) const
 }
 
 /**
-* ǂݍ񂾑SẴVF[_[vOj.
+* 読み込んだ全てのシェーダープログラムを破棄する.
 */
 void Cache::Clear()
 {
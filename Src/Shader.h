@@ -5,16 +5,22 @@
 #define SHADER_H_INCLUDED
 #include <GL/glew.h>
 #include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 #include <unordered_map>
 #include <memory>
+#include <vector>
+#include <string>
+#include <initializer_list>
 
 namespace Shader {
 
-GLuint Build(const GLchar* vsCode, const GLchar* fsCode);
+GLuint Build(const GLchar* vsCode, const GLchar* fsCode, bool retrievable = false);
 GLuint BuildFromFile(const char* vsPath, const char* fsPath);
 
 /**
-* VF[_[EvO.
+* シェーダー・プログラム.
+*
+* コンストラクタはコンパイルとリンクを開始するだけで、結果は最初に使われたときに確認する.
 */
 class Program
 {
@@ -24,6 +30,7 @@ public:
   ~Program();
 
   bool IsNull() const;
+  bool IsReady() const;
   void Use() const;
   void Unuse() const;
   void SetViewProjectionMatrix(const glm::mat4&) const;
@@ -32,26 +39,50 @@ public:
   GLint GetUniformLocation(const char* uniformName) const;
   void SetUniformInt(GLint location, GLint value) const;
   void SetModelColor(const glm::vec4&) const;
-  GLuint Id() const { return id; }
+  GLuint Id() const { Resolve(); return id; }
+  const glm::mat4& ViewProjectionMatrix() const { return matVP; }
 
 private:
-  GLuint id = 0; // vOID.
-  GLint locMatVP = -1;
-  GLint locMatModel = -1;
-  GLint locMatNormal = -1;
-  GLint locModelColor = -1;
+  void Resolve() const;
+
+  // ビルドの結果はconstなメンバ関数から最初に使われたときに確認するため、mutableにしている.
+  struct BuildState;
+  mutable std::unique_ptr<BuildState> buildState; // 結果の確認を待っているビルド.
+  mutable GLuint id = 0; // プログラムID.
+  mutable glm::mat4 matVP = glm::mat4(1); // LODの選択などCPU側で使うための控え.
+  mutable GLint locMatVP = -1;
+  mutable GLint locMatModel = -1;
+  mutable GLint locMatNormal = -1;
+  mutable GLint locModelColor = -1;
+
+  // 同じ値の再設定を省略するための、最後に設定したユニフォーム変数の値.
+  mutable glm::mat4 matModel = glm::mat4(1);
+  mutable glm::vec4 modelColor = glm::vec4(1);
+  mutable bool isMatVPUploaded = false;
+  mutable bool isMatModelUploaded = false;
+  mutable bool isModelColorUploaded = false;
 };
 using ProgramPtr = std::shared_ptr<Program>;
 
 /**
-* VF[_[vOLbVNX.
+* シェーダープログラムをキャッシュするクラス.
 */
 class Cache
 {
 public:
+  // シェーダーファイル名の組.
+  struct Source
+  {
+    const char* vsPath;
+    const char* fsPath;
+  };
+
   static Cache& Instance();
 
   ProgramPtr Create(const char* vsPath, const char* fsPath);
+  std::vector<ProgramPtr> Create(std::initializer_list<Source> sources);
+  bool IsReady() const;
+  void Finish();
   ProgramPtr Get(const char* vsPath, const char* fsPath) const;
   void Clear();
 
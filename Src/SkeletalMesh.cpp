@@ -3,13 +3,44 @@
 */
 #define NOMINMAX
 #include "SkeletalMesh.h"
-#include "UniformBuffer.h"
+#include "MeshOptimizer.h"
+#include "MatrixKernel.h"
+#include "RingBuffer.h"
+#include "GLState.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <unordered_map>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 namespace Mesh {
 
+/**
+* アニメーションを適用した座標変換行列リスト.
+*/
+struct MeshTransformation {
+  std::vector<glm::aligned_mat4> transformations;
+  std::vector<glm::aligned_mat4> matRoot;
+};
+
+/**
+* 姿勢の計算に使うアニメーション.
+*
+* 複数のアニメーションを合成する場合は、それぞれの重みを指定する.
+*/
+struct PoseLayer {
+  const Animation* animation;
+  float frame;
+  float weight;
+};
+
 /**
 *
 */
@@ -18,36 +49,229 @@ namespace GlobalSkeletalMeshState {
 namespace /* unnamed */ {
 
 /**
-* XP^EbV`pUBOf[^.
+* スケルタル・メッシュ描画用UBOデータ.
 */
 struct alignas(256) UniformDataMeshMatrix
 {
   glm::aligned_vec4 color;
+  glm::ivec4 flags; // x=1なら全ての行列が均一スケール.
   glm::aligned_mat3x4 matModel[8]; // it must transpose.
+  glm::aligned_mat3x4 matNormal[8]; // matModelの逆転置行列. it must transpose.
   glm::aligned_mat3x4 matBones[256]; // it must transpose.
 };
 
 const char UniformNameForBoneMatrix[] = "MeshMatrixUniformData";
 
 bool isInitialized = false;
-int currentUboIndex = 0;
-UniformBufferPtr ubo[2];
-std::vector<uint8_t> uboData;
+RingBuffer ubo;
+size_t framesInFlight = 3; // UBOの区画の数.
+
+/**
+* 姿勢キャッシュのキー.
+*/
+struct PoseKey
+{
+  const ExtendedFile* file;
+  const Node* node;
+  const Animation* animation;
+  float frame; ///< 量子化した再生位置.
+  bool skipLeafJoints; ///< 末端の関節のアニメーションを省略したか.
+
+  bool operator==(const PoseKey& other) const
+  {
+    return file == other.file && node == other.node && animation == other.animation && frame == other.frame &&
+      skipLeafJoints == other.skipLeafJoints;
+  }
+};
+
+/**
+* 姿勢キャッシュのキーのハッシュ関数.
+*/
+struct PoseKeyHash
+{
+  size_t operator()(const PoseKey& key) const
+  {
+    size_t h = std::hash<const void*>()(key.file);
+    h = h * 31 + std::hash<const void*>()(key.node);
+    h = h * 31 + std::hash<const void*>()(key.animation);
+    h = h * 31 + std::hash<float>()(key.frame);
+    h = h * 31 + (key.skipLeafJoints ? 1 : 0);
+    return h;
+  }
+};
+
+// 姿勢キャッシュ. 1フレームの間だけ、計算した姿勢を同じ状態のメッシュで共有する.
+float poseQuantization = 1.0f / 60.0f;
+std::unordered_map<PoseKey, size_t, PoseKeyHash> poseIndices;
+std::deque<MeshTransformation> poses; // 行列の配列を再利用するため、フレームをまたいで保持する.
+size_t poseCount = 0;
+PoseCacheStatistics poseStatistics;
+PoseCacheStatistics lastPoseStatistics;
+
+// アニメーションLOD.
+std::vector<AnimationLodSetting> animationLod = {
+  { 20.0f, 2, false },
+  { 40.0f, 4, true },
+};
+bool freezeOffscreen = true;
+uint32_t frameCount = 0; // ResetUniformData()を呼んだ回数.
+uint32_t updatePhaseCounter = 0;
+AnimationLodStatistics lodStatistics;
+AnimationLodStatistics lastLodStatistics;
+
+// 姿勢の計算要求. 同じ姿勢は1回だけ計算する.
+struct PoseJob
+{
+  ExtendedFilePtr file;
+  const Node* node;
+  size_t firstLayer; ///< 合成するアニメーションの、poseLayers内の位置.
+  size_t layerCount; ///< 合成するアニメーションの数. 0ならバインドポーズ.
+  bool skipLeafJoints;
+  size_t index; ///< 計算結果を格納するposesの番号.
+};
+std::vector<PoseJob> poseJobs;
+std::vector<PoseLayer> poseLayers; // 全ての計算要求のアニメーション.
+
+// メッシュの更新要求. UBOの書き込み先は要求した順に予約するので、オフセットは実行のたびに同じになる.
+struct UpdateRequest
+{
+  SkeletalMeshPtr mesh;
+  void* data; ///< 予約したUBO領域.
+  const MeshTransformation* pose; ///< 新しい姿勢. nullptrなら前回の姿勢を使う.
+};
+std::vector<UpdateRequest> updateRequests;
+
+// ワーカースレッド.
+std::vector<std::thread> workers;
+std::mutex workerMutex;
+std::condition_variable workerCondition;
+std::condition_variable doneCondition;
+std::function<void(size_t)> job;
+size_t jobCount = 0;
+std::atomic<size_t> nextJob{ 0 };
+uint32_t jobGeneration = 0;
+size_t busyCount = 0;
+bool isStopping = false;
+
+/**
+* 未処理のジョブがなくなるまで実行する.
+*/
+void RunJobs()
+{
+  for (;;) {
+    const size_t i = nextJob.fetch_add(1);
+    if (i >= jobCount) {
+      break;
+    }
+    job(i);
+  }
+}
+
+/**
+* ワーカースレッドの処理.
+*/
+void WorkerMain()
+{
+  uint32_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(workerMutex);
+      workerCondition.wait(lock, [&generation] { return isStopping || jobGeneration != generation; });
+      if (isStopping) {
+        return;
+      }
+      generation = jobGeneration;
+      ++busyCount;
+    }
+    RunJobs();
+    {
+      std::lock_guard<std::mutex> lock(workerMutex);
+      --busyCount;
+    }
+    doneCondition.notify_all();
+  }
+}
+
+/**
+* 関数を並列に実行する.
+*
+* @param count 実行回数.
+* @param f     実行する関数. 引数は0からcount-1までの番号.
+*
+* メインスレッドも処理に参加し、全ての実行が終わるまで戻らない.
+*/
+void ParallelFor(size_t count, const std::function<void(size_t)>& f)
+{
+  if (count == 0) {
+    return;
+  }
+  if (workers.empty() || count == 1) {
+    for (size_t i = 0; i < count; ++i) {
+      f(i);
+    }
+    return;
+  }
+  {
+    // 前回のジョブを実行中のワーカーがいなくなってから、ジョブを差し替える.
+    std::unique_lock<std::mutex> lock(workerMutex);
+    doneCondition.wait(lock, [] { return busyCount == 0; });
+    job = f;
+    jobCount = count;
+    nextJob = 0;
+    ++jobGeneration;
+  }
+  workerCondition.notify_all();
+  RunJobs();
+  std::unique_lock<std::mutex> lock(workerMutex);
+  doneCondition.wait(lock, [] { return busyCount == 0; });
+}
+
+/**
+* 骨格アニメーション用UBOを作成する.
+*
+* @retval true  作成成功.
+* @retval false 作成失敗.
+*/
+bool CreateUniformBuffer()
+{
+  const size_t maxMeshCount = 1024;
+  const GLsizeiptr uboSize = static_cast<GLsizeiptr>(sizeof(UniformDataMeshMatrix) * maxMeshCount);
+  GLint offsetAlignment = 0;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+  if (!ubo.Init(GL_UNIFORM_BUFFER, uboSize, framesInFlight, std::max<GLsizeiptr>(offsetAlignment, 256))) {
+    std::cerr << "[エラー] UBO'" << UniformNameForBoneMatrix << "'の作成に失敗\n";
+    return false;
+  }
+  std::cout << "[情報] GlobalSkeletalMeshState: UBO区画=" << framesInFlight << "\n";
+  return true;
+}
 
 } // unnamed namespace
 
 /**
+* スケルタルメッシュの共通データを初期化する.
 *
+* @param workerCount 姿勢の計算に使うワーカースレッドの数. 0なら論理コア数-1(最大4).
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
 */
-bool Initialize()
+bool Initialize(size_t workerCount)
 {
   if (!isInitialized) {
-    const size_t maxMeshCount = 1024;
-    const GLsizeiptr uboSize = static_cast<GLsizeiptr>(sizeof(UniformDataMeshMatrix) * maxMeshCount);
-    ubo[0] = UniformBuffer::Create(uboSize, 0, UniformNameForBoneMatrix);
-    ubo[1] = UniformBuffer::Create(uboSize, 0, UniformNameForBoneMatrix);
-    uboData.reserve(uboSize);
-    currentUboIndex = 0;
+    if (!CreateUniformBuffer()) {
+      return false;
+    }
+
+    if (workerCount == 0) {
+      workerCount = std::min(std::max(std::thread::hardware_concurrency(), 1U) - 1, 4U);
+    }
+    isStopping = false;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+      workers.emplace_back(WorkerMain);
+    }
+    std::cout << "[情報] GlobalSkeletalMeshState: ワーカー=" << workerCount << "\n";
 
     isInitialized = true;
   }
@@ -56,15 +280,23 @@ bool Initialize()
 }
 
 /**
-*
+* スケルタルメッシュの共通データを破棄する.
 */
 void Finalize()
 {
   if (isInitialized) {
-    uboData.clear();
-    uboData.shrink_to_fit();
-    ubo[1].reset();
-    ubo[0].reset();
+    {
+      std::lock_guard<std::mutex> lock(workerMutex);
+      isStopping = true;
+    }
+    workerCondition.notify_all();
+    for (auto& e : workers) {
+      e.join();
+    }
+    workers.clear();
+    poseJobs.clear();
+    updateRequests.clear();
+    ubo.Destroy();
     isInitialized = false;
   }
 }
@@ -80,82 +312,87 @@ bool BindUniformBlock(const Shader::ProgramPtr& program)
   const GLuint id = program->Id();
   const GLuint blockIndex = glGetUniformBlockIndex(id, blockName);
   if (blockIndex == GL_INVALID_INDEX) {
-    std::cerr << "[G[] UniformubN'" << blockName << "'܂\n";
+    std::cerr << "[エラー] Uniformブロック'" << blockName << "'が見つかりません\n";
     return false;
   }
   glUniformBlockBinding(id, blockIndex, bindingPoint);
   const GLenum result = glGetError();
   if (result != GL_NO_ERROR) {
-    std::cerr << "[G[] UniformubN'" << blockName << "'̃oChɎs\n";
+    std::cerr << "[エラー] Uniformブロック'" << blockName << "'のバインドに失敗\n";
     return false;
   }
   return true;
 }
 
 /**
+* UBOのリングバッファを次のフレーム区画に進める.
 *
+* GPUが3フレーム前の区画をまだ使っている場合は、使い終わるまで待つ.
+* また、姿勢キャッシュを空にする.
 */
 void ResetUniformData()
 {
+  // 前のフレームの姿勢はもう使わないので、キャッシュを空にする.
+  lastPoseStatistics = poseStatistics;
+  poseStatistics = PoseCacheStatistics();
+  poseIndices.clear();
+  poseCount = 0;
+  poseJobs.clear();
+  poseLayers.clear();
+  updateRequests.clear();
+  lastLodStatistics = lodStatistics;
+  lodStatistics = AnimationLodStatistics();
+  ++frameCount;
+
   if (!isInitialized) {
     return;
   }
 
-  uboData.clear();
+  ubo.BeginFrame();
 }
 
 /**
+* UBOの領域を予約する.
+*
+* @param size 予約するバイト数.
+* @param p    予約した領域への書き込み用ポインタを格納する変数.
+*
+* @return 予約した領域のバイトオフセット. 予約できなかった場合は-1.
 *
+* 領域の予約はロックを使わずに行うので、どのスレッドから呼び出してもよい.
+* 予約した領域にはUploadUniformData()が終わるまでに書き込むこと.
 */
-GLintptr PushUniformData(const void* data, size_t size)
+GLintptr ReserveUniformData(size_t size, void*& p)
 {
+  p = nullptr;
   if (!isInitialized) {
     return -1;
   }
 
-  UniformBufferPtr pUbo = ubo[currentUboIndex];
-  if (uboData.size() + size >= static_cast<size_t>(pUbo->Size())) {
+  GLintptr offset = 0;
+  p = ubo.Allocate(static_cast<GLsizeiptr>(size), offset);
+  if (!p) {
     return -1;
   }
-  const uint8_t* p = static_cast<const uint8_t*>(data);
-  const GLintptr offset = static_cast<GLintptr>(uboData.size());
-  uboData.insert(uboData.end(), p, p + size);
-  uboData.resize(((uboData.size() + 255) / 256) * 256);
   return offset;
 }
 
-/**
-*
-*/
-void UploadUniformData()
-{
-  if (!isInitialized) {
-    return;
-  }
-
-  if (!uboData.empty()) {
-    UniformBufferPtr pUbo = ubo[currentUboIndex];
-    pUbo->BufferSubData(uboData.data(), 0, uboData.size());
-    currentUboIndex = !currentUboIndex;
-  }
-}
-
 /**
 *
 */
 void BindUniformData(GLintptr offset, GLsizeiptr size)
 {
-  if (!isInitialized) {
+  if (!isInitialized || offset < 0 || size <= 0) {
     return;
   }
 
-  ubo[!currentUboIndex]->BindBufferRange(offset, size);
+  glBindBufferRange(GL_UNIFORM_BUFFER, 0, ubo.Id(), offset, size);
 }
 
 } // namespace GlobalSkeletalMeshState
 
 /**
-* Aj[Vp̒ԃf[^.
+* アニメーション用の中間データ.
 */
 struct AnimatedNodeTree {
   struct Transformation {
@@ -164,50 +401,81 @@ struct AnimatedNodeTree {
     glm::aligned_vec3 scale = glm::aligned_vec3(1);
     glm::aligned_mat4 matLocal = glm::aligned_mat4(1);
     glm::aligned_mat4 matGlobal = glm::aligned_mat4(1);
+    glm::vec3 weight = glm::vec3(0); // 合成した重みの合計(x=平行移動, y=回転, z=拡大率).
     bool isCalculated = false;
     int hasTransformation = 0;
   };
   std::vector<Transformation> nodeTransformations;
 };
 
+namespace /* unnamed */ {
+
+// 計算途中の姿勢のプール. 姿勢を計算するたびに配列を確保しないように、使い終わったら戻して再利用する.
+std::mutex nodeTreePoolMutex;
+std::vector<std::unique_ptr<AnimatedNodeTree>> nodeTreePool;
+
 /**
+* プールから計算途中の姿勢を取り出す.
+*
+* @param nodeCount ノードの数.
+*
+* @return 全てのノードを初期化した姿勢.
 *
+* ワーカースレッドから呼び出されるので、プールの操作は排他制御する.
 */
-template<typename T>
-T Interporation(const Timeline<T>& data, float frame)
+std::unique_ptr<AnimatedNodeTree> AcquireNodeTree(size_t nodeCount)
 {
-  const auto maxFrame = std::lower_bound(data.timeline.begin(), data.timeline.end(), frame,
-    [](const KeyFrame<T>& keyFrame, float frame) { return keyFrame.frame < frame; });
-  if (maxFrame == data.timeline.begin()) {
-    return data.timeline.front().value;
+  std::unique_ptr<AnimatedNodeTree> tree;
+  {
+    std::lock_guard<std::mutex> lock(nodeTreePoolMutex);
+    if (!nodeTreePool.empty()) {
+      tree = std::move(nodeTreePool.back());
+      nodeTreePool.pop_back();
+    }
   }
-  if (maxFrame == data.timeline.end()) {
-    return data.timeline.back().value;
+  if (!tree) {
+    tree.reset(new AnimatedNodeTree);
   }
-  const auto minFrame = maxFrame - 1;
-  const float ratio = glm::clamp((frame - minFrame->frame) / (maxFrame->frame - minFrame->frame), 0.0f, 1.0f);
-  return glm::mix(minFrame->value, maxFrame->value, ratio);
+  tree->nodeTransformations.assign(nodeCount, AnimatedNodeTree::Transformation());
+  return tree;
 }
 
 /**
+* 使い終わった計算途中の姿勢をプールに戻す.
 *
+* @param tree プールに戻す姿勢.
 */
-template<typename T, glm::qualifier Q>
-glm::qua<T, Q> Interporation(const Timeline<glm::qua<T, Q> >& data, float frame)
+void ReleaseNodeTree(std::unique_ptr<AnimatedNodeTree> tree)
 {
-  const auto maxFrame = std::lower_bound(data.timeline.begin(), data.timeline.end(), frame,
-    [](const KeyFrame<glm::qua<T, Q>>& keyFrame, float frame) { return keyFrame.frame < frame; });
-  if (maxFrame == data.timeline.begin()) {
-    return data.timeline.front().value;
-  }
-  if (maxFrame == data.timeline.end()) {
-    return data.timeline.back().value;
+  std::lock_guard<std::mutex> lock(nodeTreePoolMutex);
+  nodeTreePool.push_back(std::move(tree));
+}
+
+/**
+* 重み付きの回転を加算する.
+*
+* @param sum    加算先の回転.
+* @param q      加算する回転.
+* @param weight qの重み.
+* @param isFirst 最初の加算ならtrue.
+*
+* qとq反転は同じ回転なので、sumと同じ半球にあるほうを加算する.
+*/
+glm::aligned_quat AddWeightedRotation(const glm::aligned_quat& sum, const glm::quat& q, float weight, bool isFirst)
+{
+  glm::vec4 a(sum.x, sum.y, sum.z, sum.w);
+  glm::vec4 b(q.x, q.y, q.z, q.w);
+  if (isFirst) {
+    a = glm::vec4(0);
+  } else if (glm::dot(a, b) < 0) {
+    b = -b;
   }
-  const auto minFrame = maxFrame - 1;
-  const float ratio = glm::clamp((frame - minFrame->frame) / (maxFrame->frame - minFrame->frame), 0.0f, 1.0f);
-  return glm::slerp(minFrame->value, maxFrame->value, ratio);
+  a += b * weight;
+  return glm::aligned_quat(a.w, a.x, a.y, a.z);
 }
 
+} // unnamed namespace
+
 /**
 *
 */
@@ -227,50 +495,119 @@ void CalcGlobalTransform(const std::vector<Node>& nodes, const Node& node, Anima
     transformation.matLocal = glm::aligned_mat4(1);
   }
   if (transformation.hasTransformation) {
-    glm::aligned_mat4 m(1);
-    if (transformation.hasTransformation & 1) {
-      const glm::aligned_mat4 T = glm::translate(glm::aligned_mat4(1), transformation.translation);
-      m = T;
-    }
-    if (transformation.hasTransformation & 2) {
-      const glm::aligned_mat4 R = glm::mat4_cast(transformation.rotation);
-      m = m * R;
-    }
-    if (transformation.hasTransformation & 4) {
-      const glm::aligned_mat4 S = glm::scale(glm::aligned_mat4(1), transformation.scale);
-      m = m * S;
-    }
-    transformation.matLocal = transformation.matLocal * m;
+    // 持っていない要素は初期姿勢の値を使う.
+    const int has = transformation.hasTransformation;
+    glm::aligned_mat4 m;
+    ComposeAffine(
+      (has & 1) ? transformation.translation : node.translation,
+      (has & 2) ? transformation.rotation : node.rotation,
+      (has & 4) ? transformation.scale : node.scale,
+      m);
+    MultiplyAffine(transformation.matLocal, m, transformation.matLocal);
   } else {
-    transformation.matLocal *= node.matLocal;
+    MultiplyAffine(transformation.matLocal, node.matLocal, transformation.matLocal);
   }
-  transformation.matGlobal = transformation.matLocal * node.matInverseBindPose;
+  MultiplyAffine(transformation.matLocal, node.matInverseBindPose, transformation.matGlobal);
   transformation.isCalculated = true;
 }
 
 /**
-* Aj[VԂꂽWϊsvZ.
+* 末端の関節かどうか調べる.
+*
+* メッシュを持たず、子ノードもないノードを末端の関節とみなす.
 */
-AnimatedNodeTree MakeAnimatedNodeTree(const ExtendedFile& file, const Animation& animation, float keyFrame)
+bool IsLeafJoint(const ExtendedFile& file, int nodeId)
 {
-  AnimatedNodeTree tmp;
-  tmp.nodeTransformations.resize(file.nodes.size());
+  const Node& node = file.nodes[nodeId];
+  return node.children.empty() && node.mesh < 0;
+}
+
+/**
+* アニメーションの姿勢を重み付きで加算する.
+*
+* @param file           アニメーションとノードを所有するファイルオブジェクト.
+* @param layer          加算するアニメーション.
+* @param skipLeafJoints 末端の関節のアニメーションを省略するならtrue.
+* @param tree           加算先の姿勢.
+*
+* skipLeafJointsがtrueの場合、末端の関節にはアニメーションを適用せず、親に対する初期姿勢のままにする.
+* 合成するアニメーションごとに1回ずつ呼び出し、最後にNormalizeAnimatedNodeTree()で重みを正規化する.
+* 重みが0のアニメーションは加算しない(CrossFade()直後のフレームなど).
+*/
+void AccumulateAnimation(const ExtendedFile& file, const PoseLayer& layer, bool skipLeafJoints,
+  AnimatedNodeTree& tree)
+{
+  const Animation& animation = *layer.animation;
+  const float w = layer.weight;
+  if (w <= 0) {
+    return;
+  }
   for (const auto& e : animation.scaleList) {
-    tmp.nodeTransformations[e.targetNodeId].scale = Interporation(e, keyFrame);
-    tmp.nodeTransformations[e.targetNodeId].hasTransformation |= 4;
+    if (skipLeafJoints && IsLeafJoint(file, e.targetNodeId)) {
+      continue;
+    }
+    AnimatedNodeTree::Transformation& t = tree.nodeTransformations[e.targetNodeId];
+    const glm::aligned_vec3 v = SampleVector(animation.keys, e, layer.frame) * w;
+    t.scale = (t.hasTransformation & 4) ? t.scale + v : v;
+    t.weight.z += w;
+    t.hasTransformation |= 4;
   }
   for (const auto& e : animation.rotationList) {
-    tmp.nodeTransformations[e.targetNodeId].rotation = Interporation(e, keyFrame);
-    tmp.nodeTransformations[e.targetNodeId].hasTransformation |= 2;
+    if (skipLeafJoints && IsLeafJoint(file, e.targetNodeId)) {
+      continue;
+    }
+    AnimatedNodeTree::Transformation& t = tree.nodeTransformations[e.targetNodeId];
+    t.rotation = AddWeightedRotation(t.rotation, SampleRotation(animation.keys, e, layer.frame), w,
+      !(t.hasTransformation & 2));
+    t.weight.y += w;
+    t.hasTransformation |= 2;
   }
   for (const auto& e : animation.translationList) {
-    tmp.nodeTransformations[e.targetNodeId].translation = Interporation(e, keyFrame);
-    tmp.nodeTransformations[e.targetNodeId].hasTransformation |= 1;
+    if (skipLeafJoints && IsLeafJoint(file, e.targetNodeId)) {
+      continue;
+    }
+    AnimatedNodeTree::Transformation& t = tree.nodeTransformations[e.targetNodeId];
+    const glm::aligned_vec3 v = SampleVector(animation.keys, e, layer.frame) * w;
+    t.translation = (t.hasTransformation & 1) ? t.translation + v : v;
+    t.weight.x += w;
+    t.hasTransformation |= 1;
   }
-  for (auto& e : file.nodes) {
-    CalcGlobalTransform(file.nodes, e, tmp);
+}
+
+/**
+* 加算した姿勢の重みを正規化する.
+*
+* @param tree 正規化する姿勢.
+*
+* 要素ごとに、その要素を持つアニメーションの重みの合計で割る.
+* そのため、一部のアニメーションにしかない要素は、それらのアニメーションだけから決まる.
+* 重みの合計が0の要素は、アニメーションを持たないものとして初期姿勢に戻す.
+*/
+void NormalizeAnimatedNodeTree(AnimatedNodeTree& tree)
+{
+  for (auto& t : tree.nodeTransformations) {
+    if (t.hasTransformation & 1) {
+      if (t.weight.x > 0) {
+        t.translation /= t.weight.x;
+      } else {
+        t.hasTransformation &= ~1;
+      }
+    }
+    if (t.hasTransformation & 2) {
+      if (t.weight.y > 0) {
+        t.rotation = glm::normalize(t.rotation);
+      } else {
+        t.hasTransformation &= ~2;
+      }
+    }
+    if (t.hasTransformation & 4) {
+      if (t.weight.z > 0) {
+        t.scale /= t.weight.z;
+      } else {
+        t.hasTransformation &= ~4;
+      }
+    }
   }
-  return tmp;
 }
 
 // Implemented in Mesh.cpp
@@ -278,80 +615,345 @@ std::vector<char> ReadFromFile(const char* path);
 void GetBuffer(const json11::Json& accessor, const json11::Json& bufferViews, const std::vector<std::vector<char>>& binFiles, const void** pp, size_t* pLength, int* pStride = nullptr);
 
 /**
+* アニメーションを適用した座標変換行列リストを計算する.
+*
+* @param file           アニメーションとノードを所有するファイルオブジェクト.
+* @param node           スキニング対象のノード.
+* @param layers         計算の元になるアニメーションの配列.
+* @param layerCount     layersの要素数. 0ならバインドポーズになる.
+* @param transformation 計算結果の格納先. 配列の容量は再利用される.
+* @param skipLeafJoints 末端の関節のアニメーションを省略するならtrue.
 *
+* 複数のアニメーションは関節ごとの平行移動、回転、拡大率の段階で合成するので、
+* 行列の計算はアニメーションの数によらず1回で済む.
 */
-struct MeshTransformation {
-  std::vector<glm::aligned_mat4> transformations;
-  std::vector<glm::aligned_mat4> matRoot;
-};
+void CalculateTransform(const ExtendedFilePtr& file, const Node* node, const PoseLayer* layers, size_t layerCount,
+  MeshTransformation& transformation, bool skipLeafJoints = false)
+{
+  transformation.transformations.clear();
+  transformation.matRoot.clear();
+  if (!file || !node) {
+    return;
+  }
+
+  std::vector<const Node*> meshNodes;
+  meshNodes.reserve(32);
+  GetMeshNodeList(node, meshNodes);
+
+  std::unique_ptr<AnimatedNodeTree> tmp;
+  if (layerCount > 0) {
+    tmp = AcquireNodeTree(file->nodes.size());
+    for (size_t i = 0; i < layerCount; ++i) {
+      AccumulateAnimation(*file, layers[i], skipLeafJoints, *tmp);
+    }
+    if (layerCount > 1) {
+      NormalizeAnimatedNodeTree(*tmp);
+    }
+    for (auto& e : file->nodes) {
+      CalcGlobalTransform(file->nodes, e, *tmp);
+    }
+  }
+  if (node->skin >= 0) {
+    const std::vector<int>& joints = file->skins[node->skin].joints;
+    transformation.transformations.resize(joints.size(), glm::aligned_mat4(1));
+    if (tmp) {
+      for (size_t i = 0; i < joints.size(); ++i) {
+        const int jointNodeId = joints[i];
+        transformation.transformations[i] = tmp->nodeTransformations[jointNodeId].matGlobal;
+      }
+    }
+    transformation.matRoot.resize(meshNodes.size(), glm::aligned_mat4(1));
+  } else {
+    transformation.matRoot.reserve(meshNodes.size());
+    for (const auto& e : meshNodes) {
+      if (tmp) {
+        const size_t nodeId = e - &file->nodes[0];
+        transformation.matRoot.push_back(tmp->nodeTransformations[nodeId].matGlobal);
+      } else {
+        transformation.matRoot.push_back(e->matGlobal);
+      }
+    }
+  }
+  if (tmp) {
+    ReleaseNodeTree(std::move(tmp));
+  }
+}
 
 /**
-* Aj[VKpWϊs񃊃XgvZ.
+* アニメーションを適用した関節行列を計算する.
 *
-* @param file      Aj[Vƃm[hLt@CIuWFNg.
-* @param node      XLjOΏۂ̃m[h.
-* @param animation vŽɂȂAj[V.
-* @param frame     Aj[V̍Đʒu.
+* @param file      アニメーションとノードを所有するファイルオブジェクト.
+* @param node      スキニング対象のノード.
+* @param animation 計算の元になるアニメーション. nullptrならバインドポーズ.
+* @param frame     アニメーションの再生位置.
+* @param matrices  関節行列の格納先. 順序はスキンの関節リストと同じ.
 *
-* @return Aj[VKpWϊs񃊃Xg.
+* 姿勢キャッシュは使わない. 読み込み時にアニメーションを焼き付けるためのもの.
 */
-MeshTransformation CalculateTransform(const ExtendedFilePtr& file, const Node* node, const Animation* animation, float frame)
+void CalculateJointMatrices(const ExtendedFilePtr& file, const Node* node, const Animation* animation, float frame,
+  std::vector<glm::aligned_mat4>& matrices)
 {
   MeshTransformation transformation;
-  if (file && node) {
-    std::vector<const Node*> meshNodes;
-    meshNodes.reserve(32);
-    GetMeshNodeList(node, meshNodes);
+  const PoseLayer layer = { animation, frame, 1 };
+  CalculateTransform(file, node, &layer, animation ? 1 : 0, transformation);
+  matrices.swap(transformation.transformations);
+}
 
-    if (animation) {
-      const AnimatedNodeTree tmp = MakeAnimatedNodeTree(*file, *animation, frame);
-      if (node->skin >= 0) {
-        const std::vector<int>& joints = file->skins[node->skin].joints;
-        transformation.transformations.resize(joints.size());
-        for (size_t i = 0; i < joints.size(); ++i) {
-          const int jointNodeId = joints[i];
-          transformation.transformations[i] = tmp.nodeTransformations[jointNodeId].matGlobal;
-        }
-        transformation.matRoot.resize(meshNodes.size(), glm::mat4(1));
-      } else {
-        transformation.matRoot.reserve(meshNodes.size());
-        for (const auto& e : meshNodes) {
-          const size_t nodeId = e - &file->nodes[0];
-          transformation.matRoot.push_back(tmp.nodeTransformations[nodeId].matGlobal);
-        }
+namespace GlobalSkeletalMeshState {
+
+/**
+* 姿勢キャッシュの量子化間隔を設定する.
+*
+* @param step 再生位置を丸める間隔(秒). 0以下なら丸めずに、再生位置が完全に一致する場合だけ再利用する.
+*
+* 間隔を大きくするほど再利用されやすくなるが、アニメーションは滑らかでなくなる.
+*/
+void SetPoseQuantization(float step)
+{
+  poseQuantization = std::max(step, 0.0f);
+}
+
+/**
+* 姿勢キャッシュの量子化間隔を取得する.
+*
+* @return 再生位置を丸める間隔(秒).
+*/
+float GetPoseQuantization()
+{
+  return poseQuantization;
+}
+
+/**
+* 前のフレームの姿勢キャッシュの統計情報を取得する.
+*
+* @return 前のフレームの姿勢キャッシュの統計情報.
+*/
+const PoseCacheStatistics& GetPoseCacheStatistics()
+{
+  return lastPoseStatistics;
+}
+
+/**
+* 姿勢の計算を予約する.
+*
+* @param file       アニメーションとノードを所有するファイルオブジェクト.
+* @param node       スキニング対象のノード.
+* @param layers     計算の元になるアニメーションの配列.
+* @param layerCount layersの要素数. 0ならバインドポーズ.
+* @param skipLeafJoints 末端の関節のアニメーションを省略するならtrue.
+*
+* @return アニメーションを適用した座標変換行列リストの格納先.
+*         UploadUniformData()で計算され、次にResetUniformData()を呼ぶまで有効.
+*
+* アニメーションが1つなら、同じフレーム内で、同じファイル、ノード、アニメーション、量子化した再生位置の姿勢を
+* 予約済みの場合はそれを返す.
+* 複数のアニメーションを合成する場合は、重みまで一致することはまれなので、キャッシュを使わない.
+*/
+const MeshTransformation* ReservePose(const ExtendedFilePtr& file, const Node* node, const PoseLayer* layers,
+  size_t layerCount, bool skipLeafJoints)
+{
+  PoseLayer layer = { nullptr, 0, 1 };
+  if (layerCount <= 1) {
+    if (layerCount == 1) {
+      layer = layers[0];
+      layer.weight = 1;
+      if (poseQuantization > 0) {
+        layer.frame = std::floor(layer.frame / poseQuantization + 0.5f) * poseQuantization;
       }
+      layers = &layer;
     }
+    const PoseKey key = { file.get(), node, layer.animation, layer.frame, skipLeafJoints };
+    const auto itr = poseIndices.find(key);
+    if (itr != poseIndices.end()) {
+      ++poseStatistics.hitCount;
+      return &poses[itr->second];
+    }
+    poseIndices.emplace(key, poseCount);
+  }
 
-    if (node->skin >= 0) {
-      if (animation) {
-        const AnimatedNodeTree tmp = MakeAnimatedNodeTree(*file, *animation, frame);
-        const std::vector<int>& joints = file->skins[node->skin].joints;
-        transformation.transformations.resize(joints.size());
-        for (size_t i = 0; i < joints.size(); ++i) {
-          const int jointNodeId = joints[i];
-          transformation.transformations[i] = tmp.nodeTransformations[jointNodeId].matGlobal;
-        }
-      } else {
-        const std::vector<int>& joints = file->skins[node->skin].joints;
-        transformation.transformations.resize(joints.size(), glm::mat4(1));
-      }
-      transformation.matRoot.resize(meshNodes.size(), glm::mat4(1));
-    } else {
-      transformation.matRoot.reserve(meshNodes.size());
-      for (const auto& e : meshNodes) {
-        transformation.matRoot.push_back(e->matGlobal);
-      }
+  ++poseStatistics.missCount;
+  if (poseCount >= poses.size()) {
+    poses.emplace_back(); // dequeなので、既存の要素へのポインタは無効にならない.
+  }
+  poseJobs.push_back({ file, node, poseLayers.size(), layerCount, skipLeafJoints, poseCount });
+  poseLayers.insert(poseLayers.end(), layers, layers + layerCount);
+  return &poses[poseCount++];
+}
+
+/**
+* 姿勢の計算とUBOへの書き込みを行い、UBOへの書き込みを終了する.
+*
+* このフレームに予約された姿勢の計算と、メッシュごとのUBOへの書き込みを、ワーカースレッドで並列に行う.
+* 書き込み先は予約時に決まっているので、結果は実行順序によらない.
+* 永続マップできない環境ではここでアンマップする.
+*/
+void UploadUniformData()
+{
+  ParallelFor(poseJobs.size(), [](size_t i) {
+    const PoseJob& e = poseJobs[i];
+    CalculateTransform(e.file, e.node, poseLayers.data() + e.firstLayer, e.layerCount, poses[e.index],
+      e.skipLeafJoints);
+  });
+  ParallelFor(updateRequests.size(), [](size_t i) {
+    const UpdateRequest& e = updateRequests[i];
+    e.mesh->WriteUniformData(e.data, e.pose);
+  });
+  poseJobs.clear();
+  poseLayers.clear();
+  updateRequests.clear();
+
+  if (!isInitialized) {
+    return;
+  }
+
+  ubo.EndFrame();
+}
+
+/**
+* アニメーションLODを設定する.
+*
+* @param settings 距離の昇順に並べた設定の配列.
+*                 最初の設定より近いメッシュは、毎フレーム全ての関節の姿勢を計算する.
+*/
+void SetAnimationLod(const std::vector<AnimationLodSetting>& settings)
+{
+  animationLod = settings;
+  std::sort(animationLod.begin(), animationLod.end(),
+    [](const AnimationLodSetting& a, const AnimationLodSetting& b) { return a.distance < b.distance; });
+  for (auto& e : animationLod) {
+    e.updateInterval = std::max(e.updateInterval, 1);
+  }
+}
+
+/**
+* アニメーションLODの設定を取得する.
+*
+* @return 距離の昇順に並んだ設定の配列.
+*/
+const std::vector<AnimationLodSetting>& GetAnimationLod()
+{
+  return animationLod;
+}
+
+/**
+* 画面外のメッシュの姿勢を固定するかどうかを設定する.
+*
+* @param freeze trueなら、画面外にあるメッシュは姿勢を計算せず、最後に計算した姿勢を使う.
+*               再生位置は進むので、画面内に戻ったときはその時点の姿勢になる.
+*/
+void SetFreezeOffscreen(bool freeze)
+{
+  freezeOffscreen = freeze;
+}
+
+/**
+* 画面外のメッシュの姿勢を固定するかどうかを取得する.
+*
+* @retval true  固定する.
+* @retval false 固定しない.
+*/
+bool GetFreezeOffscreen()
+{
+  return freezeOffscreen;
+}
+
+/**
+* 前のフレームのアニメーションLODの統計情報を取得する.
+*
+* @return 前のフレームのアニメーションLODの統計情報.
+*/
+const AnimationLodStatistics& GetAnimationLodStatistics()
+{
+  return lastLodStatistics;
+}
+
+/**
+* UBOの区画の数を設定する.
+*
+* @param count 区画の数(2～8). GPUの処理がcount-1フレーム遅れるまでは、CPUは待たずに書き込める.
+*              増やすほど待つことは減るが、メモリ使用量と描画までの遅延が増える.
+*
+* @retval true  設定成功.
+* @retval false UBOの作成に失敗.
+*
+* 初期化済みの場合はUBOを作り直すので、ResetUniformData()からUploadUniformData()の間に呼び出してはならない.
+*/
+bool SetFramesInFlight(size_t count)
+{
+  count = std::min<size_t>(std::max<size_t>(count, 2), 8);
+  if (count == framesInFlight) {
+    return true;
+  }
+  framesInFlight = count;
+  if (isInitialized) {
+    return CreateUniformBuffer();
+  }
+  return true;
+}
+
+/**
+* UBOの区画の数を取得する.
+*
+* @return UBOの区画の数.
+*/
+size_t GetFramesInFlight()
+{
+  return framesInFlight;
+}
+
+/**
+* UBOの統計情報を取得する.
+*
+* @return 初期化、またはResetUniformBufferStatistics()を呼んでからの統計情報.
+*/
+UniformBufferStatistics GetUniformBufferStatistics()
+{
+  const RingBuffer::Statistics& stat = ubo.GetStatistics();
+  UniformBufferStatistics result;
+  result.framesInFlight = ubo.FrameCount();
+  result.frameCount = stat.frameCount;
+  result.stallCount = stat.stallCount;
+  result.lastStallTime = stat.lastStallTime;
+  result.maxStallTime = stat.maxStallTime;
+  result.totalStallTime = stat.stallTime;
+  return result;
+}
+
+/**
+* UBOの統計情報をリセットする.
+*/
+void ResetUniformBufferStatistics()
+{
+  ubo.ResetStatistics();
+}
+
+/**
+* 視点からの距離に対応するアニメーションLODを選ぶ.
+*
+* @param depth 視点からの距離.
+*
+* @return 対応する設定. 最も近い設定より近ければnullptr.
+*/
+const AnimationLodSetting* SelectAnimationLod(float depth)
+{
+  const AnimationLodSetting* lod = nullptr;
+  for (const auto& e : animationLod) {
+    if (depth < e.distance) {
+      break;
     }
+    lod = &e;
   }
-  return transformation;
+  return lod;
 }
 
+} // namespace GlobalSkeletalMeshState
+
 /**
-* Wϊs񂩂]so.
+* 座標変換行列から回転行列を取り出す.
 *
-* @param m Wϊs.
+* @param m 座標変換行列.
 *
-* @return m̉]vfȂ]s.
+* @return mの回転要素だけからなる回転行列.
 */
 glm::aligned_mat4 DecomposeRotation(const glm::aligned_mat4& m)
 {
@@ -363,6 +965,67 @@ glm::aligned_mat4 DecomposeRotation(const glm::aligned_mat4& m)
   return glm::aligned_mat3(glm::scale(m, scale));
 }
 
+/**
+* 行列が回転と均一な拡大縮小だけからなるか調べる.
+*
+* @param m 調べる行列.
+*
+* @retval true  均一スケール. 法線をmでそのまま変換しても向きは正しい.
+* @retval false 不均一スケールまたはせん断を含む.
+*/
+bool IsUniformScale(const glm::mat4& m)
+{
+  const glm::vec3 x(m[0]);
+  const glm::vec3 y(m[1]);
+  const glm::vec3 z(m[2]);
+  const float xx = glm::dot(x, x);
+  const float yy = glm::dot(y, y);
+  const float zz = glm::dot(z, z);
+  const float epsilon = std::max({ xx, yy, zz }) * 1e-3f;
+  return std::abs(xx - yy) <= epsilon && std::abs(xx - zz) <= epsilon &&
+    std::abs(glm::dot(x, y)) <= epsilon && std::abs(glm::dot(y, z)) <= epsilon &&
+    std::abs(glm::dot(z, x)) <= epsilon;
+}
+
+/**
+* 法線変換用の行列を計算する.
+*
+* @param m モデル行列.
+*
+* @return mの3x3部分の逆転置行列を転置したもの(UBOに格納する形式).
+*/
+glm::aligned_mat3x4 MakeNormalMatrix(const glm::mat4& m)
+{
+  const glm::mat4 matNormal(glm::transpose(glm::inverse(glm::mat3(m))));
+  return glm::transpose(matNormal);
+}
+
+/**
+* 境界球が視錐台と交差するか調べる.
+*
+* @param matVP  ビュー・プロジェクション行列.
+* @param center 境界球の中心(ワールド座標).
+* @param radius 境界球の半径.
+*
+* @retval true  交差する、または視錐台に含まれる.
+* @retval false 視錐台の外にある.
+*/
+bool IsSphereVisible(const glm::mat4& matVP, const glm::vec3& center, float radius)
+{
+  // ビュー・プロジェクション行列の行の和と差が、視錐台の6平面になる.
+  const glm::mat4 m = glm::transpose(matVP);
+  const glm::vec4 planes[6] = {
+    m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2],
+  };
+  for (const glm::vec4& plane : planes) {
+    const float length = glm::length(glm::vec3(plane));
+    if (length > 0 && glm::dot(glm::vec3(plane), center) + plane.w < -radius * length) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
 *
 */
@@ -377,66 +1040,75 @@ void GetMeshNodeList(const Node* node, std::vector<const Node*>& list)
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param p eƂȂ郁bVobt@.
-* @param f bVt@C.
-* @param n bVm[h.
+* @param p 親となるメッシュバッファ.
+* @param f メッシュファイル.
+* @param n メッシュノード.
 */
 SkeletalMesh::SkeletalMesh(const ExtendedFilePtr& f, const Node* n)
-  : file(f), node(n)
+  : file(f), node(n), updatePhase(GlobalSkeletalMeshState::updatePhaseCounter++)
 {
 }
 
 /**
-* Aj[VԂXV.
+* アニメーションの再生位置を進める.
+*
+* @param animation 再生中のアニメーション.
+* @param frame     現在の再生位置.
+* @param delta     進める時間.
+* @param loop      ループ再生の指定(true=ループする false=ループしない).
 *
-* @param deltaTime O̍XV̌oߎ.
-* @param matModel  fs.
-* @param color     bV̐F.
+* @return 新しい再生位置.
 */
-void SkeletalMesh::Update(float deltaTime, const glm::aligned_mat4& matModel, const glm::vec4& color)
+float AdvanceAnimationFrame(const Animation& animation, float frame, float delta, bool loop)
 {
-  // Đt[XV.
-  if (animation && state == State::play) {
-    frame += deltaTime * animationSpeed;
-    if (loop) {
-      if (frame >= animation->totalTime) {
-        frame -= animation->totalTime;
-      } else if (frame < 0) {
-        const float n = std::ceil(-frame / animation->totalTime);
-        frame += animation->totalTime * n;
-      }
-    } else {
-      if (frame >= animation->totalTime) {
-        frame = animation->totalTime;
-      } else if (frame < 0) {
-        frame = 0;
-      }
+  frame += delta;
+  if (loop) {
+    if (frame >= animation.totalTime) {
+      frame -= animation.totalTime;
+    } else if (frame < 0) {
+      const float n = std::ceil(-frame / animation.totalTime);
+      frame += animation.totalTime * n;
+    }
+  } else {
+    if (frame >= animation.totalTime) {
+      frame = animation.totalTime;
+    } else if (frame < 0) {
+      frame = 0;
     }
   }
+  return frame;
+}
 
-  // eBufferUBOf[^ǉ.
-  GlobalSkeletalMeshState::UniformDataMeshMatrix uboData;
-  uboData.color = color;
-  const MeshTransformation mt = CalculateTransform(file, node, animation, frame);
-  for (size_t i = 0; i < mt.transformations.size(); ++i) {
-    uboData.matBones[i] = glm::transpose(mt.transformations[i]);
+/**
+* 再生位置と再生状態だけを更新する.
+*
+* @param deltaTime 前回の更新からの経過時間.
+*
+* 姿勢の計算とUBOへの書き込みは行わない.
+* CrowdRendererのように、再生位置だけを使って別の方法で描画する場合に使う.
+*/
+void SkeletalMesh::AdvanceFrame(float deltaTime)
+{
+  // 再生フレーム更新.
+  if (animation && state == State::play) {
+    frame = AdvanceAnimationFrame(*animation, frame, deltaTime * animationSpeed, loop);
   }
-  if (mt.matRoot.empty()) {
-    uboData.matModel[0] = glm::transpose(matModel);
-  } else {
-    const size_t size = std::min(mt.matRoot.size(), sizeof(uboData.matModel) / sizeof(uboData.matModel[0]));
-    for (size_t i = 0; i < size; ++i) {
-      const glm::aligned_mat4 m = matModel * mt.matRoot[i];
-      uboData.matModel[i] = glm::transpose(m);
+
+  // クロスフェード更新. 再生中のアニメーションが終了しても、フェードは最後まで進める.
+  if (!fadeLayers.empty() && state != State::pause) {
+    fadeTime += deltaTime;
+    if (fadeTime >= fadeDuration) {
+      fadeLayers.clear();
+    } else {
+      for (auto& e : fadeLayers) {
+        e.frame = AdvanceAnimationFrame(*e.animation, e.frame, deltaTime * animationSpeed, e.loop);
+      }
     }
   }
-  uboSize = sizeof(glm::aligned_vec4) + sizeof(glm::aligned_mat3x4) * 8 + sizeof(glm::aligned_mat3x4) * mt.transformations.size();
-  uboSize = ((uboSize + 255) / 256) * 256;
-  uboOffset = GlobalSkeletalMeshState::PushUniformData(&uboData, uboSize);
 
-  // ԂXV.
+  // 状態を更新.
   if (animation) {
     switch (state) {
     case State::stop:
@@ -453,7 +1125,147 @@ void SkeletalMesh::Update(float deltaTime, const glm::aligned_mat4& matModel, co
 }
 
 /**
-* XP^bV`悷.
+* アニメーション状態を更新する.
+*
+* @param deltaTime 前回の更新からの経過時間.
+* @param matModel  モデル行列.
+* @param color     メッシュの色.
+*
+* 視点からの距離と画面内外の判定に応じて、アニメーションLODが姿勢の計算を間引く.
+* 間引いたフレームでも再生位置とモデル行列は更新される.
+* 姿勢の計算とUBOへの書き込みは予約だけを行い、GlobalSkeletalMeshState::UploadUniformData()で実行される.
+*/
+void SkeletalMesh::Update(float deltaTime, const glm::aligned_mat4& matModel, const glm::vec4& color)
+{
+  AdvanceFrame(deltaTime);
+
+  this->matModel = matModel;
+
+  // アニメーションLODに従って、姿勢を計算するかどうかを決める.
+  bool needsUpdate = !hasCachedPose || cachedAnimation != animation;
+  bool skipLeafJoints = false;
+  if (file && node && node->mesh >= 0 && !file->materials.empty()) {
+    using namespace GlobalSkeletalMeshState;
+    const glm::mat4& matVP = file->materials[0].progSkeletalMesh->ViewProjectionMatrix();
+    const AnimationLodSetting* lod = SelectAnimationLod((matVP * matModel[3]).w);
+    if (lod) {
+      skipLeafJoints = lod->skipLeafJoints;
+    }
+    if (!needsUpdate) {
+      // アニメーションで境界ボックスからはみ出す分を考慮して、半径を大きめにとる.
+      const MeshData& meshData = file->meshes[node->mesh];
+      const glm::vec3 center = glm::vec3(matModel * glm::vec4((meshData.boundsMin + meshData.boundsMax) * 0.5f, 1));
+      const float scale = std::sqrt(std::max({ glm::dot(glm::vec3(matModel[0]), glm::vec3(matModel[0])),
+        glm::dot(glm::vec3(matModel[1]), glm::vec3(matModel[1])),
+        glm::dot(glm::vec3(matModel[2]), glm::vec3(matModel[2])) }));
+      const float radius = glm::length(meshData.boundsMax - meshData.boundsMin) * 0.75f * scale;
+      if (freezeOffscreen && radius > 0 && !IsSphereVisible(matVP, center, radius)) {
+        ++lodStatistics.frozenCount;
+      } else if (lod && (frameCount + updatePhase) % lod->updateInterval != 0) {
+        ++lodStatistics.throttledCount;
+      } else {
+        needsUpdate = true;
+      }
+    }
+  } else {
+    needsUpdate = true;
+  }
+
+  this->color = color;
+  const MeshTransformation* pose = nullptr;
+  if (needsUpdate) {
+    // クロスフェード中は、切り替え前のアニメーションを重みを減らしながら合成する.
+    PoseLayer layers[maxBlendLayers];
+    size_t layerCount = 0;
+    const float t = fadeLayers.empty() ? 1.0f : std::min(fadeTime / fadeDuration, 1.0f);
+    for (const auto& e : fadeLayers) {
+      layers[layerCount++] = { e.animation, e.frame, e.weight * (1.0f - t) };
+    }
+    if (animation) {
+      layers[layerCount++] = { animation, frame, t };
+    }
+    ++GlobalSkeletalMeshState::lodStatistics.updateCount;
+    pose = GlobalSkeletalMeshState::ReservePose(file, node, layers, layerCount, skipLeafJoints);
+    boneCount = (file && node && node->skin >= 0) ? file->skins[node->skin].joints.size() : 0;
+    cachedAnimation = animation;
+    hasCachedPose = true;
+  }
+  boneCount = std::min<size_t>(boneCount, 256);
+
+  // UBOの領域は呼び出し順に予約されるので、オフセットは毎回同じになる.
+  uboSize = offsetof(GlobalSkeletalMeshState::UniformDataMeshMatrix, matBones) +
+    sizeof(glm::aligned_mat3x4) * boneCount;
+  uboSize = ((uboSize + 255) / 256) * 256;
+  void* data = nullptr;
+  uboOffset = GlobalSkeletalMeshState::ReserveUniformData(uboSize, data);
+  if (!data) {
+    hasCachedPose = false; // 姿勢を受け取れないので、次のフレームで計算し直す.
+    return;
+  }
+
+  // 姿勢の計算とUBOへの書き込みは、UploadUniformData()でまとめて並列に行う.
+  // 同じフレームに2回以上呼ばれた場合は、最後の呼び出しの結果を使う.
+  using GlobalSkeletalMeshState::updateRequests;
+  if (requestFrame == GlobalSkeletalMeshState::frameCount && requestIndex < updateRequests.size() &&
+    updateRequests[requestIndex].mesh.get() == this) {
+    updateRequests[requestIndex].data = data;
+    if (pose) {
+      updateRequests[requestIndex].pose = pose;
+    }
+  } else {
+    requestFrame = GlobalSkeletalMeshState::frameCount;
+    requestIndex = updateRequests.size();
+    updateRequests.push_back({ shared_from_this(), data, pose });
+  }
+}
+
+/**
+* UBOデータを書き込む.
+*
+* @param p    書き込み先.
+* @param pose 新しい姿勢. nullptrなら前回の姿勢を使う.
+*
+* GlobalSkeletalMeshState::UploadUniformData()から、ワーカースレッドで呼び出される.
+* 同時に呼び出されるのは別のメッシュだけなので、メッシュ自身のデータは排他制御なしで書き換えてよい.
+*/
+void SkeletalMesh::WriteUniformData(void* p, const MeshTransformation* pose)
+{
+  if (pose) {
+    cachedBones.resize(pose->transformations.size());
+    // 全ての行列が均一スケールなら、シェーダーは法線の変換に逆行列を使わずに済む.
+    isCachedUniformScale = true;
+    TransposeToAffine(pose->transformations.data(), cachedBones.data(), pose->transformations.size());
+    for (size_t i = 0; i < pose->transformations.size(); ++i) {
+      isCachedUniformScale = isCachedUniformScale && IsUniformScale(pose->transformations[i]);
+    }
+    cachedRoot = pose->matRoot;
+  }
+
+  // モデル行列は姿勢を計算しないフレームでも更新する.
+  GlobalSkeletalMeshState::UniformDataMeshMatrix uboData;
+  uboData.color = color;
+  const size_t count = std::min(cachedBones.size(), boneCount);
+  std::copy(cachedBones.begin(), cachedBones.begin() + count, uboData.matBones);
+  bool isUniformScale = isCachedUniformScale;
+  if (cachedRoot.empty()) {
+    uboData.matModel[0] = glm::transpose(matModel);
+    uboData.matNormal[0] = MakeNormalMatrix(matModel);
+    isUniformScale = isUniformScale && IsUniformScale(matModel);
+  } else {
+    const size_t size = std::min(cachedRoot.size(), sizeof(uboData.matModel) / sizeof(uboData.matModel[0]));
+    for (size_t i = 0; i < size; ++i) {
+      const glm::aligned_mat4 m = matModel * cachedRoot[i];
+      uboData.matModel[i] = glm::transpose(m);
+      uboData.matNormal[i] = MakeNormalMatrix(m);
+      isUniformScale = isUniformScale && IsUniformScale(m);
+    }
+  }
+  uboData.flags = glm::ivec4(isUniformScale ? 1 : 0, 0, 0, 0);
+  memcpy(p, &uboData, uboSize);
+}
+
+/**
+* スケルタルメッシュを描画する.
 */
 void SkeletalMesh::Draw() const
 {
@@ -461,7 +1273,7 @@ void SkeletalMesh::Draw() const
     return;
   }
 
-  // TODO: V[x̕`ɑΉ邱.
+  // TODO: シーンレベルの描画に対応すること.
   //std::vector<const Node*> meshNodes;
   //meshNodes.reserve(32);
   //GetMeshNodeList(node, meshNodes);
@@ -469,7 +1281,10 @@ void SkeletalMesh::Draw() const
   GlobalSkeletalMeshState::BindUniformData(uboOffset, uboSize);
 
   const MeshData& meshData = file->meshes[node->mesh];
-  GLuint prevTexId = 0;
+  int lod = 0;
+  if (!meshData.lodDistances.empty() && !file->materials.empty()) {
+    lod = SelectLod(meshData, file->materials[0].progSkeletalMesh->ViewProjectionMatrix(), matModel);
+  }
   for (const auto& prim : meshData.primitives) {
     prim.vao->Bind();
     if (!prim.hasColorAttribute) {
@@ -481,30 +1296,25 @@ void SkeletalMesh::Draw() const
       const Material& m = file->materials[prim.material];
       m.progSkeletalMesh->Use();
       if (m.texture) {
-        const GLuint texId = m.texture->Id();
-        if (prevTexId != texId) {
-          m.texture->Bind(0);
-          prevTexId = texId;
-        }
+        m.texture->Bind(0);
       }
       const GLint locMaterialColor = glGetUniformLocation(m.progSkeletalMesh->Id(), "materialColor");
       if (locMaterialColor >= 0) {
         glUniform4fv(locMaterialColor, 1, &m.baseColor.x);
       }
-      glDrawElementsBaseVertex(prim.mode, prim.count, prim.type, prim.indices, prim.baseVertex);
+      DrawElements(prim, lod);
     }
   }
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glUseProgram(0);
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  GLState::UseProgram(0);
+  GLState::BindVertexArray(0);
+  GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 /**
-* Aj[V̍ĐԂ擾.
+* アニメーションの再生状態を取得する.
 *
-* @return ĐԂState񋓌^̒l.
+* @return 再生状態を示すState列挙型の値.
 */
 SkeletalMesh::State SkeletalMesh::GetState() const
 {
@@ -512,9 +1322,9 @@ SkeletalMesh::State SkeletalMesh::GetState() const
 }
 
 /**
-* bVɊ֘AtꂽAj[ṼXg擾.
+* メッシュに関連付けられたアニメーションのリストを取得する.
 *
-* @return Aj[VXg.
+* @return アニメーションリスト.
 */
 const std::vector<Animation>& SkeletalMesh::GetAnimationList() const
 {
@@ -526,9 +1336,9 @@ const std::vector<Animation>& SkeletalMesh::GetAnimationList() const
 }
 
 /**
-* Aj[VԂ擾.
+* アニメーション時間を取得する.
 *
-* @return Aj[V(b).
+* @return アニメーション時間(秒).
 */
 float SkeletalMesh::GetTotalAnimationTime() const
 {
@@ -539,13 +1349,13 @@ float SkeletalMesh::GetTotalAnimationTime() const
 }
 
 /**
-* Aj[VĐ.
+* アニメーションを再生する.
 *
-* @param animationName ĐAj[V̖O.
-* @param loop      [vĐ̎w(true=[v false=[vȂ).
+* @param animationName 再生するアニメーションの名前.
+* @param loop      ループ再生の指定(true=ループする false=ループしない).
 *
-* @retval true  ĐJn.
-* @retval false Đs.
+* @retval true  再生開始.
+* @retval false 再生失敗.
 */
 bool SkeletalMesh::Play(const std::string& animationName, bool loop)
 {
@@ -556,6 +1366,7 @@ bool SkeletalMesh::Play(const std::string& animationName, bool loop)
         frame = 0;
         state = State::play;
         this->loop = loop;
+        fadeLayers.clear();
         return true;
       }
     }
@@ -564,10 +1375,69 @@ bool SkeletalMesh::Play(const std::string& animationName, bool loop)
 }
 
 /**
-* Aj[V̍Đ~.
+* 現在のアニメーションから徐々に切り替えながら、アニメーションを再生する.
 *
-* @retval true  .
-* @retval false s(Aj[Vݒ肳ĂȂ).
+* @param animationName 再生するアニメーションの名前.
+* @param duration      切り替えにかける時間(秒). 0以下ならPlay()と同じく即座に切り替える.
+* @param loop          ループ再生の指定(true=ループする false=ループしない).
+*
+* @retval true  再生開始.
+* @retval false 再生失敗.
+*
+* 切り替え前のアニメーションは再生を続けながら重みを減らしていく.
+* クロスフェード中にさらに切り替えた場合は、その時点の重みのまま、全てのアニメーションをフェードアウトさせる.
+* 合成するアニメーションがmaxBlendLayersを超える場合は、重みの小さいものから取り除く.
+*/
+bool SkeletalMesh::CrossFade(const std::string& animationName, float duration, bool loop)
+{
+  if (!animation || duration <= 0) {
+    return Play(animationName, loop);
+  }
+  if (!file) {
+    return false;
+  }
+  const auto itr = std::find_if(file->animations.begin(), file->animations.end(),
+    [&animationName](const Animation& e) { return e.name == animationName; });
+  if (itr == file->animations.end()) {
+    return false;
+  }
+
+  // 現在の重みを確定して、再生中のアニメーションをフェードアウトさせる.
+  const float t = fadeLayers.empty() ? 1.0f : std::min(fadeTime / fadeDuration, 1.0f);
+  for (auto& e : fadeLayers) {
+    e.weight *= 1.0f - t;
+  }
+  fadeLayers.push_back({ animation, frame, this->loop, t });
+  fadeLayers.erase(std::remove_if(fadeLayers.begin(), fadeLayers.end(),
+    [](const FadeLayer& e) { return e.weight <= 0; }), fadeLayers.end());
+  while (fadeLayers.size() >= maxBlendLayers) {
+    fadeLayers.erase(std::min_element(fadeLayers.begin(), fadeLayers.end(),
+      [](const FadeLayer& a, const FadeLayer& b) { return a.weight < b.weight; }));
+  }
+
+  // 取り除いた分を補って、重みの合計を1にする.
+  float totalWeight = 0;
+  for (const auto& e : fadeLayers) {
+    totalWeight += e.weight;
+  }
+  for (auto& e : fadeLayers) {
+    e.weight /= totalWeight;
+  }
+
+  animation = &*itr;
+  frame = 0;
+  state = State::play;
+  this->loop = loop;
+  fadeTime = 0;
+  fadeDuration = duration;
+  return true;
+}
+
+/**
+* アニメーションの再生を停止する.
+*
+* @retval true  成功.
+* @retval false 失敗(アニメーションが設定されていない).
 */
 bool SkeletalMesh::Stop()
 {
@@ -587,10 +1457,10 @@ bool SkeletalMesh::Stop()
 }
 
 /**
-* Aj[V̍Đꎞ~.
+* アニメーションの再生を一時停止する.
 *
-* @retval true  .
-* @retval false s(Aj[V~ĂA܂̓Aj[Vݒ肳ĂȂ).
+* @retval true  成功.
+* @retval false 失敗(アニメーションが停止している、またはアニメーションが設定されていない).
 */
 bool SkeletalMesh::Pause()
 {
@@ -609,10 +1479,10 @@ bool SkeletalMesh::Pause()
 }
 
 /**
-* Aj[V̍ĐĊJ.
+* アニメーションの再生を再開する.
 *
-* @retval true  .
-* @retval false s(Aj[V~ĂA܂̓Aj[Vݒ肳ĂȂ).
+* @retval true  成功.
+* @retval false 失敗(アニメーションが停止している、またはアニメーションが設定されていない).
 */
 bool SkeletalMesh::Resume()
 {
@@ -631,10 +1501,10 @@ bool SkeletalMesh::Resume()
 }
 
 /**
-* Đ̃Aj[V擾.
+* 再生中のアニメーション名を取得する.
 *
-* @return Đ̃Aj[V.
-*         xPlay()ɐĂȂꍇA̕񂪕Ԃ.
+* @return 再生中のアニメーション名.
+*         一度もPlay()に成功していない場合、空の文字列が返される.
 */
 const std::string& SkeletalMesh::GetAnimation() const
 {
@@ -646,9 +1516,9 @@ const std::string& SkeletalMesh::GetAnimation() const
 }
 
 /**
-* Aj[V̍Đxݒ肷.
+* アニメーションの再生速度を設定する.
 *
-* @param speed Đx(1.0f=, 2.0f=2{, 0.5f=1/2{).
+* @param speed 再生速度(1.0f=等速, 2.0f=2倍速, 0.5f=1/2倍速).
 */
 void SkeletalMesh::SetAnimationSpeed(float speed)
 {
@@ -656,9 +1526,9 @@ void SkeletalMesh::SetAnimationSpeed(float speed)
 }
 
 /**
-* Aj[V̍Đx擾.
+* アニメーションの再生速度を取得する.
 *
-* @return Đx.
+* @return 再生速度.
 */
 float SkeletalMesh::GetAnimationSpeed() const
 {
@@ -666,9 +1536,9 @@ float SkeletalMesh::GetAnimationSpeed() const
 }
 
 /**
-* Aj[V̍Đʒuݒ肷.
+* アニメーションの再生位置を設定する.
 *
-* @param position Đʒu(b).
+* @param position 再生位置(秒).
 */
 void SkeletalMesh::SetPosition(float position)
 {
@@ -692,9 +1562,9 @@ void SkeletalMesh::SetPosition(float position)
 }
 
 /**
-* Aj[V̍Đʒu擾.
+* アニメーションの再生位置を取得する.
 *
-* @return Đʒu(b).
+* @return 再生位置(秒).
 */
 float SkeletalMesh::GetPosition() const
 {
@@ -702,12 +1572,12 @@ float SkeletalMesh::GetPosition() const
 }
 
 /**
-* Aj[V̍ĐIĂ邩ׂ.
+* アニメーションの再生が終了しているか調べる.
 *
-* @retval true  IĂ.
-* @retval false IĂȂ. ܂́AxLȖOPlay()sĂȂ.
+* @retval true  終了している.
+* @retval false 終了していない. または、一度も有効な名前でPlay()が実行されていない.
 *
-* [vĐ̏ꍇÅ֐͏falseԂƂɒ.
+* ループ再生中の場合、この関数は常にfalseを返すことに注意.
 */
 bool SkeletalMesh::IsFinished() const
 {
@@ -718,10 +1588,10 @@ bool SkeletalMesh::IsFinished() const
 }
 
 /**
-* [vĐ̗L擾.
+* ループ再生の有無を取得する.
 *
-* @retval true [vĐ.
-* @retval false [vĐȂ.
+* @retval true ループ再生される.
+* @retval false ループ再生されない.
 */
 bool SkeletalMesh::Loop() const
 {
@@ -729,9 +1599,9 @@ bool SkeletalMesh::Loop() const
 }
 
 /**
-* [vĐ̗L擾.
+* ループ再生の有無を取得する.
 *
-* @param loop [vĐ̗L.
+* @param loop ループ再生の有無.
 */
 void SkeletalMesh::Loop(bool loop)
 {
@@ -741,11 +1611,11 @@ void SkeletalMesh::Loop(bool loop)
 namespace /* unnamed */ {
 
 /**
-* JSON̔zf[^glm::vec3ɕϊ.
+* JSONの配列データをglm::vec3に変換する.
 *
-* @param json ϊƂȂzf[^.
+* @param json 変換元となる配列データ.
 *
-* @return jsonϊĂłvec3̒l.
+* @return jsonを変換してできたvec3の値.
 */
 glm::vec3 GetVec3(const json11::Json& json)
 {
@@ -757,11 +1627,11 @@ glm::vec3 GetVec3(const json11::Json& json)
 }
 
 /**
-* JSON̔zf[^glm::quatɕϊ.
+* JSONの配列データをglm::quatに変換する.
 *
-* @param json ϊƂȂzf[^.
+* @param json 変換元となる配列データ.
 *
-* @return jsonϊĂłquat̒l.
+* @return jsonを変換してできたquatの値.
 */
 glm::quat GetQuat(const json11::Json& json)
 {
@@ -778,11 +1648,11 @@ glm::quat GetQuat(const json11::Json& json)
 }
 
 /**
-* JSON̔zf[^glm::mat4ɕϊ.
+* JSONの配列データをglm::mat4に変換する.
 *
-* @param json ϊƂȂzf[^.
+* @param json 変換元となる配列データ.
 *
-* @return jsonϊĂłmat4̒l.
+* @return jsonを変換してできたmat4の値.
 */
 glm::mat4 GetMat4(const json11::Json& json)
 {
@@ -799,11 +1669,11 @@ glm::mat4 GetMat4(const json11::Json& json)
 }
 
 /**
-* m[h̃[JpsvZ.
+* ノードのローカル姿勢行列を計算する.
 *
-* @param node gltfm[h.
+* @param node gltfノード.
 *
-* @return nodẽ[Jps.
+* @return nodeのローカル姿勢行列.
 */
 glm::mat4 CalcLocalMatrix(const json11::Json& node)
 {
@@ -824,40 +1694,83 @@ glm::mat4 CalcLocalMatrix(const json11::Json& node)
   }
 }
 
+/**
+* ノードの初期姿勢を平行移動、回転、拡大率に分解する.
+*
+* @param node gltfノード.
+* @param out  分解した値を格納するノード. matLocalは計算済みであること.
+*/
+void SetLocalTRS(const json11::Json& node, Node& out)
+{
+  if (node["matrix"].is_array()) {
+    const glm::mat4 m(out.matLocal);
+    glm::vec3 axis[3] = { glm::vec3(m[0]), glm::vec3(m[1]), glm::vec3(m[2]) };
+    glm::vec3 s(glm::length(axis[0]), glm::length(axis[1]), glm::length(axis[2]));
+    if (glm::dot(glm::cross(axis[0], axis[1]), axis[2]) < 0) {
+      s.x = -s.x; // 鏡映はX軸の拡大率で表す.
+    }
+    for (int i = 0; i < 3; ++i) {
+      if (s[i] != 0) {
+        axis[i] /= s[i];
+      }
+    }
+    const glm::quat q = glm::quat_cast(glm::mat3(axis[0], axis[1], axis[2]));
+    out.translation = glm::aligned_vec3(m[3]);
+    out.rotation = glm::aligned_quat(q.w, q.x, q.y, q.z);
+    out.scale = glm::aligned_vec3(s);
+    return;
+  }
+  if (node["translation"].is_array()) {
+    out.translation = glm::aligned_vec3(GetVec3(node["translation"]));
+  }
+  if (node["rotation"].is_array()) {
+    const glm::quat q = GetQuat(node["rotation"]);
+    out.rotation = glm::aligned_quat(q.w, q.x, q.y, q.z);
+  }
+  if (node["scale"].is_array()) {
+    out.scale = glm::aligned_vec3(GetVec3(node["scale"]));
+  }
+}
+
 } // unnamed namespace
 
 /**
-* glTFt@Cǂݍ.
+* glTFファイルを読み込む.
 *
-* @param path glTFt@C.
+* @param path glTFファイル名.
 *
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
 */
 bool Buffer::LoadSkeletalMesh(const char* path)
 {
-  // gltft@Cǂݍ.
+  if (extendedFiles.find(path) != extendedFiles.end()) {
+    std::cout << "[情報]" << __func__ << ": '" << path << "'は読み込み済みです.\n";
+    return true;
+  }
+
+  // gltfファイルを読み込む.
   std::vector<char> gltfFile = ReadFromFile(path);
   if (gltfFile.empty()) {
     return false;
   }
   gltfFile.push_back('\0');
 
-  // json.
+  // json解析.
   std::string err;
   const json11::Json json = json11::Json::parse(gltfFile.data(), err);
   if (!err.empty()) {
-    std::cerr << "ERROR: " << path << "̓ǂݍ݂Ɏs܂.\n";
+    std::cerr << "ERROR: " << path << "の読み込みに失敗しました.\n";
     std::cerr << err << "\n";
     return false;
   }
 
-  // oCit@Cǂݍ.
+  // バイナリファイルを読み込む.
   std::vector<std::vector<char>> binFiles;
   for (const json11::Json& e : json["buffers"].array_items()) {
     const json11::Json& uri = e["uri"];
     if (!uri.is_string()) {
-      std::cerr << "[G[]" << __func__ << ": " << path << "ɕsuri܂.\n";
+      std::cerr << "[エラー]" << __func__ << ": " << path << "に不正なuriがあります.\n";
       return false;
     }
     const std::string binPath = std::string("Res/") + uri.string_value();
@@ -870,43 +1783,32 @@ bool Buffer::LoadSkeletalMesh(const char* path)
   ExtendedFilePtr pFile = std::make_shared<ExtendedFile>();
   ExtendedFile& file = *pFile;
 
-  // ANZbTf[^擾GPU֓].
+  // アクセッサからデータを取得してGPUへ転送.
   const json11::Json& accessors = json["accessors"];
   const json11::Json& bufferViews = json["bufferViews"];
 
-  // CfbNXf[^ƒ_f[^̃ANZbTID擾.
+  // インデックスデータと頂点属性データのアクセッサIDを取得.
+  OptimizationStatistics stats;
   file.meshes.reserve(json["meshes"].array_items().size());
   for (const auto& currentMesh : json["meshes"].array_items()) {
     MeshData mesh;
     mesh.name = currentMesh["name"].string_value();
     const std::vector<json11::Json>& primitives = currentMesh["primitives"].array_items();
     mesh.primitives.resize(primitives.size());
+    size_t lodCount = 0;
     for (size_t primId = 0; primId < primitives.size(); ++primId) {
       const json11::Json& primitive = currentMesh["primitives"][primId];
 
-      // _CfbNX.
-      {
-        const int accessorId_index = primitive["indices"].int_value();
-        const json11::Json& accessor = accessors[accessorId_index];
-        if (accessor["type"].string_value() != "SCALAR") {
-          std::cerr << "ERROR: CfbNXf[^E^CvSCALARłȂĂ͂Ȃ܂ \n";
-          std::cerr << "  type = " << accessor["type"].string_value() << "\n";
-          return false;
-        }
-
-        mesh.primitives[primId].mode = primitive["mode"].is_null() ? GL_TRIANGLES : primitive["mode"].int_value();
-        mesh.primitives[primId].count = accessor["count"].int_value();
-        mesh.primitives[primId].type = accessor["componentType"].int_value();
-        mesh.primitives[primId].indices = reinterpret_cast<const GLvoid*>(iboEnd);
-
-        const void* p;
-        size_t byteLength;
-        GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
-        ibo.BufferSubData(iboEnd, byteLength, p);
-        iboEnd += ((byteLength + 3) / 4) * 4; // ɗ̂ǂ̃f[^^łvȂ悤4oCgEɐ.
+      // 頂点インデックス.
+      mesh.primitives[primId].vertexFormat = VertexFormat::Skinned;
+      std::vector<GLuint> remap;
+      if (!SetIndices(mesh.primitives[primId], primitive, accessors, bufferViews, binFiles, remap, stats)) {
+        file.meshes.push_back(mesh);
+        FreePrimitives(file.meshes);
+        return false;
       }
 
-      // _.
+      // 頂点属性.
       const json11::Json& attributes = primitive["attributes"];
       const int accessorId_position = attributes["POSITION"].int_value();
       const int accessorId_normal = attributes["NORMAL"].is_null() ? -1 : attributes["NORMAL"].int_value();
@@ -914,20 +1816,42 @@ bool Buffer::LoadSkeletalMesh(const char* path)
       const int accessorId_weights = attributes["WEIGHTS_0"].is_null() ? -1 : attributes["WEIGHTS_0"].int_value();
       const int accessorId_joints = attributes["JOINTS_0"].is_null() ? -1 : attributes["JOINTS_0"].int_value();
 
-      mesh.primitives[primId].vao = std::make_shared<VertexArrayObject>();
-      mesh.primitives[primId].vao->Create(vbo.Id(), ibo.Id());
-      SetAttribute(mesh.primitives[primId], 0, accessors[accessorId_position], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 2, accessors[accessorId_texcoord], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 3, accessors[accessorId_normal], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 4, accessors[accessorId_weights], bufferViews, binFiles);
-      SetAttribute(mesh.primitives[primId], 5, accessors[accessorId_joints], bufferViews, binFiles);
+      SetAttribute(mesh.primitives[primId], 0, accessors[accessorId_position], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 2, accessors[accessorId_texcoord], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 3, accessors[accessorId_normal], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 4, accessors[accessorId_weights], bufferViews, binFiles, remap);
+      SetAttribute(mesh.primitives[primId], 5, accessors[accessorId_joints], bufferViews, binFiles, remap);
+
+      SetupVertexArray(mesh.primitives[primId]);
 
       mesh.primitives[primId].material = primitive["material"].int_value();
+      lodCount = std::max(lodCount, mesh.primitives[primId].lods.size());
+
+      // 境界ボックス(バインドポーズ). 画面外のメッシュの判定に使う.
+      const std::vector<json11::Json>& minValues = accessors[accessorId_position]["min"].array_items();
+      const std::vector<json11::Json>& maxValues = accessors[accessorId_position]["max"].array_items();
+      if (minValues.size() >= 3 && maxValues.size() >= 3) {
+        glm::vec3 primMin, primMax;
+        for (int i = 0; i < 3; ++i) {
+          primMin[i] = static_cast<float>(minValues[i].number_value());
+          primMax[i] = static_cast<float>(maxValues[i].number_value());
+        }
+        if (primId == 0) {
+          mesh.boundsMin = primMin;
+          mesh.boundsMax = primMax;
+        } else {
+          mesh.boundsMin = glm::min(mesh.boundsMin, primMin);
+          mesh.boundsMax = glm::max(mesh.boundsMax, primMax);
+        }
+      }
+    }
+    for (size_t i = 0; i < lodCount; ++i) {
+      mesh.lodDistances.push_back(lodSettings[i].distance);
     }
     file.meshes.push_back(mesh);
   }
 
-  // }eA.
+  // マテリアル.
   {
     const std::vector<json11::Json> materials = json["materials"].array_items();
     file.materials.reserve(materials.size());
@@ -953,20 +1877,20 @@ bool Buffer::LoadSkeletalMesh(const char* path)
       }
       Texture::Image2DPtr tex;
       if (!texturePath.empty()) {
-        tex = Texture::Image2D::Create(texturePath.c_str());
+        tex = Texture::Cache::Instance().Create(texturePath.c_str(), true);
       }
       file.materials.push_back(CreateMaterial(col, tex));
     }
   }
 
-  // m[hc[\z.
+  // ノードツリーを構築.
   {
     const json11::Json& nodes = json["nodes"];
     int i = 0;
     file.nodes.resize(nodes.array_items().size());
     for (const auto& node : nodes.array_items()) {
-      // eq֌W\z.
-      // NOTE: |C^g킸ƂCfbNXŏ\Ȃ.
+      // 親子関係を構築.
+      // NOTE: ポインタを使わずともインデックスで十分かもしれない.
       const std::vector<json11::Json>& children = node["children"].array_items();
       file.nodes[i].children.reserve(children.size());
       for (const auto& e : children) {
@@ -977,13 +1901,14 @@ bool Buffer::LoadSkeletalMesh(const char* path)
         }
       }
 
-      // [JWϊsvZ.
+      // ローカル座標変換行列を計算.
       file.nodes[i].matLocal = CalcLocalMatrix(nodes[i]);
+      SetLocalTRS(nodes[i], file.nodes[i]);
 
       ++i;
     }
 
-    // V[̃[gm[h擾.
+    // シーンのルートノードを取得.
     file.scenes.reserve(json["scenes"].array_items().size());
     for (const auto& scene : json["scenes"].array_items()) {
       Scene tmp;
@@ -1008,15 +1933,15 @@ bool Buffer::LoadSkeletalMesh(const char* path)
   for (const auto& skin : json["skins"].array_items()) {
     Skin tmpSkin;
 
-    // oCh|[Ys擾.
+    // バインドポーズ行列を取得.
     const json11::Json& accessor = accessors[skin["inverseBindMatrices"].int_value()];
     if (accessor["type"].string_value() != "MAT4") {
-      std::cerr << "ERROR: oCh|[YtypeMAT4łȂĂ͂Ȃ܂ \n";
+      std::cerr << "ERROR: バインドポーズのtypeはMAT4でなくてはなりません \n";
       std::cerr << "  type = " << accessor["type"].string_value() << "\n";
       return false;
     }
     if (accessor["componentType"].int_value() != GL_FLOAT) {
-      std::cerr << "ERROR: oCh|[YcomponentTypeGL_FLOATłȂĂ͂Ȃ܂ \n";
+      std::cerr << "ERROR: バインドポーズのcomponentTypeはGL_FLOATでなくてはなりません \n";
       std::cerr << "  type = 0x" << std::hex << accessor["componentType"].string_value() << "\n";
       return false;
     }
@@ -1025,7 +1950,7 @@ bool Buffer::LoadSkeletalMesh(const char* path)
     size_t byteLength;
     GetBuffer(accessor, bufferViews, binFiles, &p, &byteLength);
 
-    // gltf̃obt@f[^̓gGfBA. dlɏĂ.
+    // gltfのバッファデータはリトルエンディアン. 仕様に書いてある.
     const std::vector<json11::Json>& joints = skin["joints"].array_items();
     std::vector<glm::mat4> inverseBindPoseList;
     inverseBindPoseList.resize(accessor["count"].int_value());
@@ -1054,13 +1979,15 @@ bool Buffer::LoadSkeletalMesh(const char* path)
     }
   }
 
-  // Aj[V.
+  // アニメーション.
+  AnimationCompressionStatistics animationStats;
   {
     for (const auto& animation : json["animations"].array_items()) {
       Animation anime;
-      anime.translationList.reserve(32);
-      anime.rotationList.reserve(32);
-      anime.scaleList.reserve(32);
+      RawAnimation raw;
+      raw.translationList.reserve(32);
+      raw.rotationList.reserve(32);
+      raw.scaleList.reserve(32);
       anime.name = animation["name"].string_value();
 
       const std::vector<json11::Json>& channels = animation["channels"].array_items();
@@ -1097,7 +2024,7 @@ bool Buffer::LoadSkeletalMesh(const char* path)
             timeline.timeline.push_back({ pKeyFrame[i], pData[i] });
           }
           timeline.targetNodeId = targetNodeId;
-          anime.translationList.push_back(timeline);
+          raw.translationList.push_back(timeline);
         } else if (path == "rotation") {
           const GLfloat* pKeyFrame = static_cast<const GLfloat*>(pInput);
           const glm::quat* pData = static_cast<const glm::quat*>(pOutput);
@@ -1108,7 +2035,7 @@ bool Buffer::LoadSkeletalMesh(const char* path)
             timeline.timeline.push_back({ pKeyFrame[i], pData[i] });
           }
           timeline.targetNodeId = targetNodeId;
-          anime.rotationList.push_back(timeline);
+          raw.rotationList.push_back(timeline);
         } else if (path == "scale") {
           const GLfloat* pKeyFrame = static_cast<const GLfloat*>(pInput);
           const glm::vec3* pData = static_cast<const glm::vec3*>(pOutput);
@@ -1119,9 +2046,10 @@ bool Buffer::LoadSkeletalMesh(const char* path)
             timeline.timeline.push_back({ pKeyFrame[i], pData[i] });
           }
           timeline.targetNodeId = targetNodeId;
-          anime.scaleList.push_back(timeline);
+          raw.scaleList.push_back(timeline);
         }
       }
+      CompressAnimation(raw, AnimationCompressionParameter(), anime, animationStats);
       file.animations.push_back(anime);
     }
   }
@@ -1137,14 +2065,19 @@ bool Buffer::LoadSkeletalMesh(const char* path)
     meshes.insert(std::make_pair(mesh.name, MeshIndex{ pFile, &pFile->nodes[i] }));
   }
 
-  std::cout << "[INFO]" << __func__ << ": '" << path << "'ǂݍ݂܂.\n";
+  std::cout << "[INFO]" << __func__ << ": '" << path << "'を読み込みました.\n";
   std::cout << "  total nodes = " << file.nodes.size() << "\n";
   for (size_t i = 0; i < file.meshes.size(); ++i) {
     std::cout << "  mesh[" << i << "] = " << file.meshes[i].name << "\n";
   }
+  PrintStatistics(path, stats);
   for (size_t i = 0; i < file.animations.size(); ++i) {
     std::cout << "  animation[" << i << "] = " << file.animations[i].name << "(" << file.animations[i].totalTime << "sec)\n";
   }
+  if (!file.animations.empty()) {
+    std::cout << "  animation keys = " << animationStats.keyCountBefore << " -> " << animationStats.keyCountAfter <<
+      ", bytes = " << animationStats.byteSizeBefore << " -> " << animationStats.byteSizeAfter << "\n";
+  }
   for (size_t i = 0; i < file.skins.size(); ++i) {
     std::cout << "  skin[" << i << "] = " << file.skins[i].name << "(" << file.skins[i].joints.size() << ")\n";
   }
@@ -1153,11 +2086,11 @@ bool Buffer::LoadSkeletalMesh(const char* path)
 }
 
 /**
-* XP^bV擾.
+* スケルタルメッシュを取得する.
 *
-* @param meshName 擾XP^bV̖O.
+* @param meshName 取得したいスケルタルメッシュの名前.
 *
-* @return meshNameƓOXP^bV.
+* @return meshNameと同じ名前を持つスケルタルメッシュ.
 */
 SkeletalMeshPtr Buffer::GetSkeletalMesh(const char* meshName) const
 {
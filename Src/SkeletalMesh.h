@@ -4,16 +4,17 @@
 #ifndef SKELETAL_MESH_H_INCLUDED
 #define SKELETAL_MESH_H_INCLUDED
 #include "Mesh.h"
+#include "AnimationCompression.h"
 
 namespace Mesh {
 
-// XLf[^.
+// スキンデータ.
 struct Skin {
   std::string name;
   std::vector<int> joints;
 };
 
-// m[h.
+// ノード.
 struct Node {
   Node* parent = nullptr;
   int mesh = -1;
@@ -22,40 +23,32 @@ struct Node {
   glm::aligned_mat4 matLocal = glm::aligned_mat4(1);
   glm::aligned_mat4 matGlobal = glm::aligned_mat4(1);
   glm::aligned_mat4 matInverseBindPose = glm::aligned_mat4(1);
-};
-
-// Aj[ṼL[t[.
-template<typename T>
-struct KeyFrame {
-  float frame;
-  T value;
-};
 
-// Aj[Ṽ^CC.
-template<typename T>
-struct Timeline {
-  int targetNodeId;
-  std::vector<KeyFrame<T>> timeline;
+  // matLocalを分解した平行移動、回転、拡大率. アニメーションしない要素はこの値を使う.
+  glm::aligned_vec3 translation = glm::aligned_vec3(0);
+  glm::aligned_quat rotation = glm::aligned_quat(1, 0, 0, 0);
+  glm::aligned_vec3 scale = glm::aligned_vec3(1);
 };
 
-// Aj[V.
+// アニメーション.
 struct Animation {
-  std::vector<Timeline<glm::aligned_vec3>> translationList;
-  std::vector<Timeline<glm::aligned_quat>> rotationList;
-  std::vector<Timeline<glm::aligned_vec3>> scaleList;
+  std::vector<CompressedTimeline> translationList;
+  std::vector<CompressedTimeline> rotationList;
+  std::vector<CompressedTimeline> scaleList;
+  CompressedKeys keys; // 全タイムラインのキー.
   float totalTime = 0;
   std::string name;
 };
 
-// V[.
+// シーン.
 struct Scene {
   int rootNode;
   std::vector<const Node*> meshNodes;
 };
 
-// gt@C.
+// 拡張ファイル.
 struct ExtendedFile {
-  std::string name; // t@C.
+  std::string name; // ファイル名.
   std::vector<MeshData> meshes;
   std::vector<Material> materials;
 
@@ -65,30 +58,46 @@ struct ExtendedFile {
   std::vector<Animation> animations;
 };
 
+struct MeshTransformation;
+
 /**
-* iAj[V郁bV.
+* 骨格アニメーションをするメッシュ.
 *
-* Aj[V@\܂ނ߁ACX^X͂̓sx쐬𓾂Ȃ.
+* アニメーション制御機能を含むため、インスタンスはその都度作成せざるを得ない.
+*
+* Update()は再生位置の更新、アニメーションLODの判定、UBO領域の予約だけを行う.
+* 姿勢の計算とUBOへの書き込みは、GlobalSkeletalMeshState::UploadUniformData()でワーカースレッドを使って並列に行う.
+* そのため、インスタンスはstd::shared_ptrで管理しなくてはならない.
 */
-class SkeletalMesh
+class SkeletalMesh : public std::enable_shared_from_this<SkeletalMesh>
 {
 public:
   enum class State {
-    stop, ///< ~.
-    play, ///< Đ.
-    pause, ///< ꎞ~.
+    stop, ///< 停止中.
+    play, ///< 再生中.
+    pause, ///< 一時停止中.
   };
 
+  // 同時に合成できるアニメーションの最大数(再生中のアニメーションを含む).
+  static const size_t maxBlendLayers = 4;
+
   SkeletalMesh() = default;
   SkeletalMesh(const ExtendedFilePtr& f, const Node* n);
 
   void Update(float deltaTime, const glm::aligned_mat4& matModel, const glm::vec4& color);
+  void AdvanceFrame(float deltaTime);
+  void WriteUniformData(void* p, const MeshTransformation* pose);
   void Draw() const;
+  const ExtendedFilePtr& GetFile() const { return file; }
+  const Node* GetNode() const { return node; }
+  const Animation* GetAnimationData() const { return animation; }
   const std::vector<Animation>& GetAnimationList() const;
   const std::string& GetAnimation() const;
   float GetTotalAnimationTime() const;
   State GetState() const;
   bool Play(const std::string& name, bool loop = true);
+  bool CrossFade(const std::string& name, float duration, bool loop = true);
+  bool IsCrossFading() const { return !fadeLayers.empty(); }
   bool Stop();
   bool Pause();
   bool Resume();
@@ -111,39 +120,120 @@ private:
   float animationSpeed = 1;
   bool loop = true;
 
+  // クロスフェード用. 切り替え前のアニメーションは、重みを減らしながら再生を続ける.
+  struct FadeLayer {
+    const Animation* animation;
+    float frame;
+    bool loop;
+    float weight; ///< クロスフェード開始時の重み.
+  };
+  std::vector<FadeLayer> fadeLayers; // 古い順.
+  float fadeTime = 0;     // クロスフェード開始からの経過時間.
+  float fadeDuration = 0; // クロスフェードにかける時間.
+
   GLintptr uboOffset = 0;
   GLsizeiptr uboSize = 0;
+  glm::mat4 matModel = glm::mat4(1); // LODの選択に使う.
+  glm::vec4 color = glm::vec4(1);
+  size_t boneCount = 0;
+  uint32_t requestFrame = ~0u; // 最後に更新を予約したフレーム.
+  size_t requestIndex = 0;   // 最後に予約した更新要求の番号.
+
+  // アニメーションLOD用. 姿勢を計算しないフレームは、最後に計算した姿勢を使う.
+  uint32_t updatePhase = 0; // 姿勢を計算するフレームをメッシュごとにずらすための値.
+  bool hasCachedPose = false;
+  bool isCachedUniformScale = true;
+  const Animation* cachedAnimation = nullptr;
+  std::vector<glm::aligned_mat3x4> cachedBones; // 転置済みの関節行列.
+  std::vector<glm::aligned_mat4> cachedRoot;
 };
 using SkeletalMeshPtr = std::shared_ptr<SkeletalMesh>;
 
 void GetMeshNodeList(const Node* node, std::vector<const Node*>& list);
+void CalculateJointMatrices(const ExtendedFilePtr& file, const Node* node, const Animation* animation, float frame,
+  std::vector<glm::aligned_mat4>& matrices);
 
 /**
-* SkeletalMesh̎g:
+* SkeletalMeshの使い方:
 *
-* main֐ւ̒ǉ:
-* 1. main֐́AOpenGL̏ƁAV[쐬OMesh::GlobalSkeletalMeshState::Initialize()s.
-* 2. main֐̏IOMesh::GlobalSkeletalMeshState::Finalize()s.
-* 3. SceneStack::Update֐Ăяo̒OMesh::GlobalSkeletalMeshState::ResetUniformData()s.
-* 4. SceneStack::Update֐Ăяo̒Mesh::GlobalSkeletalMeshState::UploadUniformData()s.
+* main関数への追加:
+* 1. main関数の、OpenGLの初期化が完了したあと、シーンを作成するより前にMesh::GlobalSkeletalMeshState::Initialize()を実行.
+* 2. main関数の終了直前にMesh::GlobalSkeletalMeshState::Finalize()を実行.
+* 3. SceneStack::Update関数呼び出しの直前にMesh::GlobalSkeletalMeshState::ResetUniformData()を実行.
+* 4. SceneStack::Update関数呼び出しの直後にMesh::GlobalSkeletalMeshState::UploadUniformData()を実行.
 *
-* Mesh::BufferNXւ̒ǉ:
-* 1. Mesh::Material\̂ɃXP^bVpVF[_|C^ǉ.
-* 2. Mesh::BufferNXɃXP^bVp̃VF[_ǂݍޏǉ.
-* 3. Mesh::Buffer::Init֐̍ŌBindUniformBlocks.
-* 4. Mesh::Buffer::LoadMesh֐XP^bVΉłɍւ.
-* 5. Mesh::BufferNXLoadSkeletalMesh֐AGetSkeletalMesh֐ǉ.
+* Mesh::Bufferクラスへの追加:
+* 1. Mesh::Material構造体にスケルタルメッシュ用シェーダポインタを追加.
+* 2. Mesh::Bufferクラスにスケルタルメッシュ用のシェーダを読み込む処理を追加.
+* 3. Mesh::Buffer::Init関数の最後でBindUniformBlockを実行.
+* 4. Mesh::Buffer::LoadMesh関数をスケルタルメッシュ対応版に差し替える.
+* 5. Mesh::BufferクラスにLoadSkeletalMesh関数、GetSkeletalMesh関数を追加.
 *
-* Q[:
+* ゲーム中:
 * 
 */
 namespace GlobalSkeletalMeshState {
 
-bool Initialize();
+// 姿勢キャッシュの統計情報.
+struct PoseCacheStatistics
+{
+  size_t hitCount = 0;  ///< 計算済みの姿勢を再利用した回数.
+  size_t missCount = 0; ///< 姿勢を計算した回数.
+};
+
+/**
+* アニメーションLODの設定.
+*
+* 視点からの距離がdistance以上のメッシュは、updateIntervalフレームに1回だけ姿勢を計算する.
+* 計算するフレームはメッシュごとにずらされるので、負荷は各フレームに分散する.
+*/
+struct AnimationLodSetting
+{
+  float distance;      ///< この設定に切り替える視点からの距離.
+  int updateInterval;  ///< 姿勢を計算する間隔(フレーム数).
+  bool skipLeafJoints; ///< 末端の関節のアニメーションを省略するならtrue.
+};
+
+// アニメーションLODの統計情報.
+struct AnimationLodStatistics
+{
+  size_t updateCount = 0;    ///< 姿勢を更新したメッシュの数.
+  size_t throttledCount = 0; ///< 更新間隔によって姿勢の更新を省略したメッシュの数.
+  size_t frozenCount = 0;    ///< 画面外にあるため姿勢の更新を省略したメッシュの数.
+};
+
+/**
+* 骨格アニメーション用UBOの統計情報.
+*
+* UBOはフレーム数分の区画に分けて順番に使う. 再利用する区画をGPUがまだ使っていると、CPUは待たされる.
+*/
+struct UniformBufferStatistics
+{
+  size_t framesInFlight = 0; ///< 区画の数.
+  uint32_t frameCount = 0;   ///< 計測したフレーム数.
+  uint32_t stallCount = 0;   ///< GPUを待ったフレーム数.
+  double lastStallTime = 0;  ///< 前のフレームで待った時間(秒).
+  double maxStallTime = 0;   ///< 1フレームで待った時間の最大値(秒).
+  double totalStallTime = 0; ///< 待った時間の合計(秒).
+};
+
+bool Initialize(size_t workerCount = 0);
 void Finalize();
 bool BindUniformBlock(const Shader::ProgramPtr&);
 void ResetUniformData();
 void UploadUniformData();
+void SetPoseQuantization(float step);
+float GetPoseQuantization();
+const PoseCacheStatistics& GetPoseCacheStatistics();
+void SetAnimationLod(const std::vector<AnimationLodSetting>& settings);
+const std::vector<AnimationLodSetting>& GetAnimationLod();
+void SetFreezeOffscreen(bool freeze);
+bool GetFreezeOffscreen();
+const AnimationLodStatistics& GetAnimationLodStatistics();
+bool SetFramesInFlight(size_t count);
+size_t GetFramesInFlight();
+UniformBufferStatistics GetUniformBufferStatistics();
+void ResetUniformBufferStatistics();
 
 } // namespace GlobalSkeletalMeshState
 
@@ -5,16 +5,16 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param m        \郁bV.
-* @param name     AN^[̖O.
-* @param health   ϋv.
-* @param position ʒu.
-* @param rotation ].
-* @param scale    g嗦.
+* @param m        表示するメッシュ.
+* @param name     アクターの名前.
+* @param health   耐久力.
+* @param position 位置.
+* @param rotation 回転.
+* @param scale    拡大率.
 *
-* w肳ꂽbVAOAϋv́AʒuA]Ag嗦ɂăAN^[.
+* 指定されたメッシュ、名前、耐久力、位置、回転、拡大率によってアクターを初期化する.
 */
 SkeletalMeshActor::SkeletalMeshActor(const Mesh::SkeletalMeshPtr& m,
   const std::string& name, int health, const glm::vec3& position,
@@ -24,25 +24,34 @@ SkeletalMeshActor::SkeletalMeshActor(const Mesh::SkeletalMeshPtr& m,
 }
 
 /**
-* `̍XV.
+* 描画情報の更新.
 *
-* @param deltaTime oߎ.
+* @param deltaTime 経過時間.
 */
 void SkeletalMeshActor::UpdateDrawData(float deltaTime)
 {
   if (mesh) {
-    const glm::mat4 matT = glm::translate(glm::mat4(1), position);
-    const glm::mat4 matR_Y = glm::rotate(glm::mat4(1), rotation.y, glm::vec3(0, 1, 0));
-    const glm::mat4 matR_ZY = glm::rotate(matR_Y, rotation.z, glm::vec3(0, 0, -1));
-    const glm::mat4 matR_XZY = glm::rotate(matR_ZY, rotation.x, glm::vec3(1, 0, 0));
-    const glm::mat4 matS = glm::scale(glm::mat4(1), scale);
-    const glm::mat4 matModel = matT * matR_XZY * matS;
-    mesh->Update(deltaTime, matModel, color);
+    mesh->Update(deltaTime, CalcModelMatrix(), color);
   }
 }
 
 /**
-* `.
+* モデル行列を計算する.
+*
+* @return 位置、回転、拡大率から計算したモデル行列.
+*/
+glm::mat4 SkeletalMeshActor::CalcModelMatrix() const
+{
+  const glm::mat4 matT = glm::translate(glm::mat4(1), position);
+  const glm::mat4 matR_Y = glm::rotate(glm::mat4(1), rotation.y, glm::vec3(0, 1, 0));
+  const glm::mat4 matR_ZY = glm::rotate(matR_Y, rotation.z, glm::vec3(0, 0, -1));
+  const glm::mat4 matR_XZY = glm::rotate(matR_ZY, rotation.x, glm::vec3(1, 0, 0));
+  const glm::mat4 matS = glm::scale(glm::mat4(1), scale);
+  return matT * matR_XZY * matS;
+}
+
+/**
+* 描画.
 */
 void SkeletalMeshActor::Draw()
 {
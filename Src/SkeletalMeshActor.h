@@ -7,7 +7,7 @@
 #include "SkeletalMesh.h"
 
 /**
-* XP^bVpAN^[.
+* スケルタルメッシュ用アクター.
 */
 class SkeletalMeshActor : public Actor
 {
@@ -20,6 +20,7 @@ public:
   virtual void Draw() override;
 
   const Mesh::SkeletalMeshPtr& GetMesh() const { return mesh; }
+  glm::mat4 CalcModelMatrix() const;
 
 private:
   Mesh::SkeletalMeshPtr mesh;
@@ -3,11 +3,14 @@
 */
 #include "Sprite.h"
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 
 /**
-* SpriteRXgN^.
+* Spriteコンストラクタ.
 */
 Sprite::Sprite(const Texture::Image2DPtr& tex) :
   texture(tex),
@@ -16,9 +19,9 @@ Sprite::Sprite(const Texture::Image2DPtr& tex) :
 }
 
 /**
-* `ɎgpeNX`w肷.
+* 描画に使用するテクスチャを指定する.
 *
-* @param tex `ɎgpeNX`.
+* @param tex 描画に使用するテクスチャ.
 */
 void Sprite::Texture(const Texture::Image2DPtr& tex)
 {
@@ -27,16 +30,17 @@ void Sprite::Texture(const Texture::Image2DPtr& tex)
 }
 
 /**
-* XvCg`NX.
+* スプライト描画クラスを初期化する.
 *
-* @param maxSpriteCount `\ȍőXvCg.
+* @param maxSpriteCount 描画可能な最大スプライト数.
 *
-* @retval true  .
-* @retval false s.
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
 */
 bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char* fsPath)
 {
-  vbo.Create(GL_ARRAY_BUFFER, sizeof(Vertex) * maxSpriteCount * 4, nullptr, GL_STREAM_DRAW);
+  // 頂点データの位置は描画時にベース頂点で指定するので、区画の境界を頂点の大きさで揃えておく.
+  vbo.Init(GL_ARRAY_BUFFER, sizeof(Vertex) * maxSpriteCount * 4, 3, sizeof(Vertex));
   std::vector<GLushort> indices;
   indices.resize(maxSpriteCount * 6);
   for (GLushort i = 0; i < maxSpriteCount; ++i) {
@@ -65,91 +69,116 @@ bool SpriteRenderer::Init(size_t maxSpriteCount, const char* vsPath, const char*
 }
 
 /**
-* _f[^̍쐬Jn.
+* 頂点データの作成を開始する.
+*
+* VBOのリングバッファの次の区画を、この区画全体を書き込み先として確保する.
+* 前のフレームまでの区画はGPUが使っている可能性があるので、そちらは上書きしない.
 */
 void SpriteRenderer::BeginUpdate()
 {
   drawDataList.clear();
-  vertices.clear();
-  vertices.reserve(vbo.Size() / sizeof(Vertex));
+  batches.clear();
+  vertexCount = 0;
+  maxVertexCount = 0;
+  baseVertex = 0;
+
+  vbo.BeginFrame();
+  GLintptr offset = 0;
+  mappedVertices = static_cast<Vertex*>(vbo.Allocate(vbo.FrameSize(), offset));
+  if (mappedVertices) {
+    maxVertexCount = static_cast<size_t>(vbo.FrameSize()) / sizeof(Vertex);
+    baseVertex = static_cast<GLint>(offset / sizeof(Vertex));
+  } else {
+    std::cerr << "[警告] " << __func__ << ": 頂点データの書き込み先を確保できません\n";
+  }
 }
 
 /**
-* _f[^ǉ.
+* 頂点データを追加する.
 *
-* @param sprite _f[^̌ɂȂXvCg.
+* @param sprite 頂点データの元になるスプライト.
 *
-* @retval true  ǉ.
-* @retval false _obt@tŒǉłȂ.
+* @retval true  追加成功.
+* @retval false 頂点バッファが満杯で追加できない.
+*
+* スプライトの変換は平行移動、Z軸回転、拡大縮小だけなので、行列を使わずに四隅の座標を直接計算する.
+* 書き込み先はGPUが読み取るメモリなので、書き込みだけを行い、読み出さないこと.
 */
 bool SpriteRenderer::AddVertices(const Sprite& sprite)
 {
-  if (vertices.size() * sizeof(Vertex) >= static_cast<size_t>(vbo.Size())) {
-    std::cerr << "[x] " << __func__ << "VBOtł\n";
+  if (!mappedVertices || vertexCount + 4 > maxVertexCount) {
+    std::cerr << "[警告] " << __func__ << "VBOが満杯です\n";
     return false;
   }
   const Texture::Image2DPtr& texture = sprite.Texture();
-  const glm::vec2 textureSize(texture->Width(), texture->Height());
-  const glm::vec2 reciprocalSize(glm::vec2(1) / textureSize);
-
-  Rect rect = sprite.Rectangle();
-  rect.origin *= reciprocalSize;
-  rect.size *= reciprocalSize;
-  const glm::vec2 halfSize = sprite.Rectangle().size * 0.5f;
-  const glm::mat4 matT = glm::translate(glm::mat4(1), sprite.Position());
-  const glm::mat4 matR = glm::rotate(glm::mat4(1), sprite.Rotation(), glm::vec3(0, 0, 1));
-  const glm::mat4 matS = glm::scale(glm::mat4(1), glm::vec3(sprite.Scale(), 1));
-  const glm::mat4 transform = matT * matR * matS;
+  if (!texture) {
+    return false;
+  }
+  const glm::vec2 reciprocalSize(1.0f / static_cast<float>(texture->Width()),
+    1.0f / static_cast<float>(texture->Height()));
+  const Rect& rect = sprite.Rectangle();
+  const glm::vec2 uv0 = rect.origin * reciprocalSize;
+  const glm::vec2 uv1 = (rect.origin + rect.size) * reciprocalSize;
 
-  Vertex v[4];
+  // 四隅の座標 = 中心 ± axisX ± axisY.
+  const glm::vec2 halfSize = rect.size * 0.5f * sprite.Scale();
+  glm::vec2 axisX(halfSize.x, 0);
+  glm::vec2 axisY(0, halfSize.y);
+  if (sprite.Rotation() != 0) {
+    const float c = std::cos(sprite.Rotation());
+    const float s = std::sin(sprite.Rotation());
+    axisX = glm::vec2(c, s) * halfSize.x;
+    axisY = glm::vec2(-s, c) * halfSize.y;
+  }
+  const glm::vec3& center = sprite.Position();
+  const glm::vec4& color = sprite.Color();
 
-  v[0].position = transform * glm::vec4(-halfSize.x, -halfSize.y, 0, 1);
-  v[0].color = sprite.Color();
-  v[0].texCoord = rect.origin;
+  Vertex* v = mappedVertices + vertexCount;
+  v[0].position = glm::vec3(glm::vec2(center) - axisX - axisY, center.z);
+  v[0].color = color;
+  v[0].texCoord = uv0;
 
-  v[1].position = transform * glm::vec4(halfSize.x, -halfSize.y, 0, 1);
-  v[1].color = sprite.Color();
-  v[1].texCoord = glm::vec2(rect.origin.x + rect.size.x, rect.origin.y);
+  v[1].position = glm::vec3(glm::vec2(center) + axisX - axisY, center.z);
+  v[1].color = color;
+  v[1].texCoord = glm::vec2(uv1.x, uv0.y);
 
-  v[2].position = transform * glm::vec4(halfSize.x, halfSize.y, 0, 1);
-  v[2].color = sprite.Color();
-  v[2].texCoord = rect.origin + rect.size;
+  v[2].position = glm::vec3(glm::vec2(center) + axisX + axisY, center.z);
+  v[2].color = color;
+  v[2].texCoord = uv1;
 
-  v[3].position = transform * glm::vec4(-halfSize.x, halfSize.y, 0, 1);
-  v[3].color = sprite.Color();
-  v[3].texCoord = glm::vec2(rect.origin.x, rect.origin.y + rect.size.y);
+  v[3].position = glm::vec3(glm::vec2(center) - axisX + axisY, center.z);
+  v[3].color = color;
+  v[3].texCoord = glm::vec2(uv0.x, uv1.y);
 
-  vertices.insert(vertices.end(), v, v + 4);
+  const size_t offset = (vertexCount / 4) * 6 * sizeof(GLushort);
+  vertexCount += 4;
 
-  if (drawDataList.empty()) {
-    drawDataList.push_back({ 6, 0, texture });
+  if (!drawDataList.empty() && drawDataList.back().texture == texture) {
+    drawDataList.back().count += 6;
   } else {
-    auto& data = drawDataList.back();
-    if (data.texture == texture) {
-      data.count += 6;
-    } else {
-      drawDataList.push_back({ 6, data.offset + data.count * sizeof(GLushort), texture });
-    }
+    drawDataList.push_back({ 6, offset, texture, 0 });
   }
-  
+
   return true;
 }
 
 /**
-* _f[^̍쐬I.
+* 頂点データの作成を終了する.
+*
+* 永続マップでない場合はここでVBOをアンマップする. 描画する前に呼び出すこと.
 */
 void SpriteRenderer::EndUpdate()
 {
-  vbo.BufferSubData(0, vertices.size() * sizeof(Vertex), vertices.data());
-  vertices.clear();
-  vertices.shrink_to_fit();
+  vbo.EndFrame();
+  mappedVertices = nullptr;
+  BuildDrawBatches();
 }
 
 /**
-* XvCg`悷.
+* スプライトを描画する.
 *
-* @param texture    `ɎgpeNX`.
-* @param screenSize ʃTCY.
+* @param texture    描画に使用するテクスチャ.
+* @param screenSize 画面サイズ.
 */
 void SpriteRenderer::Draw(const glm::vec2& screenSize) const
 {
@@ -160,16 +189,24 @@ void SpriteRenderer::Draw(const glm::vec2& screenSize) const
   vao.Bind();
   program->Use();
 
-  // seA_͉ʂ̒S.
+  // 平行投影、原点は画面の中心.
   const glm::vec2 halfScreenSize = screenSize * 0.5f;
   const glm::mat4x4 matProj = glm::ortho(-halfScreenSize.x, halfScreenSize.x, -halfScreenSize.y, halfScreenSize.y, 1.0f, 1000.0f);
   const glm::mat4x4 matView = glm::lookAt(glm::vec3(0, 0, 100), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
   program->SetViewProjectionMatrix(matProj * matView);
 
-  for (const auto& data : drawDataList) {
-    data.texture->Bind(0);
-    glDrawElements(GL_TRIANGLES, data.count, GL_UNSIGNED_SHORT, reinterpret_cast<const GLvoid*>(data.offset));
-    data.texture->Unbind(0);
+  // 同じテクスチャが続く場合、2回目以降のバインドはGLStateが省略する.
+  for (const auto& e : batches) {
+    e.texture->Bind(0);
+    if (e.rangeCount == 1) {
+      glDrawElementsBaseVertex(GL_TRIANGLES, rangeCounts[e.firstRange], GL_UNSIGNED_SHORT,
+        rangeOffsets[e.firstRange], baseVertex);
+    } else {
+      // GLEWのバージョンによって引数の型がconstでないため、キャストしてから渡す.
+      glMultiDrawElementsBaseVertex(GL_TRIANGLES, const_cast<GLsizei*>(&rangeCounts[e.firstRange]),
+        GL_UNSIGNED_SHORT, const_cast<GLvoid**>(&rangeOffsets[e.firstRange]), static_cast<GLsizei>(e.rangeCount),
+        const_cast<GLint*>(&rangeBaseVertices[e.firstRange]));
+    }
   }
 
   program->Unuse();
@@ -177,9 +214,57 @@ void SpriteRenderer::Draw(const glm::vec2& screenSize) const
 }
 
 /**
-* XvCg`f[^.
+* スプライト描画データを消去する.
 */
 void SpriteRenderer::ClearDrawData()
 {
   drawDataList.clear();
+  batches.clear();
+}
+
+/**
+* 描画命令のリストを作成する.
+*
+* 並べ替えが有効な場合、テクスチャが最初に現れた順に範囲を安定ソートして、同じテクスチャの範囲を1つの描画命令にまとめる.
+* 範囲はインデックスバッファ上では離れたままなので、頂点データを並べ替える必要はない.
+*/
+void SpriteRenderer::BuildDrawBatches()
+{
+  batches.clear();
+  rangeCounts.clear();
+  rangeOffsets.clear();
+  rangeBaseVertices.clear();
+
+  if (sortByTexture && drawDataList.size() > 1) {
+    textureOrder.clear();
+    for (auto& e : drawDataList) {
+      const auto itr = std::find(textureOrder.begin(), textureOrder.end(), e.texture.get());
+      e.group = itr - textureOrder.begin();
+      if (itr == textureOrder.end()) {
+        textureOrder.push_back(e.texture.get());
+      }
+    }
+    std::stable_sort(drawDataList.begin(), drawDataList.end(),
+      [](const DrawData& a, const DrawData& b) { return a.group < b.group; });
+  }
+
+  size_t rangeEnd = 0; // 直前の範囲の終端(バイトオフセット).
+  for (const auto& e : drawDataList) {
+    if (!batches.empty() && batches.back().texture == e.texture) {
+      if (e.offset == rangeEnd) {
+        rangeCounts.back() += static_cast<GLsizei>(e.count);
+      } else {
+        rangeCounts.push_back(static_cast<GLsizei>(e.count));
+        rangeOffsets.push_back(reinterpret_cast<GLvoid*>(e.offset));
+        rangeBaseVertices.push_back(baseVertex);
+        ++batches.back().rangeCount;
+      }
+    } else {
+      batches.push_back({ rangeCounts.size(), 1, e.texture });
+      rangeCounts.push_back(static_cast<GLsizei>(e.count));
+      rangeOffsets.push_back(reinterpret_cast<GLvoid*>(e.offset));
+      rangeBaseVertices.push_back(baseVertex);
+    }
+    rangeEnd = e.offset + e.count * sizeof(GLushort);
+  }
 }
\ No newline at end of file
@@ -4,22 +4,23 @@
 #ifndef SPRITE_H_INCLUDED
 #define SPRITE_H_INCLUDED
 #include "BufferObject.h"
+#include "RingBuffer.h"
 #include "Texture.h"
 #include "Shader.h"
 #include <glm/glm.hpp>
 #include <vector>
 
 /**
-* `\.
+* 矩形構造体.
 */
 struct Rect
 {
-  glm::vec2 origin; ///< _.
-  glm::vec2 size; ///< c̕.
+  glm::vec2 origin; ///< 左下原点.
+  glm::vec2 size; ///< 縦横の幅.
 };
 
 /**
-* XvCgNX.
+* スプライトクラス.
 */
 class Sprite
 {
@@ -54,7 +55,13 @@ private:
 };
 
 /**
-* XvCg`NX.
+* スプライト描画クラス.
+*
+* 同じテクスチャのスプライトが連続していれば、まとめて1回で描画する.
+* SortByTexture(true)を指定すると、テクスチャごとにスプライトをまとめてから描画する.
+* その場合、テクスチャの異なるスプライトどうしの描画順は追加順と一致しなくなる.
+*
+* 頂点データはBeginUpdate()でマップしたVBOの区画に直接書き込むので、フレームごとのメモリ確保とコピーは発生しない.
 */
 class SpriteRenderer
 {
@@ -70,26 +77,49 @@ public:
   void EndUpdate();
   void Draw(const glm::vec2&) const;
   void ClearDrawData();
+  void SortByTexture(bool enable) { sortByTexture = enable; }
+  bool SortByTexture() const { return sortByTexture; }
+  size_t DrawCount() const { return batches.size(); }
 
 private:
-  BufferObject vbo;
+  RingBuffer vbo;
   BufferObject ibo;
   VertexArrayObject vao;
   Shader::ProgramPtr program;
 
   struct Vertex {
-    glm::vec3 position; ///< W
-    glm::vec4 color; ///< F
-    glm::vec2 texCoord; ///< eNX`W
+    glm::vec3 position; ///< 座標
+    glm::vec4 color; ///< 色
+    glm::vec2 texCoord; ///< テクスチャ座標
   };
-  std::vector<Vertex> vertices;
+  Vertex* mappedVertices = nullptr; ///< 頂点データの書き込み先(マップしたVBOの区画).
+  size_t vertexCount = 0;    ///< 書き込んだ頂点の数.
+  size_t maxVertexCount = 0; ///< 書き込める頂点の数.
+  GLint baseVertex = 0; ///< 今回の頂点データを書き込んだ位置(頂点単位).
 
+  // 同じテクスチャが連続するスプライトの範囲.
   struct DrawData {
     size_t count;
     size_t offset;
     Texture::Image2DPtr texture;
+    size_t group; ///< テクスチャが最初に現れた順番. 並べ替えに使う.
   };
   std::vector<DrawData> drawDataList;
+
+  // テクスチャごとの描画命令. 範囲が複数あればglMultiDrawElementsBaseVertexでまとめて描画する.
+  struct DrawBatch {
+    size_t firstRange;
+    size_t rangeCount;
+    Texture::Image2DPtr texture;
+  };
+  std::vector<DrawBatch> batches;
+  std::vector<GLsizei> rangeCounts;
+  std::vector<GLvoid*> rangeOffsets;
+  std::vector<GLint> rangeBaseVertices;
+  std::vector<const Texture::Image2D*> textureOrder;
+  bool sortByTexture = false;
+
+  void BuildDrawBatches();
 };
 
 #endif // SPRITE_H_INCLUDED
\ No newline at end of file
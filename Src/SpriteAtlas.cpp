@@ -0,0 +1,222 @@
+/**
+* @file SpriteAtlas.cpp
+*/
+#define NOMINMAX
+#include "SpriteAtlas.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+
+/**
+* アトラスを初期化する.
+*
+* @param pageSize ページの幅と高さ(ピクセル数).
+* @param padding  画像の周囲につける余白(ピクセル数).
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool SpriteAtlas::Init(GLsizei pageSize, GLsizei padding)
+{
+  Destroy();
+  if (pageSize <= 0 || padding < 0 || padding * 2 >= pageSize) {
+    std::cerr << "[エラー]" << __func__ << ": ページサイズ(" << pageSize << ")または余白(" << padding <<
+      ")が不正です.\n";
+    return false;
+  }
+  this->pageSize = pageSize;
+  this->padding = padding;
+  return true;
+}
+
+/**
+* アトラスを破棄する.
+*
+* 作成済みのスプライトが使っているページは、スプライトが破棄されるまで残る.
+*/
+void SpriteAtlas::Destroy()
+{
+  pages.clear();
+  entries.clear();
+}
+
+/**
+* 画像ファイルを読み込んでアトラスに追加する.
+*
+* @param path 画像ファイル名. Get()で画像を指定するときの名前になる.
+*
+* @retval true  追加成功、または追加済み.
+* @retval false 追加失敗.
+*/
+bool SpriteAtlas::Add(const char* path)
+{
+  if (entries.count(path)) {
+    return true;
+  }
+  Texture::ImageData image;
+  if (!Texture::LoadImage2D(path, image)) {
+    std::cerr << "[エラー]" << __func__ << ": " << path << "を読み込めません.\n";
+    return false;
+  }
+  return Add(path, image);
+}
+
+/**
+* 画像をアトラスに追加する.
+*
+* @param name  画像の名前. Get()で画像を指定するときに使う.
+* @param image 追加する画像.
+*
+* @retval true  追加成功、または追加済み.
+* @retval false 追加失敗.
+*/
+bool SpriteAtlas::Add(const char* name, const Texture::ImageData& image)
+{
+  if (entries.count(name)) {
+    return true;
+  }
+  const GLsizei width = image.width + padding * 2;
+  const GLsizei height = image.height + padding * 2;
+  if (image.width <= 0 || image.height <= 0 || width > pageSize || height > pageSize) {
+    std::cerr << "[警告]" << __func__ << ": " << name << "(" << image.width << "x" << image.height <<
+      ")はページ(" << pageSize << "x" << pageSize << ")に入りません.\n";
+    return false;
+  }
+
+  // 入るページを探し、なければ新しいページを作る.
+  GLint x = 0;
+  GLint y = 0;
+  size_t pageNo = 0;
+  for (; pageNo < pages.size(); ++pageNo) {
+    if (Pack(pages[pageNo], width, height, x, y)) {
+      break;
+    }
+  }
+  if (pageNo >= pages.size()) {
+    Page page;
+    const std::string pageName = "SpriteAtlas#" + std::to_string(pages.size());
+    page.texture = Texture::Image2D::Create(pageName.c_str(), pageSize, pageSize, nullptr, GL_RGBA, GL_UNSIGNED_BYTE);
+    if (page.texture->IsNull()) {
+      std::cerr << "[エラー]" << __func__ << ": ページを作成できません.\n";
+      return false;
+    }
+    page.skyline.push_back({ 0, 0, pageSize });
+    pages.push_back(page);
+    Pack(pages.back(), width, height, x, y);
+  }
+
+  // 余白には端のピクセルを引き伸ばして、RGBA8に変換する.
+  std::vector<uint8_t> pixels(width * height * 4);
+  uint8_t* p = pixels.data();
+  for (GLint py = 0; py < height; ++py) {
+    for (GLint px = 0; px < width; ++px) {
+      glm::vec4 c = image.GetColor(px - padding, py - padding);
+      if (image.format == GL_RED) {
+        c = glm::vec4(c.r, c.r, c.r, 1); // 通常のテクスチャと同じく、赤を灰色として扱う.
+      }
+      for (int i = 0; i < 4; ++i) {
+        *(p++) = static_cast<uint8_t>(glm::clamp(c[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+      }
+    }
+  }
+  const Page& page = pages[pageNo];
+  GLState::BindTexture(0, GL_TEXTURE_2D, page.texture->Id());
+  glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+
+  const Rect rect = { glm::vec2(x + padding, y + padding), glm::vec2(image.width, image.height) };
+  entries.emplace(name, Entry{ pageNo, rect });
+  return true;
+}
+
+/**
+* アトラスの画像をスプライトに設定する.
+*
+* @param name   画像の名前.
+* @param sprite 設定するスプライト. テクスチャと矩形だけを変更する.
+*
+* @retval true  設定成功.
+* @retval false 画像が見つからない.
+*/
+bool SpriteAtlas::Get(const char* name, Sprite& sprite) const
+{
+  const auto itr = entries.find(name);
+  if (itr == entries.end()) {
+    return false;
+  }
+  sprite.Texture(pages[itr->second.page].texture);
+  sprite.Rectangle(itr->second.rect);
+  return true;
+}
+
+/**
+* ページに領域を確保する.
+*
+* @param page   領域を確保するページ.
+* @param width  確保する幅.
+* @param height 確保する高さ.
+* @param x      確保した領域の左下X座標を格納する変数.
+* @param y      確保した領域の左下Y座標を格納する変数.
+*
+* @retval true  確保成功.
+* @retval false ページに空きがない.
+*
+* スカイラインの各区間の左端に置いた場合を調べ、最も低い位置(同じなら最も左)を選ぶ.
+*/
+bool SpriteAtlas::Pack(Page& page, GLsizei width, GLsizei height, GLint& x, GLint& y)
+{
+  std::vector<SkylineNode>& skyline = page.skyline;
+  size_t bestIndex = skyline.size();
+  GLint bestY = pageSize;
+  for (size_t i = 0; i < skyline.size(); ++i) {
+    const GLint left = skyline[i].x;
+    if (left + width > pageSize) {
+      break;
+    }
+    // 幅widthにかかる区間のうち、最も高い位置に置く.
+    GLint top = 0;
+    GLsizei remaining = width;
+    for (size_t j = i; remaining > 0 && j < skyline.size(); ++j) {
+      top = std::max(top, skyline[j].y);
+      remaining -= skyline[j].width;
+    }
+    if (top + height <= pageSize && top < bestY) {
+      bestIndex = i;
+      bestY = top;
+    }
+  }
+  if (bestIndex >= skyline.size()) {
+    return false;
+  }
+  x = skyline[bestIndex].x;
+  y = bestY;
+
+  // 確保した領域の上端を新しい区間として挿入し、重なった区間を削る.
+  skyline.insert(skyline.begin() + bestIndex, SkylineNode{ x, y + height, width });
+  const GLint right = x + width;
+  for (size_t i = bestIndex + 1; i < skyline.size();) {
+    SkylineNode& e = skyline[i];
+    if (e.x >= right) {
+      break;
+    }
+    const GLint overlap = std::min<GLint>(right - e.x, e.width);
+    e.x += overlap;
+    e.width -= overlap;
+    if (e.width <= 0) {
+      skyline.erase(skyline.begin() + i);
+    } else {
+      break;
+    }
+  }
+
+  // 同じ高さの隣り合う区間をまとめる.
+  for (size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+  return true;
+}
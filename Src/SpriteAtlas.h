@@ -0,0 +1,65 @@
+/**
+* @file SpriteAtlas.h
+*/
+#ifndef SPRITEATLAS_H_INCLUDED
+#define SPRITEATLAS_H_INCLUDED
+#include "Sprite.h"
+#include "Texture.h"
+#include <GL/glew.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+/**
+* スプライト用のテクスチャアトラス.
+*
+* 小さな画像を実行時に大きなテクスチャ(ページ)へ詰め込む.
+* 同じページの画像を使うスプライトはテクスチャが共通になるので、SpriteRendererは1回の描画命令でまとめて描画できる.
+*
+* 詰め込みにはスカイライン法を使う. ページに入らなくなったら新しいページを作る.
+* 線形補間で隣の画像が混ざらないように、画像の周囲には端のピクセルを引き伸ばした余白をつける.
+*/
+class SpriteAtlas
+{
+public:
+  SpriteAtlas() = default;
+  ~SpriteAtlas() = default;
+  SpriteAtlas(const SpriteAtlas&) = delete;
+  SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+  bool Init(GLsizei pageSize = 1024, GLsizei padding = 1);
+  void Destroy();
+  bool Add(const char* path);
+  bool Add(const char* name, const Texture::ImageData& image);
+  bool Get(const char* name, Sprite& sprite) const;
+  size_t PageCount() const { return pages.size(); }
+
+private:
+  // スカイラインの区間. 区間[x, x+width)では、y未満の領域が使用済み.
+  struct SkylineNode {
+    GLint x;
+    GLint y;
+    GLsizei width;
+  };
+
+  // ページ.
+  struct Page {
+    Texture::Image2DPtr texture;
+    std::vector<SkylineNode> skyline;
+  };
+
+  // ページに詰め込んだ画像.
+  struct Entry {
+    size_t page;
+    Rect rect;
+  };
+
+  bool Pack(Page& page, GLsizei width, GLsizei height, GLint& x, GLint& y);
+
+  GLsizei pageSize = 1024;
+  GLsizei padding = 1;
+  std::vector<Page> pages;
+  std::unordered_map<std::string, Entry> entries;
+};
+
+#endif // SPRITEATLAS_H_INCLUDED
@@ -3,22 +3,24 @@
 */
 #include "Terrain.h"
 #include "Texture.h"
+#include "PixelConvert.h"
+#include "MeshOptimizer.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>
 
-/// n`ɊւNXi[閼O.
+/// 地形に関するクラス等を格納する名前空間.
 namespace Terrain {
 
 /**
-* 摜t@Cn`f[^ǂݍ.
+* 画像ファイルから地形データを読み込む.
 *
-* @param path      摜t@C.
-* @param scale     Ɋ|W.
-* @param baseLevel 0Ƃ݂Ȃl(ʏ0.0`1.0).
+* @param path      画像ファイル名.
+* @param scale     高さに掛ける係数.
+* @param baseLevel 高さ0とみなす値(通常0.0～1.0).
 *
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
 */
 bool HeightMap::Load(const char* path, float scale, float baseLevel)
 {
@@ -30,30 +32,54 @@ bool HeightMap::Load(const char* path, float scale, float baseLevel)
   name = path;
   size = glm::ivec2(imageData.width, imageData.height);
 
-  // 摜͉ɌĊi[Ă̂ŁA㉺]Ȃ獂f[^ɕϊ.
-  heights.resize(imageData.data.size());
-  for (int y = 0; y < size.y; ++y) {
-    for (int x = 0; x < size.x; ++x) {
-      const glm::vec4 color = imageData.GetColor(x, y);
-      heights[(size.y - y - 1) * size.x + x] = (color.r - baseLevel) * scale;
+  // 画像は下から上に向かって格納されているので、上下反転しながら高さデータに変換.
+  // 赤要素(グレースケールの場合は輝度)を高さとして使う.
+  heights.resize(size.x * size.y);
+  const float bias = -baseLevel * scale;
+  if (imageData.type == GL_UNSIGNED_SHORT && imageData.format == GL_RED) {
+    const uint16_t* src = reinterpret_cast<const uint16_t*>(imageData.data.data());
+    for (int y = 0; y < size.y; ++y) {
+      Texture::ConvertToFloat(src + y * size.x, &heights[(size.y - y - 1) * size.x], size.x, scale / 65535.0f, bias);
+    }
+  } else if (imageData.type == GL_UNSIGNED_BYTE) {
+    size_t pixelBytes = 1;
+    size_t redOffset = 0;
+    if (imageData.format == GL_BGRA) {
+      pixelBytes = 4;
+      redOffset = 2;
+    } else if (imageData.format == GL_BGR) {
+      pixelBytes = 3;
+      redOffset = 2;
+    }
+    const uint8_t* src = imageData.data.data() + redOffset;
+    for (int y = 0; y < size.y; ++y) {
+      Texture::ConvertToFloat(src + y * size.x * pixelBytes, pixelBytes, &heights[(size.y - y - 1) * size.x],
+        size.x, scale / 255.0f, bias);
+    }
+  } else {
+    for (int y = 0; y < size.y; ++y) {
+      for (int x = 0; x < size.x; ++x) {
+        const glm::vec4 color = imageData.GetColor(x, y);
+        heights[(size.y - y - 1) * size.x + x] = (color.r - baseLevel) * scale;
+      }
     }
   }
   return true;
 }
 
 /**
-* }bv烁bV쐬.
+* 高さマップからメッシュを作成する.
 *
-* @param meshBuffer bV쐬ƂȂ郁bVobt@.
-* @param meshName   쐬郁bV̖O.
-* @param texName    bVɓ\teNX`t@C.
+* @param meshBuffer メッシュ作成先となるメッシュバッファ.
+* @param meshName   作成するメッシュの名前.
+* @param texName    メッシュに貼り付けるテクスチャファイル名.
 *
-* @retval true  bV̍쐬ɐ.
-* @retval false bV쐬łȂ.
+* @retval true  メッシュの作成に成功.
+* @retval false メッシュを作成できなかった.
 *
-* Op`͈ȉ̌`ɂȂ.
+* 三角形は以下の形になる.
 *   +--+
-*   |^|
+*   |／|
 *   +--+
 */
 bool HeightMap::CreateMesh(Mesh::Buffer& meshBuffer, const char* meshName, const char* texName) const
@@ -62,23 +88,22 @@ bool HeightMap::CreateMesh(Mesh::Buffer& meshBuffer, const char* meshName, const
     return false;
   }
 
-  // _f[^쐬.
+  // 頂点データを作成.
   Mesh::Vertex v;
   v.color = glm::vec4(1);
   std::vector<Mesh::Vertex> vertices;
   vertices.reserve(size.x * size.y);
   for (int z = 0; z < size.y; ++z) {
     for (int x = 0; x < size.x; ++x) {
-      // eNX`W͏オvXȂ̂ŁAtɂKv.
+      // テクスチャ座標は上がプラスなので、向きを逆にする必要がある.
       v.position = glm::vec3(x, heights[z * size.x + x], z);
       v.texCoord = glm::vec2(x, (size.y - 1) - z) / (glm::vec2(size) - 1.0f);
       v.normal = CalcNormal(x, z);
       vertices.push_back(v);
     }
   }
-  const size_t vOffset = meshBuffer.AddVertexData(vertices.data(), vertices.size() * sizeof(Mesh::Vertex));
 
-  // CfbNXf[^쐬.
+  // インデックスデータを作成.
   std::vector<GLuint> indices;
   indices.reserve(size.x * size.y);
   for (int z = 0; z < size.y - 1; ++z) {
@@ -96,16 +121,21 @@ bool HeightMap::CreateMesh(Mesh::Buffer& meshBuffer, const char* meshName, const
       indices.push_back(a);
     }
   }
-  const size_t iOffset = meshBuffer.AddIndexData(indices.data(), indices.size() * sizeof(GLuint));
 
-  // _f[^ƃCfbNXf[^烁bV쐬.
+  // 頂点キャッシュと頂点フェッチを最適化.
+  // 地形は上から見下ろすことが多く、クラスタの向きによる並べ替えは効果が薄いのでオーバードロー最適化は行わない.
+  Mesh::PrintStatistics(meshName, Mesh::OptimizeMesh(vertices, indices, false));
+  const BufferRange vRange = meshBuffer.AddVertexData(vertices, Mesh::VertexFormat::Static);
+  const BufferRange iRange = meshBuffer.AddIndexData(indices.data(), indices.size() * sizeof(GLuint));
+
+  // 頂点データとインデックスデータからメッシュを作成.
   Texture::Image2DPtr texture;
   if (texName) {
-    texture = Texture::Image2D::Create(texName);
+    texture = Texture::Cache::Instance().Create(texName, true);
   } else {
-    texture = Texture::Image2D::Create(name.c_str());
+    texture = Texture::Cache::Instance().Create(name.c_str(), true);
   }
-  const Mesh::Primitive p = meshBuffer.CreatePrimitive(indices.size(), GL_UNSIGNED_INT, iOffset, vOffset);
+  const Mesh::Primitive p = meshBuffer.CreatePrimitive(indices.size(), GL_UNSIGNED_INT, iRange, vRange, Mesh::VertexFormat::Static);
   const Mesh::Material m = meshBuffer.CreateMaterial(glm::vec4(1), texture);
   meshBuffer.AddMesh(meshName, p, m);
 
@@ -113,35 +143,35 @@ bool HeightMap::CreateMesh(Mesh::Buffer& meshBuffer, const char* meshName, const
 }
 
 /**
-* 擾.
+* 高さを取得する.
 *
-* @param pos 擾W.
+* @param pos 高さを取得する座標.
 *
-* @return pos̈ʒu̍.
+* @return posの位置の高さ.
 *
-* nCg}bvXZʂɑΉA_(0, 0)vXɒ`.
+* ハイトマップはXZ平面に対応し、原点(0, 0)からプラス方向に定義される.
 */
 float HeightMap::Height(const glm::vec3& pos) const
 {
-  // W}bv͈͓̔Ɏ܂悤ɐ؂グA܂͐؂̂Ă.
+  // 座標が高さマップの範囲内に収まるように切り上げ、または切り捨てる.
   const glm::vec2 fpos = glm::clamp(glm::vec2(pos.x, pos.z), glm::vec2(0.0f), glm::vec2(size) - glm::vec2(1));
 
-  // E[Ɖ[1͍WƂĎgȂ̂size-2ɐ.
-  // Wpos(x,y), (x+1,y), (x,Y+1), (x+1,y+1)4_̂Ȃ`̓ɑ݂.
+  // 右端と下端の1列は左上座標として使えないのでsize-2に制限.
+  // 座標posは(x,y), (x+1,y), (x,Y+1), (x+1,y+1)の4点のなす正方形の内側に存在する.
   const glm::ivec2 index = glm::min(glm::ivec2(fpos), size - glm::ivec2(2));
 
-  // CfbNXW̑΍WvZ.
+  // インデックス座標からの相対座標を計算.
   const glm::vec2 offset = fpos - glm::vec2(index);
 
-  // n`4_Ȃ鐳`łA`͉L̂悤2̎Op`ƂĒ`.
+  // 地形は4頂点からなる正方形であり、正方形は下記のように2つの三角形として定義される.
   //     -Y
   //    +--+
-  // -X |^| +X
+  // -X |／| +X
   //    +--+
   //     +Y
-  // -YAO+YŁA1x1̐`ł邱ƂA
-  // ΍WuX + Y < 0vȂ΁A΍W͍̎Op`̈ɑ݂.
-  // łȂ΁A΍W͉E̎Op`̈ɑ݂.
+  // 奥が-Y方向、手前が+Y方向で、1x1の正方形であることから、
+  // 相対座標が「X + Y < 0」ならば、相対座標は左上の三角形領域に存在する.
+  // そうでなければ、相対座標は右下の三角形領域に存在する.
   if (offset.x + offset.y < 1) {
     const float h0 = heights[index.y * size.x       + index.x];
     const float h1 = heights[index.y * size.x       + (index.x + 1)];
@@ -156,24 +186,24 @@ float HeightMap::Height(const glm::vec3& pos) const
 }
 
 /**
-* 񂩂@vZ.
+* 高さ情報から法線を計算する.
 *
-* @param centerX vZΏۂXW.
-* @param centerY vZΏۂYW.
+* @param centerX 計算対象のX座標.
+* @param centerY 計算対象のY座標.
 *
-* @return (centerX, centerY)̈ʒu̖@.
+* @return (centerX, centerY)の位置の法線.
 */
 glm::vec3 HeightMap::CalcNormal(int centerX, int centerZ) const
 {
-  // bV͈ȉ̂悤Ȍ`Ȃ̂ŁAΏے_𒆐SƂZp`̊e_@ɉe.
-  // Ώے_}bv̒[ɂꍇA}bvO̒_͖.
+  // メッシュは以下のような形状なので、対象頂点を中心とする六角形の各頂点が法線に影響する.
+  // 対象頂点がマップの端にある場合、マップ外の頂点は無視する.
   //
   //     +----( 0,-1)-( 1,-1)
-  //     |    ^ |    ^ |
-  //     | ^    | ^    |
+  //     |    ／ |    ／ |
+  //     | ／    | ／    |
   //  (-1, 0)----+----( 1, 0)
-  //     |    ^ |    ^ |
-  //     | ^    | ^    |
+  //     |    ／ |    ／ |
+  //     | ／    | ／    |
   //  (-1, 1)-( 0, 1)----+
   //
 
@@ -11,7 +11,7 @@
 namespace Terrain {
 
 /**
-* }bv.
+* 高さマップ.
 */
 class HeightMap {
 public:
@@ -25,9 +25,9 @@ public:
   const std::string& Name() const { return name; }
 
 private:
-  std::string name; ///< ɂȂ摜t@C.
-  glm::ivec2 size = glm::ivec2(0); ///< nCg}bv̑傫.
-  std::vector<float> heights; ///< f[^.
+  std::string name; ///< 元になった画像ファイル名.
+  glm::ivec2 size = glm::ivec2(0); ///< ハイトマップの大きさ.
+  std::vector<float> heights; ///< 高さデータ.
 
   glm::vec3 CalcNormal(int x, int z) const;
 };
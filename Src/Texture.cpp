@@ -3,30 +3,36 @@
 */
 #define NOMINMAX
 #include "Texture.h"
+#include "TextureCooker.h"
+#include "TextureStreamer.h"
+#include "GLState.h"
+#include "MappedFile.h"
 #include "d3dx12.h"
 #include <cstdint>
 #include <vector>
-#include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
 #include <stdint.h>
 #include <Windows.h>
 
-/// eNX`֘Å֐NXi[閼O.
+/// テクスチャ関連の関数やクラスを格納する名前空間.
 namespace Texture {
 /**
-* FOURCC쐬.
+* FOURCCを作成する.
 */
 #define MAKE_FOURCC(a, b, c, d) static_cast<uint32_t>(a + (b << 8) + (c << 16) + (d << 24))
 
 /**
-* oCg񂩂琔l𕜌.
+* バイト列から数値を復元する.
 *
-* @param p      oCgւ̃|C^.
-* @param offset l̃ItZbg.
-* @param size   l̃oCg(1`4).
+* @param p      バイト列へのポインタ.
+* @param offset 数値のオフセット.
+* @param size   数値のバイト数(1～4).
 *
-* @return l.
+* @return 復元した数値.
 */
 uint32_t Get(const uint8_t* p, size_t offset, size_t size)
 {
@@ -39,26 +45,26 @@ uint32_t Get(const uint8_t* p, size_t offset, size_t size)
 }
 
 /**
-* DDS摜.
+* DDS画像情報.
 */
 struct DDSPixelFormat
 {
-  uint32_t size; ///< ̍\̂̃oCg(32).
-  uint32_t flgas; ///< 摜Ɋ܂܂f[^̎ނtO.
-  uint32_t fourCC; ///< 摜tH[}bgFOURCC.
-  uint32_t rgbBitCount; ///< 1sNZ̃rbg.
-  uint32_t redBitMask; ///< ԗvfgrbg.
-  uint32_t greenBitMask; ///< Ηvfgrbg.
-  uint32_t blueBitMask; ///< vfgrbg.
-  uint32_t alphaBitMask; ///< vfgrbg.
+  uint32_t size; ///< この構造体のバイト数(32).
+  uint32_t flgas; ///< 画像に含まれるデータの種類を示すフラグ.
+  uint32_t fourCC; ///< 画像フォーマットを示すFOURCC.
+  uint32_t rgbBitCount; ///< 1ピクセルのビット数.
+  uint32_t redBitMask; ///< 赤要素が使う部分を示すビット.
+  uint32_t greenBitMask; ///< 緑要素が使う部分を示すビット.
+  uint32_t blueBitMask; ///< 青要素が使う部分を示すビット.
+  uint32_t alphaBitMask; ///< 透明要素が使う部分を示すビット.
 };
 
 /**
-* obt@DDS摜ǂݏo.
+* バッファからDDS画像情報を読み出す.
 *
-* @param buf ǂݏoobt@.
+* @param buf 読み出し元バッファ.
 *
-* @return ǂݏoDDS摜.
+* @return 読み出したDDS画像情報.
 */
 DDSPixelFormat ReadDDSPixelFormat(const uint8_t* buf)
 {
@@ -75,29 +81,29 @@ DDSPixelFormat ReadDDSPixelFormat(const uint8_t* buf)
 }
 
 /**
-* DDSt@Cwb_.
+* DDSファイルヘッダ.
 */
 struct DDSHeader
 {
-  uint32_t size;  ///< ̍\̂̃oCg(124).
-  uint32_t flags; ///< ǂ̃p[^LtO.
-  uint32_t height; ///< 摜̍(sNZ).
-  uint32_t width; ///< 摜̕(sNZ).
-  uint32_t pitchOrLinearSize; ///< ̃oCg܂͉摜1̃oCg.
-  uint32_t depth; ///< 摜̉s()(3eNX`Ŏgp).
-  uint32_t mipMapCount; ///< ܂܂Ă~bv}bvx.
-  uint32_t reserved1[11]; ///< (̂߂ɗ\񂳂Ă).
-  DDSPixelFormat ddspf; ///< DDS摜.
-  uint32_t caps[4]; ///< ܂܂Ă摜̎.
-  uint32_t reserved2; ///< (̂߂ɗ\񂳂Ă).
+  uint32_t size;  ///< この構造体のバイト数(124).
+  uint32_t flags; ///< どのパラメータが有効かを示すフラグ.
+  uint32_t height; ///< 画像の高さ(ピクセル数).
+  uint32_t width; ///< 画像の幅(ピクセル数).
+  uint32_t pitchOrLinearSize; ///< 横のバイト数または画像1枚のバイト数.
+  uint32_t depth; ///< 画像の奥行き(枚数)(3次元テクスチャ等で使用).
+  uint32_t mipMapCount; ///< 含まれているミップマップレベル数.
+  uint32_t reserved1[11]; ///< (将来のために予約されている).
+  DDSPixelFormat ddspf; ///< DDS画像情報.
+  uint32_t caps[4]; ///< 含まれている画像の種類.
+  uint32_t reserved2; ///< (将来のために予約されている).
 };
 
 /**
-* obt@DDSt@Cwb_ǂݏo.
+* バッファからDDSファイルヘッダを読み出す.
 *
-* @param buf ǂݏoobt@.
+* @param buf 読み出し元バッファ.
 *
-* @return ǂݏoDDSt@Cwb_.
+* @return 読み出したDDSファイルヘッダ.
 */
 DDSHeader ReadDDSHeader(const uint8_t* buf)
 {
@@ -117,29 +123,26 @@ DDSHeader ReadDDSHeader(const uint8_t* buf)
 }
 
 /**
-* DDSt@Cwb_(DirectX10g).
+* DDSファイルヘッダ(DirectX10拡張).
 */
 struct DDSHeaderDX10
 {
-  uint32_t dxgiFormat; ///< 摜̎(DX10ȍ~ɒǉꂽ).
-  uint32_t resourceDimension; ///< (1D or 2D or 3D).
-  uint32_t miscFlag; ///< 摜z肷gtO.
-  uint32_t arraySize; ///< i[Ă̂eNX`z̏ꍇA̔zTCY.
-  uint32_t reserved; ///< (̂߂ɗ\񂳂Ă).
+  uint32_t dxgiFormat; ///< 画像の種類(DX10以降に追加された種類).
+  uint32_t resourceDimension; ///< 次元数(1D or 2D or 3D).
+  uint32_t miscFlag; ///< 画像が想定する使われ方を示すフラグ.
+  uint32_t arraySize; ///< 格納されているのがテクスチャ配列の場合、その配列サイズ.
+  uint32_t reserved; ///< (将来のために予約されている).
 };
 
 /**
-* obt@DDSt@Cwb_(DirectX10g)ǂݏo.
+* バッファからDDSファイルヘッダ(DirectX10拡張)を読み出す.
 *
-* @param buf ǂݏoobt@.
+* @param buf 読み出し元バッファ.
 *
-* @return ǂݏoDDSt@Cwb_(DirectX10g).
+* @return 読み出したDDSファイルヘッダ(DirectX10拡張).
 */
-DDSHeaderDX10 ReadDDSHeaderDX10(std::basic_ifstream<uint8_t>& ifs)
+DDSHeaderDX10 ReadDDSHeaderDX10(const uint8_t* buf)
 {
-  uint8_t buf[20];
-  ifs.read(buf, sizeof(buf));
-
   DDSHeaderDX10 tmp;
   tmp.dxgiFormat = Get(buf, 0, 4);
   tmp.resourceDimension = Get(buf, 4, 4);
@@ -150,63 +153,97 @@ DDSHeaderDX10 ReadDDSHeaderDX10(std::basic_ifstream<uint8_t>& ifs)
 }
 
 /**
-* DDSt@CeNX`쐬.
+* 画像ファイル内の画素データの配置.
+*
+* pixelsは通常ファイルの内容を直接指すので、ファイルをマップしている間だけ有効.
+* RLE圧縮されている場合はbufferに展開し、pixelsはbufferを指す.
+*/
+struct ImageView
+{
+  GLint width = 0;
+  GLint height = 0;
+  GLenum format = GL_NONE;
+  GLenum type = GL_NONE;
+  const uint8_t* pixels = nullptr; ///< ファイル内で最初に格納されている行の先頭.
+  size_t pixelBytes = 0;           ///< 1ピクセルのバイト数.
+  size_t rowBytes = 0;             ///< 次の行までのバイト数(パディングを含む).
+  bool isTopDown = false;          ///< true=上の行から格納されている. false=下の行から格納されている.
+  std::vector<uint8_t> buffer;     ///< RLE圧縮を展開した画素データ.
+};
+
+/**
+* DDSファイルの画素データの配置を調べる.
+*
+* @param filename DDSファイル名.
+* @param file     DDSファイルの内容.
+* @param fileSize DDSファイルのバイト数.
+* @param image    画素データの配置を格納する変数.
 *
-* @param filename DDSt@C.
-* @param st       DDSt@CXe[^X.
-* @param buf      t@Cǂݍ񂾃obt@.
-* @param header   DDSwb_i[ւ̃|C^.
+* @retval true  成功.
+* @retval false 未対応のDDSファイル.
 *
-* @retval 0ȊO 쐬eNX`ID.
-* @retval 0     쐬s.
+* OpenGLの関数は呼ばないので、どのスレッドから呼び出してもよい.
+* 画像データが途中で終わっている2Dテクスチャは、ファイルに収まるレベルまでを返す.
 */
-GLuint LoadDDS(const char* filename, std::basic_ifstream<uint8_t>& ifs, size_t fileSize)
+bool ParseDDS(const char* filename, const uint8_t* file, size_t fileSize, DDSImage& image)
 {
-  if (fileSize < 128) {
-    std::cerr << "WARNING: " << filename << "DDSt@Cł͂܂.\n";
-    return 0;
+  if (fileSize < 128 || Get(file, 0, 4) != MAKE_FOURCC('D', 'D', 'S', ' ')) {
+    std::cerr << "WARNING: " << filename << "はDDSファイルではありません.\n";
+    return false;
   }
-  uint8_t ddsHeader[128];
-  ifs.read(ddsHeader, sizeof(ddsHeader));
-  const DDSHeader header = ReadDDSHeader(ddsHeader + 4);
+  const DDSHeader header = ReadDDSHeader(file + 4);
   if (header.size != 124) {
-    std::cerr << "WARNING: " << filename << "DDSt@Cł͂܂.\n";
-    return 0;
+    std::cerr << "WARNING: " << filename << "はDDSファイルではありません.\n";
+    return false;
+  }
+  const GLsizei width = static_cast<GLsizei>(header.width);
+  const GLsizei height = static_cast<GLsizei>(header.height);
+  if (width <= 0 || height <= 0) {
+    std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+    return false;
   }
-  GLenum iformat;
-  GLenum format = GL_RGBA;
+  image.format = GL_RGBA;
   size_t imageOffset = 0;
   uint32_t blockSize = 16;
-  bool isCompressed = false;
+  image.isCompressed = false;
   if (header.ddspf.flgas & 0x04) {
     switch (header.ddspf.fourCC) {
     case MAKE_FOURCC('D', 'X', 'T', '1'):
-      iformat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+      image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
       blockSize = 8;
       break;
     case MAKE_FOURCC('D', 'X', 'T', '2'):
     case MAKE_FOURCC('D', 'X', 'T', '3'):
-      iformat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+      image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
       break;
     case MAKE_FOURCC('D', 'X', 'T', '4'):
     case MAKE_FOURCC('D', 'X', 'T', '5'):
-      iformat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
       break;
     case MAKE_FOURCC('B', 'C', '4', 'U'):
-      iformat = GL_COMPRESSED_RED_RGTC1;
+    case MAKE_FOURCC('A', 'T', 'I', '1'):
+      image.internalFormat = GL_COMPRESSED_RED_RGTC1;
+      blockSize = 8;
       break;
     case MAKE_FOURCC('B', 'C', '4', 'S'):
-      iformat = GL_COMPRESSED_SIGNED_RED_RGTC1;
+      image.internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1;
+      blockSize = 8;
       break;
     case MAKE_FOURCC('B', 'C', '5', 'U'):
-      iformat = GL_COMPRESSED_RG_RGTC2;
+    case MAKE_FOURCC('A', 'T', 'I', '2'):
+      image.internalFormat = GL_COMPRESSED_RG_RGTC2;
       break;
     case MAKE_FOURCC('B', 'C', '5', 'S'):
-      iformat = GL_COMPRESSED_SIGNED_RG_RGTC2;
+      image.internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2;
       break;
     case MAKE_FOURCC('D', 'X', '1', '0'):
     {
-      const DDSHeaderDX10 headerDX10 = ReadDDSHeaderDX10(ifs);
+      if (fileSize < 128 + 20) {
+        std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+        return false;
+      }
+      const DDSHeaderDX10 headerDX10 = ReadDDSHeaderDX10(file + 128);
+      GLenum& iformat = image.internalFormat;
       switch (headerDX10.dxgiFormat) {
       case DXGI_FORMAT_BC1_UNORM: iformat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; blockSize = 8; break;
       case DXGI_FORMAT_BC2_UNORM: iformat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
@@ -214,8 +251,8 @@ GLuint LoadDDS(const char* filename, std::basic_ifstream<uint8_t>& ifs, size_t f
       case DXGI_FORMAT_BC1_UNORM_SRGB: iformat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; blockSize = 8; break;
       case DXGI_FORMAT_BC2_UNORM_SRGB: iformat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT; break;
       case DXGI_FORMAT_BC3_UNORM_SRGB: iformat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; break;
-      case DXGI_FORMAT_BC4_UNORM: iformat = GL_COMPRESSED_RED_RGTC1; break;
-      case DXGI_FORMAT_BC4_SNORM: iformat = GL_COMPRESSED_SIGNED_RED_RGTC1; break;
+      case DXGI_FORMAT_BC4_UNORM: iformat = GL_COMPRESSED_RED_RGTC1; blockSize = 8; break;
+      case DXGI_FORMAT_BC4_SNORM: iformat = GL_COMPRESSED_SIGNED_RED_RGTC1; blockSize = 8; break;
       case DXGI_FORMAT_BC5_UNORM: iformat = GL_COMPRESSED_RG_RGTC2; break;
       case DXGI_FORMAT_BC5_SNORM: iformat = GL_COMPRESSED_SIGNED_RG_RGTC2; break;
       case DXGI_FORMAT_BC6H_UF16: iformat = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT; break;
@@ -223,310 +260,508 @@ GLuint LoadDDS(const char* filename, std::basic_ifstream<uint8_t>& ifs, size_t f
       case DXGI_FORMAT_BC7_UNORM: iformat = GL_COMPRESSED_RGBA_BPTC_UNORM; break;
       case DXGI_FORMAT_BC7_UNORM_SRGB: iformat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
       default:
-        std::cerr << "WARNING: " << filename << "͖ΉDDSt@Cł.\n";
-        return 0;
+        std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+        return false;
       }
-      imageOffset = 20; // DX10wb_̂ԂZ.
+      imageOffset = 20; // DX10ヘッダのぶんを加算.
       break;
     }
     default:
-      std::cerr << "WARNING: " << filename << "͖ΉDDSt@Cł.\n";
-      return 0;
+      std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+      return false;
     }
-    isCompressed = true;
+    image.isCompressed = true;
   } else if (header.ddspf.flgas & 0x40) {
     if (header.ddspf.redBitMask == 0xff) {
-      iformat = header.ddspf.alphaBitMask ? GL_RGBA8 : GL_RGB8;
-      format = header.ddspf.alphaBitMask ? GL_RGBA : GL_RGB;
+      image.internalFormat = header.ddspf.alphaBitMask ? GL_RGBA8 : GL_RGB8;
+      image.format = header.ddspf.alphaBitMask ? GL_RGBA : GL_RGB;
     } else if (header.ddspf.blueBitMask == 0xff) {
-      iformat = header.ddspf.alphaBitMask ? GL_RGBA8 : GL_RGB8;
-      format = header.ddspf.alphaBitMask ? GL_BGRA : GL_BGR;
+      image.internalFormat = header.ddspf.alphaBitMask ? GL_RGBA8 : GL_RGB8;
+      image.format = header.ddspf.alphaBitMask ? GL_BGRA : GL_BGR;
     } else {
-      std::cerr << "WARNING: " << filename << "͖ΉDDSt@Cł.\n";
-      return 0;
+      std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+      return false;
     }
   } else {
-    std::cerr << "WARNING: " << filename << "͖ΉDDSt@Cł.\n";
-    return 0;
+    std::cerr << "WARNING: " << filename << "は未対応のDDSファイルです.\n";
+    return false;
+  }
+
+  image.isCubemap = header.caps[1] & 0x200;
+  image.faceCount = image.isCubemap ? 6 : 1;
+  image.pixels = file + 128 + imageOffset;
+
+  // 各レベルの位置を計算する. 圧縮形式の行は4x4ブロック単位.
+  const uint32_t mipMapCount = std::max(header.mipMapCount, 1U);
+  image.levels.clear();
+  image.levels.reserve(mipMapCount);
+  image.faceBytes = 0;
+  GLsizei curWidth = width;
+  GLsizei curHeight = height;
+  for (uint32_t mipLevel = 0; mipLevel < mipMapCount; ++mipLevel) {
+    DDSLevel level;
+    level.width = curWidth;
+    level.height = curHeight;
+    level.offset = image.faceBytes;
+    if (image.isCompressed) {
+      level.rowBytes = ((curWidth + 3) / 4) * blockSize;
+      level.rowCount = (curHeight + 3) / 4;
+    } else {
+      level.rowBytes = curWidth * 4;
+      level.rowCount = curHeight;
+    }
+    image.faceBytes += level.rowBytes * level.rowCount;
+    image.levels.push_back(level);
+    curWidth = std::max(1, curWidth / 2);
+    curHeight = std::max(1, curHeight / 2);
+  }
+
+  const size_t available = fileSize - (128 + imageOffset);
+  if (image.faceBytes * image.faceCount > available) {
+    std::cerr << "WARNING: " << filename << "の画像データが不足しています.\n";
+    if (image.isCubemap) {
+      return false;
+    }
+    while (!image.levels.empty() && image.faceBytes > available) {
+      const DDSLevel& last = image.levels.back();
+      image.faceBytes -= last.rowBytes * last.rowCount;
+      image.levels.pop_back();
+    }
+    if (image.levels.empty()) {
+      return false;
+    }
   }
+  return true;
+}
 
-  const bool isCubemap = header.caps[1] & 0x200;
-  const GLenum target = isCubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : GL_TEXTURE_2D;
-  const int faceCount = isCubemap ? 6 : 1;
+/**
+* DDSファイルからテクスチャを作成する.
+*
+* @param filename DDSファイル名.
+* @param file     DDSファイルの内容.
+* @param fileSize DDSファイルのバイト数.
+*
+* @retval 0以外 作成したテクスチャID.
+* @retval 0     作成失敗.
+*
+* 画素データはファイルの内容から直接転送する.
+*/
+GLuint LoadDDS(const char* filename, const uint8_t* file, size_t fileSize)
+{
+  DDSImage image;
+  if (!ParseDDS(filename, file, fileSize, image)) {
+    return 0;
+  }
+  const GLenum target = image.isCubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : GL_TEXTURE_2D;
 
   GLuint texId;
   glGenTextures(1, &texId);
-  glBindTexture(isCubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texId);
-
-  std::vector<uint8_t> buf;
-  buf.resize(fileSize - (128 + imageOffset));
-  if (imageOffset) {
-    ifs.seekg(imageOffset, std::ios_base::cur);
-  }
-  ifs.read(buf.data(), buf.size());
-  const uint8_t* data = buf.data();
-  for (int faceIndex = 0; faceIndex < faceCount; ++faceIndex) {
-    GLsizei curWidth = header.width;
-    GLsizei curHeight = header.height;
-    for (int mipLevel = 0; mipLevel < static_cast<int>(header.mipMapCount); ++mipLevel) {
-      uint32_t imageSizeWithPadding;
-      if (isCompressed) {
-        imageSizeWithPadding = ((curWidth + 3) / 4) * ((curHeight + 3) / 4) * blockSize;
-      } else {
-        imageSizeWithPadding = curWidth * curHeight * 4;
-      }
-      if (isCompressed) {
-        glCompressedTexImage2D(target + faceIndex, mipLevel, iformat, curWidth, curHeight, 0, imageSizeWithPadding, data);
+  GLState::BindTexture(0, image.isCubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, texId);
+
+  for (int faceIndex = 0; faceIndex < image.faceCount; ++faceIndex) {
+    const uint8_t* const face = image.pixels + image.faceBytes * faceIndex;
+    for (size_t mipLevel = 0; mipLevel < image.levels.size(); ++mipLevel) {
+      const DDSLevel& level = image.levels[mipLevel];
+      const uint8_t* const data = face + level.offset;
+      if (image.isCompressed) {
+        glCompressedTexImage2D(target + faceIndex, static_cast<GLint>(mipLevel), image.internalFormat,
+          level.width, level.height, 0, static_cast<GLsizei>(level.rowBytes * level.rowCount), data);
       } else {
-        glTexImage2D(target + faceIndex, mipLevel, iformat, curWidth, curHeight, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(target + faceIndex, static_cast<GLint>(mipLevel), image.internalFormat,
+          level.width, level.height, 0, image.format, GL_UNSIGNED_BYTE, data);
       }
       const GLenum result = glGetError();
       switch (result) {
       case GL_NO_ERROR:
         break;
       case GL_INVALID_OPERATION:
-        std::cerr << "WARNING: " << filename << "̓ǂݍ݂Ɏs.\n";
+        std::cerr << "WARNING: " << filename << "の読み込みに失敗.\n";
         break;
       default:
-        std::cerr << "WARNING: " << filename << "̓ǂݍ݂Ɏs(" << std::hex << result << ").\n";
+        std::cerr << "WARNING: " << filename << "の読み込みに失敗(" << std::hex << result << ").\n";
         break;
       }
-      curWidth = std::max(1, curWidth / 2);
-      curHeight = std::max(1, curHeight / 2);
-      data += imageSizeWithPadding;
     }
   }
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header.mipMapCount - 1);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.mipMapCount <= 1 ? GL_LINEAR : GL_LINEAR_MIPMAP_NEAREST);
+  const GLint maxLevel = static_cast<GLint>(image.levels.size()) - 1;
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, maxLevel <= 0 ? GL_LINEAR : GL_LINEAR_MIPMAP_NEAREST);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  GLState::BindTexture(0, image.isCubemap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, 0);
   return texId;
 }
 
 /**
-* BMPt@C2DeNX`쐬.
+* BMPファイルの画素データの配置を調べる.
 *
-* @param filename t@C.
+* @param filename ファイル名.
+* @param file     ファイルの内容.
+* @param fileSize ファイルのバイト数.
+* @param view     画素データの配置を格納する変数.
 *
-* @return 쐬ɐꍇ̓eNX`|C^Ԃ.
-*         sꍇnullptrԂ.
+* @retval true  成功.
+* @retval false 未対応のBMPファイル.
 */
-bool LoadBMP(const char* filename, std::basic_ifstream<uint8_t>& ifs, size_t fileSize, ImageData& imageData)
+bool ParseBMP(const char* filename, const uint8_t* file, size_t fileSize, ImageView& view)
 {
-  const size_t bmpFileHeaderSize = 14; // rbg}bvt@Cwb_̃oCg
-  const size_t windowsV1HeaderSize = 40; // rbg}bvwb_̃oCg.
+  const size_t bmpFileHeaderSize = 14; // ビットマップファイルヘッダのバイト数
+  const size_t windowsV1HeaderSize = 40; // ビットマップ情報ヘッダのバイト数.
   if (fileSize < bmpFileHeaderSize + windowsV1HeaderSize) {
-    return false; // BMPt@Cł͂Ȃ.
+    return false;
   }
-  uint8_t bmpHeader[bmpFileHeaderSize + windowsV1HeaderSize];
-  ifs.read(bmpHeader, sizeof(bmpHeader));
-
-  if (bmpHeader[0] != 'B' || bmpHeader[1] != 'M') {
-    return false; // BMPt@Cł͂Ȃ.
-  }
-  const size_t offsetBytes = Get(bmpHeader, 10, 4);
-  const uint32_t infoSize = Get(bmpHeader, 14, 4);
-  const uint32_t width = Get(bmpHeader, 18, 4);
-  const uint32_t height = Get(bmpHeader, 22, 4);
-  const uint32_t bitCount = Get(bmpHeader, 28, 2);
-  const uint32_t compression = Get(bmpHeader, 30, 4);
-  const size_t pixelBytes = bitCount / 8;
-  if (infoSize != windowsV1HeaderSize || compression) {
-    std::cerr << "WARNING: " << filename << "͖ΉBMPt@Cł.\n";
-    return false; // ΉBMPt@C.
+  const size_t offsetBytes = Get(file, 10, 4);
+  const uint32_t infoSize = Get(file, 14, 4);
+  const int32_t width = static_cast<int32_t>(Get(file, 18, 4));
+  const int32_t height = static_cast<int32_t>(Get(file, 22, 4));
+  const uint32_t bitCount = Get(file, 28, 2);
+  const uint32_t compression = Get(file, 30, 4);
+  if (infoSize != windowsV1HeaderSize || compression || width <= 0 || height == 0 ||
+    (bitCount != 8 && bitCount != 16 && bitCount != 24 && bitCount != 32)) {
+    std::cerr << "WARNING: " << filename << "は未対応のBMPファイルです.\n";
+    return false;
   }
 
-  const size_t imageSize = width * height * pixelBytes;
-  imageData.data.resize(imageSize);
-  ifs.read(imageData.data.data(), imageSize);
-
-  GLenum type = GL_UNSIGNED_BYTE;
-  GLenum format = GL_BGR;
+  view.width = width;
+  view.height = std::abs(height);
+  view.pixelBytes = bitCount / 8;
+  view.rowBytes = ((width * bitCount + 31) / 32) * 4; // 各行は4バイト境界に整列している.
+  view.isTopDown = height < 0;
+  view.type = GL_UNSIGNED_BYTE;
+  view.format = GL_BGR;
   if (bitCount == 8) {
-    format = GL_RED;
+    view.format = GL_RED;
   } else if (bitCount == 16) {
-    type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+    view.format = GL_BGRA;
+    view.type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+  } else if (bitCount == 32) {
+    view.format = GL_BGRA;
   }
-  imageData.name = filename;
-  imageData.width = width;
-  imageData.height = height;
-  imageData.format = format;
-  imageData.type = type;
+  if (offsetBytes + view.rowBytes * view.height > fileSize) {
+    std::cerr << "WARNING: " << filename << "の画像データが不足しています.\n";
+    return false;
+  }
+  view.pixels = file + offsetBytes;
   return true;
 }
 
 /**
-* TGAt@C2DeNX`쐬.
+* RLE圧縮されたTGAの画素データを展開する.
+*
+* @param src        圧縮データの先頭.
+* @param srcSize    圧縮データのバイト数.
+* @param pixelBytes 1ピクセルのバイト数.
+* @param dst        展開先. 画像全体の大きさが確保されていること.
+* @param dstSize    展開先のバイト数.
 *
-* @param filename t@C.
+* @retval true  展開成功.
+* @retval false 圧縮データが不足している.
 *
-* @return 쐬ɐꍇ̓eNX`|C^Ԃ.
-*         sꍇnullptrԂ.
+* パケットは行をまたいでもよいので、画像全体を1本の画素列として展開する.
 */
-bool LoadTGA(const char* path, std::basic_ifstream<uint8_t>& ifs, size_t fileSize, ImageData& imageData)
+bool DecodeTGARLE(const uint8_t* src, size_t srcSize, size_t pixelBytes, uint8_t* dst, size_t dstSize)
 {
-  // TGAwb_ǂݍ.
-  uint8_t tgaHeader[18];
-  ifs.read(tgaHeader, 18);
+  const uint8_t* const srcEnd = src + srcSize;
+  uint8_t* const dstEnd = dst + dstSize;
+  while (dst < dstEnd) {
+    if (src >= srcEnd) {
+      return false;
+    }
+    const uint8_t header = *src++;
+    const size_t count = (header & 0x7f) + 1;
+    const size_t bytes = std::min(count * pixelBytes, static_cast<size_t>(dstEnd - dst));
+    if (header & 0x80) {
+      // 同じピクセルの繰り返し.
+      if (static_cast<size_t>(srcEnd - src) < pixelBytes) {
+        return false;
+      }
+      if (pixelBytes == 1) {
+        std::memset(dst, *src, bytes);
+      } else {
+        for (size_t i = 0; i < bytes; i += pixelBytes) {
+          std::memcpy(dst + i, src, pixelBytes);
+        }
+      }
+      src += pixelBytes;
+    } else {
+      // 非圧縮のピクセル列.
+      if (static_cast<size_t>(srcEnd - src) < bytes) {
+        return false;
+      }
+      std::memcpy(dst, src, bytes);
+      src += count * pixelBytes;
+    }
+    dst += bytes;
+  }
+  return true;
+}
 
-  // C[WID΂.
-  ifs.ignore(tgaHeader[0]);
+/**
+* TGAファイルの画素データの配置を調べる.
+*
+* @param filename ファイル名.
+* @param file     ファイルの内容.
+* @param fileSize ファイルのバイト数.
+* @param view     画素データの配置を格納する変数.
+*
+* @retval true  成功.
+* @retval false 未対応のTGAファイル、またはTGAファイルではない.
+*
+* フルカラーとグレースケールに対応する. それぞれRLE圧縮されていてもよい.
+* 16ビットのグレースケール(アルファなし)は、ハイトマップ用にGL_UNSIGNED_SHORTとして扱う.
+*/
+bool ParseTGA(const char* filename, const uint8_t* file, size_t fileSize, ImageView& view)
+{
+  const size_t tgaHeaderSize = 18;
+  if (fileSize < tgaHeaderSize) {
+    return false;
+  }
+  const uint8_t* tgaHeader = file;
 
-  // J[}bv΂.
+  // イメージIDとカラーマップを飛ばす.
+  size_t offset = tgaHeaderSize + tgaHeader[0];
   if (tgaHeader[1]) {
     const int colorMapLength = tgaHeader[5] | (tgaHeader[6] << 8);
     const int colorMapEntrySize = tgaHeader[7];
-    const int colorMapSize = colorMapLength * colorMapEntrySize / 8;
-    ifs.ignore(colorMapSize);
+    offset += colorMapLength * colorMapEntrySize / 8;
   }
 
-  // 摜f[^ǂݍ.
+  const int imageType = tgaHeader[2] & 0x07; // 2=フルカラー, 3=グレースケール.
+  const bool isRLE = tgaHeader[2] & 0x08;
   const int width = tgaHeader[12] | (tgaHeader[13] << 8);
   const int height = tgaHeader[14] | (tgaHeader[15] << 8);
-  if (width <= 0 || height <= 0) {
-    return false; // ΉTGAt@CA܂TGAӂł͂Ȃ.
-  }
   const int pixelDepth = tgaHeader[16];
-  if (pixelDepth != 8 && pixelDepth != 16 && pixelDepth != 24 && pixelDepth != 32) {
-    return false; // ΉTGAt@CA܂TGAӂł͂Ȃ.
-  }
-  const int imageSize = width * height * pixelDepth / 8;
-  if (fileSize < imageSize + sizeof(tgaHeader)) {
-    return false; // ΉTGAt@CA܂TGAӂł͂Ȃ.
-  }
-  std::vector<uint8_t>buf(imageSize);
-  ifs.read(buf.data(), imageSize);
-
-  // 摜f[^uォ牺vŊi[ĂꍇA㉺ւ.
-  if (tgaHeader[17] & 0x20) {
-    std::cout << "]c";
-    const int lineSize = width * pixelDepth / 8;
-    std::vector<uint8_t> tmp(imageSize);
-    std::vector<uint8_t>::iterator source = buf.begin();
-    std::vector<uint8_t>::iterator destination = tmp.end();
-    for (int i = 0; i < height; ++i) {
-      destination -= lineSize;
-      std::copy(source, source + lineSize, destination);
-      source += lineSize;
+  const int alphaBits = tgaHeader[17] & 0x0f;
+  if ((imageType != 2 && imageType != 3) || width <= 0 || height <= 0 ||
+    (pixelDepth != 8 && pixelDepth != 16 && pixelDepth != 24 && pixelDepth != 32)) {
+    return false;
+  }
+  if (imageType == 3 && pixelDepth == 16 && alphaBits) {
+    std::cerr << "WARNING: " << filename << "はアルファ付きグレースケールのTGAファイルです(未対応).\n";
+    return false;
+  }
+  view.width = width;
+  view.height = height;
+  view.pixelBytes = pixelDepth / 8;
+  view.rowBytes = width * view.pixelBytes;
+  view.isTopDown = tgaHeader[17] & 0x20;
+  const size_t imageSize = view.rowBytes * height;
+  if (isRLE) {
+    if (offset > fileSize) {
+      return false;
+    }
+    view.buffer.resize(imageSize);
+    if (!DecodeTGARLE(file + offset, fileSize - offset, view.pixelBytes, view.buffer.data(), imageSize)) {
+      std::cerr << "WARNING: " << filename << "の圧縮データが不足しています.\n";
+      return false;
     }
-    buf.swap(tmp);
-  }
-
-  // ǂݍ񂾉摜f[^eNX`쐬.
-  GLenum type = GL_UNSIGNED_BYTE;
-  GLenum format = GL_BGRA;
-  if (tgaHeader[2] == 3) {
-    format = GL_RED;
-  }
-  if (tgaHeader[16] == 24) {
-    format = GL_BGR;
-  } else if (tgaHeader[16] == 16) {
-    type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
-  }
-  imageData.name = path;
-  imageData.width = width;
-  imageData.height = height;
-  imageData.type = type;
-  imageData.format = format;
-  imageData.data.swap(buf);
+    view.pixels = view.buffer.data();
+  } else {
+    if (offset + imageSize > fileSize) {
+      return false;
+    }
+    view.pixels = file + offset;
+  }
+
+  view.type = GL_UNSIGNED_BYTE;
+  view.format = GL_BGRA;
+  if (imageType == 3) {
+    view.format = GL_RED;
+    if (pixelDepth == 16) {
+      view.type = GL_UNSIGNED_SHORT;
+    }
+  } else if (pixelDepth == 24) {
+    view.format = GL_BGR;
+  } else if (pixelDepth == 16) {
+    view.type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+  }
   return true;
 }
 
 /**
-* t@C摜f[^ǂݍ.
+* ファイル形式を判定して画素データの配置を調べる.
 *
-* @param path      摜Ƃēǂݍރt@C̃pX.
-* @param imageData 摜f[^i[\.
+* @param filename ファイル名.
+* @param file     ファイルの内容.
+* @param fileSize ファイルのバイト数.
+* @param view     画素データの配置を格納する変数.
+* @param isDDS    DDSファイルだった場合にtrueを格納する変数.
+*                 DDSファイルの場合、viewは設定されない.
 *
-* @retval true  ǂݍݐ.
-* @retval false ǂݍݎs.
+* @retval true  成功.
+* @retval false 未対応のファイル.
+*
+* 先頭のシグネチャを一度だけ調べて、対応する解析関数を呼び出す.
+* TGAにはシグネチャがないので、BMPとDDSのどちらでもなければTGAとして扱う.
 */
-bool LoadImage2D(const char* path, ImageData& imageData)
+bool ParseImage(const char* filename, const uint8_t* file, size_t fileSize, ImageView& view, bool& isDDS)
 {
-  std::basic_ifstream<uint8_t> ifs;
-  ifs.open(path, std::ios_base::binary);
-  if (!ifs) {
-    std::cerr << "WARNING: " << path << "J܂.\n";
-    return 0;
+  isDDS = false;
+  if (fileSize >= 4 && Get(file, 0, 4) == MAKE_FOURCC('D', 'D', 'S', ' ')) {
+    isDDS = true;
+    return true;
+  }
+  if (fileSize >= 2 && file[0] == 'B' && file[1] == 'M') {
+    return ParseBMP(filename, file, fileSize, view);
   }
-  std::vector<uint8_t> tmp(1024 * 1024);
-  ifs.rdbuf()->pubsetbuf(tmp.data(), tmp.size());
+  return ParseTGA(filename, file, fileSize, view);
+}
 
-  ifs.seekg(0, std::ios_base::end);
-  const size_t size = static_cast<size_t>(ifs.tellg());
+/**
+* 画素データを下の行から順に並べて画像データにコピーする.
+*
+* @param view      コピーする画素データ.
+* @param imageData コピー先の画像データ.
+*
+* 上下の反転と行末のパディングの除去は、このコピーと同時に行う.
+* RLEを展開したデータで並べ替えが不要な場合は、コピーせずにバッファを移動する.
+*/
+void CopyImage(ImageView& view, ImageData& imageData)
+{
+  const size_t lineSize = view.width * view.pixelBytes;
+  imageData.width = view.width;
+  imageData.height = view.height;
+  imageData.format = view.format;
+  imageData.type = view.type;
+  if (!view.buffer.empty() && !view.isTopDown) {
+    imageData.data = std::move(view.buffer);
+    view.pixels = nullptr;
+    return;
+  }
+  imageData.data.resize(lineSize * view.height);
+  uint8_t* dst = imageData.data.data();
+  for (int y = 0; y < view.height; ++y) {
+    const int srcY = view.isTopDown ? view.height - 1 - y : y;
+    std::copy_n(view.pixels + view.rowBytes * srcY, lineSize, dst + lineSize * y);
+  }
+}
 
-  std::cout << "INFO: " << path << "ǂݍݒc";
+/**
+* 画素データからテクスチャを作成する.
+*
+* @param view 転送する画素データ.
+*
+* @retval 0以外 作成したテクスチャID.
+* @retval 0     作成失敗.
+*
+* 下の行から格納されていてパディングもなければ、ファイルの内容をそのまま転送する.
+* そうでなければ、転送時に1行ずつ並べ替える.
+*/
+GLuint UploadImage(const ImageView& view)
+{
+  const size_t lineSize = view.width * view.pixelBytes;
+  if (!view.isTopDown && view.rowBytes == lineSize) {
+    return CreateImage2D(view.width, view.height, view.pixels, view.format, view.type);
+  }
+  const GLuint id = CreateImage2D(view.width, view.height, nullptr, view.format, view.type);
+  if (!id) {
+    return 0;
+  }
+  GLState::BindTexture(0, GL_TEXTURE_2D, id);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (int y = 0; y < view.height; ++y) {
+    const int srcY = view.isTopDown ? view.height - 1 - y : y;
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, view.width, 1, view.format, view.type,
+      view.pixels + view.rowBytes * srcY);
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  return id;
+}
 
-  ifs.seekg(0, std::ios_base::beg);
-  if (LoadBMP(path, ifs, size, imageData)) {
-    std::cout << "\n";
-    return true;
+/**
+* ファイルから画像データを読み込む.
+*
+* @param path      画像として読み込むファイルのパス.
+* @param imageData 画像データを格納する構造体.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*
+* DDSファイルには対応していない.
+*/
+bool LoadImage2D(const char* path, ImageData& imageData)
+{
+  const MappedFile file(path);
+  if (file.IsNull()) {
+    std::cerr << "WARNING: " << path << "を開けません.\n";
+    return false;
   }
-  ifs.seekg(0, std::ios_base::beg);
-  if (LoadTGA(path, ifs, size, imageData)) {
-    std::cout << "\n";
+
+  std::cout << "INFO: " << path << "を読み込み中…";
+  ImageView view;
+  bool isDDS = false;
+  if (ParseImage(path, file.Data(), file.Size(), view, isDDS) && !isDDS) {
+    CopyImage(view, imageData);
+    imageData.name = path;
+    std::cout << "完了\n";
     return true;
   }
-  std::cout << "s\n";
+  std::cout << "失敗\n";
   return false;
 }
 
 /**
-* t@C2DeNX`ǂݍ.
+* ファイルから2Dテクスチャを読み込む.
 *
-* @param path 2DeNX`Ƃēǂݍރt@C̃pX.
+* @param path 2Dテクスチャとして読み込むファイルのパス.
 *
-* @retval 0ȊO  쐬eNX`EIuWFNgID.
-* @retval 0      eNX`̍쐬Ɏs.
+* @retval 0以外  作成したテクスチャ・オブジェクトのID.
+* @retval 0      テクスチャの作成に失敗.
 */
 GLuint LoadImage2D(const char* path)
 {
-  std::basic_ifstream<uint8_t> ifs;
-  ifs.open(path, std::ios_base::binary);
-  if (!ifs) {
-    std::cerr << "WARNING: " << path << "J܂.\n";
-    return 0;
+  // 変換済みのDDSファイルがあれば、そちらを優先する.
+  if (IsCookedImageAvailable(path)) {
+    const std::string cookedPath = CookedPath(path);
+    const MappedFile file(cookedPath.c_str());
+    if (!file.IsNull()) {
+      std::cout << "INFO: " << cookedPath << "を読み込み中…";
+      const GLuint texId = LoadDDS(cookedPath.c_str(), file.Data(), file.Size());
+      if (texId) {
+        // LoadDDS()は端をクランプするので、変換元を直接読み込んだ場合と同じく繰り返しに戻す.
+        GLState::BindTexture(0, GL_TEXTURE_2D, texId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+        std::cout << "完了\n";
+        return texId;
+      }
+      std::cout << "失敗\n";
+    }
   }
-  std::vector<uint8_t> tmp(1024 * 1024);
-  ifs.rdbuf()->pubsetbuf(tmp.data(), tmp.size());
-
-  ifs.seekg(0, std::ios_base::end);
-  const size_t size = static_cast<size_t>(ifs.tellg());
-
-  std::cout << "INFO: " << path << "ǂݍݒc";
 
-  ImageData imageData;
-  ifs.seekg(0, std::ios_base::beg);
-  if (LoadBMP(path, ifs, size, imageData)) {
-    std::cout << "\n";
-    return CreateImage2D(imageData.width, imageData.height, imageData.data.data(), imageData.format, imageData.type);
-  }
-  ifs.seekg(0, std::ios_base::beg);
-  if (LoadTGA(path, ifs, size, imageData)) {
-    std::cout << "\n";
-    return CreateImage2D(imageData.width, imageData.height, imageData.data.data(), imageData.format, imageData.type);
+  const MappedFile file(path);
+  if (file.IsNull()) {
+    std::cerr << "WARNING: " << path << "を開けません.\n";
+    return 0;
   }
-  ifs.seekg(0, std::ios_base::beg);
-  const GLuint texId = LoadDDS(path, ifs, size);
-  if (texId) {
-    std::cout << "\n";
-    return texId;
+
+  std::cout << "INFO: " << path << "を読み込み中…";
+  ImageView view;
+  bool isDDS = false;
+  if (ParseImage(path, file.Data(), file.Size(), view, isDDS)) {
+    const GLuint texId = isDDS ? LoadDDS(path, file.Data(), file.Size()) : UploadImage(view);
+    if (texId) {
+      std::cout << "完了\n";
+      return texId;
+    }
   }
-  std::cout << "s\n";
+  std::cout << "失敗\n";
   return 0;
 }
 
 /**
-* Ff[^擾.
+* 色データを取得する.
 *
-* @param x  XW.
-* @param y  YW.
+* @param x  X座標.
+* @param y  Y座標.
 *
-* @return W(x, y)̐F0.0`1.0ŕ\l.
-*         Fvff[^ɑ݂ȂꍇARGB0.0AA1.0ɂȂ.
+* @return 座標(x, y)の色を0.0～1.0で表した値.
+*         色要素がデータに存在しない場合、RGBは0.0、Aは1.0になる.
 */
 glm::vec4 ImageData::GetColor(int x, int y) const
 {
@@ -561,45 +796,48 @@ glm::vec4 ImageData::GetColor(int x, int y) const
       color.a = static_cast<float>((c & 0b1000'0000'0000'0000) >> 15);
     }
     return color / glm::vec4(31.0f, 31.0f, 31.0f, 1.0f);
+  } else if (type == GL_UNSIGNED_SHORT && format == GL_RED) {
+    const uint8_t* p = &data[x * 2 + y * (width * 2)];
+    return glm::vec4(static_cast<float>(p[0] + p[1] * 0x100) / 65535.0f, 0, 0, 1);
   }
   return glm::vec4(0, 0, 0, 1);
 }
 
 /**
-* 2DeNX`쐬.
+* 2Dテクスチャを作成する.
 *
-* @param width   eNX`̕(sNZ).
-* @param height  eNX`̍(sNZ).
-* @param data    eNX`f[^ւ̃|C^.
-* @param format  ]摜̃f[^`.
-* @param type    ]摜̃f[^i[`.
+* @param width   テクスチャの幅(ピクセル数).
+* @param height  テクスチャの高さ(ピクセル数).
+* @param data    テクスチャデータへのポインタ.
+* @param format  転送元画像のデータ形式.
+* @param type    転送元画像のデータ格納形式.
 *
-* @retval 0ȊO  쐬eNX`EIuWFNgID.
-* @retval 0      eNX`̍쐬Ɏs.
+* @retval 0以外  作成したテクスチャ・オブジェクトのID.
+* @retval 0      テクスチャの作成に失敗.
 */
 GLuint CreateImage2D(GLsizei width, GLsizei height, const GLvoid* data, GLenum format, GLenum type)
 {
   GLuint id;
   glGenTextures(1, &id);
-  glBindTexture(GL_TEXTURE_2D, id);
+  GLState::BindTexture(0, GL_TEXTURE_2D, id);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
   GLenum internalFormat = GL_RGBA8;
   if (format == GL_BGR) {
     internalFormat = GL_RGB8;
   } else if (format == GL_RED) {
-    internalFormat = GL_R8;
+    internalFormat = type == GL_UNSIGNED_SHORT ? GL_R16 : GL_R8;
   }
   glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, data);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
   const GLenum result = glGetError();
   if (result != GL_NO_ERROR) {
-    std::cerr << "ERROR: eNX`̍쐬Ɏs(0x" << std::hex << result << ").";
-    glBindTexture(GL_TEXTURE_2D, 0);
+    std::cerr << "ERROR: テクスチャの作成に失敗(0x" << std::hex << result << ").";
+    GLState::BindTexture(0, GL_TEXTURE_2D, 0);
     glDeleteTextures(1, &id);
     return 0;
   }
 
-  // eNX`̃p[^ݒ肷.
+  // テクスチャのパラメータを設定する.
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -610,15 +848,15 @@ GLuint CreateImage2D(GLsizei width, GLsizei height, const GLvoid* data, GLenum f
     glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
   }
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
 
   return id;
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param path eNX`t@C.
+* @param path テクスチャファイル名.
 */
 Image2D::Image2D(const char* path)
 {
@@ -626,43 +864,44 @@ Image2D::Image2D(const char* path)
   if (id) {
     name = path;
     const GLenum target = Target();
-    glBindTexture(target, id);
+    GLState::BindTexture(0, target, id);
     glGetTexLevelParameteriv(target, 0, GL_TEXTURE_WIDTH, &width);
     glGetTexLevelParameteriv(target, 0, GL_TEXTURE_HEIGHT, &height);
-    glBindTexture(target, 0);
+    GLState::BindTexture(0, target, 0);
   }
 }
 
 /**
-* RXgN^.
+* コンストラクタ.
 *
-* @param id eNX`ID.
+* @param id テクスチャID.
 */
 Image2D::Image2D(const char* name, GLuint id) : id(id)
 {
   if (id) {
     this->name = name;
     const GLenum target = Target();
-    glBindTexture(target, id);
+    GLState::BindTexture(0, target, id);
     glGetTexLevelParameteriv(target, 0, GL_TEXTURE_WIDTH, &width);
     glGetTexLevelParameteriv(target, 0, GL_TEXTURE_HEIGHT, &height);
-    glBindTexture(target, 0);
+    GLState::BindTexture(0, target, 0);
   }
 }
 
 /**
-* fXgN^.
+* デストラクタ.
 */
 Image2D::~Image2D()
 {
+  GLState::ForgetTexture(id);
   glDeleteTextures(1, &id);
 }
 
 /**
-* eNX`EIuWFNgݒ肳Ă邩ׂ.
+* テクスチャ・オブジェクトが設定されているか調べる.
 *
-* @retval true  ݒ肳Ă.
-* @retval false ݒ肳ĂȂ.
+* @retval true  設定されている.
+* @retval false 設定されていない.
 */
 bool Image2D::IsNull() const
 {
@@ -670,10 +909,10 @@ bool Image2D::IsNull() const
 }
 
 /**
-* eNX`ɑΉoChΏۂ擾.
+* テクスチャに対応するバインド対象を取得する.
 *
-* @return eNX`ɑΉoChΏ.
-*         ݂GL_TEXTURE_2DGL_TEXTURE_CUBE_MAP̂ꂩ.
+* @return テクスチャに対応するバインド対象.
+*         現在はGL_TEXTURE_2DとGL_TEXTURE_CUBE_MAPのいずれか.
 */
 GLenum Image2D::Target() const
 {
@@ -681,27 +920,25 @@ GLenum Image2D::Target() const
 }
 
 /**
-* eNX`oCh.
+* テクスチャをバインドする.
 */
 void Image2D::Bind(int no) const
 {
-  glActiveTexture(GL_TEXTURE0 + no);
-  glBindTexture(Target(), Id());
+  GLState::BindTexture(no, Target(), Id());
 }
 
 /**
-* eNX`̃oCh.
+* テクスチャのバインドを解除する.
 */
 void Image2D::Unbind(int no) const
 {
-  glActiveTexture(GL_TEXTURE0 + no);
-  glBindTexture(Target(), 0);
+  GLState::BindTexture(no, Target(), 0);
 }
 
 /**
-* 2DeNX`쐬.
+* 2Dテクスチャを作成する.
 *
-* @param path eNX`t@C.
+* @param path テクスチャファイル名.
 */
 Image2DPtr Image2D::Create(const char* path)
 {
@@ -712,13 +949,13 @@ Image2DPtr Image2D::Create(const char* path)
 }
 
 /**
-* 2DeNX`쐬.
+* 2Dテクスチャを作成する.
 *
-* @param width   eNX`̕(sNZ).
-* @param height  eNX`̍(sNZ).
-* @param data    eNX`f[^ւ̃|C^.
-* @param format  ]摜̃f[^`.
-* @param type    ]摜̃f[^i[`.
+* @param width   テクスチャの幅(ピクセル数).
+* @param height  テクスチャの高さ(ピクセル数).
+* @param data    テクスチャデータへのポインタ.
+* @param format  転送元画像のデータ形式.
+* @param type    転送元画像のデータ格納形式.
 *
 */
 Image2DPtr Image2D::Create(const char* name, GLsizei width, GLsizei height, const GLvoid* data, GLenum format, GLenum type)
@@ -729,4 +966,172 @@ Image2DPtr Image2D::Create(const char* name, GLsizei width, GLsizei height, cons
   return std::make_shared<Impl>(name, CreateImage2D(width, height, data, format, type));
 }
 
+/**
+* シングルトンインスタンスを取得する.
+*
+* @return Cacheのシングルトンインスタンス.
+*/
+Cache& Cache::Instance()
+{
+  static Cache instance;
+  return instance;
+}
+
+/**
+* コンストラクタ.
+*/
+Cache::Cache()
+{
+  map.reserve(256);
+}
+
+/**
+* キャッシュのキーにするためにファイル名を正規化する.
+*
+* @param path ファイル名.
+*
+* @return 正規化したファイル名.
+*
+* 区切り文字を'/'に統一し、"."と".."を取り除く.
+* Windowsのファイルシステムは大文字と小文字を区別しないので、英字は小文字に統一する.
+*/
+std::string Cache::NormalizePath(const char* path)
+{
+  std::vector<std::string> parts;
+  std::string part;
+  for (const char* p = path; ; ++p) {
+    if (*p == '/' || *p == '\\' || *p == '\0') {
+      if (part == "..") {
+        if (!parts.empty() && parts.back() != "..") {
+          parts.pop_back();
+        } else {
+          parts.push_back(part);
+        }
+      } else if (!part.empty() && part != ".") {
+        parts.push_back(part);
+      }
+      part.clear();
+      if (*p == '\0') {
+        break;
+      }
+    } else {
+      part.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*p))));
+    }
+  }
+  std::string result;
+  result.reserve(std::strlen(path));
+  for (const std::string& e : parts) {
+    if (!result.empty()) {
+      result.push_back('/');
+    }
+    result += e;
+  }
+  return result;
+}
+
+/**
+* テクスチャを作成し、キャッシュする.
+*
+* @param path  テクスチャファイル名.
+* @param async true=Streamerで非同期に読み込む. false=その場で読み込む.
+*              Streamerが初期化されていない場合は常にその場で読み込む.
+*
+* @return pathから作成されたテクスチャ.
+*         読み込み済みのテクスチャがまだ使われていれば、それを返す.
+*         非同期に読み込む場合、読み込みが終わるまでは仮の画像が設定されている.
+*/
+Image2DPtr Cache::Create(const char* path, bool async)
+{
+  const std::string key = NormalizePath(path);
+  const auto itr = map.find(key);
+  if (itr != map.end()) {
+    if (Image2DPtr p = itr->second.lock()) {
+      ++hitCount;
+      return p;
+    }
+  }
+  ++missCount;
+  Streamer& streamer = Streamer::Instance();
+  const Image2DPtr value = async && streamer.IsInitialized() ? streamer.Request(path) : Image2D::Create(path);
+  map[key] = value;
+  return value;
+}
+
+/**
+* テクスチャを取得する.
+*
+* @param path テクスチャファイル名.
+*
+* @return pathから作成されたテクスチャ.
+*         対応するエントリがない、またはテクスチャが破棄済みの場合はnullptrを返す.
+*/
+Image2DPtr Cache::Get(const char* path) const
+{
+  const auto itr = map.find(NormalizePath(path));
+  if (itr != map.end()) {
+    return itr->second.lock();
+  }
+  return Image2DPtr();
+}
+
+/**
+* 破棄済みのテクスチャのエントリを取り除く.
+*
+* @return 取り除いたエントリの数.
+*/
+size_t Cache::Purge()
+{
+  size_t count = 0;
+  for (auto itr = map.begin(); itr != map.end();) {
+    if (itr->second.expired()) {
+      itr = map.erase(itr);
+      ++count;
+    } else {
+      ++itr;
+    }
+  }
+  return count;
+}
+
+/**
+* 全てのエントリを取り除き、統計情報をリセットする.
+*
+* 使用中のテクスチャは破棄されないが、次にCreate()を呼んだときは新しく読み込まれる.
+*/
+void Cache::Clear()
+{
+  map.clear();
+  hitCount = 0;
+  missCount = 0;
+}
+
+/**
+* 統計情報を取得する.
+*
+* @return 統計情報.
+*/
+Cache::Statistics Cache::GetStatistics() const
+{
+  Statistics stats;
+  stats.hitCount = hitCount;
+  stats.missCount = missCount;
+  stats.entryCount = map.size();
+  for (const auto& e : map) {
+    if (!e.second.expired()) {
+      ++stats.aliveCount;
+    }
+  }
+  return stats;
+}
+
+/**
+* 統計情報を表示する.
+*/
+void Cache::PrintStatistics() const
+{
+  const Statistics stats = GetStatistics();
+  std::cout << "[情報]テクスチャキャッシュ: ヒット=" << stats.hitCount << " ミス=" << stats.missCount <<
+    " エントリ=" << stats.entryCount << " 使用中=" << stats.aliveCount << "\n";
+}
+
 } // namespace Texture
\ No newline at end of file
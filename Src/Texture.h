@@ -8,6 +8,8 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <cstdint>
 
 namespace Texture {
 
@@ -15,19 +17,19 @@ class Image2D;
 using Image2DPtr = std::shared_ptr<Image2D>;
 
 /**
-* 摜f[^.
+* 画像データ.
 */
 class ImageData {
 public:
   glm::vec4 GetColor(int x, int y) const;
 
 public:
-  std::string name; ///< t@C.
-  GLint width = 0; ///< ̃sNZ.
-  GLint height = 0; ///< c̃sNZ.
-  GLenum format = GL_NONE; ///< ǂ̐F񂪋L^Ă邩.
-  GLenum type = GL_NONE; ///< ꂼ̐F̃rbgzu.
-  std::vector<uint8_t> data; ///< oCgf[^.
+  std::string name; ///< ファイル名.
+  GLint width = 0; ///< 横のピクセル数.
+  GLint height = 0; ///< 縦のピクセル数.
+  GLenum format = GL_NONE; ///< どの色情報が記録されているか.
+  GLenum type = GL_NONE; ///< それぞれの色情報のビット配置.
+  std::vector<uint8_t> data; ///< バイトデータ.
 };
 
 GLuint CreateImage2D(GLsizei width, GLsizei height, const GLvoid* data, GLenum format, GLenum type);
@@ -35,7 +37,39 @@ GLuint LoadImage2D(const char* path);
 bool LoadImage2D(const char* path, ImageData& imageData);
 
 /**
-* eNX`EC[W.
+* DDSファイルのミップマップレベル.
+*/
+struct DDSLevel
+{
+  GLsizei width;
+  GLsizei height;
+  size_t offset;    ///< DDSImage::pixelsからのバイトオフセット.
+  size_t rowBytes;  ///< 1行(圧縮形式の場合は4x4ブロックの1行)のバイト数.
+  GLsizei rowCount; ///< 行数(圧縮形式の場合はブロックの行数).
+};
+
+/**
+* DDSファイル内の画素データの配置.
+*
+* pixelsはファイルの内容を直接指すので、ファイルをマップしている間だけ有効.
+* キューブマップの場合、各面のレベルはfaceBytesバイト間隔で同じ配置になっている.
+*/
+struct DDSImage
+{
+  GLenum internalFormat = GL_NONE;
+  GLenum format = GL_NONE; ///< 非圧縮形式の場合の色情報の並び.
+  bool isCompressed = false;
+  bool isCubemap = false;
+  int faceCount = 1;
+  const uint8_t* pixels = nullptr; ///< 最初の面のレベル0の先頭.
+  size_t faceBytes = 0;            ///< 1面の全レベルのバイト数.
+  std::vector<DDSLevel> levels;
+};
+
+bool ParseDDS(const char* filename, const uint8_t* file, size_t fileSize, DDSImage& image);
+
+/**
+* テクスチャ・イメージ.
 */
 class Image2D
 {
@@ -54,17 +88,60 @@ public:
   void Unbind(int no) const;
 
 private:
+  friend class Streamer;
+
   Image2D() = default;
   explicit Image2D(const char*);
   Image2D(const char*, GLuint);
 
-  std::string name; ///< eNX`t@C.
+  std::string name; ///< テクスチャファイル名.
   GLuint id = 0;
   GLint width = 0;
   GLint height = 0;
   bool isCubemap = false;
 };
 
+/**
+* テクスチャをキャッシュするクラス.
+*
+* 同じファイル名のテクスチャを複数回作成しようとした場合、読み込み済みのテクスチャを返す.
+* キャッシュはテクスチャを弱参照で保持するので、どこからも使われなくなったテクスチャは自動的に破棄される.
+* 破棄されたテクスチャのエントリはPurge()で取り除く.
+*/
+class Cache
+{
+public:
+  // 統計情報.
+  struct Statistics
+  {
+    size_t hitCount = 0;    ///< キャッシュから取得できた回数.
+    size_t missCount = 0;   ///< ファイルから読み込んだ回数.
+    size_t entryCount = 0;  ///< エントリの数.
+    size_t aliveCount = 0;  ///< エントリのうち、まだ破棄されていないテクスチャの数.
+  };
+
+  static Cache& Instance();
+
+  Image2DPtr Create(const char* path, bool async = false);
+  Image2DPtr Get(const char* path) const;
+  size_t Purge();
+  void Clear();
+  Statistics GetStatistics() const;
+  void PrintStatistics() const;
+
+private:
+  Cache();
+  ~Cache() = default;
+  Cache(const Cache&) = delete;
+  Cache& operator=(const Cache&) = delete;
+
+  static std::string NormalizePath(const char* path);
+
+  std::unordered_map<std::string, std::weak_ptr<Image2D>> map;
+  size_t hitCount = 0;
+  size_t missCount = 0;
+};
+
 } // namespace Texture
 
 #endif // TEXTURE_H_INCLUDED
\ No newline at end of file
@@ -0,0 +1,679 @@
+/**
+* @file TextureCooker.cpp
+*
+* TGA/BMP画像を、ミップマップ付きのBC圧縮DDSファイルに変換する.
+*/
+#include "TextureCooker.h"
+#include "Texture.h"
+#include "PixelConvert.h"
+#include <emmintrin.h>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <climits>
+#include <cctype>
+
+namespace Texture {
+
+namespace /* unnamed */ {
+
+/**
+* 浮動小数点数で表した線形色空間の画像.
+*/
+struct LinearImage
+{
+  int width = 0;
+  int height = 0;
+  std::vector<float> data; // RGBAの順で格納.
+};
+
+/**
+* sRGBから線形色空間への変換テーブルを取得する.
+*/
+const float* SrgbToLinearTable()
+{
+  static float table[256];
+  static bool initialized = false;
+  if (!initialized) {
+    for (int i = 0; i < 256; ++i) {
+      const float c = static_cast<float>(i) / 255.0f;
+      table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    initialized = true;
+  }
+  return table;
+}
+
+/**
+* 線形色空間の値をsRGBの8ビット値に変換する.
+*/
+uint8_t LinearToSrgb(float c)
+{
+  c = std::min(std::max(c, 0.0f), 1.0f);
+  c = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(c * 255.0f + 0.5f);
+}
+
+/**
+* 画像データをRGBA8形式に変換する.
+*
+* @param imageData 変換する画像データ.
+*
+* @return RGBA8形式の画像データ.
+*
+* 1チャンネルの画像は、CreateImage2D()のスウィズルと同じくRGBに同じ値を複製する.
+*/
+std::vector<uint8_t> ToRGBA8(const ImageData& imageData)
+{
+  const size_t pixelCount = static_cast<size_t>(imageData.width) * imageData.height;
+  std::vector<uint8_t> rgba(pixelCount * 4);
+  const uint8_t* src = imageData.data.data();
+  uint8_t* dst = rgba.data();
+  if (imageData.type == GL_UNSIGNED_BYTE && imageData.format == GL_BGRA) {
+    SwizzleBGRAToRGBA(src, dst, pixelCount);
+  } else if (imageData.type == GL_UNSIGNED_BYTE && imageData.format == GL_BGR) {
+    SwizzleBGRToRGBA(src, dst, pixelCount);
+  } else if (imageData.type == GL_UNSIGNED_BYTE && imageData.format == GL_RED) {
+    for (size_t i = 0; i < pixelCount; ++i, ++src, dst += 4) {
+      dst[0] = dst[1] = dst[2] = src[0];
+      dst[3] = 255;
+    }
+  } else if (imageData.type == GL_UNSIGNED_SHORT && imageData.format == GL_RED) {
+    // 16ビットの上位8ビットを使う(リトルエンディアン).
+    for (size_t i = 0; i < pixelCount; ++i, src += 2, dst += 4) {
+      dst[0] = dst[1] = dst[2] = src[1];
+      dst[3] = 255;
+    }
+  } else {
+    for (int y = 0; y < imageData.height; ++y) {
+      for (int x = 0; x < imageData.width; ++x, dst += 4) {
+        const glm::vec4 c = imageData.GetColor(x, y);
+        for (int i = 0; i < 4; ++i) {
+          dst[i] = static_cast<uint8_t>(std::min(std::max(c[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+      }
+    }
+  }
+  return rgba;
+}
+
+/**
+* RGBA8形式の画像を線形色空間に変換する.
+*
+* @param rgba   RGBA8形式の画像データ.
+* @param width  画像の幅.
+* @param height 画像の高さ.
+* @param isSrgb true=RGBをsRGBとして扱う. false=値をそのまま使う.
+*
+* @return 線形色空間の画像. RGBにはアルファを乗算済み.
+*/
+LinearImage ToLinear(const std::vector<uint8_t>& rgba, int width, int height, bool isSrgb)
+{
+  const float* table = SrgbToLinearTable();
+  LinearImage image;
+  image.width = width;
+  image.height = height;
+  image.data.resize(rgba.size());
+  for (size_t i = 0; i < rgba.size(); i += 4) {
+    const float a = static_cast<float>(rgba[i + 3]) / 255.0f;
+    for (size_t c = 0; c < 3; ++c) {
+      const float v = isSrgb ? table[rgba[i + c]] : static_cast<float>(rgba[i + c]) / 255.0f;
+      image.data[i + c] = v * a;
+    }
+    image.data[i + 3] = a;
+  }
+  return image;
+}
+
+/**
+* 線形色空間の画像をRGBA8形式に変換する.
+*
+* @param image  変換する画像. RGBにはアルファが乗算されていること.
+* @param isSrgb true=RGBをsRGBに変換する. false=値をそのまま使う.
+*
+* @return RGBA8形式の画像データ.
+*/
+std::vector<uint8_t> FromLinear(const LinearImage& image, bool isSrgb)
+{
+  std::vector<uint8_t> rgba(image.data.size());
+  for (size_t i = 0; i < rgba.size(); i += 4) {
+    const float a = image.data[i + 3];
+    for (size_t c = 0; c < 3; ++c) {
+      const float v = a > 0 ? image.data[i + c] / a : 0.0f;
+      rgba[i + c] = isSrgb ? LinearToSrgb(v) :
+        static_cast<uint8_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+    rgba[i + 3] = static_cast<uint8_t>(std::min(std::max(a, 0.0f), 1.0f) * 255.0f + 0.5f);
+  }
+  return rgba;
+}
+
+/**
+* 1次元の縮小フィルタの重みを計算する.
+*
+* @param srcSize 縮小前の要素数.
+* @param dstSize 縮小後の要素数.
+*
+* @return 縮小後の要素ごとの(縮小前の要素番号, 重み)のリスト.
+*
+* 奇数の大きさを半分にする場合でも、縮小前の全ての要素が同じ重みで寄与するように、
+* 範囲の端にかかる要素には覆っている割合の重みを与える.
+*/
+std::vector<std::vector<std::pair<int, float>>> BoxWeights(int srcSize, int dstSize)
+{
+  std::vector<std::vector<std::pair<int, float>>> weights(dstSize);
+  const double ratio = static_cast<double>(srcSize) / static_cast<double>(dstSize);
+  for (int i = 0; i < dstSize; ++i) {
+    const double start = i * ratio;
+    const double end = (i + 1) * ratio;
+    for (int j = static_cast<int>(start); j < srcSize && j < end; ++j) {
+      const double w = std::min(end, j + 1.0) - std::max(start, static_cast<double>(j));
+      if (w > 0) {
+        weights[i].emplace_back(j, static_cast<float>(w / ratio));
+      }
+    }
+  }
+  return weights;
+}
+
+/**
+* 画像を縦横半分に縮小する.
+*
+* @param src 縮小する画像.
+*
+* @return 縮小した画像. 大きさが1の辺は1のまま.
+*/
+LinearImage Downsample(const LinearImage& src)
+{
+  LinearImage dst;
+  dst.width = std::max(1, src.width / 2);
+  dst.height = std::max(1, src.height / 2);
+
+  // 横方向.
+  const auto wx = BoxWeights(src.width, dst.width);
+  std::vector<float> tmp(static_cast<size_t>(dst.width) * src.height * 4, 0.0f);
+  for (int y = 0; y < src.height; ++y) {
+    for (int x = 0; x < dst.width; ++x) {
+      float* d = &tmp[(static_cast<size_t>(y) * dst.width + x) * 4];
+      for (const auto& e : wx[x]) {
+        const float* s = &src.data[(static_cast<size_t>(y) * src.width + e.first) * 4];
+        for (int c = 0; c < 4; ++c) {
+          d[c] += s[c] * e.second;
+        }
+      }
+    }
+  }
+
+  // 縦方向.
+  const auto wy = BoxWeights(src.height, dst.height);
+  dst.data.assign(static_cast<size_t>(dst.width) * dst.height * 4, 0.0f);
+  for (int y = 0; y < dst.height; ++y) {
+    for (const auto& e : wy[y]) {
+      const float* s = &tmp[static_cast<size_t>(e.first) * dst.width * 4];
+      float* d = &dst.data[static_cast<size_t>(y) * dst.width * 4];
+      for (int i = 0; i < dst.width * 4; ++i) {
+        d[i] += s[i] * e.second;
+      }
+    }
+  }
+  return dst;
+}
+
+/**
+* 8ビットRGBを16ビットの5-6-5形式に変換する.
+*/
+uint16_t To565(const int* rgb)
+{
+  const int r = (rgb[0] * 31 + 127) / 255;
+  const int g = (rgb[1] * 63 + 127) / 255;
+  const int b = (rgb[2] * 31 + 127) / 255;
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+/**
+* 16ビットの5-6-5形式を8ビットRGBに変換する.
+*/
+void From565(uint16_t c, int* rgb)
+{
+  const int r = (c >> 11) & 31;
+  const int g = (c >> 5) & 63;
+  const int b = c & 31;
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+/**
+* 2ピクセル×2組のRGBと、パレット色との距離の2乗を計算する.
+*
+* @param lo  ピクセル0, 1のRGBA(16ビット×8, アルファは0).
+* @param hi  ピクセル2, 3のRGBA(16ビット×8, アルファは0).
+* @param pal パレット色のRGBA(16ビット×8, 同じ色を2回, アルファは0).
+*
+* @return ピクセル0～3の距離の2乗(32ビット×4).
+*/
+__m128i ColorDistance(__m128i lo, __m128i hi, __m128i pal)
+{
+  const __m128i dl = _mm_sub_epi16(lo, pal);
+  const __m128i dh = _mm_sub_epi16(hi, pal);
+  __m128i ml = _mm_madd_epi16(dl, dl); // [r0^2+g0^2, b0^2, r1^2+g1^2, b1^2]
+  __m128i mh = _mm_madd_epi16(dh, dh);
+  ml = _mm_add_epi32(ml, _mm_shuffle_epi32(ml, _MM_SHUFFLE(2, 3, 0, 1)));
+  mh = _mm_add_epi32(mh, _mm_shuffle_epi32(mh, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_castps_si128(_mm_shuffle_ps(
+    _mm_castsi128_ps(ml), _mm_castsi128_ps(mh), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+/**
+* 4x4ピクセルをBC1形式で圧縮する.
+*
+* @param rgba 16ピクセルのRGBA8データ.
+* @param out  圧縮データ(8バイト)の格納先.
+*
+* 色のバウンディングボックスの対角を端点とし、各ピクセルに最も近い補間色を割り当てる.
+* 範囲の計算と最近傍の検索はSSE2で4ピクセルずつ処理する.
+* BC3の色ブロックとしても使えるように、常に4色モード(color0 > color1)で出力する.
+*/
+void EncodeBC1(const uint8_t* rgba, uint8_t* out)
+{
+  __m128i px[4];
+  for (int i = 0; i < 4; ++i) {
+    px[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 16));
+  }
+  __m128i mn = _mm_min_epu8(_mm_min_epu8(px[0], px[1]), _mm_min_epu8(px[2], px[3]));
+  __m128i mx = _mm_max_epu8(_mm_max_epu8(px[0], px[1]), _mm_max_epu8(px[2], px[3]));
+  mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+  mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+  mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+  mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+  const uint32_t minColor = static_cast<uint32_t>(_mm_cvtsi128_si32(mn));
+  const uint32_t maxColor = static_cast<uint32_t>(_mm_cvtsi128_si32(mx));
+
+  // 範囲を1/16だけ内側に寄せると、平均的な誤差が小さくなる.
+  int lo[3], hi[3];
+  for (int c = 0; c < 3; ++c) {
+    lo[c] = (minColor >> (c * 8)) & 0xff;
+    hi[c] = (maxColor >> (c * 8)) & 0xff;
+    const int inset = (hi[c] - lo[c]) >> 4;
+    lo[c] += inset;
+    hi[c] -= inset;
+  }
+  uint16_t c0 = To565(hi);
+  uint16_t c1 = To565(lo);
+  uint32_t indices = 0;
+  if (c0 == c1) {
+    // 単色. 4色モードにするため片方をずらし、全ピクセルでcolor0を使う.
+    if (c1 > 0) {
+      --c1;
+    } else {
+      ++c0;
+      indices = 0x55555555; // 全ピクセルでcolor1(=元の色)を使う.
+    }
+  } else {
+    int pal[4][3];
+    From565(c0, pal[0]);
+    From565(c1, pal[1]);
+    for (int c = 0; c < 3; ++c) {
+      pal[2][c] = (pal[0][c] * 2 + pal[1][c]) / 3;
+      pal[3][c] = (pal[0][c] + pal[1][c] * 2) / 3;
+    }
+    __m128i pal16[4];
+    for (int k = 0; k < 4; ++k) {
+      pal16[k] = _mm_setr_epi16(static_cast<short>(pal[k][0]), static_cast<short>(pal[k][1]),
+        static_cast<short>(pal[k][2]), 0, static_cast<short>(pal[k][0]), static_cast<short>(pal[k][1]),
+        static_cast<short>(pal[k][2]), 0);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+    for (int i = 0; i < 4; ++i) {
+      const __m128i rgb = _mm_and_si128(px[i], rgbMask);
+      const __m128i lo16 = _mm_unpacklo_epi8(rgb, zero);
+      const __m128i hi16 = _mm_unpackhi_epi8(rgb, zero);
+      __m128i best = _mm_set1_epi32(INT_MAX);
+      __m128i bestIndex = zero;
+      for (int k = 0; k < 4; ++k) {
+        const __m128i dist = ColorDistance(lo16, hi16, pal16[k]);
+        const __m128i mask = _mm_cmplt_epi32(dist, best);
+        best = _mm_or_si128(_mm_and_si128(mask, dist), _mm_andnot_si128(mask, best));
+        bestIndex = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi32(k)), _mm_andnot_si128(mask, bestIndex));
+      }
+      alignas(16) int32_t index[4];
+      _mm_store_si128(reinterpret_cast<__m128i*>(index), bestIndex);
+      for (int j = 0; j < 4; ++j) {
+        indices |= static_cast<uint32_t>(index[j]) << ((i * 4 + j) * 2);
+      }
+    }
+  }
+  out[0] = static_cast<uint8_t>(c0);
+  out[1] = static_cast<uint8_t>(c0 >> 8);
+  out[2] = static_cast<uint8_t>(c1);
+  out[3] = static_cast<uint8_t>(c1 >> 8);
+  for (int i = 0; i < 4; ++i) {
+    out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+  }
+}
+
+/**
+* 4x4ピクセルの1チャンネルをBC4形式で圧縮する.
+*
+* @param rgba    16ピクセルのRGBA8データ.
+* @param channel 圧縮するチャンネル(0=R, 1=G, 2=B, 3=A).
+* @param out     圧縮データ(8バイト)の格納先.
+*
+* BC3のアルファブロックとBC5の各チャンネルで使う.
+* 常に8値モード(alpha0 > alpha1)で出力する.
+*/
+void EncodeBC4(const uint8_t* rgba, int channel, uint8_t* out)
+{
+  alignas(16) uint8_t v[16];
+  for (int i = 0; i < 16; ++i) {
+    v[i] = rgba[i * 4 + channel];
+  }
+  __m128i mn = _mm_load_si128(reinterpret_cast<const __m128i*>(v));
+  __m128i mx = mn;
+  mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 8));
+  mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 8));
+  mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 4));
+  mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 4));
+  mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 2));
+  mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 2));
+  mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 1));
+  mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 1));
+  const int a1 = _mm_cvtsi128_si32(mn) & 0xff;
+  const int a0 = _mm_cvtsi128_si32(mx) & 0xff;
+
+  uint64_t indices = 0;
+  if (a0 > a1) {
+    // 最小値からの位置(0～7)を、BC4のインデックス順(0=a0, 1=a1, 2～7=a0寄りからa1寄り)に変換する.
+    static const uint64_t positionToIndex[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+    const int range = a0 - a1;
+    for (int i = 0; i < 16; ++i) {
+      const int pos = ((v[i] - a1) * 14 + range) / (range * 2);
+      indices |= positionToIndex[pos] << (i * 3);
+    }
+  }
+  out[0] = static_cast<uint8_t>(a0);
+  out[1] = static_cast<uint8_t>(a1);
+  for (int i = 0; i < 6; ++i) {
+    out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+  }
+}
+
+/**
+* 1枚の画像をBC形式で圧縮する.
+*
+* @param rgba   RGBA8形式の画像データ.
+* @param width  画像の幅.
+* @param height 画像の高さ.
+* @param format 圧縮形式.
+* @param out    圧縮データの追加先.
+*
+* 4で割り切れない大きさの場合、はみ出した部分は端のピクセルで埋める.
+*/
+void Compress(const std::vector<uint8_t>& rgba, int width, int height, CompressionFormat format,
+  std::vector<uint8_t>& out)
+{
+  const size_t blockSize = format == CompressionFormat::BC1 ? 8 : 16;
+  const int blockCountX = (width + 3) / 4;
+  const int blockCountY = (height + 3) / 4;
+  size_t offset = out.size();
+  out.resize(offset + blockCountX * blockCountY * blockSize);
+
+  uint8_t block[16 * 4];
+  for (int by = 0; by < blockCountY; ++by) {
+    for (int bx = 0; bx < blockCountX; ++bx) {
+      for (int y = 0; y < 4; ++y) {
+        const int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+          const int sx = std::min(bx * 4 + x, width - 1);
+          const uint8_t* p = &rgba[(static_cast<size_t>(sy) * width + sx) * 4];
+          std::copy(p, p + 4, block + (y * 4 + x) * 4);
+        }
+      }
+      uint8_t* dst = &out[offset];
+      switch (format) {
+      default:
+      case CompressionFormat::BC1:
+        EncodeBC1(block, dst);
+        break;
+      case CompressionFormat::BC3:
+        EncodeBC4(block, 3, dst);
+        EncodeBC1(block, dst + 8);
+        break;
+      case CompressionFormat::BC5:
+        EncodeBC4(block, 0, dst);
+        EncodeBC4(block, 1, dst + 8);
+        break;
+      }
+      offset += blockSize;
+    }
+  }
+}
+
+/**
+* 32ビット整数をリトルエンディアンで追加する.
+*/
+void Put(std::vector<uint8_t>& buf, uint32_t n)
+{
+  for (int i = 0; i < 4; ++i) {
+    buf.push_back(static_cast<uint8_t>(n >> (i * 8)));
+  }
+}
+
+/**
+* DDSファイルのヘッダを作成する.
+*
+* @param width    画像の幅.
+* @param height   画像の高さ.
+* @param mipCount ミップマップレベル数.
+* @param format   圧縮形式.
+* @param topLevelSize 最初のミップマップレベルのバイト数.
+*
+* @return 作成したヘッダ(128バイト).
+*/
+std::vector<uint8_t> CreateDDSHeader(int width, int height, int mipCount, CompressionFormat format,
+  size_t topLevelSize)
+{
+  const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+  const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+  const uint32_t DDPF_FOURCC = 0x4;
+  const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+  uint32_t fourCC;
+  switch (format) {
+  default:
+  case CompressionFormat::BC1: fourCC = 'D' | ('X' << 8) | ('T' << 16) | ('1' << 24); break;
+  case CompressionFormat::BC3: fourCC = 'D' | ('X' << 8) | ('T' << 16) | ('5' << 24); break;
+  case CompressionFormat::BC5: fourCC = 'B' | ('C' << 8) | ('5' << 16) | ('U' << 24); break;
+  }
+
+  std::vector<uint8_t> header;
+  header.reserve(128);
+  Put(header, 'D' | ('D' << 8) | ('S' << 16) | (' ' << 24));
+  Put(header, 124);
+  Put(header, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+  Put(header, height);
+  Put(header, width);
+  Put(header, static_cast<uint32_t>(topLevelSize));
+  Put(header, 0); // depth.
+  Put(header, mipCount);
+  for (int i = 0; i < 11; ++i) {
+    Put(header, 0); // reserved1.
+  }
+  Put(header, 32);
+  Put(header, DDPF_FOURCC);
+  Put(header, fourCC);
+  for (int i = 0; i < 5; ++i) {
+    Put(header, 0); // rgbBitCount, 各色のビットマスク.
+  }
+  Put(header, DDSCAPS_TEXTURE | (mipCount > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0));
+  for (int i = 0; i < 4; ++i) {
+    Put(header, 0); // caps2～4, reserved2.
+  }
+  return header;
+}
+
+/**
+* ファイル名が変換対象の拡張子を持つか調べる.
+*/
+bool IsCookableExtension(const std::filesystem::path& path)
+{
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+    [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+  return ext == ".tga" || ext == ".bmp";
+}
+
+} // unnamed namespace
+
+/**
+* 変換後のファイル名を取得する.
+*
+* @param path 変換元のファイル名.
+*
+* @return 拡張子を.ddsに置き換えたファイル名.
+*         pathが変換対象の形式でなければ空文字列.
+*/
+std::string CookedPath(const char* path)
+{
+  std::filesystem::path p(path);
+  if (!IsCookableExtension(p)) {
+    return std::string();
+  }
+  return p.replace_extension(".dds").string();
+}
+
+/**
+* 変換済みのファイルが使えるか調べる.
+*
+* @param path 変換元のファイル名.
+*
+* @retval true  変換済みのファイルが存在し、変換元より新しい.
+* @retval false 変換済みのファイルがない、または変換元のほうが新しい.
+*/
+bool IsCookedImageAvailable(const char* path)
+{
+  const std::string cookedPath = CookedPath(path);
+  if (cookedPath.empty()) {
+    return false;
+  }
+  std::error_code ec;
+  const auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+  if (ec) {
+    return false;
+  }
+  const auto srcTime = std::filesystem::last_write_time(path, ec);
+  return ec || cookedTime >= srcTime;
+}
+
+/**
+* 画像ファイルをBC圧縮したDDSファイルに変換する.
+*
+* @param srcPath 変換元のTGAまたはBMPファイル名.
+* @param dstPath 変換先のDDSファイル名.
+* @param format  圧縮形式.
+*
+* @retval true  変換成功.
+* @retval false 変換失敗.
+*
+* 1x1までの全てのミップマップを作成する. 縮小はアルファを乗算した線形色空間で行うので、
+* 遠景が暗くなったり、透明部分の色がにじみ出たりしない(BC5の場合は値をそのまま平均する).
+*
+* 画素の並びは変換元を読み込んだときのもの(下の行が先頭)をそのまま使う.
+* LoadDDS()は並びを変更せずに転送するので、TGAを直接読み込んだ場合と同じ向きになる.
+*/
+bool CookImage(const char* srcPath, const char* dstPath, CompressionFormat format)
+{
+  ImageData imageData;
+  if (!LoadImage2D(srcPath, imageData)) {
+    return false;
+  }
+  const int width = imageData.width;
+  const int height = imageData.height;
+  std::vector<uint8_t> rgba = ToRGBA8(imageData);
+  imageData.data.clear();
+
+  if (format == CompressionFormat::Auto) {
+    format = CompressionFormat::BC1;
+    for (size_t i = 3; i < rgba.size(); i += 4) {
+      if (rgba[i] != 255) {
+        format = CompressionFormat::BC3;
+        break;
+      }
+    }
+  }
+  const bool isSrgb = format != CompressionFormat::BC5;
+
+  std::vector<uint8_t> body;
+  Compress(rgba, width, height, format, body);
+  const size_t topLevelSize = body.size();
+  int mipCount = 1;
+  LinearImage image = ToLinear(rgba, width, height, isSrgb);
+  while (image.width > 1 || image.height > 1) {
+    image = Downsample(image);
+    Compress(FromLinear(image, isSrgb), image.width, image.height, format, body);
+    ++mipCount;
+  }
+
+  const std::vector<uint8_t> header = CreateDDSHeader(width, height, mipCount, format, topLevelSize);
+  std::ofstream ofs(dstPath, std::ios_base::binary);
+  if (!ofs) {
+    std::cerr << "[エラー]" << __func__ << ": " << dstPath << "を作成できません.\n";
+    return false;
+  }
+  ofs.write(reinterpret_cast<const char*>(header.data()), header.size());
+  ofs.write(reinterpret_cast<const char*>(body.data()), body.size());
+  if (!ofs) {
+    std::cerr << "[エラー]" << __func__ << ": " << dstPath << "に書き込めません.\n";
+    return false;
+  }
+
+  static const char* const formatNames[] = { "Auto", "BC1", "BC3", "BC5" };
+  const size_t srcSize = static_cast<size_t>(width) * height * 4;
+  std::cout << "[情報]" << __func__ << ": " << srcPath << " -> " << dstPath << " (" <<
+    formatNames[static_cast<int>(format)] << ", " << mipCount << "レベル, " <<
+    srcSize / 1024 << "KB -> " << (header.size() + body.size()) / 1024 << "KB)\n";
+  return true;
+}
+
+/**
+* ディレクトリ内の画像ファイルを全てDDSファイルに変換する.
+*
+* @param directory 変換する画像ファイルのあるディレクトリ.
+*
+* @return 変換したファイルの数.
+*
+* 変換済みのファイルが変換元より新しい場合は変換しない.
+* 圧縮形式は自動的に選択する.
+*/
+size_t CookDirectory(const char* directory)
+{
+  std::error_code ec;
+  std::filesystem::directory_iterator itr(directory, ec);
+  if (ec) {
+    std::cerr << "[エラー]" << __func__ << ": " << directory << "を開けません.\n";
+    return 0;
+  }
+  size_t count = 0;
+  for (const std::filesystem::directory_entry& e : itr) {
+    if (!e.is_regular_file() || !IsCookableExtension(e.path())) {
+      continue;
+    }
+    const std::string srcPath = e.path().string();
+    if (IsCookedImageAvailable(srcPath.c_str())) {
+      continue;
+    }
+    if (CookImage(srcPath.c_str(), CookedPath(srcPath.c_str()).c_str())) {
+      ++count;
+    }
+  }
+  std::cout << "[情報]" << __func__ << ": " << directory << "の画像を" << count << "個変換しました.\n";
+  return count;
+}
+
+} // namespace Texture
@@ -0,0 +1,27 @@
+/**
+* @file TextureCooker.h
+*/
+#ifndef TEXTURECOOKER_H_INCLUDED
+#define TEXTURECOOKER_H_INCLUDED
+#include <string>
+
+namespace Texture {
+
+/**
+* 変換後の圧縮形式.
+*/
+enum class CompressionFormat {
+  Auto, ///< 全てのピクセルが不透明ならBC1, そうでなければBC3.
+  BC1,  ///< RGB. 1ピクセルあたり4ビット.
+  BC3,  ///< RGBA. 1ピクセルあたり8ビット.
+  BC5,  ///< RG. 法線マップなどの色ではないデータ用. 1ピクセルあたり8ビット.
+};
+
+bool CookImage(const char* srcPath, const char* dstPath, CompressionFormat format = CompressionFormat::Auto);
+size_t CookDirectory(const char* directory);
+std::string CookedPath(const char* path);
+bool IsCookedImageAvailable(const char* path);
+
+} // namespace Texture
+
+#endif // TEXTURECOOKER_H_INCLUDED
@@ -0,0 +1,571 @@
+/**
+* @file TextureStreamer.cpp
+*/
+#include "TextureStreamer.h"
+#include "TextureCooker.h"
+#include "MappedFile.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+namespace Texture {
+
+/**
+* シングルトンインスタンスを取得する.
+*
+* @return Streamerのシングルトンインスタンス.
+*/
+Streamer& Streamer::Instance()
+{
+  static Streamer instance;
+  return instance;
+}
+
+/**
+* 初期化.
+*
+* @param workerCount   デコードを行うワーカースレッドの数. 0の場合はCPUのコア数から決める.
+* @param ringSize      PBOリングのバイト数.
+* @param segmentCount  リングを分割する区画の数. 区画ごとにフェンスで転送完了を待つ.
+* @param bytesPerFrame 1フレームに転送するバイト数の上限.
+*
+* @retval true  初期化成功.
+* @retval false 初期化失敗.
+*/
+bool Streamer::Init(size_t workerCount, GLsizeiptr ringSize, size_t segmentCount, GLsizeiptr bytesPerFrame)
+{
+  Finalize();
+
+  if (segmentCount == 0 || ringSize < static_cast<GLsizeiptr>(segmentCount * 256)) {
+    std::cerr << "[エラー] Texture::Streamer::Init: リングのサイズが小さすぎます(" << ringSize << "/" <<
+      segmentCount << ")." << std::endl;
+    return false;
+  }
+  segmentSize = (ringSize / segmentCount) & ~static_cast<GLsizeiptr>(255);
+  const GLsizeiptr bufferSize = segmentSize * segmentCount;
+
+  // 永続マップできる場合、マップは1回だけ行い、以後はポインタに直接書き込む.
+  glGenBuffers(1, &pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+  isPersistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+  if (isPersistent) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, flags);
+    mappedPointer = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, flags));
+    if (!mappedPointer) {
+      std::cerr << "[警告] Texture::Streamer::Init: PBOを永続マップできません. 通常のマップを使います." <<
+        std::endl;
+      glDeleteBuffers(1, &pbo);
+      glGenBuffers(1, &pbo);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+      isPersistent = false;
+    }
+  }
+  if (!isPersistent) {
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  const GLenum error = glGetError();
+  if (error != GL_NO_ERROR) {
+    std::cerr << "[エラー] Texture::Streamer::Init: PBOの作成に失敗(0x" << std::hex << error << std::dec <<
+      ")." << std::endl;
+    Finalize();
+    return false;
+  }
+
+  segments.resize(segmentCount);
+  for (size_t i = 0; i < segmentCount; ++i) {
+    segments[i].offset = segmentSize * i;
+  }
+  nextSegment = 0;
+  this->bytesPerFrame = std::max(bytesPerFrame, segmentSize);
+
+  if (workerCount == 0) {
+    workerCount = std::min(std::max(std::thread::hardware_concurrency() / 2, 1U), 4U);
+  }
+  isStopping = false;
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back(&Streamer::WorkerMain, this);
+  }
+
+  std::cout << "[情報] Texture::Streamer: ワーカー=" << workerCount << " リング=" << segmentSize << "x" <<
+    segmentCount << "バイト" << (isPersistent ? "(永続マップ)" : "") << std::endl;
+  return true;
+}
+
+/**
+* 終了処理.
+*
+* ワーカースレッドを停止し、転送中のテクスチャを破棄する.
+* 転送が終わっていないテクスチャは、その時点で転送済みのミップマップレベルのまま残る.
+*/
+void Streamer::Finalize()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+  }
+  condition.notify_all();
+  for (auto& e : workers) {
+    e.join();
+  }
+  workers.clear();
+  jobs.clear();
+  decodedList.clear();
+  uploads.clear();
+
+  if (pbo) {
+    for (auto& e : segments) {
+      if (e.fence) {
+        glDeleteSync(e.fence);
+      }
+    }
+    if (mappedPointer) {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &pbo);
+  }
+  segments.clear();
+  pbo = 0;
+  mappedPointer = nullptr;
+  isPersistent = false;
+}
+
+/**
+* テクスチャの読み込みを要求する.
+*
+* @param path テクスチャファイル名.
+*
+* @return 作成したテクスチャ.
+*         読み込みが終わるまでは1x1の灰色の画像が設定されている.
+*
+* Streamerが初期化されていない場合はその場で読み込む.
+*/
+Image2DPtr Streamer::Request(const char* path)
+{
+  if (!pbo) {
+    return Image2D::Create(path);
+  }
+  static const uint8_t placeholder[] = { 128, 128, 128, 255 };
+  const Image2DPtr texture = Image2D::Create(path, 1, 1, placeholder, GL_RGBA, GL_UNSIGNED_BYTE);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(Job{ texture, path });
+  }
+  condition.notify_one();
+  return texture;
+}
+
+/**
+* ワーカースレッドの処理.
+*/
+void Streamer::WorkerMain()
+{
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this] { return isStopping || !jobs.empty(); });
+      if (isStopping) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+      ++busyCount;
+    }
+
+    // デコード前に破棄されたテクスチャは読み込まない.
+    std::unique_ptr<Decoded> decoded;
+    if (!job.texture.expired()) {
+      decoded.reset(new Decoded);
+      if (!Decode(job, *decoded)) {
+        std::cerr << "[警告] Texture::Streamer: " << job.path << "を読み込めません." << std::endl;
+        decoded.reset();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (decoded) {
+      decodedList.push_back(std::move(decoded));
+    }
+    --busyCount;
+  }
+}
+
+/**
+* 画像ファイルをデコードする.
+*
+* @param job     デコード要求.
+* @param decoded デコード結果を格納する変数.
+*
+* @retval true  デコード成功.
+* @retval false デコード失敗.
+*
+* 変換済みのDDSファイルがあればそちらを使う.
+*/
+bool Streamer::Decode(const Job& job, Decoded& decoded)
+{
+  decoded.texture = job.texture;
+  decoded.path = job.path;
+  if (IsCookedImageAvailable(job.path.c_str()) && DecodeDDS(CookedPath(job.path.c_str()), decoded)) {
+    return true;
+  }
+  std::string ext = job.path.substr(job.path.size() - std::min<size_t>(job.path.size(), 4));
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+  if (ext == ".dds") {
+    return DecodeDDS(job.path, decoded);
+  }
+  return DecodeImage(job.path, decoded);
+}
+
+/**
+* DDSファイルを読み込む.
+*
+* @param path    DDSファイル名.
+* @param decoded デコード結果を格納する変数.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*
+* ヘッダの解析はLoadDDS()と同じParseDDS()で行う.
+* 画素データはマップしたファイルからdataへコピーする. ページフォールトやディスクの読み込みが
+* メインスレッドの転送中に起きないように、ファイルへのアクセスはこのワーカースレッドで済ませておく.
+* 圧縮形式の2Dテクスチャだけを扱い、それ以外のDDSファイルはfalseを返す.
+*/
+bool Streamer::DecodeDDS(const std::string& path, Decoded& decoded)
+{
+  const MappedFile file(path.c_str());
+  if (file.IsNull()) {
+    return false;
+  }
+  DDSImage image;
+  if (!ParseDDS(path.c_str(), file.Data(), file.Size(), image) || !image.isCompressed || image.isCubemap) {
+    return false;
+  }
+  decoded.internalFormat = image.internalFormat;
+  decoded.isCompressed = true;
+  decoded.levels.reserve(image.levels.size());
+  for (const DDSLevel& e : image.levels) {
+    Level level;
+    level.width = e.width;
+    level.height = e.height;
+    level.offset = e.offset;
+    level.rowBytes = e.rowBytes;
+    level.rowCount = e.rowCount;
+    decoded.levels.push_back(level);
+  }
+  decoded.data.assign(image.pixels, image.pixels + image.faceBytes);
+  return true;
+}
+
+/**
+* TGA/BMPファイルを読み込み、ミップマップを作成する.
+*
+* @param path    画像ファイル名.
+* @param decoded デコード結果を格納する変数.
+*
+* @retval true  読み込み成功.
+* @retval false 読み込み失敗.
+*
+* ミップマップは2x2ピクセルの単純な平均で作成する.
+* 8ビット/チャンネル以外の形式はミップマップを作成せず、レベル0だけを転送する.
+*/
+bool Streamer::DecodeImage(const std::string& path, Decoded& decoded)
+{
+  ImageData image;
+  if (!LoadImage2D(path.c_str(), image)) {
+    return false;
+  }
+  decoded.format = image.format;
+  decoded.type = image.type;
+  size_t pixelBytes = 2;
+  if (image.format == GL_BGR) {
+    decoded.internalFormat = GL_RGB8;
+    pixelBytes = 3;
+  } else if (image.format == GL_RED) {
+    if (image.type == GL_UNSIGNED_SHORT) {
+      decoded.internalFormat = GL_R16;
+    } else {
+      decoded.internalFormat = GL_R8;
+      pixelBytes = 1;
+    }
+  } else {
+    decoded.internalFormat = GL_RGBA8;
+    if (image.type == GL_UNSIGNED_BYTE) {
+      pixelBytes = 4;
+    }
+  }
+
+  Level level;
+  level.width = image.width;
+  level.height = image.height;
+  level.offset = 0;
+  level.rowBytes = image.width * pixelBytes;
+  level.rowCount = image.height;
+  decoded.levels.push_back(level);
+  decoded.data = std::move(image.data);
+  if (image.type != GL_UNSIGNED_BYTE) {
+    return true;
+  }
+
+  // 全レベルの合計はおおむね元の画像の4/3倍になる.
+  decoded.data.reserve(decoded.data.size() * 4 / 3 + 64);
+  while (level.width > 1 || level.height > 1) {
+    const Level src = level;
+    level.width = std::max(src.width / 2, 1);
+    level.height = std::max(src.height / 2, 1);
+    level.offset = decoded.data.size();
+    level.rowBytes = level.width * pixelBytes;
+    level.rowCount = level.height;
+    decoded.data.resize(level.offset + level.rowBytes * level.rowCount);
+
+    const uint8_t* s = decoded.data.data() + src.offset;
+    uint8_t* d = decoded.data.data() + level.offset;
+    for (GLsizei y = 0; y < level.height; ++y) {
+      const uint8_t* row0 = s + std::min(y * 2, src.height - 1) * src.rowBytes;
+      const uint8_t* row1 = s + std::min(y * 2 + 1, src.height - 1) * src.rowBytes;
+      for (GLsizei x = 0; x < level.width; ++x) {
+        const size_t x0 = std::min(x * 2, src.width - 1) * pixelBytes;
+        const size_t x1 = std::min(x * 2 + 1, src.width - 1) * pixelBytes;
+        for (size_t c = 0; c < pixelBytes; ++c) {
+          *d++ = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+        }
+      }
+    }
+    decoded.levels.push_back(level);
+  }
+  return true;
+}
+
+/**
+* テクスチャの全レベルの領域を確保する.
+*
+* @param decoded デコード済みの画像.
+* @param texture 領域を確保するテクスチャ.
+*
+* テクスチャはGL_TEXTURE_2Dにバインドされていること.
+* 確保した時点ではどのレベルも転送されていないので、最小レベルをベースレベルにしておく.
+*/
+void Streamer::Allocate(Decoded& decoded, Image2D& texture) const
+{
+  const GLint maxLevel = static_cast<GLint>(decoded.levels.size()) - 1;
+  for (GLint i = 0; i <= maxLevel; ++i) {
+    const Level& level = decoded.levels[i];
+    if (decoded.isCompressed) {
+      glCompressedTexImage2D(GL_TEXTURE_2D, i, decoded.internalFormat, level.width, level.height, 0,
+        static_cast<GLsizei>(level.rowBytes * level.rowCount), nullptr);
+    } else {
+      glTexImage2D(GL_TEXTURE_2D, i, decoded.internalFormat, level.width, level.height, 0,
+        decoded.format, decoded.type, nullptr);
+    }
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, maxLevel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, maxLevel > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  if (decoded.format == GL_RED || decoded.internalFormat == GL_COMPRESSED_RED_RGTC1) {
+    const GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+  }
+  texture.width = decoded.levels[0].width;
+  texture.height = decoded.levels[0].height;
+  decoded.isAllocated = true;
+  decoded.currentLevel = maxLevel;
+  decoded.currentRow = 0;
+}
+
+/**
+* 転送中のレベルに画像の一部を転送する.
+*
+* @param decoded  デコード済みの画像.
+* @param rowCount 転送する行数.
+* @param data     転送するデータ. PBOがバインドされている場合はPBO内のオフセット.
+*/
+void Streamer::Upload(const Decoded& decoded, GLsizei rowCount, const GLvoid* data)
+{
+  const Level& level = decoded.levels[decoded.currentLevel];
+  if (decoded.isCompressed) {
+    const GLint y = decoded.currentRow * 4;
+    const GLsizei height = std::min(rowCount * 4, level.height - y);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, decoded.currentLevel, 0, y, level.width, height,
+      decoded.internalFormat, static_cast<GLsizei>(level.rowBytes * rowCount), data);
+  } else {
+    glTexSubImage2D(GL_TEXTURE_2D, decoded.currentLevel, 0, decoded.currentRow, level.width, rowCount,
+      decoded.format, decoded.type, data);
+  }
+}
+
+/**
+* リングの区画に書き込むためのポインタを取得する.
+*
+* @param segment 書き込む区画.
+* @param size    書き込むバイト数.
+*
+* @return 書き込み先のポインタ.
+*
+* 区画のフェンスは通過済みであること. そのため、非永続マップでも同期なしでマップできる.
+*/
+uint8_t* Streamer::MapSegment(const Segment& segment, GLsizeiptr size)
+{
+  if (isPersistent) {
+    return mappedPointer + segment.offset;
+  }
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+  return static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, segment.offset, size, flags));
+}
+
+/**
+* MapSegment()で取得したポインタへの書き込みを終了する.
+*/
+void Streamer::UnmapSegment()
+{
+  if (!isPersistent) {
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  }
+}
+
+/**
+* デコード済みの画像をテクスチャに転送する.
+*
+* @param budget このフレームで転送するバイト数の上限. 0の場合はInit()で指定した値を使う.
+*
+* @retval true  転送に成功した、または転送するものがなかった.
+* @retval false PBOをマップできなかった. そのテクスチャの転送は中止する.
+*
+* 毎フレーム呼び出すこと.
+* 全てのテクスチャについて小さいレベルから転送するため、レベルを1つ転送し終えるたびに
+* そのテクスチャを待ち行列の末尾に回す.
+*/
+bool Streamer::Update(GLsizeiptr budget)
+{
+  if (!pbo) {
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!decodedList.empty()) {
+      uploads.push_back(std::move(decodedList.front()));
+      decodedList.pop_front();
+    }
+  }
+  if (uploads.empty()) {
+    return true;
+  }
+
+  bool result = true;
+  if (budget <= 0) {
+    budget = bytesPerFrame;
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+  while (!uploads.empty() && budget > 0) {
+    Decoded& decoded = *uploads.front();
+    const Image2DPtr texture = decoded.texture.lock();
+    if (!texture) {
+      uploads.pop_front(); // 転送中に破棄された.
+      continue;
+    }
+
+    // 区画がまだGPUに使われていたら、このフレームの転送は終わり.
+    Segment& segment = segments[nextSegment];
+    if (segment.fence) {
+      const GLenum result = glClientWaitSync(segment.fence, 0, 0);
+      if (result == GL_TIMEOUT_EXPIRED) {
+        break;
+      }
+      glDeleteSync(segment.fence);
+      segment.fence = nullptr;
+    }
+
+    GLState::BindTexture(0, GL_TEXTURE_2D, texture->Id());
+    if (!decoded.isAllocated) {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      Allocate(decoded, *texture);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    }
+
+    // 区画に収まるだけの行を転送する.
+    const Level& level = decoded.levels[decoded.currentLevel];
+    const GLsizei maxRows = static_cast<GLsizei>(segmentSize / level.rowBytes);
+    const GLsizei rowCount = std::min(level.rowCount - decoded.currentRow, std::max(maxRows, 1));
+    const GLsizeiptr size = rowCount * level.rowBytes;
+    const uint8_t* src = decoded.data.data() + level.offset + decoded.currentRow * level.rowBytes;
+    if (maxRows > 0) {
+      uint8_t* dst = MapSegment(segment, size);
+      if (!dst) {
+        // 同じ転送を繰り返しても失敗するだけなので、このテクスチャは転送済みのレベルまでで諦める.
+        std::cerr << "[エラー] Texture::Streamer::Update: PBOをマップできません(" << decoded.path << ")." << std::endl;
+        uploads.pop_front();
+        result = false;
+        break;
+      }
+      memcpy(dst, src, size);
+      UnmapSegment();
+      Upload(decoded, rowCount, reinterpret_cast<const GLvoid*>(segment.offset));
+      segment.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      nextSegment = (nextSegment + 1) % segments.size();
+    } else {
+      // 1行が区画に収まらないほど幅の広い画像は、PBOを使わずに転送する.
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      Upload(decoded, rowCount, src);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    }
+    budget -= size;
+    decoded.currentRow += rowCount;
+
+    // レベルの転送が終わったら、そのレベルを表示に使えるようにする.
+    if (decoded.currentRow >= level.rowCount) {
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, decoded.currentLevel);
+      --decoded.currentLevel;
+      decoded.currentRow = 0;
+      std::unique_ptr<Decoded> p = std::move(uploads.front());
+      uploads.pop_front();
+      if (p->currentLevel >= 0) {
+        uploads.push_back(std::move(p));
+      }
+    }
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  GLState::BindTexture(0, GL_TEXTURE_2D, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  return result;
+}
+
+/**
+* 要求済みの全てのテクスチャの読み込みが終わるまで待つ.
+*
+* 読み込み画面やインポスターの焼き付けなど、最終的な画像が必要な場合に使う.
+*/
+void Streamer::Flush()
+{
+  while (PendingCount() > 0) {
+    // 転送に失敗した場合、待ち続けても終わらない可能性があるので打ち切る.
+    if (!Update(std::numeric_limits<GLsizeiptr>::max())) {
+      std::cerr << "[警告] Texture::Streamer::Flush: 転送に失敗したため、待機を中止します." << std::endl;
+      break;
+    }
+    glFlush();
+    std::this_thread::yield();
+  }
+}
+
+/**
+* 読み込みが終わっていないテクスチャの数を取得する.
+*
+* @return デコード待ち、デコード中、転送待ちのテクスチャの数.
+*/
+size_t Streamer::PendingCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return jobs.size() + busyCount + decodedList.size() + uploads.size();
+}
+
+} // namespace Texture
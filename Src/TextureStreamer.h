@@ -0,0 +1,124 @@
+/**
+* @file TextureStreamer.h
+*/
+#ifndef TEXTURESTREAMER_H_INCLUDED
+#define TEXTURESTREAMER_H_INCLUDED
+#include <GL/glew.h>
+#include "Texture.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Texture {
+
+/**
+* テクスチャを非同期に読み込むクラス.
+*
+* Request()はすぐにテクスチャを返す. 画像のデコードはワーカースレッドで行い、
+* 転送はUpdate()の中でピクセルバッファオブジェクト(PBO)のリングを通して少しずつ行う.
+* ミップマップは小さいレベルから順に転送し、GL_TEXTURE_BASE_LEVELを下げていくので、
+* 読み込み途中でも低解像度の画像が表示される.
+*
+* 使い方:
+* -# OpenGLの初期化後にInit()を呼ぶ.
+* -# テクスチャが必要になったらRequest()を呼ぶ(通常はCache::Create()経由).
+* -# 毎フレームUpdate()を呼ぶ.
+* -# 終了時にFinalize()を呼ぶ.
+*/
+class Streamer
+{
+public:
+  static Streamer& Instance();
+
+  bool Init(size_t workerCount = 0, GLsizeiptr ringSize = 16 * 1024 * 1024, size_t segmentCount = 4,
+    GLsizeiptr bytesPerFrame = 4 * 1024 * 1024);
+  void Finalize();
+  bool IsInitialized() const { return pbo != 0; }
+
+  Image2DPtr Request(const char* path);
+  bool Update(GLsizeiptr budget = 0);
+  void Flush();
+  size_t PendingCount() const;
+
+private:
+  Streamer() = default;
+  ~Streamer() { Finalize(); }
+  Streamer(const Streamer&) = delete;
+  Streamer& operator=(const Streamer&) = delete;
+
+  // ミップマップレベル.
+  struct Level
+  {
+    GLsizei width;
+    GLsizei height;
+    size_t offset;    ///< dataの先頭からのバイトオフセット.
+    size_t rowBytes;  ///< 1行(圧縮形式の場合は4x4ブロックの1行)のバイト数.
+    GLsizei rowCount; ///< 行数(圧縮形式の場合はブロックの行数).
+  };
+
+  // デコード済みの画像.
+  struct Decoded
+  {
+    std::weak_ptr<Image2D> texture;
+    std::string path;
+    bool isCompressed = false;
+    GLenum internalFormat = GL_RGBA8;
+    GLenum format = GL_NONE;
+    GLenum type = GL_NONE;
+    std::vector<Level> levels;
+    std::vector<uint8_t> data;
+
+    // 転送の進行状況.
+    bool isAllocated = false;
+    int currentLevel = -1; ///< 転送中のレベル.
+    GLsizei currentRow = 0; ///< 次に転送する行.
+  };
+
+  // デコード要求.
+  struct Job
+  {
+    std::weak_ptr<Image2D> texture;
+    std::string path;
+  };
+
+  // PBOリングの区画.
+  struct Segment
+  {
+    GLintptr offset = 0;
+    GLsync fence = nullptr;
+  };
+
+  void WorkerMain();
+  static bool Decode(const Job& job, Decoded& decoded);
+  static bool DecodeDDS(const std::string& path, Decoded& decoded);
+  static bool DecodeImage(const std::string& path, Decoded& decoded);
+  void Allocate(Decoded& decoded, Image2D& texture) const;
+  static void Upload(const Decoded& decoded, GLsizei rowCount, const GLvoid* data);
+  uint8_t* MapSegment(const Segment& segment, GLsizeiptr size);
+  void UnmapSegment();
+
+  std::vector<std::thread> workers;
+  std::deque<Job> jobs;
+  std::deque<std::unique_ptr<Decoded>> decodedList;
+  mutable std::mutex mutex;
+  std::condition_variable condition;
+  size_t busyCount = 0; ///< デコード中のジョブの数.
+  bool isStopping = false;
+
+  std::deque<std::unique_ptr<Decoded>> uploads; // メインスレッドだけが触る.
+  GLuint pbo = 0;
+  uint8_t* mappedPointer = nullptr; // 永続マップしている場合の先頭アドレス.
+  bool isPersistent = false;
+  GLsizeiptr segmentSize = 0;
+  std::vector<Segment> segments;
+  size_t nextSegment = 0;
+  GLsizeiptr bytesPerFrame = 0;
+};
+
+} // namespace Texture
+
+#endif // TEXTURESTREAMER_H_INCLUDED
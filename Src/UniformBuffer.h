@@ -8,10 +8,10 @@
 #include <memory>
 
 class UniformBuffer;
-using UniformBufferPtr = std::shared_ptr<UniformBuffer>; ///< UBO|C^^.
+using UniformBufferPtr = std::shared_ptr<UniformBuffer>; ///< UBOポインタ型.
 
 /**
-* UBONX.
+* UBOクラス.
 */
 class UniformBuffer {
 public:
@@ -31,9 +31,9 @@ private:
 
 private:
   GLuint ubo = 0; ///< Uniform Buffer Object.
-  GLsizeiptr size = 0; ///< UBÕoCgTCY.
-  GLuint bindingPoint; ///< UBO̊蓖ĂĐoCfBOE|Cg.
-  std::string name; ///< UBO.
+  GLsizeiptr size = 0; ///< UBOのバイトサイズ.
+  GLuint bindingPoint; ///< UBOの割り当てて先バインディング・ポイント.
+  std::string name; ///< UBO名.
 };
 
 #endif // UNIFORMBUFFER_H_INCLUDED
\ No newline at end of file